@@ -7,8 +7,8 @@
 typedef max17260_info_t batteryInfo_t;
 
 bool                 get_battery_is_smart(void);
-float                get_battery_voltage (void);
-float                get_battery_percentage (void);
+int32_t              get_battery_millivolts (void);
+int32_t              get_battery_millipercent (void);
 esp_err_t            get_battery_info(batteryInfo_t*);
 
 extern TaskHandle_t xBatteryMonitorHandle;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Wall clock disciplined by a client over HTTP, NTP style, for slot-accurate digital modes.
+ *
+ * A client (the web UI, SOTAmat) runs bursts of timestamped round trips against
+ * /api/v1/clock. Each round trip gives four times: the client's send time t1, the device's
+ * receive and reply times t2 and t3, and the client's receive time t4. Assuming the path is
+ * symmetric, the client's clock is ((t1 + t4) - (t2 + t3)) / 2 ahead of the device's, give or
+ * take half the round-trip delay (t4 - t1) - (t3 - t2). Within a burst the sample with the
+ * smallest delay wins, since queueing only ever adds delay. The winners of bursts spread over
+ * time give the drift rate of the device's crystal against the client's clock.
+ *
+ * Samples are kept against esp_timer, the monotonic clock, so the estimate does not depend on
+ * corrections already made. The wall clock is esp_timer plus the estimated offset, extrapolated
+ * with the drift rate. A new estimate is slewed in at CLOCK_SYNC_SLEW_PPM, so the clock never
+ * jumps during a transmission, unless it is more than CLOCK_SYNC_STEP_US off, when it steps.
+ * Until the first sample, the clock is the system time, which the FT8 prepare request sets.
+ */
+
+#define CLOCK_SYNC_BURST_GAP_US   60000000   // a sample this long after the previous one starts a new burst
+#define CLOCK_SYNC_HISTORY        8          // bursts kept for the drift estimate
+#define CLOCK_SYNC_DRIFT_SPAN_US  300000000  // bursts must span this long to estimate drift
+#define CLOCK_SYNC_MAX_DRIFT_PPB  100000     // drift estimates beyond +/-100 ppm are taken as bad data
+#define CLOCK_SYNC_UNKNOWN_PPB    20000      // drift uncertainty before it is estimated: a crystal's tolerance
+#define CLOCK_SYNC_MAX_DELAY_US   2000000    // round trips slower than this are discarded
+#define CLOCK_SYNC_SLEW_PPM       5000       // corrections are slewed in at 5 ms per second...
+#define CLOCK_SYNC_STEP_US        128000     // ... unless they are larger than this
+#define CLOCK_SYNC_TRUSTED_US     250000     // a disciplined clock this good ignores coarse time settings
+
+typedef struct {
+    bool     synced;              // at least one round trip has been measured
+    int64_t  last_sample_ago_us;  // since the best sample of the latest burst
+    int32_t  offset_us;           // latest sample: client minus device clock, before it was corrected
+    uint32_t delay_us;            // round-trip delay of the best sample of the latest burst
+    int32_t  drift_ppb;           // estimated rate of the device's clock against the client's; positive is slow
+    bool     drift_estimated;     // false until bursts span CLOCK_SYNC_DRIFT_SPAN_US
+    int32_t  slew_remaining_us;   // correction still being slewed in
+    uint32_t uncertainty_us;      // current bound on the clock's error
+    uint16_t samples;             // round trips measured since boot
+    uint16_t steps;               // times the clock was stepped rather than slewed
+} clock_sync_status_t;
+
+/**
+ * Creates the clock state's mutex. Call at startup, before any request or transmission can
+ * reach the clock; safe to call more than once.
+ */
+void init_clock_sync ();
+
+/**
+ * @return the disciplined wall clock, in microseconds since the Unix epoch.
+ */
+int64_t clock_sync_now_us ();
+
+/**
+ * Starts a round trip: remembers when the request carrying the client's send time arrived and
+ * when it is answered, to be completed by clock_sync_complete_exchange() on the next request.
+ * @param client_sent_ms t1: the client's clock when it sent the request, in ms since the epoch.
+ * @param received_us esp_timer time the request arrived.
+ * @param replied_us esp_timer time the reply is sent.
+ */
+void clock_sync_begin_exchange (double client_sent_ms, int64_t received_us, int64_t replied_us);
+
+/**
+ * Completes a round trip begun by clock_sync_begin_exchange() and folds it into the estimate.
+ * @param client_sent_ms t1 of that round trip, which identifies it.
+ * @param client_received_ms t4: the client's clock when it received the reply.
+ * @return false if the round trip is unknown or its delay is implausible.
+ */
+bool clock_sync_complete_exchange (double client_sent_ms, double client_received_ms);
+
+/**
+ * Sets the clock from a single timestamp of unknown latency, such as the FT8 prepare request's
+ * timeNow, unless round trips have already disciplined it to within CLOCK_SYNC_TRUSTED_US.
+ * @return true if the clock was set.
+ */
+bool clock_sync_set_coarse (int64_t client_now_ms);
+
+/**
+ * @param status Receives the state of the estimate.
+ */
+void clock_sync_get_status (clock_sync_status_t * status);
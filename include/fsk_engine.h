@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Timed-FSK transmit engine shared by FT8, FT4 and WSPR.
+ *
+ * A mode is a table row: symbol count and period, tone spacing, slot length and an encoder.
+ * The engine turns a message into the radio's CAT command for every symbol ahead of time,
+ * waits for the mode's next slot, and plays the commands from a hardware timer ISR that
+ * writes each one into the UART TX FIFO on schedule. It also keeps the transmit queue and
+ * the on-air timing of recent transmissions. Queued transmissions carry their own message,
+ * so the transmit task can encode the next one while the current one is on the air. The
+ * HTTP workflow around it (prepare, transmit, cancel, radio state restore) lives in
+ * handler_ft8.cpp.
+ */
+
+#define FSK_MAX_SYMBOLS     162  // WSPR, the longest mode
+#define FSK_MESSAGE_MAX     37   // longest message text of any mode, without the NUL
+#define FSK_TIMING_HISTORY  8    // transmissions kept for fsk_get_timing()
+#define FSK_LATE_SYMBOL_US  2000 // a symbol written this long after its schedule is late
+#define FSK_QUEUE_MAX       4    // transmissions waiting behind the one in progress
+#define FSK_SLOT_ANY        -1   // slot_parity: the next slot, whichever it is
+
+/**
+ * Creates the mutexes guarding the callsign hash table, the timing history and the transmit
+ * queue. Call at startup, before any request or transmission; safe to call more than once.
+ */
+void init_fsk_engine ();
+
+typedef struct {
+    const char * name;               // "ft8", "ft4", "wspr": the API's mode parameter
+    uint16_t     symbols;            // channel symbols per transmission
+    uint32_t     symbol_us;          // symbol period
+    uint32_t     tone_spacing_mhz;   // tone spacing, in millihertz
+    uint32_t     slot_ms;            // transmissions start on multiples of this since the epoch...
+    uint32_t     start_delay_ms;     // ... this long into the slot
+    uint8_t      max_message_chars;  // longest message text the encoder takes
+    bool         sub_hz_tones;       // whole-hertz tones are too far off to decode; needs supports_sub_hz_tuning()
+    /**
+     * Encodes a message as tone numbers, one per symbol.
+     * @return 0 on success, negative if the message can't be encoded in this mode.
+     */
+    int (*encode) (const char * message, uint8_t * tones);
+} fsk_mode_t;
+
+/**
+ * @return the mode with this name (case-insensitive), or nullptr.
+ */
+const fsk_mode_t * fsk_find_mode (const char * name);
+
+/**
+ * @return FT8, the mode used when a request names none.
+ */
+const fsk_mode_t * fsk_default_mode ();
+
+/**
+ * Builds the CAT command for every symbol, back to back, each the same length. Tone offsets
+ * are rounded to whole hertz, the radios' tuning step; modes with sub_hz_tones are not
+ * offered on radios that can't do better.
+ * @param mode Mode of the transmission.
+ * @param tones Tone numbers from mode->encode().
+ * @param base_freq Frequency of tone 0, in Hz.
+ * @param commands Receives the commands; room for mode->symbols * (FT8_TONE_COMMAND_MAX - 1) bytes.
+ * @param command_length Receives the length of each command.
+ * @return false if the radio driver can't format a command.
+ */
+bool fsk_build_tone_commands (const fsk_mode_t * mode, const uint8_t * tones, long base_freq, char * commands, size_t * command_length);
+
+/**
+ * One transmission: what to send, where, and in which slots.
+ */
+typedef struct {
+    char   message[FSK_MESSAGE_MAX + 1];
+    long   base_freq;    // frequency of tone 0, in Hz
+    int8_t slot_parity;  // 0 for even slots (FT8 :00/:30), 1 for odd, or FSK_SLOT_ANY
+} fsk_transmission_t;
+
+/**
+ * @param slot_parity 0 or 1 to skip to the next even or odd slot, or FSK_SLOT_ANY.
+ * @return milliseconds until the mode's next transmission start (slot boundary plus start delay).
+ */
+long fsk_ms_until_window (const fsk_mode_t * mode, int slot_parity = FSK_SLOT_ANY);
+
+/**
+ * Sleeps until the mode's next transmission start in a slot of this parity, feeding the
+ * task watchdog.
+ * @param cancelled Polled every 250 ms; the wait ends early when it returns true.
+ */
+void fsk_wait_for_window (const fsk_mode_t * mode, int slot_parity, bool (*cancelled) ());
+
+/**
+ * Plays a transmission: writes symbol 0 and has the tone timer write the rest, each
+ * mode->symbol_us after the one before, then records the timing. Call from the transmit
+ * task, with the radio lock held and the radio's tone on.
+ * @param cancelled Polled about every second; a cancel stops the transmission.
+ * @param on_air If set, called once with on_air_arg as soon as the timer is running, to do
+ *               work (such as encoding the next transmission) while the symbols play.
+ * @return true if every symbol was sent and played for its full period.
+ */
+bool fsk_play (const fsk_mode_t * mode, const char * commands, size_t command_length, bool (*cancelled) (),
+               void (*on_air) (void *) = nullptr, void * on_air_arg = nullptr);
+
+/**
+ * On-air timing of one transmission, from the times the symbols' commands were written to the UART.
+ */
+typedef struct {
+    int64_t      started_ms;                 // Unix time symbol 0 was written
+    const char * mode;                       // mode name, e.g. "ft8"
+    const char * radio;                      // radio type, e.g. "KX2"
+    int32_t      slot_offset_us;             // symbol 0 from its scheduled start; negative is early
+    uint32_t     symbol_interval_mean_us;    // between consecutive symbols
+    uint32_t     symbol_interval_stddev_us;
+    uint32_t     max_jitter_us;              // largest difference of an interval from the symbol period
+    uint16_t     symbols_sent;
+    uint16_t     late_symbols;               // written more than FSK_LATE_SYMBOL_US behind schedule
+    bool         aborted;
+} fsk_timing_t;
+
+/**
+ * Copies the timing of recent transmissions, newest first.
+ * @param history Receives up to FSK_TIMING_HISTORY entries.
+ * @param count Receives the number of transmissions since boot.
+ * @return number of entries copied.
+ */
+size_t fsk_get_timing (fsk_timing_t * history, uint32_t * count);
+
+/**
+ * Transmit queue: transmissions requested while another is in progress, oldest first.
+ * The push/pop variants with a deadline retry every 100 ms until it passes.
+ */
+size_t fsk_queue_size ();
+bool   fsk_queue_push (const fsk_transmission_t & transmission);
+bool   fsk_queue_pop (fsk_transmission_t & out_transmission);
+bool   fsk_queue_push_with_timeout (const fsk_transmission_t & transmission, int64_t wait_deadline_us);
+bool   fsk_queue_pop_with_timeout (fsk_transmission_t & out_transmission, int64_t wait_deadline_us);
+void   fsk_queue_clear ();
+
+/**
+ * Marks a transmit run, from taking the radio for the first transmission to releasing it
+ * after the last, so that background work (the settings flush) can keep off the flash.
+ */
+void fsk_set_transmitting (bool transmitting);
+
+/**
+ * @return true while a transmit run is in progress or transmissions are queued.
+ */
+bool fsk_is_transmitting ();
@@ -20,4 +20,4 @@ extern "C" bool starts_with (const char * string, const char * prefix);
 #define SC_TASK_PRIORITY_LOW     4
 #define SC_TASK_PRIORITY_IDLE    1
 
-#define BATTERY_SHUTOFF_PERCENTAGE 70.0f
+#define BATTERY_SHUTOFF_PERCENTAGE 70
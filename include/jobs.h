@@ -0,0 +1,131 @@
+#pragma once
+
+#include <esp_http_server.h>
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Registry of long-running radio operations ("jobs").
+ *
+ * A job is accepted immediately, runs on the worker pool, and can be polled or
+ * cancelled through /api/v1/jobs/<id>. Slots are statically allocated; finished
+ * jobs stay visible until their slot is recycled for a newer job.
+ */
+
+#define JOB_SLOTS      8
+#define JOB_ARG_SIZE   192  // inline argument storage, so accepting a job never touches the heap
+#define JOB_ERROR_SIZE 48
+
+typedef enum {
+    JOB_KIND_TIME,
+    JOB_KIND_ATU,
+    JOB_KIND_FT8_PREPARE,
+    JOB_KIND_KEYER,
+    JOB_KIND_COUNT
+} job_kind_t;
+
+typedef enum {
+    JOB_QUEUED,
+    JOB_RUNNING,
+    JOB_SUCCEEDED,
+    JOB_FAILED,
+    JOB_CANCELLED
+} job_state_t;
+
+typedef enum {
+    JOB_START_OK,
+    JOB_START_KIND_BUSY,  // a job of the same kind is already queued or running
+    JOB_START_FULL,       // no free registry slot, or the worker queue is full
+} job_start_result_t;
+
+struct job_t;
+
+/**
+ * Body of a job, run on a worker task.
+ * @return true on success; false after job_fail(), or when giving up because of a cancel request.
+ */
+typedef bool (*job_fn_t) (job_t * job);
+
+/**
+ * Optional hook invoked (on the cancelling task) when a running job is asked to cancel,
+ * for operations that need a nudge to notice the request.
+ */
+typedef void (*job_cancel_fn_t) (job_t * job);
+
+struct job_t {
+    uint32_t                 id;
+    job_kind_t               kind;
+    std::atomic<job_state_t> state;
+    std::atomic<uint8_t>     progress;  // 0-100
+    std::atomic<bool>        cancel_requested;
+    job_fn_t                 fn;
+    job_cancel_fn_t          on_cancel;
+    int64_t                  created_us;
+    int64_t                  finished_us;
+    char                     error[JOB_ERROR_SIZE];
+    alignas (8) uint8_t      arg[JOB_ARG_SIZE];
+};
+
+/**
+ * Snapshot of a job, safe to use after the registry lock is released.
+ */
+typedef struct {
+    uint32_t    id;
+    job_kind_t  kind;
+    job_state_t state;
+    uint8_t     progress;
+    bool        cancel_requested;
+    int64_t     age_ms;
+    char        error[JOB_ERROR_SIZE];
+} job_info_t;
+
+/**
+ * Creates the registry lock. Call once at startup, before the web server accepts requests.
+ */
+void init_jobs ();
+
+/**
+ * Accepts a job and queues it on the worker pool.
+ *
+ * @param kind      Kind of operation; at most one job per kind may be queued or running.
+ * @param fn        Job body.
+ * @param on_cancel Optional hook for cancelling the job while it runs.
+ * @param arg       Argument bytes copied into the job (may be null when arg_len is 0).
+ * @param arg_len   Size of arg, at most JOB_ARG_SIZE.
+ * @param out_id    Receives the new job id on success.
+ */
+job_start_result_t job_start (job_kind_t kind, job_fn_t fn, job_cancel_fn_t on_cancel, const void * arg, size_t arg_len, uint32_t * out_id);
+
+bool job_get_info (uint32_t id, job_info_t * out);
+bool job_cancel (uint32_t id);
+bool job_is_active (job_kind_t kind);
+
+/**
+ * Fills out with snapshots of all known jobs, newest first.
+ * @return number of entries written.
+ */
+size_t job_list (job_info_t * out, size_t max_entries);
+
+// For use inside job bodies
+void job_set_progress (job_t * job, uint8_t percent);
+bool job_is_cancel_requested (const job_t * job);
+bool job_fail (job_t * job, const char * message);
+
+const char * job_kind_name (job_kind_t kind);
+const char * job_state_name (job_state_t state);
+
+// HTTP helpers (handler_jobs.cpp)
+
+/**
+ * @return true if the client asked for an asynchronous reply with "Prefer: respond-async" (RFC 7240).
+ */
+bool client_prefers_async (httpd_req_t * req);
+
+/**
+ * Starts a job and answers "202 Accepted" with a Location header pointing at the job,
+ * or an error reply if the job could not be accepted: "409 Conflict" while a job of the same kind
+ * is running, "503 Service Unavailable" when the job queue is full.
+ */
+esp_err_t start_job_and_reply (httpd_req_t * req, job_kind_t kind, job_fn_t fn, job_cancel_fn_t on_cancel, const void * arg, size_t arg_len);
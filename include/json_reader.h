@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+
+#define JSON_READER_MAX_DEPTH 8  // nesting of objects and arrays
+
+/**
+ * Single-pass, in-place JSON tokenizer for request bodies.
+ *
+ * The document is read once, front to back. Strings (keys and values) are unescaped by
+ * writing forward over the characters already read, and NUL-terminated where they end, so
+ * they can be handed out without copying. Each value is reported to a callback as a typed
+ * event together with its member name.
+ *
+ * A callback can take an object or array whole, as its JSON text, by answering
+ * JSON_CAPTURE to its begin event: the tokenizer then only validates it, leaves its bytes
+ * untouched, and reports it again as a JSON_RAW event.
+ */
+
+typedef enum {
+    JSON_STRING,
+    JSON_NUMBER,
+    JSON_BOOL,
+    JSON_NULL,
+    JSON_OBJECT_BEGIN,
+    JSON_OBJECT_END,
+    JSON_ARRAY_BEGIN,
+    JSON_ARRAY_END,
+    JSON_RAW  // a captured object or array
+} json_event_type_t;
+
+typedef struct {
+    json_event_type_t type;
+    int               depth;  // 1 for members of the top-level object or array
+    const char *      key;    // member name, or nullptr for array elements and the top-level value
+    const char *      string; // JSON_STRING: unescaped value
+    double            number; // JSON_NUMBER
+    bool              boolean;
+    const char *      raw;  // JSON_RAW: text of the captured value (not NUL-terminated)
+    size_t            raw_len;
+} json_event_t;
+
+typedef enum {
+    JSON_CONTINUE,
+    JSON_CAPTURE,  // on an *_BEGIN event: deliver the whole value as JSON_RAW instead
+    JSON_STOP,     // abandon the document; json_parse_in_place() returns false
+} json_action_t;
+
+typedef json_action_t (*json_event_fn_t) (const json_event_t & event, void * ctx);
+
+/**
+ * Tokenizes a NUL-terminated JSON document in place; the buffer is modified.
+ * Strings handed to the callback stay valid as long as the buffer does.
+ *
+ * @param json Document text.
+ * @param on_event Called for every value, in document order.
+ * @param ctx Passed through to on_event.
+ * @return true if the whole document was well-formed and no callback answered JSON_STOP.
+ */
+bool json_parse_in_place (char * json, json_event_fn_t on_event, void * ctx);
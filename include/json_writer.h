@@ -0,0 +1,91 @@
+#pragma once
+
+#include <esp_http_server.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define JSON_WRITER_BUFFER_SIZE 256  // bytes buffered before a chunk goes out
+#define JSON_WRITER_MAX_DEPTH   8    // nesting of objects and arrays
+
+/**
+ * Streams a JSON document into an HTTP response, as chunks of at most
+ * JSON_WRITER_BUFFER_SIZE bytes. Nothing is sized up front and nothing is allocated:
+ * values of any length are escaped straight into the small buffer, which is sent
+ * whenever it fills.
+ *
+ * Usage:
+ *   ```
+ *   JsonWriter json (req);
+ *   json.begin_object();
+ *   json.string ("callsign", g_callsign);
+ *   json.boolean ("mobile", g_tune_targets_mobile);
+ *   json.end_object();
+ *   return json.finish();
+ *   ```
+ *
+ * Members of an object take a key; array elements (and the top-level value) pass nullptr.
+ * Response headers must be set before the first value is written, since the first chunk
+ * may go out at any point. After a send error, or a container nested deeper than
+ * JSON_WRITER_MAX_DEPTH, the remaining calls do nothing and finish() reports the error
+ * without ending the response, so the client sees it cut short rather than a broken document.
+ */
+class JsonWriter {
+    httpd_req_t * m_req;
+    esp_err_t     m_error;
+    size_t        m_len;
+    uint8_t       m_depth;
+    uint32_t      m_has_members;  // bit n: the container at depth n already has a member
+    char          m_buf[JSON_WRITER_BUFFER_SIZE];
+
+    void put (char c);
+    void put (const char * s, size_t len);
+    void put_escaped (const char * s);
+    void begin_value (const char * key);
+    bool begin_container (const char * key, char open);
+    void flush ();
+
+  public:
+    /**
+     * @param req Request to respond to; its content type is set to application/json.
+     */
+    explicit JsonWriter (httpd_req_t * req);
+
+    JsonWriter (const JsonWriter &)             = delete;
+    JsonWriter & operator= (const JsonWriter &) = delete;
+
+    /**
+     * @return false if the container would nest deeper than JSON_WRITER_MAX_DEPTH (the document
+     *         has failed) or an earlier error stopped the output.
+     */
+    bool begin_object (const char * key = nullptr);
+    void end_object ();
+    bool begin_array (const char * key = nullptr);
+    void end_array ();
+
+    void string (const char * key, const char * value);
+    void integer (const char * key, long long value);
+    /**
+     * Writes a number with a fixed number of decimals; NaN and infinities become null.
+     */
+    void number (const char * key, double value, int decimals);
+    /**
+     * Writes a fixed-point number without floating point: `value` is in units of 10^-scale, and is
+     * rounded half away from zero to `decimals` decimals (e.g. 3712 mV, scale 3, decimals 2: 3.71).
+     */
+    void fixed (const char * key, long long value, int scale, int decimals);
+    void boolean (const char * key, bool value);
+    void null (const char * key);
+
+    /**
+     * Writes an already-serialized JSON value (e.g. an array kept as text in NVS) verbatim.
+     */
+    void raw (const char * key, const char * json);
+
+    /**
+     * Sends what is buffered and ends the chunked response.
+     * @return ESP_OK; the first error met while sending; ESP_ERR_INVALID_SIZE if a container
+     *         nested too deeply; or ESP_ERR_INVALID_STATE if containers were left open.
+     */
+    esp_err_t finish ();
+};
@@ -3,11 +3,11 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include <freertos/task.h>
-#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 
 #define SC_KX_COMMUNICATION_RETRIES 3
+#define FT8_TONE_COMMAND_MAX        16  // longest per-symbol CAT command, with its terminating NUL
 
 /**
  * Enumeration of radio operation modes.
@@ -40,8 +40,9 @@ typedef struct {
     uint8_t      audio_peaking;
 } kx_state_t;
 
-// Forward declaration for TimedLock
+// Forward declarations for TimedLock
 class TimedLock;
+class LockContention;
 class IRadioDriver;
 struct RadioTimeHms;
 
@@ -68,7 +69,6 @@ class KXRadio {
     bool              m_is_connected;
     RadioType         m_radio_type;
     IRadioDriver *    m_driver;
-    std::atomic<bool> m_keyer_active { false };
     KXRadio();
     void detect_radio_type ();
     void select_driver ();
@@ -89,6 +89,9 @@ class KXRadio {
     // Returns a TimedLock that can be used with TIMED_LOCK_OR_FAIL or manually
     TimedLock timed_lock (TickType_t timeout_ms, const char * operation);
 
+    // How contended the radio mutex has been lately (see LockContention)
+    const LockContention & lock_contention () const;
+
     void empty_kx_input_buffer (int wait_ms);
 
     long get_from_kx (const char * command, int tries, int num_digits);
@@ -112,33 +115,22 @@ class KXRadio {
     bool tune_atu ();
     bool supports_keyer () const;
     bool supports_volume () const;
+    bool supports_sub_hz_tuning () const;
     bool send_keyer_message (const char * message);
 
-    // True while an HTTP-accepted CW keyer request is outstanding (between
-    // try_begin_keyer_operation() and end_keyer_operation()). Used by the
-    // connection-status handler to report "transmitting" without waiting on
-    // the radio mutex.
-    bool is_keyer_active () const { return m_keyer_active.load (std::memory_order_acquire); }
-
-    // Atomically claim the keyer. Returns true if the caller now owns the
-    // operation and must pair with end_keyer_operation(); false if one is
-    // already in progress and the caller should reject its request.
-    bool try_begin_keyer_operation () {
-        bool expected = false;
-        return m_keyer_active.compare_exchange_strong (
-            expected, true,
-            std::memory_order_acq_rel, std::memory_order_acquire);
-    }
-
-    // Release the claim taken by try_begin_keyer_operation().
-    void end_keyer_operation () { m_keyer_active.store (false, std::memory_order_release); }
     bool sync_time (const RadioTimeHms & client_time);
     bool get_radio_state (kx_state_t * in_state);
     bool restore_radio_state (const kx_state_t * in_state, int tries);
     bool ft8_prepare (long base_freq);
     void ft8_tone_on ();
     void ft8_tone_off ();
-    void ft8_set_tone (long base_freq, long frequency);
+    /**
+     * Formats the CAT command that moves the FT8 carrier to one symbol's frequency, without
+     * sending it: the commands are built ahead of the transmission and written from a timer.
+     * Every command for a radio has the same length.
+     * @return length of the command written to `command` (at most FT8_TONE_COMMAND_MAX - 1), or 0.
+     */
+    size_t ft8_tone_command (long base_freq, long frequency, char * command, size_t size) const;
 
     RadioType get_radio_type () const { return m_radio_type; }
 
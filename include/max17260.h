@@ -12,20 +12,24 @@ typedef struct {
     float v_recovery;  // recovery volgage, V
 } max17620_setup_t;
 
+/**
+ * One poll of the fuel gauge, in raw register units. The ESP32-C3 has no FPU, so they are only
+ * converted, with the integer max17260_*() functions below, when they are shown.
+ */
 typedef struct {
-    float voltage;                   // V
-    float voltage_average;           // V
-    float current;                   // mA
-    float current_average;           // mA
-    float reported_capacity;         // mAh
-    float reported_state_of_charge;  // %
-    float time_to_empty;             // hours
-    float time_to_full;              // hours
-    float temperature;               // degC
-    float temperature_average;       // degC
-    float power;                     // mW
-    float power_average;             // mW
-    bool  charging;
+    uint16_t voltage;                   // VCell
+    uint16_t voltage_average;           // VCellAvg
+    int16_t  current;                   // Current
+    int16_t  current_average;           // CurrentAvg
+    uint16_t reported_capacity;         // RepCap
+    uint16_t reported_state_of_charge;  // RepSOC
+    uint16_t time_to_empty;             // TTE
+    uint16_t time_to_full;              // TTF
+    int16_t  temperature;               // Temp
+    int16_t  temperature_average;       // AvgTA
+    int16_t  power;                     // Power
+    int16_t  power_average;             // AvgPower
+    bool     charging;
 } max17260_info_t;
 
 typedef struct {
@@ -36,11 +40,23 @@ typedef struct {
     uint16_t FullCapNom;
 } max17260_saved_params_t;
 
+/**
+ * Conversions of max17260_info_t registers to integer units, for the configured sense resistor.
+ */
+int32_t max17260_millivolts (uint16_t voltage);
+int32_t max17260_microamps (int16_t current);
+int32_t max17260_microamp_hours (uint16_t capacity);
+int32_t max17260_millipercent (uint16_t state_of_charge);
+int32_t max17260_seconds (uint16_t time);
+int32_t max17260_millidegrees (int16_t temperature);
+int32_t max17260_microwatts (int16_t power);
+
 class Max17620 {
   private:
     smbus_info_t *          m_smb;
     max17620_setup_t        m_setup;
     max17260_saved_params_t m_saved_params;
+    int16_t                 m_charging_current;  // raw CurrentAvg above which the battery is charging
     uint16_t                devnum (uint16_t devname);
 
   public:
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+
+/**
+ * Compile-time perfect hashing for small, fixed lookup tables (web server routes and assets).
+ *
+ * A key is a one-byte tag (e.g. the HTTP method) plus a string. build_perfect_hash() runs
+ * entirely in the compiler: it searches for a hash seed under which every entry of the table
+ * lands in its own slot, so a lookup at runtime is one hash of the key, one slot read and one
+ * exact comparison, independent of the number of entries.
+ *
+ * Adding a duplicate key to a table is a compile error (perfect_hash_duplicate_key).
+ */
+
+struct perfect_hash_key_t {
+    uint8_t          tag;
+    std::string_view name;
+
+    constexpr bool operator== (const perfect_hash_key_t & other) const {
+        return tag == other.tag && name == other.name;
+    }
+};
+
+constexpr uint32_t perfect_hash (uint32_t seed, const perfect_hash_key_t & key) {
+    // FNV-1a over the tag and the name, followed by a murmur-style finalizer so that the
+    // low bits (used as the slot number) depend on every input byte.
+    uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+    h          = (h ^ key.tag) * 16777619u;
+    for (char c : key.name)
+        h = (h ^ (uint8_t)c) * 16777619u;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    return h;
+}
+
+/**
+ * @return a power-of-two slot count giving the seed search a comfortable load factor (<= 1/4).
+ */
+constexpr size_t perfect_hash_slots (size_t entries) {
+    size_t slots = 1;
+    while (slots < entries * 4)
+        slots <<= 1;
+    return slots;
+}
+
+template <size_t SLOTS>
+struct perfect_hash_index_t {
+    static_assert ((SLOTS & (SLOTS - 1)) == 0, "slot count must be a power of two");
+
+    static constexpr uint8_t EMPTY = 0xff;
+
+    uint32_t                   seed;
+    std::array<uint8_t, SLOTS> slots;  // table index per slot, or EMPTY
+
+    constexpr size_t slot_of (const perfect_hash_key_t & key) const {
+        return perfect_hash (seed, key) & (SLOTS - 1);
+    }
+
+    /**
+     * @param table  The table the index was built from.
+     * @param key_of Function returning the perfect_hash_key_t of a table entry.
+     * @param key    Key to look up.
+     * @return the matching table entry, or nullptr.
+     */
+    template <typename Entry, size_t N, typename KeyFn>
+    constexpr const Entry * find (const Entry (&table)[N], KeyFn key_of, const perfect_hash_key_t & key) const {
+        uint8_t index = slots[slot_of (key)];
+        if (index == EMPTY || !(key_of (table[index]) == key))
+            return nullptr;
+        return &table[index];
+    }
+};
+
+// Not constexpr on purpose: reaching a call during constant evaluation fails the build
+// with this function's name in the diagnostic.
+void perfect_hash_duplicate_key ();
+void perfect_hash_no_seed_found ();
+
+/**
+ * Builds the perfect-hash index of a table at compile time.
+ * @param table  Table of entries.
+ * @param key_of Function returning the perfect_hash_key_t of a table entry.
+ */
+template <size_t SLOTS, typename Entry, size_t N, typename KeyFn>
+consteval perfect_hash_index_t<SLOTS> build_perfect_hash (const Entry (&table)[N], KeyFn key_of) {
+    static_assert (N < perfect_hash_index_t<SLOTS>::EMPTY, "table too large for 8-bit slot entries");
+    static_assert (N <= SLOTS, "more entries than slots");
+
+    for (size_t i = 0; i < N; ++i)
+        for (size_t j = i + 1; j < N; ++j)
+            if (key_of (table[i]) == key_of (table[j]))
+                perfect_hash_duplicate_key();
+
+    perfect_hash_index_t<SLOTS> index{};
+    for (uint32_t seed = 0; seed < 100000; ++seed) {
+        index.seed = seed;
+        index.slots.fill (perfect_hash_index_t<SLOTS>::EMPTY);
+
+        bool collision = false;
+        for (size_t i = 0; i < N && !collision; ++i) {
+            size_t slot = index.slot_of (key_of (table[i]));
+            if (index.slots[slot] != perfect_hash_index_t<SLOTS>::EMPTY)
+                collision = true;
+            else
+                index.slots[slot] = (uint8_t)i;
+        }
+        if (!collision)
+            return index;
+    }
+
+    perfect_hash_no_seed_found();
+    return index;
+}
@@ -14,6 +14,7 @@ class IRadioDriver {
 
     virtual bool supports_keyer () const = 0;
     virtual bool supports_volume () const = 0;
+    virtual bool supports_sub_hz_tuning () const = 0;  // FSK tones can be placed between whole hertz
 
     virtual bool get_frequency (KXRadio & radio, long & out_hz) = 0;
     virtual bool set_frequency (KXRadio & radio, long hz, int tries) = 0;
@@ -43,5 +44,5 @@ class IRadioDriver {
     virtual bool ft8_prepare (KXRadio & radio, long base_freq) = 0;
     virtual void ft8_tone_on (KXRadio & radio) = 0;
     virtual void ft8_tone_off (KXRadio & radio) = 0;
-    virtual void ft8_set_tone (KXRadio & radio, long base_freq, long frequency) = 0;
+    virtual size_t ft8_tone_command (long base_freq, long frequency, char * command, size_t size) const = 0;
 };
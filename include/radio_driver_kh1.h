@@ -6,6 +6,7 @@ class KH1RadioDriver : public IRadioDriver {
   public:
     bool supports_keyer () const override;
     bool supports_volume () const override;
+    bool supports_sub_hz_tuning () const override;
 
     bool get_frequency (KXRadio & radio, long & out_hz) override;
     bool set_frequency (KXRadio & radio, long hz, int tries) override;
@@ -35,5 +36,5 @@ class KH1RadioDriver : public IRadioDriver {
     bool ft8_prepare (KXRadio & radio, long base_freq) override;
     void ft8_tone_on (KXRadio & radio) override;
     void ft8_tone_off (KXRadio & radio) override;
-    void ft8_set_tone (KXRadio & radio, long base_freq, long frequency) override;
+    size_t ft8_tone_command (long base_freq, long frequency, char * command, size_t size) const override;
 };
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * Per-request bump allocator for the web server.
+ *
+ * Every task that runs request handlers (the httpd task and the worker-pool tasks) owns
+ * one statically allocated arena. Handlers take scratch memory for query strings and reply
+ * text from it instead of the general heap; everything is released at once when the request
+ * ends, so a long session on a summit does not fragment the heap. The rare large scratch (a
+ * settings POST body and the blobs it sets) comes from the heap instead, rather than sizing
+ * the arena, and its DRAM, for it.
+ *
+ * The httpd task always begins a request before any worker does (workers only run
+ * requests the httpd task handed them), so it claims the first, larger arena.
+ */
+
+#define REQUEST_ARENA_SIZE        4096  // httpd task: the settings replies, which copy the values and blobs they report
+#define REQUEST_ARENA_WORKER_SIZE 1024  // worker tasks: offloaded radio handlers only parse a query string
+
+/**
+ * Binds the calling task to its arena (claiming a free one on first use) and empties it.
+ * @return false if every arena is owned by another task.
+ */
+bool request_arena_begin ();
+
+/**
+ * Releases everything allocated from the calling task's arena since request_arena_begin().
+ */
+void request_arena_end ();
+
+/**
+ * Allocates from the calling task's arena; 8-byte aligned, valid until request_arena_end().
+ * @param size Number of bytes.
+ * @return the memory, or nullptr if the arena is exhausted or the task has none.
+ */
+void * request_arena_alloc (size_t size);
+
+/**
+ * As request_arena_alloc(), with the memory zeroed.
+ */
+void * request_arena_calloc (size_t size);
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <esp_http_server.h>
+#include <stdint.h>
+
+/**
+ * Per-client admission control, and load hints for the web UI's pollers.
+ *
+ * Admission: every request passes a token bucket, kept per client address and per class
+ * of request, before it is dispatched. A client that runs a bucket dry (a runaway tab, a
+ * retry loop) gets "429 Too Many Requests" with a Retry-After for the time until its next
+ * token, while other clients keep their own full buckets: one bad client cannot fill the
+ * sockets and the UART and take latency away from everyone else on the AP. Admissions
+ * and refusals are counted per class and per client for monitoring.
+ *
+ * Load hints: every browser tab polls the radio on its own timers. When several are open,
+ * or a slow radio operation holds the radio mutex, those polls queue up on the mutex, time
+ * out as "radio busy", and are retried, adding load exactly when the radio can least take
+ * it. So API replies carry X-Poll-Interval (milliseconds), derived from the number of
+ * clients seen recently and the recent wait for the radio mutex, and busy replies carry a
+ * Retry-After (seconds) from the same estimate. The web UI never polls faster than either
+ * allows.
+ */
+
+#define SERVER_LOAD_MAX_CLIENTS      8         // distinct client addresses tracked; the longest idle is forgotten first
+#define SERVER_LOAD_CLIENT_ACTIVE_US 10000000  // a client counts as active this long after its last request
+#define POLL_INTERVAL_PER_CLIENT_MS  1000      // recommended interval grows by this for every active client
+#define POLL_INTERVAL_PER_WAIT       4         // ... and by this many times the average radio mutex wait
+#define POLL_INTERVAL_MAX_MS         15000
+
+/**
+ * Classes of request, each with its own token bucket per client (limits in server_load.cpp).
+ */
+typedef enum {
+    RATE_CLASS_STATIC,     // web page assets
+    RATE_CLASS_STATUS,     // cheap device status: battery, RSSI, connection, version, jobs
+    RATE_CLASS_RADIO_GET,  // reads from the radio over the UART
+    RATE_CLASS_RADIO_SET,  // changes to the radio: tuning, keying, transmit, FT8
+    RATE_CLASS_SETTINGS,   // settings (NVS), OTA, reboot
+    RATE_CLASS_COUNT
+} rate_class_t;
+
+typedef struct {
+    uint32_t admitted;
+    uint32_t limited;  // refused with 429
+} rate_counters_t;
+
+typedef struct {
+    uint32_t address;  // IPv4 address in network byte order, or a fold of an IPv6 address
+    uint32_t idle_ms;  // since its last request
+    uint32_t limited;  // requests refused with 429, while the client has been tracked
+} client_stats_t;
+
+typedef struct {
+    rate_counters_t classes[RATE_CLASS_COUNT];  // since boot
+    client_stats_t  clients[SERVER_LOAD_MAX_CLIENTS];
+    int             client_count;
+} server_load_stats_t;
+
+/**
+ * Creates the client table's mutex. Safe to call more than once.
+ */
+void init_server_load ();
+
+/**
+ * @return the class's name for logs and the stats JSON, e.g. "radioGet".
+ */
+const char * rate_class_name (rate_class_t rate_class);
+
+/**
+ * Admits a request: records its client (by address) as active, and takes a token from
+ * the client's bucket for the request's class. Requests whose client cannot be
+ * identified are always admitted.
+ * @param req Pointer to the HTTP request.
+ * @param rate_class Class of the request.
+ * @param retry_after_s Receives, when refused, the whole seconds until the next token.
+ * @return true to serve the request, false to refuse it with 429.
+ */
+bool server_load_admit (httpd_req_t * req, rate_class_t rate_class, int * retry_after_s);
+
+/**
+ * Copies the admission counters and the tracked clients.
+ */
+void server_load_get_stats (server_load_stats_t * stats);
+
+/**
+ * @return number of clients that made a request within SERVER_LOAD_CLIENT_ACTIVE_US.
+ */
+int server_load_active_clients ();
+
+/**
+ * @return the recommended minimum interval between a client's polls, in milliseconds.
+ */
+uint32_t server_load_poll_interval_ms ();
+
+/**
+ * @return the recommended wait before retrying a busy request, in whole seconds (at least 1).
+ */
+int server_load_retry_after_s ();
+
+/**
+ * Adds the X-Poll-Interval header to an API reply. The header text lives in the calling
+ * task's request arena, so call this from the task that sends the reply.
+ * @param req Pointer to the HTTP request.
+ */
+void server_load_set_hints (httpd_req_t * req);
@@ -5,7 +5,7 @@
 
 // ADC Battery measurement
 #define BATTERY_SAMPLES_TO_AVERAGE 16
-#define BATTERY_CALIBRATION_VALUE  1.006879
+#define BATTERY_CALIBRATION_PPM    1006879  // divider correction, in millionths
 
 // LED behavior
 #define LED_FLASH_MSEC    25
@@ -41,25 +41,23 @@ extern char g_gps_lon[MAX_GPS_LON_SIZE];
 #define MAX_CALLSIGN_SIZE 16
 extern char g_callsign[MAX_CALLSIGN_SIZE];
 
-#define MAX_LICENSE_CLASS_SIZE 4  // "T", "G", "E", or ""
+#define MAX_LICENSE_CLASS_SIZE 4  // "N", "T", "G", "A", "E", or ""
 extern char g_license_class[MAX_LICENSE_CLASS_SIZE];
 
 // Tune targets - URLs to open when tuning (e.g., WebSDR, KiwiSDR)
 // Format: [{"url": "...", "enabled": true}, ...]
 #define MAX_TUNE_TARGETS      5
 #define MAX_TUNE_TARGET_SIZE  256
-#define MAX_TUNE_TARGETS_JSON 1600  // 5 URLs * 256 chars + JSON object overhead
-extern char g_tune_targets[MAX_TUNE_TARGETS_JSON];
+#define MAX_TUNE_TARGETS_JSON 1600  // 5 URLs * 256 chars + JSON object overhead; kept in NVS only
 extern bool g_tune_targets_mobile;
 
 // CW Macros - configurable keyer buttons with placeholder support
 // Format: [{"label": "CQ SOTA", "template": "CQ SOTA DE {MYCALL} K"}, ...]
 #define MAX_CW_MACROS      8
-#define MAX_CW_MACROS_JSON 1024  // 8 macros * ~90 chars + JSON overhead
-extern char g_cw_macros[MAX_CW_MACROS_JSON];
+#define MAX_CW_MACROS_JSON 1024  // 8 macros * ~90 chars + JSON overhead; kept in NVS only
 
 void      init_settings ();
-esp_err_t retrieve_and_send_settings (httpd_req_t * req);
+esp_err_t flush_settings ();  // write changed settings to NVS now, rather than after the write-behind delay
 esp_err_t handler_settings_get (httpd_req_t * req);
 esp_err_t handler_settings_post (httpd_req_t * req);
 esp_err_t handler_gps_settings_get (httpd_req_t * req);
@@ -72,4 +70,6 @@ esp_err_t handler_tune_targets_get (httpd_req_t * req);
 esp_err_t handler_tune_targets_post (httpd_req_t * req);
 esp_err_t handler_cw_macros_get (httpd_req_t * req);
 esp_err_t handler_cw_macros_post (httpd_req_t * req);
+esp_err_t handler_config_get (httpd_req_t * req);
+esp_err_t handler_config_patch (httpd_req_t * req);
 esp_err_t handler_radio_type_get (httpd_req_t * req);
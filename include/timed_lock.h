@@ -1,9 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 
+#include "server_load.h"
+
 /**
  * Timeout constants for 3-tier mutex locking strategy
  *
@@ -28,6 +32,58 @@ constexpr TickType_t RADIO_LOCK_TIMEOUT_FT8_MS      = 20000;  // FT8: Long trans
 
 // NOLINTEND(clang-diagnostic-unused-const-variable)
 
+/**
+ * Running measure of how long tasks wait for a mutex, fed by the TimedLocks that take it.
+ *
+ * Keeps an exponentially weighted average of the wait (a timeout counts as its full
+ * timeout). The average also decays while nobody takes the mutex, halving every second,
+ * so a burst of contention is forgotten once it is over. Updates from concurrent
+ * takers may occasionally overwrite each other; that is fine for a load estimate.
+ */
+class LockContention {
+    std::atomic<uint32_t> m_average_us;  // weighted average wait, in microseconds
+    std::atomic<int64_t>  m_updated_us;  // esp_timer time of the last sample
+    std::atomic<uint32_t> m_timeouts;
+
+    static uint32_t decayed (uint32_t average_us, int64_t elapsed_us) {
+        int64_t halvings = elapsed_us / 1000000;
+        return halvings >= 32 ? 0 : average_us >> halvings;
+    }
+
+  public:
+    LockContention ()
+        : m_average_us (0)
+        , m_updated_us (0)
+        , m_timeouts (0) {}
+
+    /**
+     * Records one attempt to take the mutex.
+     * @param waited_us How long the taker blocked.
+     * @param acquired false if it gave up at its timeout.
+     */
+    void record (int64_t waited_us, bool acquired) {
+        int64_t  now     = esp_timer_get_time();
+        uint32_t average = decayed (m_average_us.load(), now - m_updated_us.load());
+        uint32_t sample  = waited_us > UINT32_MAX ? UINT32_MAX : (uint32_t)waited_us;
+        m_average_us.store (average - average / 8 + sample / 8);
+        m_updated_us.store (now);
+        if (!acquired)
+            m_timeouts.fetch_add (1);
+    }
+
+    /**
+     * @return the current weighted average wait, in milliseconds.
+     */
+    uint32_t average_wait_ms () const {
+        return decayed (m_average_us.load(), esp_timer_get_time() - m_updated_us.load()) / 1000;
+    }
+
+    /**
+     * @return number of takers that gave up, since boot.
+     */
+    uint32_t timeouts () const { return m_timeouts.load(); }
+};
+
 /**
  * RAII wrapper for timeout-based mutex locking.
  *
@@ -41,7 +97,7 @@ constexpr TickType_t RADIO_LOCK_TIMEOUT_FT8_MS      = 20000;  // FT8: Long trans
  *   TIMED_LOCK_OR_FAIL(req, kxRadio, RADIO_LOCK_TIMEOUT_FAST_MS, "connection status GET") {
  *       transmitting = kxRadio.get_from_kx("TQ", SC_KX_COMMUNICATION_RETRIES, 1);
  *   }
- *   // Auto unlocks and auto-returns HTTP 500 "radio busy" on timeout
+ *   // Auto unlocks and auto-returns HTTP 503 "radio busy" on timeout
  *   ```
  *
  * 2. Manual TimedLock with custom fallback behavior (e.g., returning stale cached data):
@@ -70,13 +126,20 @@ class TimedLock {
      * @param mutex The FreeRTOS mutex to lock
      * @param timeout_ms Timeout in milliseconds
      * @param operation Optional operation name for logging
+     * @param contention Optional statistics to record the wait in
      */
-    TimedLock (SemaphoreHandle_t mutex, TickType_t timeout_ms, const char * operation = nullptr)
+    TimedLock (SemaphoreHandle_t mutex, TickType_t timeout_ms, const char * operation = nullptr, LockContention * contention = nullptr)
         : m_mutex (mutex)
         , m_acquired (false)
         , m_operation (operation) {
 
-        m_acquired = (xSemaphoreTake (mutex, pdMS_TO_TICKS (timeout_ms)) == pdTRUE);
+        if (contention) {
+            int64_t start_us = esp_timer_get_time();
+            m_acquired       = (xSemaphoreTake (mutex, pdMS_TO_TICKS (timeout_ms)) == pdTRUE);
+            contention->record (esp_timer_get_time() - start_us, m_acquired);
+        }
+        else
+            m_acquired = (xSemaphoreTake (mutex, pdMS_TO_TICKS (timeout_ms)) == pdTRUE);
 
         if (m_acquired) {
             ESP_LOGD ("TimedLock", "%s LOCKED (timed) --", m_operation ? m_operation : "unknown");
@@ -116,14 +179,15 @@ class TimedLock {
  * Helper macro for automatic failure on timeout
  *
  * TIMED_LOCK_OR_FAIL takes a TimedLock object (usually from kxRadio.timed_lock())
- * and automatically returns HTTP 500 if timeout occurs.
+ * and automatically returns HTTP 503 if timeout occurs, with a Retry-After that grows
+ * with the current server load (see server_load.h).
  * This is the recommended pattern for most HTTP handlers.
  *
  * Usage: TIMED_LOCK_OR_FAIL(req, kxRadio.timed_lock(RADIO_LOCK_TIMEOUT_FAST_MS, "operation")) { ... }
  */
-#define TIMED_LOCK_OR_FAIL(req, timed_lock_expr)                                               \
-    TimedLock _timed_lock_##__LINE__ = timed_lock_expr;                                        \
-    if (!_timed_lock_##__LINE__.acquired()) {                                                  \
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "radio busy, please retry"); \
-    }                                                                                          \
+#define TIMED_LOCK_OR_FAIL(req, timed_lock_expr)                                                         \
+    TimedLock _timed_lock_##__LINE__ = timed_lock_expr;                                                  \
+    if (!_timed_lock_##__LINE__.acquired()) {                                                            \
+        return reply_service_unavailable (req, server_load_retry_after_s(), "radio busy, please retry"); \
+    }                                                                                                    \
     else
@@ -1,12 +1,34 @@
 #pragma once
 
+#include "request_arena.h"
+
 #include <esp_http_server.h>
-#include <memory>
+#include <string.h>
 #include <strings.h>  // for size_t
 
+#define REQUEST_QUERY_MAX_PARAMS    12
+#define STANDARD_PARAMETER_MAX_SIZE 128  // longest value (with terminator) STANDARD_DECODE_PARAMETER accepts
+
+/**
+ * A URL query split into name/value pairs. The strings point into one copy of the query in
+ * the request arena and stay valid until the request ends; values are still URL-encoded.
+ */
+typedef struct {
+    struct {
+        const char * name;
+        char *       value;
+    } params[REQUEST_QUERY_MAX_PARAMS];
+    size_t count;
+} request_query_t;
+
 extern void      start_webserver ();
 extern bool      url_decode_in_place (char * str);
+extern esp_err_t request_query_parse (httpd_req_t * req, request_query_t * query);
+extern char *    request_query_value (const request_query_t & query, const char * name);
+extern esp_err_t request_query_copy (const request_query_t & query, const char * name, char * out, size_t out_size);
 extern esp_err_t schedule_deferred_reboot (httpd_req_t * req);
+extern esp_err_t reply_service_unavailable (httpd_req_t * req, int retry_after_s, const char * message);
+extern bool      reply_not_modified_if_match (httpd_req_t * req, const char * etag, const char * cache_control, const char * vary);
 
 extern esp_err_t handler_frequency_get (httpd_req_t *);
 extern esp_err_t handler_frequency_put (httpd_req_t *);
@@ -23,49 +45,54 @@ extern esp_err_t handler_prepareft8_post (httpd_req_t *);
 extern esp_err_t handler_reboot_get (httpd_req_t *);
 extern esp_err_t handler_ft8_post (httpd_req_t *);
 extern esp_err_t handler_cancelft8_post (httpd_req_t *);
+extern esp_err_t handler_ft8_stats_get (httpd_req_t *);
 extern esp_err_t handler_batteryInfo_get (httpd_req_t *);
 extern esp_err_t handler_rssi_get (httpd_req_t *);
 extern esp_err_t handler_connectionStatus_get (httpd_req_t *);
+extern esp_err_t handler_serverLoad_get (httpd_req_t *);
 extern esp_err_t handler_time_put (httpd_req_t *);
+extern esp_err_t handler_clock_get (httpd_req_t *);
 extern esp_err_t handler_settings_get (httpd_req_t *);
 extern esp_err_t handler_settings_post (httpd_req_t *);
 extern esp_err_t handler_version_get (httpd_req_t *);
 extern esp_err_t handler_xmit_put (httpd_req_t *);
 extern esp_err_t handler_atu_put (httpd_req_t * req);
+extern esp_err_t handler_jobs_get (httpd_req_t *);
+extern esp_err_t handler_jobs_delete (httpd_req_t *);
 
 /**
  * Helper definition, to be used within a function body.
- * Retrieves a URL query from an httpd request.
+ * Retrieves the URL query of an httpd request, split into parameters.
  *
  * @param req the httpd_req_t object containing the request
- * @param unsafe_buf a pointer to a newly allocated object containing the query
+ * @param query name of the request_query_t to declare; its strings live in the request arena
  */
-#define STANDARD_DECODE_QUERY(req, unsafe_buf)                                               \
-    /* Get the length of the URL query */                                                    \
-    size_t buf_len = httpd_req_get_url_query_len (req) + 1;                                  \
-    if (buf_len <= 1)                                                                        \
-        REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "missing query string");               \
-    std::unique_ptr<char[]> buf (new char[buf_len]);                                         \
-    if (!buf)                                                                                \
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "heap allocation failed"); \
-    char * unsafe_buf = buf.get(); /* reference to an ephemeral buffer */                    \
-    /* Get the URL query */                                                                  \
-    if (httpd_req_get_url_query_str (req, unsafe_buf, buf_len) != ESP_OK)                    \
-        REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "query parsing error");                \
-    ESP_LOGV (TAG8, "request buffer[%d] = \"%s\"", buf_len, unsafe_buf);
+#define STANDARD_DECODE_QUERY(req, query)                                                      \
+    request_query_t query;                                                                     \
+    switch (request_query_parse (req, &query)) {                                               \
+    case ESP_OK:                                                                               \
+        break;                                                                                 \
+    case ESP_ERR_NOT_FOUND:                                                                    \
+        REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "missing query string");                 \
+    case ESP_ERR_NO_MEM:                                                                       \
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "request arena exhausted"); \
+    default:                                                                                   \
+        REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "query parsing error");                  \
+    }
 
 
 /**
  * Helper definition, to be used within a function body.
- * Given a query string, extracts on parameter by name.
+ * Given a parsed query, looks up one parameter by name.
  *
- * @param unsafe_buf buffer containing the complete query
+ * @param query request_query_t from STANDARD_DECODE_QUERY
  * @param param_name name of the query parameter
- * @param param_value extracted value of the named query parameter
+ * @param param_value name of the char * to declare; points at the (still URL-encoded) value
+ *                    inside the request arena, and may be modified in place
  */
-#define STANDARD_DECODE_PARAMETER(unsafe_buf, param_name, param_value)                               \
-    char param_value[128] = {0};                                                                      \
-    if (httpd_query_key_value (unsafe_buf, param_name, param_value, sizeof (param_value)) != ESP_OK) \
+#define STANDARD_DECODE_PARAMETER(query, param_name, param_value)                                          \
+    char * param_value = request_query_value (query, param_name);                                          \
+    if (!param_value || strnlen (param_value, STANDARD_PARAMETER_MAX_SIZE) >= STANDARD_PARAMETER_MAX_SIZE) \
         REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "parameter parsing error");
 
 /**
@@ -82,8 +109,8 @@ extern esp_err_t handler_atu_put (httpd_req_t * req);
  * @param param_value extracted value of the named query parameter
  */
 #define STANDARD_DECODE_SOLE_PARAMETER(req, param_name, param_value) \
-    STANDARD_DECODE_QUERY (req, unsafe_buf);                         \
-    STANDARD_DECODE_PARAMETER (unsafe_buf, param_name, param_value);
+    STANDARD_DECODE_QUERY (req, query);                              \
+    STANDARD_DECODE_PARAMETER (query, param_name, param_value);
 
 /**
  * Logs an error message, sends a JSON-formatted error response, and returns `ESP_FAIL`.
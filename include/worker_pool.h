@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * Small pool of background tasks used to run slow work off the httpd server task.
+ *
+ * Work items are queued on a bounded FreeRTOS queue; when the queue is full,
+ * worker_pool_submit() fails immediately rather than blocking the caller, so the
+ * caller can shed load (e.g. answer "503 Service Unavailable").
+ */
+typedef void (*worker_fn_t) (void * arg);
+
+#define WORKER_POOL_TASK_COUNT  2     // concurrent slow operations (radio work serializes on its mutex anyway)
+#define WORKER_POOL_QUEUE_DEPTH 4     // pending items beyond the running ones before we refuse new work
+#define WORKER_POOL_STACK_SIZE  6144  // bytes - enough for the heaviest offloaded handler (FT8 prepare)
+
+/**
+ * Creates the work queue and the worker tasks. Safe to call more than once.
+ */
+void start_worker_pool ();
+
+/**
+ * Queues a work item for execution on one of the worker tasks. Never blocks.
+ *
+ * @param fn  Function to run on a worker task.
+ * @param arg Argument passed to fn; ownership transfers to fn.
+ * @return true if queued, false if the pool is not started or the queue is full.
+ */
+bool worker_pool_submit (worker_fn_t fn, void * arg);
+
+/**
+ * @return number of work items waiting for a free worker.
+ */
+size_t worker_pool_pending ();
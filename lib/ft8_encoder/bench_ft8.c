@@ -0,0 +1,359 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "ft8/pack.h"
+#include "ft8/encode.h"
+#include "ft8/crc.h"
+#include "ft8/constants.h"
+
+// Checks the encoder against golden vectors and the original bit-at-a-time kernels, then times it.
+// Usage: bench_ft8 [iterations]
+
+// Tones and CRC-14 produced by the original byte-wise LDPC / bitwise CRC implementation
+typedef struct
+{
+    const char* message;
+    uint16_t crc;
+    const char* ft8_tones;
+    const char* ft4_tones;
+} golden_t;
+
+static const golden_t kGolden[] = {
+    { "CQ K1ABC FN42", 0x0b2e,
+      "3140652000000001005476704606021533433140652736011047517007334745455133543140652",
+      "001321033112330313110222113111302210231223312331210203121200233032123101212323023000120100233321133032010" },
+    { "K1ABC W9XYZ -11", 0x2e81,
+      "3140652032247523504061147017463022603140652054445103423557634070241144523140652",
+      "001321002230213332310210120023311110230330110030222311323012102223023101120313000001322133100310132132010" },
+    { "W9XYZ K1ABC R-09", 0x2afd,
+      "3140652020355725005476704627463523673140652461375524341536404620765601323140652",
+      "001321013121232030210222113111302210233330110330212132301313113303323100033333313300212103332331312132010" },
+    { "K1ABC W9XYZ RR73", 0x2e6b,
+      "3140652032247523504061147017455422543140652656077704107145041657342273103140652",
+      "001321002230213332310210120023311110230330133230223100321213021233223102312203232023230330110012101332010" },
+    { "CQ DX AB6D CM", 0x24ed,
+      "3140652121105573065566052341543011143140652472243067646417506244216727023140652",
+      "001321313202233232213123123032210010232133020033332102202322303102123103003020003312120232331023002132010" },
+    { "TNX FER QSO", 0x2558,
+      "3140652207447171130766340450170011363140652532201607555567526464534073673140652",
+      "001320331320210133101322223003233010231112013033330031132331222232123100300310003113033211123212130132010" },
+    { "TNX BOB 73 GL", 0x3f8b,
+      "3140652207447147063336401773500017703140652646427306546072440503670130533140652",
+      "001320331320210121113011003101223310233003223033121300221003030231123100002301012020301213003321232032010" },
+    { "CQ SOTA W6/CT", 0x220f,
+      "3140652121106330316033467532530010503140652776023377475072601777322125733140652",
+      "001321313202221323220130001202012110232033323033313303211203300002023100101301000323123331010323221032010" },
+};
+
+#define NUM_GOLDEN (int)(sizeof(kGolden) / sizeof(kGolden[0]))
+
+// 77-bit payloads of the structured message types, as laid out by WSJT-X's packjt77
+typedef struct
+{
+    const char* message;
+    const char* payload; // 10 bytes in hex, MSB first
+} pack_golden_t;
+
+static const pack_golden_t kPackGolden[] = {
+    { "CQ DX AB6D CM97", "000046f293db4804c848" },                  // Type 1, directed CQ
+    { "CQ 290 K1ABC FN42", "000012504def1a8a1988" },                // Type 1, CQ with a frequency
+    { "CQ POTA K1ABC", "004feef04def1a9fa448" },                    // Type 1, no grid
+    { "AB6D/P KI6SYD 73", "527b690cbb11181fa510" },                 // Type 2
+    { "K1ABC/R W9XYZ R EN37", "09bde3586149dc285648" },             // Type 1, /R and R grid
+    { "K1ABC W9XYZ -45", "09bde3506149dc1fbac8" },                  // Type 1, report below -30
+    { "K1ABC W9XYZ R+49", "09bde3506149dc3fb908" },                 // Type 1, R report
+    { "QRZ W9XYZ", "000000106149dc1fa448" },                        // Type 1, token
+    { "<W6/AB6D> K1ABC -11", "045996804def1a9faa08" },              // Type 1, hashed call
+    { "K1ABC W6/AB6D -11", "09bde35022ccb41faa08" },                // Type 1, nonstandard call hashed
+    { "CQ W6/AB6D", "000000005d2043cb0060" },                       // Type 4, CQ
+    { "<K1ABC> W6/AB6D RR73", "b23000005d2043cb0120" },             // Type 4
+    { "W6/AB6D K1ABC 73", "b23000005d2043cb03a0" },                 // Type 4, standard call hashed
+    { "PJ4/K1ABC <W9XYZ>", "f31001a3a311caa00620" },                // Type 4
+    { "<PA3XYZ> <G4ABC/P> R 590003 IO91NP", "c8bc8be4fc01a2eb01e8" }, // Type 5, EU VHF
+    { "<G4ABC/P> <PA3XYZ> 520112 JO22DB", "c8bc8bf7c03826b87268" },   // Type 5
+    { "K1ABC RR73; W9XYZ <KH1/KH7Z> -12", "09bde350c293b8325240" },   // 0.1, DXpedition
+    { "123456789ABCDEF012", "2468acf13579bde02540" },               // 0.5, telemetry
+    { "DEADBEEF", "0000000001bd5b7ddf40" },                         // 0.5
+};
+
+#define NUM_PACK_GOLDEN (int)(sizeof(kPackGolden) / sizeof(kPackGolden[0]))
+
+// Messages that fit no type: longer than 13 characters and not structured
+static const char* kUnpackable[] = {
+    "CQ SOTA W6/CT-006",     // too long for free text
+    "K1ABC W9XYZ -51",       // report out of range
+    "CQ W6/AB6D FN42",       // a hashed call needs a standard one with it
+    "K1ABC/P W9XYZ/R EN37",  // /P and /R mixed
+    "<K1ABC> <W9XYZ> -10",   // two hashed calls
+};
+
+#define NUM_UNPACKABLE (int)(sizeof(kUnpackable) / sizeof(kUnpackable[0]))
+
+// The original CRC: modulo-2 division a bit at a time
+static uint16_t ref_compute_crc(const uint8_t message[], int num_bits)
+{
+    const uint16_t topbit = 1u << (FT8_CRC_WIDTH - 1);
+    uint16_t remainder = 0;
+    int idx_byte = 0;
+    for (int idx_bit = 0; idx_bit < num_bits; ++idx_bit)
+    {
+        if (idx_bit % 8 == 0)
+            remainder ^= (message[idx_byte++] << (FT8_CRC_WIDTH - 8));
+        remainder = (remainder & topbit) ? (remainder << 1) ^ FT8_CRC_POLYNOMIAL : (remainder << 1);
+    }
+    return remainder & ((topbit << 1) - 1u);
+}
+
+static uint8_t ref_parity8(uint8_t x)
+{
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+    return x % 2;
+}
+
+// The original LDPC parity: a byte at a time, one parity bit per generator row
+static void ref_encode174(const uint8_t* message, uint8_t* codeword)
+{
+    for (int j = 0; j < FTX_LDPC_N_BYTES; ++j)
+        codeword[j] = (j < FTX_LDPC_K_BYTES) ? message[j] : 0;
+
+    for (int i = 0; i < FTX_LDPC_M; ++i)
+    {
+        uint8_t nsum = 0;
+        for (int j = 0; j < FTX_LDPC_K_BYTES; ++j)
+        {
+            uint8_t row_byte = (uint8_t)(kFTX_LDPC_generator[i][j / 4] >> (24 - 8 * (j % 4)));
+            nsum ^= ref_parity8(message[j] & row_byte);
+        }
+        if (nsum)
+            codeword[(FTX_LDPC_K + i) / 8] |= 0x80u >> ((FTX_LDPC_K + i) % 8);
+    }
+}
+
+// The original FT8 symbol mapping: codeword bits pulled out one at a time
+static void ref_ft8_encode(const uint8_t* payload, uint8_t* tones)
+{
+    uint8_t a91[FTX_LDPC_K_BYTES];
+    memcpy(a91, payload, 10);
+    a91[9] &= 0xF8u;
+    a91[10] = 0;
+    a91[11] = 0;
+    uint16_t checksum = ref_compute_crc(a91, 96 - 14);
+    a91[9] |= (uint8_t)(checksum >> 11);
+    a91[10] = (uint8_t)(checksum >> 3);
+    a91[11] = (uint8_t)(checksum << 5);
+
+    uint8_t codeword[FTX_LDPC_N_BYTES];
+    ref_encode174(a91, codeword);
+
+    int i_bit = 0;
+    for (int i_tone = 0; i_tone < FT8_NN; ++i_tone)
+    {
+        if (i_tone < 7 || (i_tone >= 36 && i_tone < 43) || i_tone >= 72)
+        {
+            tones[i_tone] = kFT8_Costas_pattern[i_tone % 36 % 7];
+            continue;
+        }
+        uint8_t bits3 = 0;
+        for (int k = 0; k < 3; ++k, ++i_bit)
+            bits3 = (bits3 << 1) | ((codeword[i_bit / 8] >> (7 - i_bit % 8)) & 1u);
+        tones[i_tone] = kFT8_Gray_map[bits3];
+    }
+}
+
+static int check_tones(const char* what, const char* message, const uint8_t* tones, const char* expected, int num_tones)
+{
+    for (int i = 0; i < num_tones; ++i)
+    {
+        if (tones[i] != expected[i] - '0')
+        {
+            printf("FAIL %s '%s': symbol %d is %d, expected %c\n", what, message, i, tones[i], expected[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check_golden(void)
+{
+    int failures = 0;
+    for (int m = 0; m < NUM_GOLDEN; ++m)
+    {
+        uint8_t packed[FTX_LDPC_K_BYTES] = { 0 };
+        if (pack77(kGolden[m].message, packed) < 0)
+        {
+            printf("FAIL pack77 '%s'\n", kGolden[m].message);
+            ++failures;
+            continue;
+        }
+
+        uint8_t a91[FTX_LDPC_K_BYTES];
+        ftx_add_crc(packed, a91);
+        uint16_t crc = (uint16_t)(((a91[9] & 0x07u) << 11) | (a91[10] << 3) | (a91[11] >> 5));
+        if (crc != kGolden[m].crc)
+        {
+            printf("FAIL crc '%s': 0x%04x, expected 0x%04x\n", kGolden[m].message, crc, kGolden[m].crc);
+            ++failures;
+        }
+
+        uint8_t tones[FT4_NN];
+        ft8_encode(packed, tones);
+        failures += check_tones("ft8_encode", kGolden[m].message, tones, kGolden[m].ft8_tones, FT8_NN);
+        ft4_encode(packed, tones);
+        failures += check_tones("ft4_encode", kGolden[m].message, tones, kGolden[m].ft4_tones, FT4_NN);
+    }
+    return failures;
+}
+
+static int check_pack(void)
+{
+    int failures = 0;
+    for (int m = 0; m < NUM_PACK_GOLDEN; ++m)
+    {
+        uint8_t packed[FTX_LDPC_K_BYTES] = { 0 };
+        char hex[21];
+        if (pack77(kPackGolden[m].message, packed) < 0)
+        {
+            printf("FAIL pack77 '%s'\n", kPackGolden[m].message);
+            ++failures;
+            continue;
+        }
+        for (int i = 0; i < 10; ++i)
+            sprintf(hex + 2 * i, "%02x", packed[i]);
+        if (strcmp(hex, kPackGolden[m].payload) != 0)
+        {
+            printf("FAIL pack77 '%s': %s, expected %s\n", kPackGolden[m].message, hex, kPackGolden[m].payload);
+            ++failures;
+        }
+    }
+
+    for (int m = 0; m < NUM_UNPACKABLE; ++m)
+    {
+        uint8_t packed[FTX_LDPC_K_BYTES] = { 0 };
+        if (pack77(kUnpackable[m], packed) == 0)
+        {
+            printf("FAIL pack77 '%s' should not pack\n", kUnpackable[m]);
+            ++failures;
+        }
+    }
+
+    // The hashed calls packed above can be looked up by the hashes the messages carry
+    char callsign[12];
+    if (!ftx_lookup_hash_call(2497664, 22, callsign) || strcmp(callsign, "W6/AB6D") != 0)
+    {
+        printf("FAIL ftx_lookup_hash_call W6/AB6D\n");
+        ++failures;
+    }
+    if (!ftx_lookup_hash_call(201, 10, callsign) || strcmp(callsign, "KH1/KH7Z") != 0)
+    {
+        printf("FAIL ftx_lookup_hash_call KH1/KH7Z\n");
+        ++failures;
+    }
+    return failures;
+}
+
+// Random payloads and bit counts through the new and the original kernels
+static int check_random(int count)
+{
+    int failures = 0;
+    srand(12345);
+    for (int n = 0; n < count && failures < 10; ++n)
+    {
+        uint8_t payload[FTX_LDPC_K_BYTES];
+        for (int j = 0; j < FTX_LDPC_K_BYTES; ++j)
+            payload[j] = (uint8_t)rand();
+
+        int num_bits = 1 + rand() % (8 * FTX_LDPC_K_BYTES);
+        if (ftx_compute_crc(payload, num_bits) != ref_compute_crc(payload, num_bits))
+        {
+            printf("FAIL crc of random payload %d over %d bits\n", n, num_bits);
+            ++failures;
+        }
+
+        uint8_t tones[FT8_NN];
+        uint8_t ref_tones[FT8_NN];
+        ft8_encode(payload, tones);
+        ref_ft8_encode(payload, ref_tones);
+        if (memcmp(tones, ref_tones, FT8_NN) != 0)
+        {
+            printf("FAIL ft8_encode of random payload %d\n", n);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile uint8_t sink; // keeps the timed calls from being optimized away
+
+int main(int argc, char** argv)
+{
+    int iterations = (argc > 1) ? atoi(argv[1]) : 200000;
+
+    int failures = check_golden() + check_pack() + check_random(10000);
+    if (failures)
+    {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("golden vectors, message types and random cross-checks passed\n");
+
+    uint8_t packed[FTX_LDPC_K_BYTES] = { 0 };
+    uint8_t a91[FTX_LDPC_K_BYTES];
+    uint8_t tones[FT4_NN];
+    pack77(kGolden[0].message, packed);
+
+    double t0 = now_ns();
+    for (int n = 0; n < iterations; ++n)
+    {
+        packed[0] = (uint8_t)n;
+        ftx_add_crc(packed, a91);
+        sink ^= a91[11];
+    }
+    double t1 = now_ns();
+    for (int n = 0; n < iterations; ++n)
+    {
+        packed[0] = (uint8_t)n;
+        sink ^= (uint8_t)ref_compute_crc(packed, 82);
+    }
+    double t2 = now_ns();
+    for (int n = 0; n < iterations; ++n)
+    {
+        packed[0] = (uint8_t)n;
+        ft8_encode(packed, tones);
+        sink ^= tones[40];
+    }
+    double t3 = now_ns();
+    for (int n = 0; n < iterations; ++n)
+    {
+        packed[0] = (uint8_t)n;
+        ref_ft8_encode(packed, tones);
+        sink ^= tones[40];
+    }
+    double t4 = now_ns();
+    for (int n = 0; n < iterations; ++n)
+    {
+        packed[0] = (uint8_t)n;
+        ft4_encode(packed, tones);
+        sink ^= tones[40];
+    }
+    double t5 = now_ns();
+
+    printf("%-24s %8.1f ns\n", "ftx_add_crc", (t1 - t0) / iterations);
+    printf("%-24s %8.1f ns\n", "  original bitwise CRC", (t2 - t1) / iterations);
+    printf("%-24s %8.1f ns\n", "ft8_encode", (t3 - t2) / iterations);
+    printf("%-24s %8.1f ns\n", "  original ft8_encode", (t4 - t3) / iterations);
+    printf("%-24s %8.1f ns\n", "ft4_encode", (t5 - t4) / iterations);
+    return 0;
+}
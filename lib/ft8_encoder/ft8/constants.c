@@ -6,90 +6,143 @@ const uint8_t kFT8_Costas_pattern[7] = { 3, 1, 4, 0, 6, 5, 2 };
 // Gray code map (FTx bits -> channel symbols)
 const uint8_t kFT8_Gray_map[8] = { 0, 1, 3, 2, 5, 6, 4, 7 };
 
-// Parity generator matrix for (174,91) LDPC code, stored in bitpacked format (MSB first)
-const uint8_t kFTX_LDPC_generator[FTX_LDPC_M][FTX_LDPC_K_BYTES] = {
-    { 0x83, 0x29, 0xce, 0x11, 0xbf, 0x31, 0xea, 0xf5, 0x09, 0xf2, 0x7f, 0xc0 },
-    { 0x76, 0x1c, 0x26, 0x4e, 0x25, 0xc2, 0x59, 0x33, 0x54, 0x93, 0x13, 0x20 },
-    { 0xdc, 0x26, 0x59, 0x02, 0xfb, 0x27, 0x7c, 0x64, 0x10, 0xa1, 0xbd, 0xc0 },
-    { 0x1b, 0x3f, 0x41, 0x78, 0x58, 0xcd, 0x2d, 0xd3, 0x3e, 0xc7, 0xf6, 0x20 },
-    { 0x09, 0xfd, 0xa4, 0xfe, 0xe0, 0x41, 0x95, 0xfd, 0x03, 0x47, 0x83, 0xa0 },
-    { 0x07, 0x7c, 0xcc, 0xc1, 0x1b, 0x88, 0x73, 0xed, 0x5c, 0x3d, 0x48, 0xa0 },
-    { 0x29, 0xb6, 0x2a, 0xfe, 0x3c, 0xa0, 0x36, 0xf4, 0xfe, 0x1a, 0x9d, 0xa0 },
-    { 0x60, 0x54, 0xfa, 0xf5, 0xf3, 0x5d, 0x96, 0xd3, 0xb0, 0xc8, 0xc3, 0xe0 },
-    { 0xe2, 0x07, 0x98, 0xe4, 0x31, 0x0e, 0xed, 0x27, 0x88, 0x4a, 0xe9, 0x00 },
-    { 0x77, 0x5c, 0x9c, 0x08, 0xe8, 0x0e, 0x26, 0xdd, 0xae, 0x56, 0x31, 0x80 },
-    { 0xb0, 0xb8, 0x11, 0x02, 0x8c, 0x2b, 0xf9, 0x97, 0x21, 0x34, 0x87, 0xc0 },
-    { 0x18, 0xa0, 0xc9, 0x23, 0x1f, 0xc6, 0x0a, 0xdf, 0x5c, 0x5e, 0xa3, 0x20 },
-    { 0x76, 0x47, 0x1e, 0x83, 0x02, 0xa0, 0x72, 0x1e, 0x01, 0xb1, 0x2b, 0x80 },
-    { 0xff, 0xbc, 0xcb, 0x80, 0xca, 0x83, 0x41, 0xfa, 0xfb, 0x47, 0xb2, 0xe0 },
-    { 0x66, 0xa7, 0x2a, 0x15, 0x8f, 0x93, 0x25, 0xa2, 0xbf, 0x67, 0x17, 0x00 },
-    { 0xc4, 0x24, 0x36, 0x89, 0xfe, 0x85, 0xb1, 0xc5, 0x13, 0x63, 0xa1, 0x80 },
-    { 0x0d, 0xff, 0x73, 0x94, 0x14, 0xd1, 0xa1, 0xb3, 0x4b, 0x1c, 0x27, 0x00 },
-    { 0x15, 0xb4, 0x88, 0x30, 0x63, 0x6c, 0x8b, 0x99, 0x89, 0x49, 0x72, 0xe0 },
-    { 0x29, 0xa8, 0x9c, 0x0d, 0x3d, 0xe8, 0x1d, 0x66, 0x54, 0x89, 0xb0, 0xe0 },
-    { 0x4f, 0x12, 0x6f, 0x37, 0xfa, 0x51, 0xcb, 0xe6, 0x1b, 0xd6, 0xb9, 0x40 },
-    { 0x99, 0xc4, 0x72, 0x39, 0xd0, 0xd9, 0x7d, 0x3c, 0x84, 0xe0, 0x94, 0x00 },
-    { 0x19, 0x19, 0xb7, 0x51, 0x19, 0x76, 0x56, 0x21, 0xbb, 0x4f, 0x1e, 0x80 },
-    { 0x09, 0xdb, 0x12, 0xd7, 0x31, 0xfa, 0xee, 0x0b, 0x86, 0xdf, 0x6b, 0x80 },
-    { 0x48, 0x8f, 0xc3, 0x3d, 0xf4, 0x3f, 0xbd, 0xee, 0xa4, 0xea, 0xfb, 0x40 },
-    { 0x82, 0x74, 0x23, 0xee, 0x40, 0xb6, 0x75, 0xf7, 0x56, 0xeb, 0x5f, 0xe0 },
-    { 0xab, 0xe1, 0x97, 0xc4, 0x84, 0xcb, 0x74, 0x75, 0x71, 0x44, 0xa9, 0xa0 },
-    { 0x2b, 0x50, 0x0e, 0x4b, 0xc0, 0xec, 0x5a, 0x6d, 0x2b, 0xdb, 0xdd, 0x00 },
-    { 0xc4, 0x74, 0xaa, 0x53, 0xd7, 0x02, 0x18, 0x76, 0x16, 0x69, 0x36, 0x00 },
-    { 0x8e, 0xba, 0x1a, 0x13, 0xdb, 0x33, 0x90, 0xbd, 0x67, 0x18, 0xce, 0xc0 },
-    { 0x75, 0x38, 0x44, 0x67, 0x3a, 0x27, 0x78, 0x2c, 0xc4, 0x20, 0x12, 0xe0 },
-    { 0x06, 0xff, 0x83, 0xa1, 0x45, 0xc3, 0x70, 0x35, 0xa5, 0xc1, 0x26, 0x80 },
-    { 0x3b, 0x37, 0x41, 0x78, 0x58, 0xcc, 0x2d, 0xd3, 0x3e, 0xc3, 0xf6, 0x20 },
-    { 0x9a, 0x4a, 0x5a, 0x28, 0xee, 0x17, 0xca, 0x9c, 0x32, 0x48, 0x42, 0xc0 },
-    { 0xbc, 0x29, 0xf4, 0x65, 0x30, 0x9c, 0x97, 0x7e, 0x89, 0x61, 0x0a, 0x40 },
-    { 0x26, 0x63, 0xae, 0x6d, 0xdf, 0x8b, 0x5c, 0xe2, 0xbb, 0x29, 0x48, 0x80 },
-    { 0x46, 0xf2, 0x31, 0xef, 0xe4, 0x57, 0x03, 0x4c, 0x18, 0x14, 0x41, 0x80 },
-    { 0x3f, 0xb2, 0xce, 0x85, 0xab, 0xe9, 0xb0, 0xc7, 0x2e, 0x06, 0xfb, 0xe0 },
-    { 0xde, 0x87, 0x48, 0x1f, 0x28, 0x2c, 0x15, 0x39, 0x71, 0xa0, 0xa2, 0xe0 },
-    { 0xfc, 0xd7, 0xcc, 0xf2, 0x3c, 0x69, 0xfa, 0x99, 0xbb, 0xa1, 0x41, 0x20 },
-    { 0xf0, 0x26, 0x14, 0x47, 0xe9, 0x49, 0x0c, 0xa8, 0xe4, 0x74, 0xce, 0xc0 },
-    { 0x44, 0x10, 0x11, 0x58, 0x18, 0x19, 0x6f, 0x95, 0xcd, 0xd7, 0x01, 0x20 },
-    { 0x08, 0x8f, 0xc3, 0x1d, 0xf4, 0xbf, 0xbd, 0xe2, 0xa4, 0xea, 0xfb, 0x40 },
-    { 0xb8, 0xfe, 0xf1, 0xb6, 0x30, 0x77, 0x29, 0xfb, 0x0a, 0x07, 0x8c, 0x00 },
-    { 0x5a, 0xfe, 0xa7, 0xac, 0xcc, 0xb7, 0x7b, 0xbc, 0x9d, 0x99, 0xa9, 0x00 },
-    { 0x49, 0xa7, 0x01, 0x6a, 0xc6, 0x53, 0xf6, 0x5e, 0xcd, 0xc9, 0x07, 0x60 },
-    { 0x19, 0x44, 0xd0, 0x85, 0xbe, 0x4e, 0x7d, 0xa8, 0xd6, 0xcc, 0x7d, 0x00 },
-    { 0x25, 0x1f, 0x62, 0xad, 0xc4, 0x03, 0x2f, 0x0e, 0xe7, 0x14, 0x00, 0x20 },
-    { 0x56, 0x47, 0x1f, 0x87, 0x02, 0xa0, 0x72, 0x1e, 0x00, 0xb1, 0x2b, 0x80 },
-    { 0x2b, 0x8e, 0x49, 0x23, 0xf2, 0xdd, 0x51, 0xe2, 0xd5, 0x37, 0xfa, 0x00 },
-    { 0x6b, 0x55, 0x0a, 0x40, 0xa6, 0x6f, 0x47, 0x55, 0xde, 0x95, 0xc2, 0x60 },
-    { 0xa1, 0x8a, 0xd2, 0x8d, 0x4e, 0x27, 0xfe, 0x92, 0xa4, 0xf6, 0xc8, 0x40 },
-    { 0x10, 0xc2, 0xe5, 0x86, 0x38, 0x8c, 0xb8, 0x2a, 0x3d, 0x80, 0x75, 0x80 },
-    { 0xef, 0x34, 0xa4, 0x18, 0x17, 0xee, 0x02, 0x13, 0x3d, 0xb2, 0xeb, 0x00 },
-    { 0x7e, 0x9c, 0x0c, 0x54, 0x32, 0x5a, 0x9c, 0x15, 0x83, 0x6e, 0x00, 0x00 },
-    { 0x36, 0x93, 0xe5, 0x72, 0xd1, 0xfd, 0xe4, 0xcd, 0xf0, 0x79, 0xe8, 0x60 },
-    { 0xbf, 0xb2, 0xce, 0xc5, 0xab, 0xe1, 0xb0, 0xc7, 0x2e, 0x07, 0xfb, 0xe0 },
-    { 0x7e, 0xe1, 0x82, 0x30, 0xc5, 0x83, 0xcc, 0xcc, 0x57, 0xd4, 0xb0, 0x80 },
-    { 0xa0, 0x66, 0xcb, 0x2f, 0xed, 0xaf, 0xc9, 0xf5, 0x26, 0x64, 0x12, 0x60 },
-    { 0xbb, 0x23, 0x72, 0x5a, 0xbc, 0x47, 0xcc, 0x5f, 0x4c, 0xc4, 0xcd, 0x20 },
-    { 0xde, 0xd9, 0xdb, 0xa3, 0xbe, 0xe4, 0x0c, 0x59, 0xb5, 0x60, 0x9b, 0x40 },
-    { 0xd9, 0xa7, 0x01, 0x6a, 0xc6, 0x53, 0xe6, 0xde, 0xcd, 0xc9, 0x03, 0x60 },
-    { 0x9a, 0xd4, 0x6a, 0xed, 0x5f, 0x70, 0x7f, 0x28, 0x0a, 0xb5, 0xfc, 0x40 },
-    { 0xe5, 0x92, 0x1c, 0x77, 0x82, 0x25, 0x87, 0x31, 0x6d, 0x7d, 0x3c, 0x20 },
-    { 0x4f, 0x14, 0xda, 0x82, 0x42, 0xa8, 0xb8, 0x6d, 0xca, 0x73, 0x35, 0x20 },
-    { 0x8b, 0x8b, 0x50, 0x7a, 0xd4, 0x67, 0xd4, 0x44, 0x1d, 0xf7, 0x70, 0xe0 },
-    { 0x22, 0x83, 0x1c, 0x9c, 0xf1, 0x16, 0x94, 0x67, 0xad, 0x04, 0xb6, 0x80 },
-    { 0x21, 0x3b, 0x83, 0x8f, 0xe2, 0xae, 0x54, 0xc3, 0x8e, 0xe7, 0x18, 0x00 },
-    { 0x5d, 0x92, 0x6b, 0x6d, 0xd7, 0x1f, 0x08, 0x51, 0x81, 0xa4, 0xe1, 0x20 },
-    { 0x66, 0xab, 0x79, 0xd4, 0xb2, 0x9e, 0xe6, 0xe6, 0x95, 0x09, 0xe5, 0x60 },
-    { 0x95, 0x81, 0x48, 0x68, 0x2d, 0x74, 0x8a, 0x38, 0xdd, 0x68, 0xba, 0xa0 },
-    { 0xb8, 0xce, 0x02, 0x0c, 0xf0, 0x69, 0xc3, 0x2a, 0x72, 0x3a, 0xb1, 0x40 },
-    { 0xf4, 0x33, 0x1d, 0x6d, 0x46, 0x16, 0x07, 0xe9, 0x57, 0x52, 0x74, 0x60 },
-    { 0x6d, 0xa2, 0x3b, 0xa4, 0x24, 0xb9, 0x59, 0x61, 0x33, 0xcf, 0x9c, 0x80 },
-    { 0xa6, 0x36, 0xbc, 0xbc, 0x7b, 0x30, 0xc5, 0xfb, 0xea, 0xe6, 0x7f, 0xe0 },
-    { 0x5c, 0xb0, 0xd8, 0x6a, 0x07, 0xdf, 0x65, 0x4a, 0x90, 0x89, 0xa2, 0x00 },
-    { 0xf1, 0x1f, 0x10, 0x68, 0x48, 0x78, 0x0f, 0xc9, 0xec, 0xdd, 0x80, 0xa0 },
-    { 0x1f, 0xbb, 0x53, 0x64, 0xfb, 0x8d, 0x2c, 0x9d, 0x73, 0x0d, 0x5b, 0xa0 },
-    { 0xfc, 0xb8, 0x6b, 0xc7, 0x0a, 0x50, 0xc9, 0xd0, 0x2a, 0x5d, 0x03, 0x40 },
-    { 0xa5, 0x34, 0x43, 0x30, 0x29, 0xea, 0xc1, 0x5f, 0x32, 0x2e, 0x34, 0xc0 },
-    { 0xc9, 0x89, 0xd9, 0xc7, 0xc3, 0xd3, 0xb8, 0xc5, 0x5d, 0x75, 0x13, 0x00 },
-    { 0x7b, 0xb3, 0x8b, 0x2f, 0x01, 0x86, 0xd4, 0x66, 0x43, 0xae, 0x96, 0x20 },
-    { 0x26, 0x44, 0xeb, 0xad, 0xeb, 0x44, 0xb9, 0x46, 0x7d, 0x1f, 0x42, 0xc0 },
-    { 0x60, 0x8c, 0xc8, 0x57, 0x59, 0x4b, 0xfb, 0xb5, 0x5d, 0x69, 0x60, 0x00 }
+// FT4 sync tone patterns, one for each of the four sync blocks
+const uint8_t kFT4_Costas_pattern[4][4] = {
+    { 0, 1, 3, 2 },
+    { 1, 0, 2, 3 },
+    { 2, 3, 1, 0 },
+    { 3, 2, 0, 1 }
+};
+
+// Gray code map (FT4 bits -> channel symbols)
+const uint8_t kFT4_Gray_map[4] = { 0, 1, 3, 2 };
+
+// FT4 payload scrambling sequence (77 bits, MSB first)
+const uint8_t kFT4_XOR_sequence[10] = {
+    0x4Au, 0x5Eu, 0x89u, 0xB4u, 0xB0u, 0x8Au, 0x79u, 0x55u, 0xBEu, 0x28u
+};
+
+// Parity generator matrix for (174,91) LDPC code, stored in bitpacked format (MSB first),
+// each row as three 32-bit words so parity is computed a word at a time
+const uint32_t kFTX_LDPC_generator[FTX_LDPC_M][FTX_LDPC_K_WORDS] = {
+    { 0x8329ce11u, 0xbf31eaf5u, 0x09f27fc0u },
+    { 0x761c264eu, 0x25c25933u, 0x54931320u },
+    { 0xdc265902u, 0xfb277c64u, 0x10a1bdc0u },
+    { 0x1b3f4178u, 0x58cd2dd3u, 0x3ec7f620u },
+    { 0x09fda4feu, 0xe04195fdu, 0x034783a0u },
+    { 0x077cccc1u, 0x1b8873edu, 0x5c3d48a0u },
+    { 0x29b62afeu, 0x3ca036f4u, 0xfe1a9da0u },
+    { 0x6054faf5u, 0xf35d96d3u, 0xb0c8c3e0u },
+    { 0xe20798e4u, 0x310eed27u, 0x884ae900u },
+    { 0x775c9c08u, 0xe80e26ddu, 0xae563180u },
+    { 0xb0b81102u, 0x8c2bf997u, 0x213487c0u },
+    { 0x18a0c923u, 0x1fc60adfu, 0x5c5ea320u },
+    { 0x76471e83u, 0x02a0721eu, 0x01b12b80u },
+    { 0xffbccb80u, 0xca8341fau, 0xfb47b2e0u },
+    { 0x66a72a15u, 0x8f9325a2u, 0xbf671700u },
+    { 0xc4243689u, 0xfe85b1c5u, 0x1363a180u },
+    { 0x0dff7394u, 0x14d1a1b3u, 0x4b1c2700u },
+    { 0x15b48830u, 0x636c8b99u, 0x894972e0u },
+    { 0x29a89c0du, 0x3de81d66u, 0x5489b0e0u },
+    { 0x4f126f37u, 0xfa51cbe6u, 0x1bd6b940u },
+    { 0x99c47239u, 0xd0d97d3cu, 0x84e09400u },
+    { 0x1919b751u, 0x19765621u, 0xbb4f1e80u },
+    { 0x09db12d7u, 0x31faee0bu, 0x86df6b80u },
+    { 0x488fc33du, 0xf43fbdeeu, 0xa4eafb40u },
+    { 0x827423eeu, 0x40b675f7u, 0x56eb5fe0u },
+    { 0xabe197c4u, 0x84cb7475u, 0x7144a9a0u },
+    { 0x2b500e4bu, 0xc0ec5a6du, 0x2bdbdd00u },
+    { 0xc474aa53u, 0xd7021876u, 0x16693600u },
+    { 0x8eba1a13u, 0xdb3390bdu, 0x6718cec0u },
+    { 0x75384467u, 0x3a27782cu, 0xc42012e0u },
+    { 0x06ff83a1u, 0x45c37035u, 0xa5c12680u },
+    { 0x3b374178u, 0x58cc2dd3u, 0x3ec3f620u },
+    { 0x9a4a5a28u, 0xee17ca9cu, 0x324842c0u },
+    { 0xbc29f465u, 0x309c977eu, 0x89610a40u },
+    { 0x2663ae6du, 0xdf8b5ce2u, 0xbb294880u },
+    { 0x46f231efu, 0xe457034cu, 0x18144180u },
+    { 0x3fb2ce85u, 0xabe9b0c7u, 0x2e06fbe0u },
+    { 0xde87481fu, 0x282c1539u, 0x71a0a2e0u },
+    { 0xfcd7ccf2u, 0x3c69fa99u, 0xbba14120u },
+    { 0xf0261447u, 0xe9490ca8u, 0xe474cec0u },
+    { 0x44101158u, 0x18196f95u, 0xcdd70120u },
+    { 0x088fc31du, 0xf4bfbde2u, 0xa4eafb40u },
+    { 0xb8fef1b6u, 0x307729fbu, 0x0a078c00u },
+    { 0x5afea7acu, 0xccb77bbcu, 0x9d99a900u },
+    { 0x49a7016au, 0xc653f65eu, 0xcdc90760u },
+    { 0x1944d085u, 0xbe4e7da8u, 0xd6cc7d00u },
+    { 0x251f62adu, 0xc4032f0eu, 0xe7140020u },
+    { 0x56471f87u, 0x02a0721eu, 0x00b12b80u },
+    { 0x2b8e4923u, 0xf2dd51e2u, 0xd537fa00u },
+    { 0x6b550a40u, 0xa66f4755u, 0xde95c260u },
+    { 0xa18ad28du, 0x4e27fe92u, 0xa4f6c840u },
+    { 0x10c2e586u, 0x388cb82au, 0x3d807580u },
+    { 0xef34a418u, 0x17ee0213u, 0x3db2eb00u },
+    { 0x7e9c0c54u, 0x325a9c15u, 0x836e0000u },
+    { 0x3693e572u, 0xd1fde4cdu, 0xf079e860u },
+    { 0xbfb2cec5u, 0xabe1b0c7u, 0x2e07fbe0u },
+    { 0x7ee18230u, 0xc583ccccu, 0x57d4b080u },
+    { 0xa066cb2fu, 0xedafc9f5u, 0x26641260u },
+    { 0xbb23725au, 0xbc47cc5fu, 0x4cc4cd20u },
+    { 0xded9dba3u, 0xbee40c59u, 0xb5609b40u },
+    { 0xd9a7016au, 0xc653e6deu, 0xcdc90360u },
+    { 0x9ad46aedu, 0x5f707f28u, 0x0ab5fc40u },
+    { 0xe5921c77u, 0x82258731u, 0x6d7d3c20u },
+    { 0x4f14da82u, 0x42a8b86du, 0xca733520u },
+    { 0x8b8b507au, 0xd467d444u, 0x1df770e0u },
+    { 0x22831c9cu, 0xf1169467u, 0xad04b680u },
+    { 0x213b838fu, 0xe2ae54c3u, 0x8ee71800u },
+    { 0x5d926b6du, 0xd71f0851u, 0x81a4e120u },
+    { 0x66ab79d4u, 0xb29ee6e6u, 0x9509e560u },
+    { 0x95814868u, 0x2d748a38u, 0xdd68baa0u },
+    { 0xb8ce020cu, 0xf069c32au, 0x723ab140u },
+    { 0xf4331d6du, 0x461607e9u, 0x57527460u },
+    { 0x6da23ba4u, 0x24b95961u, 0x33cf9c80u },
+    { 0xa636bcbcu, 0x7b30c5fbu, 0xeae67fe0u },
+    { 0x5cb0d86au, 0x07df654au, 0x9089a200u },
+    { 0xf11f1068u, 0x48780fc9u, 0xecdd80a0u },
+    { 0x1fbb5364u, 0xfb8d2c9du, 0x730d5ba0u },
+    { 0xfcb86bc7u, 0x0a50c9d0u, 0x2a5d0340u },
+    { 0xa5344330u, 0x29eac15fu, 0x322e34c0u },
+    { 0xc989d9c7u, 0xc3d3b8c5u, 0x5d751300u },
+    { 0x7bb38b2fu, 0x0186d466u, 0x43ae9620u },
+    { 0x2644ebadu, 0xeb44b946u, 0x7d1f42c0u },
+    { 0x608cc857u, 0x594bfbb5u, 0x5d696000u },
+};
+
+// CRC-14 of each byte value, for the byte-at-a-time CRC (polynomial FT8_CRC_POLYNOMIAL)
+const uint16_t kFT8_CRC_table[256] = {
+    0x0000u, 0x2757u, 0x29f9u, 0x0eaeu, 0x34a5u, 0x13f2u, 0x1d5cu, 0x3a0bu,
+    0x0e1du, 0x294au, 0x27e4u, 0x00b3u, 0x3ab8u, 0x1defu, 0x1341u, 0x3416u,
+    0x1c3au, 0x3b6du, 0x35c3u, 0x1294u, 0x289fu, 0x0fc8u, 0x0166u, 0x2631u,
+    0x1227u, 0x3570u, 0x3bdeu, 0x1c89u, 0x2682u, 0x01d5u, 0x0f7bu, 0x282cu,
+    0x3874u, 0x1f23u, 0x118du, 0x36dau, 0x0cd1u, 0x2b86u, 0x2528u, 0x027fu,
+    0x3669u, 0x113eu, 0x1f90u, 0x38c7u, 0x02ccu, 0x259bu, 0x2b35u, 0x0c62u,
+    0x244eu, 0x0319u, 0x0db7u, 0x2ae0u, 0x10ebu, 0x37bcu, 0x3912u, 0x1e45u,
+    0x2a53u, 0x0d04u, 0x03aau, 0x24fdu, 0x1ef6u, 0x39a1u, 0x370fu, 0x1058u,
+    0x17bfu, 0x30e8u, 0x3e46u, 0x1911u, 0x231au, 0x044du, 0x0ae3u, 0x2db4u,
+    0x19a2u, 0x3ef5u, 0x305bu, 0x170cu, 0x2d07u, 0x0a50u, 0x04feu, 0x23a9u,
+    0x0b85u, 0x2cd2u, 0x227cu, 0x052bu, 0x3f20u, 0x1877u, 0x16d9u, 0x318eu,
+    0x0598u, 0x22cfu, 0x2c61u, 0x0b36u, 0x313du, 0x166au, 0x18c4u, 0x3f93u,
+    0x2fcbu, 0x089cu, 0x0632u, 0x2165u, 0x1b6eu, 0x3c39u, 0x3297u, 0x15c0u,
+    0x21d6u, 0x0681u, 0x082fu, 0x2f78u, 0x1573u, 0x3224u, 0x3c8au, 0x1bddu,
+    0x33f1u, 0x14a6u, 0x1a08u, 0x3d5fu, 0x0754u, 0x2003u, 0x2eadu, 0x09fau,
+    0x3decu, 0x1abbu, 0x1415u, 0x3342u, 0x0949u, 0x2e1eu, 0x20b0u, 0x07e7u,
+    0x2f7eu, 0x0829u, 0x0687u, 0x21d0u, 0x1bdbu, 0x3c8cu, 0x3222u, 0x1575u,
+    0x2163u, 0x0634u, 0x089au, 0x2fcdu, 0x15c6u, 0x3291u, 0x3c3fu, 0x1b68u,
+    0x3344u, 0x1413u, 0x1abdu, 0x3deau, 0x07e1u, 0x20b6u, 0x2e18u, 0x094fu,
+    0x3d59u, 0x1a0eu, 0x14a0u, 0x33f7u, 0x09fcu, 0x2eabu, 0x2005u, 0x0752u,
+    0x170au, 0x305du, 0x3ef3u, 0x19a4u, 0x23afu, 0x04f8u, 0x0a56u, 0x2d01u,
+    0x1917u, 0x3e40u, 0x30eeu, 0x17b9u, 0x2db2u, 0x0ae5u, 0x044bu, 0x231cu,
+    0x0b30u, 0x2c67u, 0x22c9u, 0x059eu, 0x3f95u, 0x18c2u, 0x166cu, 0x313bu,
+    0x052du, 0x227au, 0x2cd4u, 0x0b83u, 0x3188u, 0x16dfu, 0x1871u, 0x3f26u,
+    0x38c1u, 0x1f96u, 0x1138u, 0x366fu, 0x0c64u, 0x2b33u, 0x259du, 0x02cau,
+    0x36dcu, 0x118bu, 0x1f25u, 0x3872u, 0x0279u, 0x252eu, 0x2b80u, 0x0cd7u,
+    0x24fbu, 0x03acu, 0x0d02u, 0x2a55u, 0x105eu, 0x3709u, 0x39a7u, 0x1ef0u,
+    0x2ae6u, 0x0db1u, 0x031fu, 0x2448u, 0x1e43u, 0x3914u, 0x37bau, 0x10edu,
+    0x00b5u, 0x27e2u, 0x294cu, 0x0e1bu, 0x3410u, 0x1347u, 0x1de9u, 0x3abeu,
+    0x0ea8u, 0x29ffu, 0x2751u, 0x0006u, 0x3a0du, 0x1d5au, 0x13f4u, 0x34a3u,
+    0x1c8fu, 0x3bd8u, 0x3576u, 0x1221u, 0x282au, 0x0f7du, 0x01d3u, 0x2684u,
+    0x1292u, 0x35c5u, 0x3b6bu, 0x1c3cu, 0x2637u, 0x0160u, 0x0fceu, 0x2899u
 };
 
@@ -15,6 +15,9 @@ extern "C"
 #define FT8_SYMBOL_PERIOD (0.160f) ///< FT8 symbol duration, defines tone deviation in Hz and symbol rate
 #define FT8_SLOT_TIME     (15.0f)  ///< FT8 slot period
 
+#define FT4_SYMBOL_PERIOD (0.048f) ///< FT4 symbol duration, defines tone deviation in Hz and symbol rate
+#define FT4_SLOT_TIME     (7.5f)   ///< FT4 slot period
+
 // Define FT8 symbol counts
 // FT8 message structure:
 //     S D1 S D2 S
@@ -23,12 +26,21 @@ extern "C"
 #define FT8_ND          (58) ///< Data symbols
 #define FT8_NN          (79) ///< Total channel symbols (FT8_NS + FT8_ND)
 
+// FT4 message structure:
+//     R Sa D1 Sb D2 Sc D3 Sd R
+// R  - ramping symbol (no payload information conveyed)
+// Sx - one of four _different_ sync blocks (4 symbols of Costas pattern)
+// Dy - data block (29 symbols each encoding 2 bits)
+#define FT4_ND          (87)  ///< Data symbols
+#define FT4_NN          (105) ///< Total channel symbols (FT4_NS + FT4_ND + 2 ramp symbols)
+
 // Define LDPC parameters
 #define FTX_LDPC_N       (174)                  ///< Number of bits in the encoded message (payload with LDPC checksum bits)
 #define FTX_LDPC_K       (91)                   ///< Number of payload bits (including CRC)
 #define FTX_LDPC_M       (83)                   ///< Number of LDPC checksum bits (FTX_LDPC_N - FTX_LDPC_K)
 #define FTX_LDPC_N_BYTES ((FTX_LDPC_N + 7) / 8) ///< Number of whole bytes needed to store 174 bits (full message)
 #define FTX_LDPC_K_BYTES ((FTX_LDPC_K + 7) / 8) ///< Number of whole bytes needed to store 91 bits (payload + CRC only)
+#define FTX_LDPC_K_WORDS ((FTX_LDPC_K + 31) / 32) ///< Number of 32-bit words needed to store 91 bits (payload + CRC only)
 
 // Define CRC parameters
 #define FT8_CRC_POLYNOMIAL ((uint16_t)0x2757u) ///< CRC-14 polynomial without the leading (MSB) 1
@@ -40,8 +52,20 @@ extern "C"
     /// Gray code map to encode 8 symbols (tones)
     extern const uint8_t kFT8_Gray_map[8];
 
-    /// Parity generator matrix for (174,91) LDPC code, stored in bitpacked format (MSB first)
-    extern const uint8_t kFTX_LDPC_generator[FTX_LDPC_M][FTX_LDPC_K_BYTES];
+    /// Costas 4x4 tone patterns for FT4 synchronization, one per sync block
+    extern const uint8_t kFT4_Costas_pattern[4][4];
+
+    /// Gray code map to encode 4 symbols (tones)
+    extern const uint8_t kFT4_Gray_map[4];
+
+    /// Sequence XOR'ed with the FT4 payload, so messages don't start with long runs of zeros
+    extern const uint8_t kFT4_XOR_sequence[10];
+
+    /// Parity generator matrix for (174,91) LDPC code, stored in bitpacked format (MSB first), 32 bits per word
+    extern const uint32_t kFTX_LDPC_generator[FTX_LDPC_M][FTX_LDPC_K_WORDS];
+
+    /// CRC-14 remainder of each byte value (FT8_CRC_POLYNOMIAL), for the table-driven CRC
+    extern const uint16_t kFT8_CRC_table[256];
 
 #ifdef __cplusplus
 }
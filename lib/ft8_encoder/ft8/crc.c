@@ -5,6 +5,7 @@
 
 // Compute 14-bit CRC for a sequence of given number of bits
 // Adapted from https://barrgroup.com/Embedded-Systems/How-To/CRC-Calculation-C-Code
+// Whole bytes go through kFT8_CRC_table a byte at a time; a trailing partial byte is divided a bit at a time.
 // [IN] message  - byte sequence (MSB first)
 // [IN] num_bits - number of bits in the sequence
 uint16_t ftx_compute_crc(const uint8_t message[], int num_bits)
@@ -12,24 +13,27 @@ uint16_t ftx_compute_crc(const uint8_t message[], int num_bits)
     uint16_t remainder = 0;
     int idx_byte = 0;
 
-    // Perform modulo-2 division, a bit at a time.
-    for (int idx_bit = 0; idx_bit < num_bits; ++idx_bit)
+    // Perform modulo-2 division, a byte at a time.
+    for (; idx_byte < num_bits / 8; ++idx_byte)
     {
-        if (idx_bit % 8 == 0)
-        {
-            // Bring the next byte into the remainder.
-            remainder ^= (message[idx_byte] << (FT8_CRC_WIDTH - 8));
-            ++idx_byte;
-        }
+        uint8_t top = (uint8_t)((remainder >> (FT8_CRC_WIDTH - 8)) ^ message[idx_byte]);
+        remainder = (uint16_t)((remainder << 8) ^ kFT8_CRC_table[top]) & ((TOPBIT << 1) - 1u);
+    }
 
-        // Try to divide the current data bit.
-        if (remainder & TOPBIT)
-        {
-            remainder = (remainder << 1) ^ FT8_CRC_POLYNOMIAL;
-        }
-        else
+    // Bring in the last, partial byte and divide only its leading bits.
+    if (num_bits % 8)
+    {
+        remainder ^= (message[idx_byte] << (FT8_CRC_WIDTH - 8));
+        for (int idx_bit = 0; idx_bit < num_bits % 8; ++idx_bit)
         {
-            remainder = (remainder << 1);
+            if (remainder & TOPBIT)
+            {
+                remainder = (remainder << 1) ^ FT8_CRC_POLYNOMIAL;
+            }
+            else
+            {
+                remainder = (remainder << 1);
+            }
         }
     }
 
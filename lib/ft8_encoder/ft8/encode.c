@@ -5,12 +5,12 @@
 #include <stdio.h>
 
 // Returns 1 if an odd number of bits are set in x, zero otherwise
-static uint8_t parity8(uint8_t x)
+static uint8_t parity32(uint32_t x)
 {
-    x ^= x >> 4;  // a b c d ae bf cg dh
-    x ^= x >> 2;  // a b ac bd cae dbf aecg bfdh
-    x ^= x >> 1;  // a ab bac acbd bdcae caedbf aecgbfdh
-    return x % 2; // modulo 2
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    return (0x6996u >> (x & 0x0Fu)) & 1u; // parity of the remaining nibble, looked up in a 16-bit constant
 }
 
 // Encode via LDPC a 91-bit message and return a 174-bit codeword.
@@ -21,7 +21,13 @@ static uint8_t parity8(uint8_t x)
 // [OUT] codeword - array of 174 bits stored as 22 bytes (MSB first)
 static void encode174(const uint8_t* message, uint8_t* codeword)
 {
-    // This implementation accesses the generator bits straight from the packed binary representation in kFTX_LDPC_generator
+    // Load the message as three big-endian words, to match the layout of kFTX_LDPC_generator
+    uint32_t words[FTX_LDPC_K_WORDS];
+    for (int w = 0; w < FTX_LDPC_K_WORDS; ++w)
+    {
+        const uint8_t* b = message + 4 * w;
+        words[w] = ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
+    }
 
     // Fill the codeword with message and zeros, as we will only update binary ones later
     for (int j = 0; j < FTX_LDPC_N_BYTES; ++j)
@@ -36,18 +42,13 @@ static void encode174(const uint8_t* message, uint8_t* codeword)
     // Compute the LDPC checksum bits and store them in codeword
     for (int i = 0; i < FTX_LDPC_M; ++i)
     {
-        // Fast implementation of bitwise multiplication and parity checking
-        // Normally nsum would contain the result of dot product between message and kFTX_LDPC_generator[i],
-        // but we only compute the sum modulo 2.
-        uint8_t nsum = 0;
-        for (int j = 0; j < FTX_LDPC_K_BYTES; ++j)
-        {
-            uint8_t bits = message[j] & kFTX_LDPC_generator[i][j]; // bitwise AND (bitwise multiplication)
-            nsum ^= parity8(bits);                                 // bitwise XOR (addition modulo 2)
-        }
+        // The dot product of message and kFTX_LDPC_generator[i] modulo 2: AND (bitwise multiplication)
+        // a word at a time, XOR the words together, and take the parity of the result
+        const uint32_t* row = kFTX_LDPC_generator[i];
+        uint32_t bits = (words[0] & row[0]) ^ (words[1] & row[1]) ^ (words[2] & row[2]);
 
-        // Set the current checksum bit in codeword if nsum is odd
-        if (nsum % 2)
+        // Set the current checksum bit in codeword if the sum is odd
+        if (parity32(bits))
         {
             codeword[col_idx] |= col_mask;
         }
@@ -70,57 +71,70 @@ void ft8_encode(const uint8_t* payload, uint8_t* tones)
     // a91 contains 77 bits of payload + 14 bits of CRC
     ftx_add_crc(payload, a91);
 
-    uint8_t codeword[FTX_LDPC_N_BYTES];
+    uint8_t codeword[FTX_LDPC_N_BYTES + 1]; // one spare byte, so every symbol's bits can be read as a 16-bit window
     encode174(a91, codeword);
+    codeword[FTX_LDPC_N_BYTES] = 0;
 
     // Message structure: S7 D29 S7 D29 S7
     // Total symbols: 79 (FT8_NN)
+    for (int i = 0; i < 7; ++i)
+    {
+        tones[i] = kFT8_Costas_pattern[i];
+        tones[36 + i] = kFT8_Costas_pattern[i];
+        tones[72 + i] = kFT8_Costas_pattern[i];
+    }
 
-    uint8_t mask = 0x80u; // Mask to extract 1 bit from codeword
-    int i_byte = 0;       // Index of the current byte of the codeword
-    for (int i_tone = 0; i_tone < FT8_NN; ++i_tone)
+    for (int i_data = 0; i_data < FT8_ND; ++i_data)
     {
-        if ((i_tone >= 0) && (i_tone < 7))
-        {
-            tones[i_tone] = kFT8_Costas_pattern[i_tone];
-        }
-        else if ((i_tone >= 36) && (i_tone < 43))
-        {
-            tones[i_tone] = kFT8_Costas_pattern[i_tone - 36];
-        }
-        else if ((i_tone >= 72) && (i_tone < 79))
-        {
-            tones[i_tone] = kFT8_Costas_pattern[i_tone - 72];
-        }
-        else
-        {
-            // Extract 3 bits from codeword at i-th position
-            uint8_t bits3 = 0;
-
-            if (codeword[i_byte] & mask)
-                bits3 |= 4;
-            if (0 == (mask >>= 1))
-            {
-                mask = 0x80u;
-                i_byte++;
-            }
-            if (codeword[i_byte] & mask)
-                bits3 |= 2;
-            if (0 == (mask >>= 1))
-            {
-                mask = 0x80u;
-                i_byte++;
-            }
-            if (codeword[i_byte] & mask)
-                bits3 |= 1;
-            if (0 == (mask >>= 1))
-            {
-                mask = 0x80u;
-                i_byte++;
-            }
-
-            tones[i_tone] = kFT8_Gray_map[bits3];
-        }
+        // Extract the data symbol's 3 bits from the two bytes they fall in
+        int i_bit = 3 * i_data;
+        uint16_t window = ((uint16_t)codeword[i_bit / 8] << 8) | codeword[i_bit / 8 + 1];
+        uint8_t bits3 = (window >> (13 - i_bit % 8)) & 7u;
+
+        int i_tone = i_data + ((i_data < 29) ? 7 : 14); // skip the sync blocks before it
+        tones[i_tone] = kFT8_Gray_map[bits3];
     }
 }
 
+
+void ft4_encode(const uint8_t* payload, uint8_t* tones)
+{
+    uint8_t a91[FTX_LDPC_K_BYTES]; // Store 77 bits of payload + 14 bits CRC
+    uint8_t payload_xor[10];       // Scrambled payload
+
+    // FT4 scrambles the 77-bit payload before computing the CRC and parity bits,
+    // to avoid transmitting long runs of zeros (e.g. in CQ messages)
+    for (int i = 0; i < 10; ++i)
+    {
+        payload_xor[i] = payload[i] ^ kFT4_XOR_sequence[i];
+    }
+
+    // Compute and add CRC at the end of the message
+    // a91 contains 77 bits of payload + 14 bits of CRC
+    ftx_add_crc(payload_xor, a91);
+
+    uint8_t codeword[FTX_LDPC_N_BYTES];
+    encode174(a91, codeword);
+
+    // Message structure: R S4_1 D29 S4_2 D29 S4_3 D29 S4_4 R
+    // Total symbols: 105 (FT4_NN)
+    tones[0] = 0;   // R (ramp) symbol
+    tones[104] = 0; // R (ramp) symbol
+    for (int i = 0; i < 4; ++i)
+    {
+        tones[1 + i] = kFT4_Costas_pattern[0][i];
+        tones[34 + i] = kFT4_Costas_pattern[1][i];
+        tones[67 + i] = kFT4_Costas_pattern[2][i];
+        tones[100 + i] = kFT4_Costas_pattern[3][i];
+    }
+
+    for (int i_data = 0; i_data < FT4_ND; ++i_data)
+    {
+        // Extract the data symbol's 2 bits; they never straddle a byte boundary
+        int i_bit = 2 * i_data;
+        uint8_t bits2 = (codeword[i_bit / 8] >> (6 - i_bit % 8)) & 3u;
+
+        int i_tone = i_data + 5 + 4 * (i_data / 29); // skip the ramp symbol and the sync blocks before it
+        tones[i_tone] = kFT4_Gray_map[bits2];
+    }
+}
@@ -10,42 +10,182 @@
 #define MAX22    ((uint32_t)4194304L)
 #define MAXGRID4 ((uint16_t)32400)
 
-// TODO: This is wasteful, should figure out something more elegant
-const char A0[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ+-./?";
-const char A1[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-const char A2[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-const char A3[] = "0123456789";
-const char A4[] = " ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-
-// Pack a special token, a 22-bit hash code, or a valid base call
-// into a 28-bit integer.
-int32_t pack28(const char* callsign)
+#define MAX_WORDS 5  // words in the longest structured message (DXpedition mode)
+#define WORD_SIZE 19 // 18 characters (telemetry, the longest word) and the terminating zero
+
+#define DIGITS_FROM(n)                                                                                     \
+    ['0'] = (n), ['1'] = (n) + 1, ['2'] = (n) + 2, ['3'] = (n) + 3, ['4'] = (n) + 4, ['5'] = (n) + 5,      \
+    ['6'] = (n) + 6, ['7'] = (n) + 7, ['8'] = (n) + 8, ['9'] = (n) + 9
+#define LETTERS_FROM(n)                                                                                    \
+    ['A'] = (n), ['B'] = (n) + 1, ['C'] = (n) + 2, ['D'] = (n) + 3, ['E'] = (n) + 4, ['F'] = (n) + 5,      \
+    ['G'] = (n) + 6, ['H'] = (n) + 7, ['I'] = (n) + 8, ['J'] = (n) + 9, ['K'] = (n) + 10, ['L'] = (n) + 11, \
+    ['M'] = (n) + 12, ['N'] = (n) + 13, ['O'] = (n) + 14, ['P'] = (n) + 15, ['Q'] = (n) + 16,              \
+    ['R'] = (n) + 17, ['S'] = (n) + 18, ['T'] = (n) + 19, ['U'] = (n) + 20, ['V'] = (n) + 21,              \
+    ['W'] = (n) + 22, ['X'] = (n) + 23, ['Y'] = (n) + 24, ['Z'] = (n) + 25
+
+// Character -> 1 + its index in each packing alphabet, 0 if it isn't in it, so that every
+// character is packed with a single table read instead of a scan of the alphabet string
+static const uint8_t kA0[256] = { [' '] = 1, DIGITS_FROM(2), LETTERS_FROM(12), ['+'] = 38, ['-'] = 39, ['.'] = 40, ['/'] = 41, ['?'] = 42 }; // " 0-9A-Z+-./?"
+static const uint8_t kA1[256] = { [' '] = 1, DIGITS_FROM(2), LETTERS_FROM(12) };                                                            // " 0-9A-Z"
+static const uint8_t kA2[256] = { DIGITS_FROM(1), LETTERS_FROM(11) };                                                                       // "0-9A-Z"
+static const uint8_t kA3[256] = { DIGITS_FROM(1) };                                                                                         // "0-9"
+static const uint8_t kA4[256] = { [' '] = 1, LETTERS_FROM(2) };                                                                             // " A-Z"
+static const uint8_t kA5[256] = { [' '] = 1, DIGITS_FROM(2), LETTERS_FROM(12), ['/'] = 38 };                                                // " 0-9A-Z/", hashes and nonstandard calls
+
+// Index of c in an alphabet, or -1
+static inline int nchar(const uint8_t* alphabet, char c)
 {
-    // Check for special tokens first
-    if (starts_with(callsign, "DE "))
-        return 0;
-    if (starts_with(callsign, "QRZ "))
-        return 1;
-    if (starts_with(callsign, "CQ "))
-        return 2;
+    return (int)alphabet[(uint8_t)c] - 1;
+}
 
-    if (starts_with(callsign, "CQ_"))
+// Recently packed nonstandard and hashed callsigns, newest overwriting the oldest
+#define NUM_HASH_CALLS 16
+static struct
+{
+    uint32_t n22;
+    char callsign[12];
+} hash_calls[NUM_HASH_CALLS];
+static int hash_calls_next = 0;
+
+// Compute the m-bit hash of a callsign (WSJT-X ihashcall)
+// Returns -1 if the callsign is longer than 11 characters or has characters outside " 0-9A-Z/"
+static int32_t hash_call(const char* callsign, int m)
+{
+    uint64_t n8 = 0;
+    int length = strlen(callsign);
+    if (length > 11)
+        return -1;
+    for (int i = 0; i < 11; ++i)
     {
-        // int nnum = 0, nlet = 0;
+        int j = (i < length) ? nchar(kA5, callsign[i]) : 0; // left-justified, padded with spaces
+        if (j < 0)
+            return -1;
+        n8 = 38 * n8 + j;
+    }
+    return (int32_t)((47055833459ull * n8) >> (64 - m));
+}
 
-        // TODO:
+// Remember a callsign so that its hash can be looked up later
+static void save_hash_call(const char* callsign)
+{
+    int32_t n22 = hash_call(callsign, 22);
+    if (n22 < 0)
+        return;
+    for (int i = 0; i < NUM_HASH_CALLS; ++i)
+    {
+        if (hash_calls[i].callsign[0] != 0 && hash_calls[i].n22 == (uint32_t)n22 && equals(hash_calls[i].callsign, callsign))
+            return;
     }
+    hash_calls[hash_calls_next].n22 = n22;
+    strncpy(hash_calls[hash_calls_next].callsign, callsign, sizeof(hash_calls[0].callsign) - 1);
+    hash_calls_next = (hash_calls_next + 1) % NUM_HASH_CALLS;
+}
 
-    // TODO: Check for <...> callsign
+bool ftx_lookup_hash_call(uint32_t hash, int bits, char* callsign)
+{
+    if (bits != 10 && bits != 12 && bits != 22)
+        return false;
+    for (int n = 1; n <= NUM_HASH_CALLS; ++n)
+    {
+        int i = (hash_calls_next + NUM_HASH_CALLS - n) % NUM_HASH_CALLS; // newest first
+        if (hash_calls[i].callsign[0] != 0 && (hash_calls[i].n22 >> (22 - bits)) == hash)
+        {
+            strcpy(callsign, hash_calls[i].callsign);
+            return true;
+        }
+    }
+    return false;
+}
 
-    char c6[6] = { ' ', ' ', ' ', ' ', ' ', ' ' };
+// Write the low num_bits of value into b77 at bit *pos (MSB first), and advance *pos
+static void put_bits(uint8_t* b77, int* pos, uint64_t value, int num_bits)
+{
+    for (int i = num_bits - 1; i >= 0; --i, ++*pos)
+    {
+        if ((value >> i) & 1u)
+            b77[*pos / 8] |= (uint8_t)(0x80u >> (*pos % 8));
+    }
+}
+
+static bool ends_with(const char* string, const char* suffix)
+{
+    int length = strlen(string);
+    int suffix_length = strlen(suffix);
+    return length >= suffix_length && equals(string + length - suffix_length, suffix);
+}
 
-    int length = 0; // strlen(callsign);  // We will need it later
-    while (callsign[length] != ' ' && callsign[length] != 0)
+// Copy "<CALL>" without its brackets; returns false if the word isn't bracketed
+static bool unbracket(const char* word, char* callsign)
+{
+    int length = strlen(word);
+    if (length < 3 || word[0] != '<' || word[length - 1] != '>')
+        return false;
+    memcpy(callsign, word + 1, length - 2);
+    callsign[length - 2] = 0;
+    return true;
+}
+
+// Check that a callsign, possibly compound (W6/AB6D, AB6D/7), is plausible (WSJT-X chkcall)
+static bool is_valid_call(const char* callsign)
+{
+    int length = strlen(callsign);
+    if (length < 3 || length > 11)
+        return false;
+    for (int i = 0; i < length; ++i)
     {
-        length++;
+        if (nchar(kA5, callsign[i]) <= 0)
+            return false;
     }
 
+    // The base call is the longer part of a compound call
+    const char* base = callsign;
+    int base_length = length;
+    const char* slash = strchr(callsign, '/');
+    if (slash != NULL)
+    {
+        int i0 = slash - callsign;
+        if (i0 < 1 || i0 > length - 2 || strchr(slash + 1, '/') != NULL)
+            return false;
+        if (i0 <= length / 2)
+        {
+            base = slash + 1;
+            base_length = length - i0 - 1;
+        }
+        else
+        {
+            base_length = i0;
+        }
+    }
+    if (base_length < 3 || base_length > 6)
+        return false;
+
+    // One of the first two characters is a letter, it doesn't start with Q,
+    // a digit in 2nd or 3rd position, then a suffix of 1-3 letters
+    if (!is_letter(base[0]) && !is_letter(base[1]))
+        return false;
+    if (base[0] == 'Q')
+        return false;
+    int i1 = is_digit(base[2]) ? 3 : (is_digit(base[1]) ? 2 : 0);
+    if (i1 == 0 || base_length - i1 < 1 || base_length - i1 > 3)
+        return false;
+    for (int i = i1; i < base_length; ++i)
+    {
+        if (!is_letter(base[i]))
+            return false;
+    }
+    return true;
+}
+
+// Pack a standard base callsign into its 28-bit value, without the token and hash offsets.
+// Returns -1 if the callsign doesn't fit the standard layout.
+static int32_t pack_basecall(const char* callsign)
+{
+    int length = strlen(callsign);
+    if (length < 3 || length > 7)
+        return -1;
+
+    char c6[6] = { ' ', ' ', ' ', ' ', ' ', ' ' };
+
     // Copy callsign to 6 character buffer
     if (starts_with(callsign, "3DA0") && length <= 7)
     {
@@ -59,43 +199,87 @@ int32_t pack28(const char* callsign)
         memcpy(c6, "Q", 1);
         memcpy(c6 + 1, callsign + 2, length - 2);
     }
+    else if (is_digit(callsign[2]) && length <= 6)
+    {
+        // AB0XYZ
+        memcpy(c6, callsign, length);
+    }
+    else if (is_digit(callsign[1]) && length <= 5)
+    {
+        // A0XYZ -> " A0XYZ"
+        memcpy(c6 + 1, callsign, length);
+    }
     else
     {
-        if (is_digit(callsign[2]) && length <= 6)
-        {
-            // AB0XYZ
-            memcpy(c6, callsign, length);
-        }
-        else if (is_digit(callsign[1]) && length <= 5)
-        {
-            // A0XYZ -> " A0XYZ"
-            memcpy(c6 + 1, callsign, length);
-        }
+        return -1;
     }
 
     // Check for standard callsign
     int i0, i1, i2, i3, i4, i5;
-    if ((i0 = char_index(A1, c6[0])) >= 0 && (i1 = char_index(A2, c6[1])) >= 0 && (i2 = char_index(A3, c6[2])) >= 0 && (i3 = char_index(A4, c6[3])) >= 0 && (i4 = char_index(A4, c6[4])) >= 0 && (i5 = char_index(A4, c6[5])) >= 0)
+    if ((i0 = nchar(kA1, c6[0])) < 0 || (i1 = nchar(kA2, c6[1])) < 0 || (i2 = nchar(kA3, c6[2])) < 0 ||
+        (i3 = nchar(kA4, c6[3])) < 0 || (i4 = nchar(kA4, c6[4])) < 0 || (i5 = nchar(kA4, c6[5])) < 0)
+    {
+        return -1;
+    }
+
+    int32_t n28 = i0;
+    n28 = n28 * 36 + i1;
+    n28 = n28 * 10 + i2;
+    n28 = n28 * 27 + i3;
+    n28 = n28 * 27 + i4;
+    n28 = n28 * 27 + i5;
+    return n28;
+}
+
+// Pack a special token, a 22-bit hash code of a <bracketed> call, or a valid base call
+// into a 28-bit integer. Returns -1 if the word is none of these.
+static int32_t pack28(const char* word)
+{
+    // Check for special tokens first
+    if (equals(word, "DE"))
+        return 0;
+    if (equals(word, "QRZ"))
+        return 1;
+    if (equals(word, "CQ"))
+        return 2;
+
+    if (starts_with(word, "CQ_"))
     {
-        // This is a standard callsign
-        int32_t n28 = i0;
-        n28 = n28 * 36 + i1;
-        n28 = n28 * 10 + i2;
-        n28 = n28 * 27 + i3;
-        n28 = n28 * 27 + i4;
-        n28 = n28 * 27 + i5;
-        return NTOKENS + MAX22 + n28;
+        // CQ_nnn (a frequency) or CQ_a .. CQ_abcd (a directed CQ)
+        const char* arg = word + 3;
+        int length = strlen(arg);
+        if (length == 3 && is_digit(arg[0]) && is_digit(arg[1]) && is_digit(arg[2]))
+            return 3 + (arg[0] - '0') * 100 + (arg[1] - '0') * 10 + (arg[2] - '0');
+        if (length < 1 || length > 4)
+            return -1;
+        int32_t m = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            int j = (i < 4 - length) ? 0 : nchar(kA4, arg[i - (4 - length)]); // right-justified
+            if (j <= 0 && i >= 4 - length)
+                return -1;
+            m = 27 * m + j;
+        }
+        return 3 + 1000 + m;
     }
 
-    // char text[13];
-    // if (length > 13) return -1;
+    char callsign[WORD_SIZE];
+    if (unbracket(word, callsign))
+    {
+        int32_t n22 = hash_call(callsign, 22);
+        if (n22 < 0)
+            return -1;
+        save_hash_call(callsign);
+        return NTOKENS + n22;
+    }
 
-    // TODO:
-    // Treat this as a nonstandard callsign: compute its 22-bit hash
-    return -1;
+    int32_t n28 = pack_basecall(word);
+    return (n28 < 0) ? -1 : (int32_t)(NTOKENS + MAX22 + n28);
 }
 
-uint16_t packgrid(const char* grid4)
+// Pack a grid, RRR/RR73/73, or a report (+dd, -dd, R+dd, R-dd) into 16 bits: the ir flag and igrid4.
+// Returns -1 if the word is none of these.
+static int32_t packgrid(const char* grid4)
 {
     if (grid4 == 0)
     {
@@ -112,7 +296,7 @@ uint16_t packgrid(const char* grid4)
         return MAXGRID4 + 4;
 
     // Check for standard 4 letter grid
-    if (in_range(grid4[0], 'A', 'R') && in_range(grid4[1], 'A', 'R') && is_digit(grid4[2]) && is_digit(grid4[3]))
+    if (strlen(grid4) == 4 && in_range(grid4[0], 'A', 'R') && in_range(grid4[1], 'A', 'R') && is_digit(grid4[2]) && is_digit(grid4[3]))
     {
         uint16_t igrid4 = (grid4[0] - 'A');
         igrid4 = igrid4 * 18 + (grid4[1] - 'A');
@@ -121,75 +305,303 @@ uint16_t packgrid(const char* grid4)
         return igrid4;
     }
 
-    // Parse report: +dd / -dd / R+dd / R-dd
-    // TODO: check the range of dd
+    // Parse report: +dd / -dd / R+dd / R-dd, from -50 to +49
+    int32_t ir = 0;
     if (grid4[0] == 'R')
     {
-        int dd = dd_to_int(grid4 + 1, 3);
-        uint16_t irpt = 35 + dd;
-        return (MAXGRID4 + irpt) | 0x8000; // ir = 1
+        ir = 0x8000;
+        ++grid4;
     }
+    if ((grid4[0] != '+' && grid4[0] != '-') || !is_digit(grid4[1]) || !is_digit(grid4[2]) || grid4[3] != 0)
+        return -1;
+    int dd = dd_to_int(grid4, 3);
+    if (dd < -50 || dd > 49)
+        return -1;
+    if (dd <= -31)
+        dd += 101; // -50..-31 go above the -30..+49 range
+    return ir | (MAXGRID4 + 35 + dd);
+}
+
+// Pack Type 1 (Standard 77-bit message) and Type 2 (ditto, with a "/P" call)
+// With hash_nonstandard set, a compound or otherwise nonstandard call is sent as its hash,
+// as if it were <bracketed>: the only way to send it with a report.
+static int pack77_1(int nwords, char words[][WORD_SIZE], bool hash_nonstandard, uint8_t* b77)
+{
+    if (nwords < 2 || nwords > 4 || (nwords == 4 && !equals(words[2], "R")))
+        return -1;
+
+    int32_t n28[2];
+    uint8_t ip[2] = { 0, 0 };
+    bool has_p = false, has_r = false, has_hash = false, has_slash = false;
+    for (int k = 0; k < 2; ++k)
+    {
+        char callsign[WORD_SIZE];
+        strcpy(callsign, words[k]);
+        has_hash |= (callsign[0] == '<');
+
+        // A /R or /P suffix on a standard call is carried in the ipa/ipb bit
+        if (callsign[0] != '<' && (ends_with(callsign, "/R") || ends_with(callsign, "/P")) && strlen(callsign) >= 6)
+        {
+            int length = strlen(callsign);
+            has_p |= (callsign[length - 1] == 'P');
+            has_r |= (callsign[length - 1] == 'R');
+            callsign[length - 2] = 0;
+            ip[k] = 1;
+        }
+
+        n28[k] = pack28(callsign);
+        if (n28[k] < 0 && hash_nonstandard && is_valid_call(words[k]))
+        {
+            char bracketed[WORD_SIZE + 2];
+            snprintf(bracketed, sizeof(bracketed), "<%s>", words[k]);
+            n28[k] = pack28(bracketed);
+            ip[k] = 0;
+            has_hash = true;
+        }
+        else if (callsign[0] != '<')
+        {
+            has_slash |= (strchr(callsign, '/') != NULL) || ip[k];
+        }
+        if (n28[k] < 0)
+            return -1;
+    }
+
+    // Only the first word may be a token; /R and /P don't mix; a hashed call goes with a plain one
+    // (a hash is only known to stations that heard the full call, so CQ with one is useless)
+    if (n28[1] < (int32_t)NTOKENS || (has_p && has_r) || (has_hash && (has_slash || n28[0] < (int32_t)NTOKENS)))
+        return -1;
+    if (n28[0] >= (int32_t)NTOKENS && n28[0] < (int32_t)(NTOKENS + MAX22) && n28[1] < (int32_t)(NTOKENS + MAX22))
+        return -1; // two hashed calls
+
+    int32_t igrid4;
+    if (nwords == 2)
+        igrid4 = packgrid(0);
     else
+        igrid4 = packgrid(words[nwords - 1]);
+    if (igrid4 < 0)
+        return -1;
+    if (nwords == 4)
     {
-        int dd = dd_to_int(grid4, 3);
-        uint16_t irpt = 35 + dd;
-        return (MAXGRID4 + irpt); // ir = 0
+        // "R" followed by a grid
+        if ((igrid4 & 0x8000) || (igrid4 & 0x7FFF) >= MAXGRID4)
+            return -1;
+        igrid4 |= 0x8000;
     }
 
-    return MAXGRID4 + 1;
+    uint8_t i3 = has_p ? 2 : 1; // Type 2 with "/P", otherwise Type 1 (no suffix or /R)
+
+    // Pack into (28 + 1) + (28 + 1) + (1 + 15) + 3 bits
+    int pos = 0;
+    memset(b77, 0, 10);
+    put_bits(b77, &pos, n28[0], 28);
+    put_bits(b77, &pos, ip[0], 1);
+    put_bits(b77, &pos, n28[1], 28);
+    put_bits(b77, &pos, ip[1], 1);
+    put_bits(b77, &pos, igrid4, 16);
+    put_bits(b77, &pos, i3, 3);
+    return 0;
 }
 
-// Pack Type 1 (Standard 77-bit message) and Type 2 (ditto, with a "/P" call)
-int pack77_1(const char* msg, uint8_t* b77)
+// Pack Type 4: one nonstandard call in full and one hashed call, or CQ and a nonstandard call.
+// If neither call is <bracketed>, the standard one is hashed.
+static int pack77_4(int nwords, char words[][WORD_SIZE], uint8_t* b77)
 {
-    // Locate the first delimiter
-    const char* s1 = strchr(msg, ' ');
-    if (s1 == 0)
+    if (nwords != 2 && nwords != 3)
         return -1;
 
-    const char* call1 = msg;    // 1st call
-    const char* call2 = s1 + 1; // 2nd call
+    uint8_t nrpt = 0;
+    if (nwords == 3)
+    {
+        if (equals(words[2], "RRR"))
+            nrpt = 1;
+        else if (equals(words[2], "RR73"))
+            nrpt = 2;
+        else if (equals(words[2], "73"))
+            nrpt = 3;
+        else
+            return -1;
+    }
 
-    int32_t n28a = pack28(call1);
-    int32_t n28b = pack28(call2);
+    uint8_t icq = equals(words[0], "CQ");
+    uint8_t iflip = 0;
+    int32_t n12 = 0;
+    const char* full_call;
+    char hashed[2][WORD_SIZE];
+    bool is_hashed[2];
+    for (int k = 0; k < 2; ++k)
+        is_hashed[k] = unbracket(words[k], hashed[k]);
 
-    if (n28a < 0 || n28b < 0)
-        return -1;
+    if (icq)
+    {
+        if (nwords == 3 || is_hashed[1])
+            return -1;
+        full_call = words[1];
+    }
+    else
+    {
+        if (is_hashed[0] && is_hashed[1])
+            return -1;
+        if (!is_hashed[0] && !is_hashed[1])
+        {
+            // Hash the call that has a standard form, and send the other in full
+            bool standard0 = pack_basecall(words[0]) >= 0;
+            bool standard1 = pack_basecall(words[1]) >= 0;
+            if (standard0 == standard1)
+                return -1;
+            strcpy(hashed[standard0 ? 0 : 1], words[standard0 ? 0 : 1]);
+            is_hashed[standard0 ? 0 : 1] = true;
+        }
+        iflip = is_hashed[1];
+        full_call = words[iflip ? 0 : 1];
+        n12 = hash_call(hashed[iflip], 12);
+        if (n12 < 0)
+            return -1;
+        save_hash_call(hashed[iflip]);
+    }
 
-    uint16_t igrid4;
+    if (!is_valid_call(full_call))
+        return -1;
+    save_hash_call(full_call);
 
-    // Locate the second delimiter
-    const char* s2 = strchr(s1 + 1, ' ');
-    if (s2 != 0)
+    // The full call, right-justified in 11 characters, as a base-38 number
+    int length = strlen(full_call);
+    uint64_t n58 = 0;
+    for (int i = 0; i < 11; ++i)
     {
-        igrid4 = packgrid(s2 + 1);
+        int j = (i < 11 - length) ? 0 : nchar(kA5, full_call[i - (11 - length)]);
+        n58 = n58 * 38 + j;
     }
-    else
+
+    int pos = 0;
+    memset(b77, 0, 10);
+    put_bits(b77, &pos, n12, 12);
+    put_bits(b77, &pos, n58, 58);
+    put_bits(b77, &pos, iflip, 1);
+    put_bits(b77, &pos, nrpt, 2);
+    put_bits(b77, &pos, icq, 1);
+    put_bits(b77, &pos, 4, 3); // i3 = 4
+    return 0;
+}
+
+// Pack Type 5: EU VHF contest, two hashed calls, report and serial number, and a 6 character grid,
+// e.g. "<PA3XYZ> <G4ABC/P> R 590003 IO91NP"
+static int pack77_5(int nwords, char words[][WORD_SIZE], uint8_t* b77)
+{
+    if (nwords != 4 && nwords != 5)
+        return -1;
+    if (nwords == 5 && !equals(words[2], "R"))
+        return -1;
+
+    char call1[WORD_SIZE], call2[WORD_SIZE];
+    if (!unbracket(words[0], call1) || !unbracket(words[1], call2))
+        return -1;
+
+    const char* rs = words[nwords - 2]; // report and serial: 52..59 and 0001..2047
+    const char* grid6 = words[nwords - 1];
+    if (strlen(rs) != 6 || rs[0] != '5' || !in_range(rs[1], '2', '9'))
+        return -1;
+    for (int i = 2; i < 6; ++i)
     {
-        // Two callsigns, no grid/report
-        igrid4 = packgrid(0);
+        if (!is_digit(rs[i]))
+            return -1;
     }
+    int serial = (rs[2] - '0') * 1000 + (rs[3] - '0') * 100 + (rs[4] - '0') * 10 + (rs[5] - '0');
+    if (serial > 2047)
+        return -1;
+    if (strlen(grid6) != 6 || !in_range(grid6[0], 'A', 'R') || !in_range(grid6[1], 'A', 'R') || !is_digit(grid6[2]) ||
+        !is_digit(grid6[3]) || !in_range(grid6[4], 'A', 'X') || !in_range(grid6[5], 'A', 'X'))
+        return -1;
 
-    uint8_t i3 = 1; // No suffix or /R
+    int32_t n12 = hash_call(call1, 12);
+    int32_t n22 = hash_call(call2, 22);
+    if (n12 < 0 || n22 < 0)
+        return -1;
+    save_hash_call(call1);
+    save_hash_call(call2);
+
+    uint32_t igrid6 = grid6[0] - 'A';
+    igrid6 = igrid6 * 18 + (grid6[1] - 'A');
+    igrid6 = igrid6 * 10 + (grid6[2] - '0');
+    igrid6 = igrid6 * 10 + (grid6[3] - '0');
+    igrid6 = igrid6 * 24 + (grid6[4] - 'A');
+    igrid6 = igrid6 * 24 + (grid6[5] - 'A');
+
+    int pos = 0;
+    memset(b77, 0, 10);
+    put_bits(b77, &pos, n12, 12);
+    put_bits(b77, &pos, n22, 22);
+    put_bits(b77, &pos, nwords == 5, 1);
+    put_bits(b77, &pos, rs[1] - '2', 3);
+    put_bits(b77, &pos, serial, 11);
+    put_bits(b77, &pos, igrid6, 25);
+    put_bits(b77, &pos, 5, 3); // i3 = 5
+    return 0;
+}
 
-    // TODO: check for suffixes
+// Pack Type 0.1: DXpedition mode, e.g. "K1ABC RR73; W9XYZ <KH1/KH7Z> -12"
+static int pack77_01(int nwords, char words[][WORD_SIZE], uint8_t* b77)
+{
+    if (nwords != 5 || !equals(words[1], "RR73;"))
+        return -1;
 
-    // Shift in ipa and ipb bits into n28a and n28b
-    n28a <<= 1; // ipa = 0
-    n28b <<= 1; // ipb = 0
+    char dx_call[WORD_SIZE];
+    int32_t n28a = pack_basecall(words[0]);
+    int32_t n28b = pack_basecall(words[2]);
+    if (n28a < 0 || n28b < 0 || !unbracket(words[3], dx_call))
+        return -1;
+    int32_t n10 = hash_call(dx_call, 10);
+    if (n10 < 0)
+        return -1;
 
-    // Pack into (28 + 1) + (28 + 1) + (1 + 15) + 3 bits
-    b77[0] = (n28a >> 21);
-    b77[1] = (n28a >> 13);
-    b77[2] = (n28a >> 5);
-    b77[3] = (uint8_t)(n28a << 3) | (uint8_t)(n28b >> 26);
-    b77[4] = (n28b >> 18);
-    b77[5] = (n28b >> 10);
-    b77[6] = (n28b >> 2);
-    b77[7] = (uint8_t)(n28b << 6) | (uint8_t)(igrid4 >> 10);
-    b77[8] = (igrid4 >> 2);
-    b77[9] = (uint8_t)(igrid4 << 6) | (uint8_t)(i3 << 3);
+    // Report -30..+32 in steps of 2
+    const char* report = words[4];
+    if ((report[0] != '+' && report[0] != '-') || !is_digit(report[1]) || !is_digit(report[2]) || report[3] != 0)
+        return -1;
+    int dd = dd_to_int(report, 3);
+    if (dd < -30 || dd > 32)
+        return -1;
+    save_hash_call(dx_call);
+
+    int pos = 0;
+    memset(b77, 0, 10);
+    put_bits(b77, &pos, NTOKENS + MAX22 + n28a, 28);
+    put_bits(b77, &pos, NTOKENS + MAX22 + n28b, 28);
+    put_bits(b77, &pos, n10, 10);
+    put_bits(b77, &pos, (dd + 30) / 2, 5);
+    put_bits(b77, &pos, 1, 3); // n3 = 1
+    put_bits(b77, &pos, 0, 3); // i3 = 0
+    return 0;
+}
+
+// Pack Type 0.5: telemetry, up to 18 hex digits (71 bits). Decoders show it without leading zeros,
+// so a word with a leading zero is left to free text, which keeps it as typed.
+static int pack77_05(int nwords, char words[][WORD_SIZE], uint8_t* b77)
+{
+    if (nwords != 1)
+        return -1;
+    const char* hex = words[0];
+    int length = strlen(hex);
+    if (length < 1 || length > 18 || (length == 18 && hex[0] > '7') || (length > 1 && hex[0] == '0'))
+        return -1;
 
+    // Right-justified in 71 bits, as 23 + 24 + 24 bits
+    uint32_t ntel[3] = { 0, 0, 0 };
+    for (int i = 0; i < 18; ++i)
+    {
+        char c = (i < 18 - length) ? '0' : hex[i - (18 - length)];
+        int digit = is_digit(c) ? c - '0' : (in_range(c, 'A', 'F') ? c - 'A' + 10 : -1);
+        if (digit < 0)
+            return -1;
+        ntel[i / 6] = (ntel[i / 6] << 4) | digit;
+    }
+
+    int pos = 0;
+    memset(b77, 0, 10);
+    put_bits(b77, &pos, ntel[0], 23);
+    put_bits(b77, &pos, ntel[1], 24);
+    put_bits(b77, &pos, ntel[2], 24);
+    put_bits(b77, &pos, 5, 3); // n3 = 5
+    put_bits(b77, &pos, 0, 3); // i3 = 0
     return 0;
 }
 
@@ -230,7 +642,7 @@ void packtext77(const char* text, uint8_t* b77)
         // Get the index of the current char
         if (j < length)
         {
-            int q = char_index(A0, text[j]);
+            int q = nchar(kA0, text[j]);
             x = (q > 0) ? q : 0;
         }
         else
@@ -257,21 +669,83 @@ void packtext77(const char* text, uint8_t* b77)
     b77[9] &= 0x00;
 }
 
-int pack77(const char* msg, uint8_t* c77)
+// Split a message into words, joining "CQ DX", "CQ POTA" or "CQ 290" into one "CQ_" token.
+// Returns the number of words, or -1 if the message has too many words or a word is too long.
+static int split_words(const char* msg, char words[][WORD_SIZE])
 {
-    // Check Type 1 (Standard 77-bit message) or Type 2, with optional "/P"
-    if (0 == pack77_1(msg, c77))
+    int nwords = 0;
+    while (*msg)
     {
-        return 0;
+        while (*msg == ' ')
+            ++msg;
+        if (*msg == 0)
+            break;
+        int length = strcspn(msg, " ");
+        if (nwords == MAX_WORDS || length >= WORD_SIZE)
+            return -1;
+        memcpy(words[nwords], msg, length);
+        words[nwords][length] = 0;
+        ++nwords;
+        msg += length;
     }
 
-    // TODO:
-    // Check 0.5 (telemetry)
+    if (nwords >= 3 && equals(words[0], "CQ"))
+    {
+        const char* arg = words[1];
+        int length = strlen(arg);
+        bool letters = length >= 1 && length <= 4;
+        for (int i = 0; i < length; ++i)
+            letters &= (arg[i] >= 'A' && arg[i] <= 'Z');
+        bool digits = length == 3 && is_digit(arg[0]) && is_digit(arg[1]) && is_digit(arg[2]);
+        if (letters || digits)
+        {
+            char token[WORD_SIZE];
+            snprintf(token, sizeof(token), "CQ_%s", arg);
+            strcpy(words[0], token);
+            for (int i = 1; i < nwords - 1; ++i)
+                strcpy(words[i], words[i + 1]);
+            --nwords;
+        }
+    }
+    return nwords;
+}
+
+int pack77(const char* msg, uint8_t* c77)
+{
+    char words[MAX_WORDS][WORD_SIZE];
+    int nwords = split_words(msg, words);
+    if (nwords > 0)
+    {
+        // Check 0.5 (telemetry) and 0.1 (DXpedition mode)
+        if (0 == pack77_05(nwords, words, c77) || 0 == pack77_01(nwords, words, c77))
+            return 0;
+
+        // Check Type 1 (Standard 77-bit message) or Type 2, with optional "/P"
+        if (0 == pack77_1(nwords, words, false, c77))
+            return 0;
 
-    // Check Type 4 (One nonstandard call and one hashed call)
+        // Check Type 4 (One nonstandard call and one hashed call) and Type 5 (EU VHF contest)
+        if (0 == pack77_4(nwords, words, c77) || 0 == pack77_5(nwords, words, c77))
+            return 0;
 
-    // Default to free text
+        // A nonstandard call with a report: Type 1 with the call hashed
+        if (0 == pack77_1(nwords, words, true, c77))
+            return 0;
+    }
+
+    // Default to free text, up to 13 characters
     // i3=0 n3=0
-    packtext77(msg, c77);
+    const char* text = msg;
+    int length = strlen(text);
+    while (*text == ' ')
+    {
+        ++text;
+        --length;
+    }
+    while (length > 0 && text[length - 1] == ' ')
+        --length;
+    if (length > 13)
+        return -1;
+    packtext77(text, c77);
     return 0;
 }
@@ -1,6 +1,7 @@
 #ifndef _INCLUDE_PACK_H_
 #define _INCLUDE_PACK_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -8,11 +9,24 @@ extern "C"
 {
 #endif
 
-    // Pack FT8 text message into 72 bits
+#define FTX_MESSAGE_MAX 37 // longest message pack77 takes: Type 4 "<PJ4/K1ABC> PJ4/KA1ABCD RR73" and the like
+
+    // Pack FT8/FT4 text message into 77 bits: standard (Type 1), /P (Type 2), nonstandard and
+    // hashed calls (Type 4, or Type 1 with a hash), EU VHF (Type 5), DXpedition (0.1),
+    // telemetry (0.5) and free text (0.0, up to 13 characters).
+    // Not thread-safe: it keeps the table of recent calls used by ftx_lookup_hash_call().
     // [IN] msg      - FT8 message (e.g. "CQ TE5T KN01")
     // [OUT] c77     - 10 byte array to store the 77 bit payload (MSB first)
+    // Returns 0 on success, -1 if the message can't be packed
     int pack77(const char* msg, uint8_t* c77);
 
+    // Find a recently packed callsign by its hash
+    // [IN] hash     - hash value from a message
+    // [IN] bits     - width of the hash: 10, 12 or 22
+    // [OUT] callsign - receives the callsign, up to 11 characters
+    // Returns true if a callsign with that hash was packed since boot (among the last 16)
+    bool ftx_lookup_hash_call(uint32_t hash, int bits, char* callsign);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "wspr.h"
+
+// Checks wspr_encode() against the reference channel symbols and the messages it must refuse.
+// Usage: test_wspr
+
+// Channel symbols WSJT-X's wsprcode gives for its example message; the source encoding is
+// F7 0C 23 8B 0D 19 40 (28 bits of callsign, 22 of locator and power)
+static const char* kReferenceMessage = "K1ABC FN42 37";
+static const char* kReferenceTones =
+    "330020001020131222100323133220200032012322002232110233210221321222033030301210212032132003323032203020201023021112330231212221332000010320132222202332323320031222";
+
+// Spellings that must encode the same as the reference
+static const char* kEquivalent[] = {
+    "k1abc fn42 37",
+    "  K1ABC   FN42 37  ",
+};
+
+#define NUM_EQUIVALENT (int)(sizeof(kEquivalent) / sizeof(kEquivalent[0]))
+
+static const char* kRefused[] = {
+    "",
+    "K1ABC FN42",        // no power
+    "K1ABC FN42 37 X",   // extra field
+    "K1ABC FN42 38",     // power must end in 0, 3 or 7
+    "K1ABC FN42 63",     // over 60 dBm
+    "K1ABC FN42 -3",     // negative power
+    "K1ABC SN42 37",     // field letters run A..R
+    "K1ABC FN4 37",      // locator of 4 characters only
+    "K1ABC FN42AA 37",   // 6-character locators need a type 2/3 message
+    "KK1ABCD FN42 37",   // callsign over 6 characters
+    "KABC FN42 37",      // no digit in the callsign
+    "K1AB2 FN42 37",     // only letters follow the digit
+    "W6/AB6D FN42 37",   // compound callsigns need a type 2 message
+};
+
+#define NUM_REFUSED (int)(sizeof(kRefused) / sizeof(kRefused[0]))
+
+static int check_tones(const char* message, const char* expected)
+{
+    uint8_t tones[WSPR_NN];
+    if (wspr_encode(message, tones) != 0)
+    {
+        printf("FAIL wspr_encode '%s' refused\n", message);
+        return 1;
+    }
+    for (int i = 0; i < WSPR_NN; ++i)
+    {
+        if (tones[i] != expected[i] - '0')
+        {
+            printf("FAIL wspr_encode '%s': symbol %d is %d, expected %c\n", message, i, tones[i], expected[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+    if (strlen(kReferenceTones) != WSPR_NN)
+    {
+        printf("FAIL reference has %d symbols\n", (int)strlen(kReferenceTones));
+        return 1;
+    }
+
+    failures += check_tones(kReferenceMessage, kReferenceTones);
+    for (int m = 0; m < NUM_EQUIVALENT; ++m)
+        failures += check_tones(kEquivalent[m], kReferenceTones);
+
+    for (int m = 0; m < NUM_REFUSED; ++m)
+    {
+        uint8_t tones[WSPR_NN];
+        if (wspr_encode(kRefused[m], tones) >= 0)
+        {
+            printf("FAIL wspr_encode '%s' should be refused\n", kRefused[m]);
+            ++failures;
+        }
+    }
+
+    if (failures)
+    {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("reference symbols and refused messages passed\n");
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include "wspr.h"
+
+#include <string.h>
+
+// Convolutional code: constraint length 32, rate 1/2
+#define WSPR_POLY_1 0xF2D05351u
+#define WSPR_POLY_2 0xE4613C47u
+
+// Pseudo-random sync vector, one bit per channel symbol
+static const uint8_t kWSPR_Sync[WSPR_NN] = {
+    1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 0,
+    0, 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1,
+    0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 0, 1,
+    1, 0, 1, 0, 0, 0, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 1,
+    0, 0, 1, 0, 1, 1, 0, 0, 0, 1, 1, 0, 1, 0, 1, 0, 0, 0, 1, 0,
+    0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 1, 1, 0, 1, 1, 0, 0, 1, 1,
+    0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 1,
+    0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 0, 1, 1, 0, 0, 0, 1, 1, 0,
+    0, 0
+};
+
+// Returns 1 if an odd number of bits are set in x, zero otherwise
+static uint8_t parity32(uint32_t x)
+{
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+    return x & 1;
+}
+
+// Callsign character code: '0'..'9' -> 0..9, 'A'..'Z' -> 10..35, ' ' -> 36; -1 if not allowed
+static int wspr_char_code(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'Z')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'z')
+        return c - 'a' + 10;
+    if (c == ' ')
+        return 36;
+    return -1;
+}
+
+static int is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static char to_upper(char c)
+{
+    return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+}
+
+// Pack a callsign into 28 bits. The third character must be a digit, so a callsign
+// with a one-letter prefix ("K1ABC") is aligned with a leading space.
+static int pack_call(const char* call, int length, uint32_t* n)
+{
+    char padded[6];
+    memset(padded, ' ', sizeof(padded));
+
+    int offset = (length >= 2 && is_digit(call[1]) && !(length >= 3 && is_digit(call[2]))) ? 1 : 0;
+    if (length < 3 || length + offset > 6)
+        return -1;
+    memcpy(padded + offset, call, length);
+    if (!is_digit(padded[2]))
+        return -1;
+
+    int c[6];
+    for (int i = 0; i < 6; ++i)
+    {
+        c[i] = wspr_char_code(padded[i]);
+        if (c[i] < 0)
+            return -1;
+    }
+    // Only letters or a space may follow the digit
+    for (int i = 3; i < 6; ++i)
+    {
+        if (c[i] < 10)
+            return -1;
+    }
+    if (c[1] == 36)
+        return -1;
+
+    uint32_t value = c[0];
+    value = value * 36 + c[1];
+    value = value * 10 + c[2];
+    value = value * 27 + (c[3] - 10);
+    value = value * 27 + (c[4] - 10);
+    value = value * 27 + (c[5] - 10);
+    *n = value;
+    return 0;
+}
+
+// Pack a 4-character locator and the power into 22 bits
+static int pack_grid_power(const char* grid, int power, uint32_t* m)
+{
+    char g0 = to_upper(grid[0]);
+    char g1 = to_upper(grid[1]);
+    if (g0 < 'A' || g0 > 'R' || g1 < 'A' || g1 > 'R' || !is_digit(grid[2]) || !is_digit(grid[3]))
+        return -1;
+    if (power < 0 || power > 60)
+        return -1;
+    int last = power % 10;
+    if (last != 0 && last != 3 && last != 7)
+        return -1;
+
+    uint32_t m1 = (179 - 10 * (g0 - 'A') - (grid[2] - '0')) * 180 + 10 * (g1 - 'A') + (grid[3] - '0');
+    *m = m1 * 128 + power + 64;
+    return 0;
+}
+
+int wspr_encode(const char* message, uint8_t* tones)
+{
+    // Split "CALL GRID DBM"
+    const char* fields[3];
+    int lengths[3];
+    int count = 0;
+    const char* p = message;
+    while (*p && count < 4)
+    {
+        while (*p == ' ')
+            ++p;
+        if (!*p)
+            break;
+        if (count == 3)
+            return -1;
+        fields[count] = p;
+        while (*p && *p != ' ')
+            ++p;
+        lengths[count] = (int)(p - fields[count]);
+        ++count;
+    }
+    if (count != 3 || lengths[1] != 4 || lengths[2] < 1 || lengths[2] > 2)
+        return -1;
+
+    char call[6];
+    for (int i = 0; i < lengths[0] && i < 6; ++i)
+        call[i] = to_upper(fields[0][i]);
+
+    int power = 0;
+    for (int i = 0; i < lengths[2]; ++i)
+    {
+        if (!is_digit(fields[2][i]))
+            return -1;
+        power = power * 10 + (fields[2][i] - '0');
+    }
+
+    uint32_t n, m;
+    if (lengths[0] > 6 || pack_call(call, lengths[0], &n) < 0 || pack_grid_power(fields[1], power, &m) < 0)
+        return -2;
+
+    // 28 bits of callsign and 22 bits of locator and power, then 31 zero bits to flush the encoder
+    uint8_t packed[11] = { 0 };
+    packed[0] = (uint8_t)(n >> 20);
+    packed[1] = (uint8_t)(n >> 12);
+    packed[2] = (uint8_t)(n >> 4);
+    packed[3] = (uint8_t)(((n & 0x0f) << 4) | ((m >> 18) & 0x0f));
+    packed[4] = (uint8_t)(m >> 10);
+    packed[5] = (uint8_t)(m >> 2);
+    packed[6] = (uint8_t)((m & 0x03) << 6);
+
+    // Convolutional encoding: 81 bits in, 162 symbols out
+    uint8_t symbols[WSPR_NN];
+    uint32_t reg = 0;
+    int i_sym = 0;
+    for (int i_bit = 0; i_bit < 81; ++i_bit)
+    {
+        reg = (reg << 1) | ((packed[i_bit / 8] >> (7 - i_bit % 8)) & 1);
+        symbols[i_sym++] = parity32(reg & WSPR_POLY_1);
+        symbols[i_sym++] = parity32(reg & WSPR_POLY_2);
+    }
+
+    // Interleave by bit-reversed 8-bit index, and add the sync vector
+    int i_src = 0;
+    for (int i = 0; i < 256 && i_src < WSPR_NN; ++i)
+    {
+        uint8_t j = (uint8_t)i;
+        j = (uint8_t)(((j & 0xf0) >> 4) | ((j & 0x0f) << 4));
+        j = (uint8_t)(((j & 0xcc) >> 2) | ((j & 0x33) << 2));
+        j = (uint8_t)(((j & 0xaa) >> 1) | ((j & 0x55) << 1));
+        if (j < WSPR_NN)
+        {
+            tones[j] = kWSPR_Sync[j] + 2 * symbols[i_src++];
+        }
+    }
+    return 0;
+}
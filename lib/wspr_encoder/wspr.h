@@ -0,0 +1,28 @@
+#ifndef _INCLUDE_WSPR_H_
+#define _INCLUDE_WSPR_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define WSPR_SYMBOL_PERIOD (8192.0f / 12000.0f) ///< WSPR symbol duration (~683 ms), defines tone deviation in Hz and symbol rate
+#define WSPR_SLOT_TIME     (120.0f)             ///< WSPR slot period; transmissions start 1 s into an even minute
+
+#define WSPR_NN            (162) ///< Total channel symbols
+#define WSPR_MESSAGE_MAX   (22)  ///< Longest message text accepted by wspr_encode(), e.g. "AB1CDE FN42 37"
+
+    /// Generate a WSPR (type 1) tone sequence from a message
+    /// @param[in] message - "CALL GRID DBM": a callsign of up to 6 characters, a 4-character Maidenhead
+    ///                      locator, and the power in dBm (0..60, ending in 0, 3 or 7), separated by spaces
+    /// @param[out] tones  - array of WSPR_NN (162) bytes to store the generated tones (encoded as 0..3)
+    /// @return 0 on success, or a negative number if the message can't be parsed
+    int wspr_encode(const char* message, uint8_t* tones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _INCLUDE_WSPR_H_
@@ -218,9 +218,10 @@ def _ensure_pio_python_deps():
     """
     Ensure required Python packages are installed in the PlatformIO Python environment.
     Some packages like 'intelhex' (required by esptool) might be missing in some
-    installations or after updates.
+    installations or after updates. 'brotli' lets build_web_assets.py add Brotli
+    variants of the web assets (without it they are served gzip-only).
     """
-    required = ["intelhex"]
+    required = ["intelhex", "brotli"]
     missing = []
 
     for pkg in required:
@@ -390,44 +391,21 @@ def _write_manifest_file():
     log_message(f"Wrote webtools manifest: {manifest_abs}")
 
 
-# Conditionally compress web assets: only regenerate .htmlgz/.jsgz/.cssgz files
-# when their source is newer, avoiding unnecessary recompilation of embedded .S files.
-def _compress_web_assets():
-    import gzip as _gzip
-
-    web_dir = os.path.join(env.subst("$PROJECT_DIR"), "src", "web")
-    extensions = (".html", ".js", ".css")
-    compressed_count = 0
-    skipped_count = 0
-
-    for ext in extensions:
-        for src_path in glob.glob(os.path.join(web_dir, f"*{ext}")):
-            # Derive output: index.html → index.htmlgz
-            base = os.path.basename(src_path)
-            gz_name = base + "gz"  # .html → .htmlgz, .js → .jsgz, .css → .cssgz
-            gz_path = os.path.join(web_dir, gz_name)
-
-            # Skip if compressed file exists and is newer than source
-            if os.path.isfile(gz_path) and os.path.getmtime(gz_path) >= os.path.getmtime(
-                src_path
-            ):
-                skipped_count += 1
-                continue
-
-            with open(src_path, "rb") as f_in:
-                data = _gzip.compress(f_in.read(), 9)
-            with open(gz_path, "wb") as f_out:
-                f_out.write(data)
-            compressed_count += 1
-            log_message(f"  Compressed {base} -> {gz_name}")
+# Build the embedded web UI (minify, bundle, content-hash, gzip, pack into one blob).
+# Outputs are only rewritten when they change, avoiding unnecessary re-embedding.
+def _build_web_assets():
+    project_dir = env.subst("$PROJECT_DIR")
+    sys.path.insert(0, os.path.join(project_dir, "scripts"))
+    from build_web_assets import build
 
-    if compressed_count:
-        log_message(f"Compressed {compressed_count} web asset(s), {skipped_count} unchanged")
+    assets, changed = build(project_dir)
+    if changed:
+        log_message(f"Rebuilt web assets ({len(assets)} URLs)")
     else:
-        log_message(f"Web assets up to date ({skipped_count} file(s) unchanged)")
+        log_message("Web assets up to date")
 
 
-_compress_web_assets()
+_build_web_assets()
 
 # Update version strings (script only runs during actual builds, not IDE scans)
 build_type = access_build_flags()
@@ -0,0 +1,422 @@
+#!/usr/bin/env python3
+"""
+Build the embedded web UI from the sources in src/web.
+
+  1. Minify HTML, CSS and JavaScript (comments and indentation only; line structure is
+     kept, so JavaScript semantics, including automatic semicolon insertion, are unchanged).
+  2. Bundle the scripts each page loads with <script src> into one <page>.bundle.js.
+  3. Name every asset after a hash of its content (main.js -> main.1a2b3c4d.js), rewrite the
+     references in the pages, and inject the ASSET_URLS map that main.js uses to find tab
+     content. Hashed URLs are served "immutable"; only the entry page and favicon.ico keep
+     their names.
+  4. Compress the text assets with gzip and, when the brotli module is installed, Brotli
+     (kept only where it beats gzip), and pack every variant into one blob. The server
+     picks the smallest variant the client's Accept-Encoding allows.
+
+Outputs, in src/web/build/ (generated, not tracked):
+  web_assets.bin       all served assets back to back; embedded in the firmware
+  web_asset_table.inc  asset_map rows for src/webserver.cpp (uri, type, cache policy, variants)
+
+Adding a file to src/web is all it takes to serve it. Outputs are only rewritten when their
+content changes, so an unchanged UI doesn't trigger a rebuild of the firmware.
+
+Run by the PlatformIO pre-build step; can also be run by hand.
+"""
+
+import gzip
+import hashlib
+import json
+import re
+import sys
+from pathlib import Path
+
+try:
+    import brotli
+except ImportError:  # Brotli variants are optional; gzip is always built
+    brotli = None
+
+ENTRY_PAGE = "index.html"  # served at "/" and "/index.html"; must be revalidated, never immutable
+FIXED_NAMES = {"favicon.ico"}  # browsers request these by name
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".js": "text/javascript",
+    ".css": "text/css",
+    ".ico": "image/x-icon",
+    ".jpg": "image/jpeg",
+    ".png": "image/png",
+    ".svg": "image/svg+xml",
+}
+COMPRESSIBLE = {".html", ".js", ".css", ".svg"}
+
+# Variant order matches asset_encoding_t in src/webserver.cpp
+ENCODINGS = ("identity", "gzip", "br")
+
+CACHE_REVALIDATE = "no-cache"  # cached, but checked with If-None-Match on every use
+CACHE_FIXED = "max-age=86400"
+CACHE_IMMUTABLE = "max-age=31536000, immutable"
+
+# ----------------------------------------------------------------------------------------
+# Minifiers
+# ----------------------------------------------------------------------------------------
+
+# After these tokens a "/" starts a regular expression literal rather than a division
+_REGEX_PRECEDING_PUNCTUATION = set("(,=:[!&|?{};+-*%<>~^")
+_REGEX_PRECEDING_KEYWORDS = {"return", "typeof", "case", "do", "else", "in", "of", "new", "delete", "void", "throw", "yield", "await"}
+
+
+def _skip_string(src, i, quote):
+    """Return the index just past the string literal whose opening quote is at i."""
+    i += 1
+    while i < len(src):
+        c = src[i]
+        if c == "\\":
+            i += 2
+            continue
+        if c == quote:
+            return i + 1
+        if quote == "`" and src.startswith("${", i):
+            i = _skip_template_expression(src, i + 2)
+            continue
+        i += 1
+    raise ValueError("unterminated string literal")
+
+
+def _skip_template_expression(src, i):
+    """Return the index just past the "}" that closes a ${...} starting at i."""
+    depth = 1
+    while i < len(src):
+        c = src[i]
+        if c in "'\"`":
+            i = _skip_string(src, i, c)
+            continue
+        if c == "{":
+            depth += 1
+        elif c == "}":
+            depth -= 1
+            if depth == 0:
+                return i + 1
+        i += 1
+    raise ValueError("unterminated template expression")
+
+
+def _skip_regex(src, i):
+    """Return the index just past the regular expression literal starting at i (incl. flags)."""
+    i += 1
+    in_class = False
+    while i < len(src):
+        c = src[i]
+        if c == "\\":
+            i += 2
+            continue
+        if c == "\n":
+            raise ValueError("unterminated regular expression")
+        if in_class:
+            in_class = c != "]"
+        elif c == "[":
+            in_class = True
+        elif c == "/":
+            i += 1
+            while i < len(src) and (src[i].isalnum() or src[i] == "_"):
+                i += 1
+            return i
+        i += 1
+    raise ValueError("unterminated regular expression")
+
+
+def _regex_allowed(out):
+    """Whether a "/" following the already-emitted code starts a regular expression."""
+    code = "".join(out[-8:]).rstrip()
+    if not code:
+        return True
+    if code[-1] in _REGEX_PRECEDING_PUNCTUATION:
+        return True
+    word = re.search(r"[A-Za-z_$][\w$]*$", code)
+    return bool(word) and word.group(0) in _REGEX_PRECEDING_KEYWORDS
+
+
+def minify_js(src):
+    """
+    Drop comments and indentation, collapse blank lines and runs of spaces. Literals
+    (strings, templates, regular expressions) are copied verbatim, and every line break
+    between tokens is kept, so the result parses exactly like the source.
+    """
+    out = []
+    i = 0
+    pending = ""  # whitespace owed before the next token: "", " " or "\n"
+    while i < len(src):
+        c = src[i]
+        if c in " \t\r\n":
+            if c == "\n":
+                pending = "\n"
+            elif not pending:
+                pending = " "
+            i += 1
+            continue
+        if src.startswith("//", i):
+            end = src.find("\n", i)
+            i = len(src) if end < 0 else end
+            continue
+        if src.startswith("/*", i):
+            end = src.find("*/", i + 2)
+            if end < 0:
+                raise ValueError("unterminated comment")
+            if "\n" in src[i:end]:
+                pending = "\n"
+            elif not pending:
+                pending = " "
+            i = end + 2
+            continue
+
+        if pending and out:
+            out.append(pending)
+        pending = ""
+
+        if c in "'\"`":
+            end = _skip_string(src, i, c)
+        elif c == "/" and _regex_allowed(out):
+            end = _skip_regex(src, i)
+        else:
+            end = i + 1
+        out.append(src[i:end])
+        i = end
+    return "".join(out) + "\n"
+
+
+def minify_css(src):
+    """Drop comments, collapse whitespace, and remove it next to { } ; , (strings are kept)."""
+    out = []
+    i = 0
+    pending = False
+    while i < len(src):
+        c = src[i]
+        if c in " \t\r\n":
+            pending = True
+            i += 1
+            continue
+        if src.startswith("/*", i):
+            end = src.find("*/", i + 2)
+            if end < 0:
+                raise ValueError("unterminated comment")
+            pending = True
+            i = end + 2
+            continue
+        if pending and out and out[-1][-1] not in "{};," and c not in "{};,":
+            out.append(" ")
+        pending = False
+        if c in "'\"":
+            end = _skip_string(src, i, c)
+            out.append(src[i:end])
+            i = end
+        else:
+            out.append(c)
+            i += 1
+    return "".join(out) + "\n"
+
+
+_HTML_VERBATIM = re.compile(r"(<(pre|textarea|script|style)\b.*?</\2>)", re.S | re.I)
+
+
+def minify_html(src):
+    """Drop comments, indentation and blank lines; <pre>, <textarea>, <script> and <style> are kept as is."""
+    parts = _HTML_VERBATIM.split(src)
+    out = []
+    # split() with two groups yields: text, verbatim block, tag name, text, ...
+    for index in range(0, len(parts), 3):
+        text = re.sub(r"<!--(?!\[if).*?-->", "", parts[index], flags=re.S)
+        lines = [line.strip() for line in text.split("\n")]
+        out.append("\n".join(line for line in lines if line))
+        if index + 1 < len(parts):
+            out.append(("\n" if out[-1] else "") + parts[index + 1] + "\n")
+    return "".join(out).strip() + "\n"
+
+
+MINIFIERS = {".html": minify_html, ".js": minify_js, ".css": minify_css}
+
+# ----------------------------------------------------------------------------------------
+# Pipeline
+# ----------------------------------------------------------------------------------------
+
+_SCRIPT_TAG = re.compile(r'[ \t]*<script src="([^":/]+\.js)"></script>\n?')
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()
+
+
+def hashed_name(name, data):
+    stem, dot, ext = name.rpartition(".")
+    return f"{stem}.{content_hash(data)[:8]}.{ext}"
+
+
+def _rewrite_references(html, urls):
+    """Point src="x" / href="x" attributes that name a local asset at its hashed URL."""
+    return re.sub(
+        r'\b(src|href)="([^":/?#]+)"',
+        lambda m: f'{m.group(1)}="{urls.get(m.group(2), m.group(2))}"',
+        html,
+    )
+
+
+def collect_assets(web_dir):
+    """
+    Return the served assets as a list of dicts with uri, data (served bytes), type,
+    gzipped, cache_control and etag.
+    """
+    sources = {
+        path.name: path.read_bytes()
+        for path in sorted(Path(web_dir).iterdir())
+        if path.is_file() and path.suffix in CONTENT_TYPES
+    }
+    if ENTRY_PAGE not in sources:
+        raise FileNotFoundError(f"{ENTRY_PAGE} not found in {web_dir}")
+
+    # Bundle each page's <script src> tags, in document order, into <page>.bundle.js
+    pages = {}
+    bundles = {}
+    bundled = set()
+    for name, data in sources.items():
+        if not name.endswith(".html"):
+            continue
+        html = data.decode("utf-8")
+        scripts = _SCRIPT_TAG.findall(html)
+        if scripts:
+            bundle_name = name[: -len(".html")] + ".bundle.js"
+            bundles[bundle_name] = ";\n".join(minify_js(sources[s].decode("utf-8")) for s in scripts).encode("utf-8")
+            bundled.update(scripts)
+            first = _SCRIPT_TAG.search(html)
+            html = _SCRIPT_TAG.sub("", html)
+            html = html[: first.start()] + f'<script src="{bundle_name}"></script>\n' + html[first.start() :]
+        pages[name] = html
+
+    # Minify and hash everything except the pages that reference other assets
+    files = {}
+    for name, data in sources.items():
+        if name in bundled or name in pages:
+            continue
+        ext = Path(name).suffix
+        files[name] = MINIFIERS[ext](data.decode("utf-8")).encode("utf-8") if ext in MINIFIERS else data
+    files.update(bundles)
+
+    # Tab pages don't reference assets, so they can be hashed before the entry page
+    urls = {name: name if name in FIXED_NAMES else hashed_name(name, data) for name, data in files.items()}
+    for name, html in pages.items():
+        if name == ENTRY_PAGE:
+            continue
+        files[name] = minify_html(_rewrite_references(html, urls)).encode("utf-8")
+        urls[name] = hashed_name(name, files[name])
+
+    # The entry page gets the map of hashed URLs, for content main.js loads by name
+    manifest = json.dumps({n: u for n, u in sorted(urls.items()) if n != u and n not in bundles}, separators=(",", ":"))
+    entry = _rewrite_references(pages[ENTRY_PAGE], urls)
+    bundle_tag = entry.find("<script src=")
+    entry = entry[:bundle_tag] + f"<script>const ASSET_URLS = {manifest};</script>\n" + entry[bundle_tag:]
+    entry_data = minify_html(entry).encode("utf-8")
+
+    assets = []
+
+    def add(uri, name, data, cache_control):
+        ext = Path(name).suffix
+        etag = content_hash(data)[:16]
+        variants = {}
+        if ext in COMPRESSIBLE:
+            variants["gzip"] = gzip.compress(data, 9, mtime=0)
+            if brotli:
+                compressed = brotli.compress(data, mode=brotli.MODE_TEXT, quality=11)
+                if len(compressed) < len(variants["gzip"]):
+                    variants["br"] = compressed
+        else:
+            variants["identity"] = data
+        assets.append(
+            {
+                "uri": uri,
+                "type": CONTENT_TYPES[ext],
+                "cache_control": cache_control,
+                # Each encoding is a different representation, so it needs its own strong ETag
+                "variants": {
+                    encoding: (body, f'"{etag}"' if encoding == "identity" else f'"{etag}-{encoding}"')
+                    for encoding, body in variants.items()
+                },
+            }
+        )
+
+    add("/", ENTRY_PAGE, entry_data, CACHE_REVALIDATE)
+    add("/" + ENTRY_PAGE, ENTRY_PAGE, entry_data, CACHE_REVALIDATE)
+    for name in sorted(files):
+        add("/" + urls[name], name, files[name], CACHE_FIXED if name in FIXED_NAMES else CACHE_IMMUTABLE)
+    return assets
+
+
+def _c_string(text):
+    return '"' + text.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def render(assets):
+    """Return (blob bytes, asset table text)."""
+    blob = bytearray()
+    rows = [
+        "// Generated by scripts/build_web_assets.py from src/web - do not edit.",
+        "// uri, asset_type, cache_control, {offset, size, etag} for each of: " + ", ".join(ENCODINGS),
+    ]
+    offsets = {}
+    for asset in assets:
+        variants = []
+        for encoding in ENCODINGS:
+            if encoding not in asset["variants"]:
+                variants.append("{0, 0, nullptr}")
+                continue
+            data, etag = asset["variants"][encoding]
+            if data not in offsets:  # "/" and "/index.html" share their bytes
+                offsets[data] = len(blob)
+                blob += data
+            variants.append("{%d, %d, %s}" % (offsets[data], len(data), _c_string(etag)))
+        rows.append(
+            "{%s, %s, %s, {%s}},"
+            % (
+                _c_string(asset["uri"]),
+                _c_string(asset["type"]),
+                _c_string(asset["cache_control"]),
+                ", ".join(variants),
+            )
+        )
+    return bytes(blob), "\n".join(rows) + "\n"
+
+
+def _write_if_changed(path, data):
+    if path.is_file() and path.read_bytes() == data:
+        return False
+    path.write_bytes(data)
+    return True
+
+
+def build(project_dir):
+    """Build the web assets of the project. Returns the list of assets and whether any output changed."""
+    project_dir = Path(project_dir)
+    web_dir = project_dir / "src" / "web"
+    out_dir = web_dir / "build"
+    out_dir.mkdir(exist_ok=True)
+
+    assets = collect_assets(web_dir)
+    blob, table = render(assets)
+    changed = _write_if_changed(out_dir / "web_assets.bin", blob)
+    changed |= _write_if_changed(out_dir / "web_asset_table.inc", table.encode("utf-8"))
+    return assets, changed
+
+
+def main():
+    project_dir = Path(__file__).resolve().parent.parent
+    assets, changed = build(project_dir)
+    if not brotli:
+        print("brotli module not installed: building gzip variants only (pip install brotli)")
+    total = 0
+    for asset in assets:
+        sizes = "  ".join(f"{e} {len(asset['variants'][e][0]):7,d}" for e in ENCODINGS if e in asset["variants"])
+        print(f"{asset['uri']:32s} {sizes:34s} {asset['cache_control']}")
+        if asset["uri"] != "/":
+            total += sum(len(body) for body, _ in asset["variants"].values())
+    print(f"{len(assets)} URLs, {total:,d} bytes embedded ({'updated' if changed else 'unchanged'})")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
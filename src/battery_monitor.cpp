@@ -13,12 +13,12 @@ const int REPORTING_TIME_SEC = 10;
 
 /**
  * Measures and calculates the battery voltage by averaging several ADC samples.
- * If ADC read or calibration fails, it logs an error and returns -1.0.
- * The voltage is adjusted based on a calibration constant.
+ * If ADC read or calibration fails, it logs an error and returns -1.
+ * The voltage is the ADC's, doubled by the divider, adjusted by a calibration constant.
  *
- * @return Calculated battery voltage in volts, or -1.0f if there's an error.
+ * @return Calculated battery voltage in millivolts, or -1 if there's an error.
  */
-float get_analog_battery_voltage (void) {
+int32_t get_analog_battery_millivolts (void) {
     uint32_t VbattMillivolts = 0;
     int      raw             = 0;
     int      millivolts      = 0;
@@ -26,7 +26,7 @@ float get_analog_battery_voltage (void) {
     for (int i = 0; i < BATTERY_SAMPLES_TO_AVERAGE; i++) {
         if (adc_oneshot_read (Global_adc1_handle, ADC_CHANNEL_2, &raw) != ESP_OK) {
             ESP_LOGE (TAG8, "failed to read ADC channel");
-            return -1.0f;
+            return -1;
         }
         if (adc_cali_raw_to_voltage (Global_cali_handle, raw, &millivolts) != ESP_OK) {
             ESP_LOGE (TAG8, "adc raw to calibrated failed.");
@@ -35,41 +35,42 @@ float get_analog_battery_voltage (void) {
         VbattMillivolts += millivolts;
     }
 
-    float Vbattf = BATTERY_CALIBRATION_VALUE * (2.0f * VbattMillivolts / BATTERY_SAMPLES_TO_AVERAGE / 1000.0f);
+    const uint64_t divisor = (uint64_t)BATTERY_SAMPLES_TO_AVERAGE * 1000000;
+    int32_t        Vbatt   = (int32_t)(((uint64_t)VbattMillivolts * 2 * BATTERY_CALIBRATION_PPM + divisor / 2) / divisor);
 
-    ESP_LOGV (TAG8, "analog battery voltage: %.3f V", Vbattf);
-    return Vbattf;
+    ESP_LOGV (TAG8, "analog battery voltage: %ld mV", (long)Vbatt);
+    return Vbatt;
 }
 
 /**
- * Voltage thresholds for linearly interpolating battery percentage,
+ * Voltage thresholds in millivolts for linearly interpolating battery percentage, 5% apart,
  * from a full charge (4.2V) down to a fully discharged state (3.27V).
  */
-static const float BatteryVoltageTable[] = {4.2, 4.15, 4.11, 4.08, 4.02, 3.98, 3.95, 3.91, 3.87, 3.85, 3.84, 3.82, 3.8, 3.79, 3.77, 3.75, 3.73, 3.71, 3.69, 3.61, 3.27};
+static const int16_t BatteryVoltageTable[] = {4200, 4150, 4110, 4080, 4020, 3980, 3950, 3910, 3870, 3850, 3840, 3820, 3800, 3790, 3770, 3750, 3730, 3710, 3690, 3610, 3270};
 
 /**
  * Converts the measured battery voltage into a percentage based on a predefined voltage table.
  * It uses linear interpolation between known voltage values to calculate the percentage.
  *
- * @param voltage Measured battery voltage in volts.
- * @return Battery charge percentage, or -1.0f if the voltage is out of range.
+ * @param millivolts Measured battery voltage in millivolts.
+ * @return Battery charge in thousandths of a percent, or -1 if the voltage is out of range.
  */
-float get_analog_battery_percentage (float voltage) {
-    if (voltage >= 4.2f)
-        return 100.0f;
-    if (voltage <= 3.27f)
-        return 0.0f;
+int32_t get_analog_battery_millipercent (int32_t millivolts) {
+    if (millivolts >= 4200)
+        return 100000;
+    if (millivolts <= 3270)
+        return 0;
 
-    float prior_voltage = BatteryVoltageTable[0];
+    int32_t prior_millivolts = BatteryVoltageTable[0];
     for (int i = 1; i < sizeof (BatteryVoltageTable) / sizeof (BatteryVoltageTable[0]); i++) {
-        if (voltage >= BatteryVoltageTable[i]) {
+        if (millivolts >= BatteryVoltageTable[i]) {
             // Find the fractional position between the two voltage steps and then linearly interpolate the percentage between the two steps.
-            float fraction = (voltage - BatteryVoltageTable[i]) / (prior_voltage - BatteryVoltageTable[i]);
-            return 100.0f - ((i - fraction) * 5.0f);
+            int32_t step = prior_millivolts - BatteryVoltageTable[i];
+            return 100000 - i * 5000 + (millivolts - BatteryVoltageTable[i]) * 5000 / step;
         }
-        prior_voltage = BatteryVoltageTable[i];
+        prior_millivolts = BatteryVoltageTable[i];
     }
-    return -1.0f;
+    return -1;
 }
 
 #define I2C_MASTER_NUM       (I2C_NUM_0)
@@ -79,23 +80,23 @@ float get_analog_battery_percentage (float voltage) {
 
 static max17260_saved_params_t params;
 static bool                    max17260_detected      = false;
-static float                   vbat_analog            = 0;
-static float                   vpct_analog            = 0;
-static float                   vbat_digital           = 0;
-static float                   vpct_digital           = 0;
+static int32_t                 vbat_analog            = 0;  // mV
+static int32_t                 vpct_analog            = 0;  // thousandths of a percent
+static int32_t                 vbat_digital           = 0;
+static int32_t                 vpct_digital           = 0;
 static i2c_master_bus_handle_t i2c_bus_handle         = NULL;
 
 static max17260_info_t   bat_info;  // Smart Battery info struct
 static SemaphoreHandle_t bat_info_mutex;
 
-float get_battery_voltage (void) {
+int32_t get_battery_millivolts (void) {
     if (max17260_detected)
         return vbat_digital;
     else
         return vbat_analog;
 }
 
-float get_battery_percentage (void) {
+int32_t get_battery_millipercent (void) {
     if (max17260_detected)
         return vpct_digital;
     else
@@ -215,8 +216,8 @@ void battery_monitor_task (void * _pvParameter) {
         // Reset watchdog timer
         ESP_ERROR_CHECK (esp_task_wdt_reset());
 
-        vbat_analog = get_analog_battery_voltage();
-        vpct_analog = get_analog_battery_percentage (vbat_analog);
+        vbat_analog = get_analog_battery_millivolts();
+        vpct_analog = get_analog_battery_millipercent (vbat_analog);
         if (max17260_detected) {
             xSemaphoreTake (bat_info_mutex, 100 / portTICK_PERIOD_MS);
             dig_bat_mon.poll (&bat_info);
@@ -224,14 +225,18 @@ void battery_monitor_task (void * _pvParameter) {
 
             // Reset watchdog again after I2C operations
             ESP_ERROR_CHECK (esp_task_wdt_reset());
-            vbat_digital           = bat_info.voltage_average;
-            vpct_digital           = bat_info.reported_state_of_charge;
+            vbat_digital           = max17260_millivolts (bat_info.voltage_average);
+            vpct_digital           = max17260_millipercent (bat_info.reported_state_of_charge);
             if (!(cnt % REPORTING_TIME_SEC))
-                ESP_LOGI (TAG8, "battery: %4.2fV %4.1f%% %5.1fmA %s", vbat_digital, vpct_digital, bat_info.current_average, (bat_info.charging ? "charging" : "discharging"));
+                ESP_LOGI (TAG8, "battery: %ldmV %ld.%ld%% %ldmA %s", (long)vbat_digital, (long)vpct_digital / 1000, (long)vpct_digital % 1000 / 100, (long)max17260_microamps (bat_info.current_average) / 1000, (bat_info.charging ? "charging" : "discharging"));
         }
         else {
-            if (!(cnt % REPORTING_TIME_SEC))
-                ESP_LOGI (TAG8, "battery: %4.2fV %4.2f%%", get_battery_voltage(), get_battery_percentage());
+            if (!(cnt % REPORTING_TIME_SEC)) {
+                if (vpct_analog < 0)
+                    ESP_LOGE (TAG8, "battery: %ldmV, charge unknown", (long)vbat_analog);
+                else
+                    ESP_LOGI (TAG8, "battery: %ldmV %ld.%02ld%%", (long)vbat_analog, (long)vpct_analog / 1000, (long)vpct_analog % 1000 / 10);
+            }
         }
 
         // Reset watchdog timer before sleeping to ensure we don't timeout during the delay
@@ -0,0 +1,286 @@
+#include "clock_sync.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <sys/time.h>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:clk_sync";
+
+/**
+ * A round trip whose reply has gone out, waiting for the client to report when it arrived.
+ */
+typedef struct {
+    double  client_sent_ms;  // t1, 0 if the slot is free
+    int64_t received_us;     // t2 and t3, on esp_timer
+    int64_t replied_us;
+} clock_exchange_t;
+
+/**
+ * The best sample of one burst: the client's clock minus esp_timer, at an esp_timer time.
+ */
+typedef struct {
+    int64_t  at_us;      // midpoint of t2 and t3
+    int64_t  offset_us;  // client clock minus esp_timer
+    uint32_t delay_us;   // round-trip delay
+} clock_sample_t;
+
+#define CLOCK_SYNC_EXCHANGES 4  // round trips in flight at once (one per client, in practice)
+
+static SemaphoreHandle_t s_clock_mutex = nullptr;
+static clock_exchange_t  s_exchanges[CLOCK_SYNC_EXCHANGES];
+static size_t            s_next_exchange = 0;
+
+static clock_sample_t s_history[CLOCK_SYNC_HISTORY];  // oldest first; the last is the current burst's best
+static size_t         s_history_count = 0;
+static int64_t        s_last_sample_us = 0;
+static int32_t        s_last_offset_us = 0;
+static uint16_t       s_sample_count   = 0;
+static uint16_t       s_step_count     = 0;
+
+// The model: client time = esp_timer + offset, where the offset is the target line plus a
+// residual that is slewed away after the anchor. Only used once s_synced.
+static bool     s_synced               = false;
+static int64_t  s_anchor_us            = 0;
+static int64_t  s_anchor_offset_us     = 0;  // target offset at the anchor
+static int64_t  s_residual_us          = 0;  // displayed minus target offset at the anchor
+static int32_t  s_drift_ppb            = 0;
+static bool     s_drift_estimated      = false;
+static uint32_t s_drift_uncertainty_ppb = CLOCK_SYNC_UNKNOWN_PPB;
+
+void init_clock_sync () {
+    if (!s_clock_mutex)
+        s_clock_mutex = xSemaphoreCreateMutex();
+}
+
+static bool clock_lock () {
+    return s_clock_mutex && xSemaphoreTake (s_clock_mutex, pdMS_TO_TICKS (100)) == pdTRUE;
+}
+
+static void clock_unlock () {
+    xSemaphoreGive (s_clock_mutex);
+}
+
+static int64_t system_time_us () {
+    struct timeval tv;
+    gettimeofday (&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+/**
+ * @return the part of the residual not yet slewed away at esp_timer time now_us.
+ */
+static int64_t slew_remaining_us (int64_t now_us) {
+    int64_t elapsed   = now_us > s_anchor_us ? now_us - s_anchor_us : 0;
+    int64_t slewed    = elapsed * CLOCK_SYNC_SLEW_PPM / 1000000;
+    int64_t magnitude = llabs (s_residual_us) - slewed;
+    if (magnitude <= 0)
+        return 0;
+    return s_residual_us < 0 ? -magnitude : magnitude;
+}
+
+/**
+ * @return the offset the clock shows at esp_timer time now_us. Call with the lock held.
+ */
+static int64_t displayed_offset_us (int64_t now_us) {
+    if (!s_synced)
+        return system_time_us() - esp_timer_get_time();
+    int64_t target = s_anchor_offset_us + (now_us - s_anchor_us) * s_drift_ppb / 1000000000LL;
+    return target + slew_remaining_us (now_us);
+}
+
+static uint32_t uncertainty_us (int64_t now_us) {
+    if (!s_synced || s_history_count == 0)
+        return UINT32_MAX;
+    const clock_sample_t & latest = s_history[s_history_count - 1];
+    int64_t                error  = latest.delay_us / 2 + llabs (slew_remaining_us (now_us)) +
+                    (now_us - latest.at_us) * (int64_t)s_drift_uncertainty_ppb / 1000000000LL;
+    return error < UINT32_MAX ? (uint32_t)error : UINT32_MAX;
+}
+
+/**
+ * Estimates the drift rate as the least-squares slope through the bursts' best samples, once
+ * they span CLOCK_SYNC_DRIFT_SPAN_US, and bounds its error by the samples' delays.
+ */
+static void estimate_drift () {
+    const clock_sample_t & first = s_history[0];
+    const clock_sample_t & last  = s_history[s_history_count - 1];
+    int64_t                span  = last.at_us - first.at_us;
+    if (s_history_count < 2 || span < CLOCK_SYNC_DRIFT_SPAN_US)
+        return;
+
+    double mean_t = 0, mean_offset = 0;
+    for (size_t i = 0; i < s_history_count; ++i) {
+        mean_t += (double)(s_history[i].at_us - first.at_us);
+        mean_offset += (double)(s_history[i].offset_us - first.offset_us);
+    }
+    mean_t /= s_history_count;
+    mean_offset /= s_history_count;
+    double sxy = 0, sxx = 0;
+    for (size_t i = 0; i < s_history_count; ++i) {
+        double dt = (double)(s_history[i].at_us - first.at_us) - mean_t;
+        sxy += dt * ((double)(s_history[i].offset_us - first.offset_us) - mean_offset);
+        sxx += dt * dt;
+    }
+    double drift_ppb = sxy / sxx * 1e9;
+    if (std::fabs (drift_ppb) > CLOCK_SYNC_MAX_DRIFT_PPB) {
+        ESP_LOGW (TAG8, "implausible drift of %.0f ppb ignored", drift_ppb);
+        return;
+    }
+
+    s_drift_ppb             = (int32_t)lround (drift_ppb);
+    s_drift_estimated       = true;
+    s_drift_uncertainty_ppb = (uint32_t)(((int64_t)first.delay_us / 2 + last.delay_us / 2) * 1000000000LL / span);
+    if (s_drift_uncertainty_ppb < 100)
+        s_drift_uncertainty_ppb = 100;  // the best the clocks at either end can promise
+}
+
+/**
+ * Moves the target to the latest burst's best sample, and slews or steps the clock to it.
+ * Call with the lock held.
+ */
+static void apply_estimate (int64_t now_us) {
+    const clock_sample_t & latest = s_history[s_history_count - 1];
+    int64_t                shown  = displayed_offset_us (now_us);
+    int64_t                target = latest.offset_us + (now_us - latest.at_us) * s_drift_ppb / 1000000000LL;
+    int64_t                error  = shown - target;
+
+    if (!s_synced || llabs (error) > CLOCK_SYNC_STEP_US) {
+        ESP_LOGI (TAG8, "stepping clock by %lld us", (long long)-error);
+        error = 0;
+        ++s_step_count;
+    }
+    s_synced           = true;
+    s_anchor_us        = now_us;
+    s_anchor_offset_us = target;
+    s_residual_us      = error;
+
+    // Keep the system time, which the logs and the C library go by, close behind
+    struct timeval tv;
+    int64_t        wall_us = now_us + displayed_offset_us (now_us);
+    tv.tv_sec              = wall_us / 1000000;
+    tv.tv_usec             = wall_us % 1000000;
+    settimeofday (&tv, NULL);
+}
+
+int64_t clock_sync_now_us () {
+    if (!clock_lock())
+        return system_time_us();
+    int64_t now_us = esp_timer_get_time();
+    int64_t wall   = now_us + displayed_offset_us (now_us);
+    clock_unlock();
+    return wall;
+}
+
+void clock_sync_begin_exchange (double client_sent_ms, int64_t received_us, int64_t replied_us) {
+    if (!clock_lock())
+        return;
+    s_exchanges[s_next_exchange] = {client_sent_ms, received_us, replied_us};
+    s_next_exchange              = (s_next_exchange + 1) % CLOCK_SYNC_EXCHANGES;
+    clock_unlock();
+}
+
+bool clock_sync_complete_exchange (double client_sent_ms, double client_received_ms) {
+    if (!clock_lock())
+        return false;
+
+    clock_exchange_t * exchange = nullptr;
+    for (clock_exchange_t & candidate : s_exchanges)
+        if (candidate.client_sent_ms != 0 && candidate.client_sent_ms == client_sent_ms)
+            exchange = &candidate;
+    if (!exchange) {
+        clock_unlock();
+        return false;
+    }
+
+    // Offset and delay, per RFC 5905, against esp_timer rather than the wall clock
+    int64_t t1_us   = llround (client_sent_ms * 1000.0);
+    int64_t t4_us   = llround (client_received_ms * 1000.0);
+    int64_t delay   = (t4_us - t1_us) - (exchange->replied_us - exchange->received_us);
+    clock_sample_t sample;
+    sample.at_us     = (exchange->received_us + exchange->replied_us) / 2;
+    sample.offset_us = ((t1_us - exchange->received_us) + (t4_us - exchange->replied_us)) / 2;
+    sample.delay_us  = delay > 0 ? (uint32_t)delay : 0;  // the client's clock may tick in whole ms
+    exchange->client_sent_ms = 0;
+    if (delay > CLOCK_SYNC_MAX_DELAY_US || delay < -1000) {
+        clock_unlock();
+        ESP_LOGW (TAG8, "round trip with delay %lld us discarded", (long long)delay);
+        return false;
+    }
+
+    int64_t now_us   = esp_timer_get_time();
+    s_last_offset_us = (int32_t)(sample.offset_us - displayed_offset_us (sample.at_us));
+    ++s_sample_count;
+
+    // Keep the smallest delay of each burst: queueing and retries only ever add delay
+    bool improved = true;
+    if (s_history_count == 0 || sample.at_us - s_last_sample_us > CLOCK_SYNC_BURST_GAP_US) {
+        if (s_history_count == CLOCK_SYNC_HISTORY) {
+            for (size_t i = 1; i < CLOCK_SYNC_HISTORY; ++i)
+                s_history[i - 1] = s_history[i];
+            --s_history_count;
+        }
+        s_history[s_history_count++] = sample;
+    }
+    else if (sample.delay_us < s_history[s_history_count - 1].delay_us) {
+        s_history[s_history_count - 1] = sample;
+    }
+    else {
+        improved = false;
+    }
+    s_last_sample_us = sample.at_us;
+
+    if (improved || !s_synced) {
+        estimate_drift();
+        apply_estimate (now_us);
+    }
+    ESP_LOGI (TAG8, "offset %ld us, delay %lu us, drift %ld ppb, uncertainty %lu us",
+              (long)s_last_offset_us, (unsigned long)sample.delay_us, (long)s_drift_ppb, (unsigned long)uncertainty_us (now_us));
+    clock_unlock();
+    return true;
+}
+
+bool clock_sync_set_coarse (int64_t client_now_ms) {
+    if (!clock_lock())
+        return false;
+    int64_t now_us = esp_timer_get_time();
+    if (s_synced && uncertainty_us (now_us) < CLOCK_SYNC_TRUSTED_US) {
+        ESP_LOGI (TAG8, "coarse time %lld ms off the disciplined clock, ignored",
+                  (long long)(client_now_ms - (now_us + displayed_offset_us (now_us)) / 1000));
+        clock_unlock();
+        return false;
+    }
+
+    // Back to the system time; the bursts seen so far still count towards the drift estimate
+    s_synced = false;
+    struct timeval tv;
+    tv.tv_sec  = client_now_ms / 1000;
+    tv.tv_usec = (client_now_ms % 1000) * 1000;
+    settimeofday (&tv, NULL);
+    clock_unlock();
+    return true;
+}
+
+void clock_sync_get_status (clock_sync_status_t * status) {
+    *status = {};
+    if (!clock_lock())
+        return;
+    int64_t now_us            = esp_timer_get_time();
+    status->synced            = s_synced;
+    status->offset_us         = s_last_offset_us;
+    status->drift_ppb         = s_drift_ppb;
+    status->drift_estimated   = s_drift_estimated;
+    status->uncertainty_us    = uncertainty_us (now_us);
+    status->samples           = s_sample_count;
+    status->steps             = s_step_count;
+    if (s_history_count > 0) {
+        status->last_sample_ago_us = now_us - s_history[s_history_count - 1].at_us;
+        status->delay_us           = s_history[s_history_count - 1].delay_us;
+    }
+    if (s_synced)
+        status->slew_remaining_us = (int32_t)slew_remaining_us (now_us);
+    clock_unlock();
+}
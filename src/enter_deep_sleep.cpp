@@ -1,5 +1,6 @@
 #include "enter_deep_sleep.h"
 #include "hardware_specific.h"
+#include "settings.h"
 #include "setup_adc.h"
 
 #include <driver/rtc_io.h>
@@ -13,6 +14,8 @@ void enter_deep_sleep () {
     ESP_LOGV (TAG8, "trace: %s()", __func__);
 
     ESP_LOGI (TAG8, "preparing for deep sleep:");
+    flush_settings();  // deep sleep loses RAM, including settings still waiting to be written
+    ESP_LOGI (TAG8, "settings are saved.");
     esp_wifi_stop();
     ESP_LOGI (TAG8, "wifi is stopped.");
     shutdown_adc();
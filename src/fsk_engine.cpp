@@ -0,0 +1,484 @@
+#include "../lib/ft8_encoder/ft8/constants.h"
+#include "../lib/ft8_encoder/ft8/encode.h"
+#include "../lib/ft8_encoder/ft8/pack.h"
+#include "../lib/wspr_encoder/wspr.h"
+#include "clock_sync.h"
+#include "fsk_engine.h"
+#include "hardware_specific.h"
+#include "kx_radio.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <driver/gptimer.h>
+#include <driver/uart.h>
+#include <esp_attr.h>
+#include <esp_rom_sys.h>
+#include <esp_task_wdt.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <hal/uart_ll.h>
+#include <strings.h>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:fsk_eng.";
+
+/**
+ * pack77() keeps a table of recently packed callsigns for hashed calls, so packing is
+ * serialized: the HTTP handler and the transmit task can both be encoding.
+ */
+static SemaphoreHandle_t fsk_pack_mutex = nullptr;
+
+static int fsk_pack77 (const char * message, uint8_t * packed) {
+    if (!fsk_pack_mutex || xSemaphoreTake (fsk_pack_mutex, pdMS_TO_TICKS (100)) != pdTRUE)
+        return -1;
+    int result = pack77 (message, packed);
+    xSemaphoreGive (fsk_pack_mutex);
+    return result;
+}
+
+static int fsk_encode_ft8 (const char * message, uint8_t * tones) {
+    uint8_t packed[FTX_LDPC_K_BYTES];
+    if (fsk_pack77 (message, packed) < 0)
+        return -1;
+    ft8_encode (packed, tones);
+    return 0;
+}
+
+static int fsk_encode_ft4 (const char * message, uint8_t * tones) {
+    uint8_t packed[FTX_LDPC_K_BYTES];
+    if (fsk_pack77 (message, packed) < 0)
+        return -1;
+    ft4_encode (packed, tones);
+    return 0;
+}
+
+static_assert (FT8_NN <= FSK_MAX_SYMBOLS && FT4_NN <= FSK_MAX_SYMBOLS && WSPR_NN <= FSK_MAX_SYMBOLS, "FSK_MAX_SYMBOLS too small");
+static_assert (WSPR_MESSAGE_MAX <= FSK_MESSAGE_MAX && FTX_MESSAGE_MAX <= FSK_MESSAGE_MAX, "FSK_MESSAGE_MAX too small");
+
+/**
+ * Symbol periods and tone spacings are 12 kHz sample counts in WSJT-X: FT8 1920 samples
+ * (6.25 Hz), FT4 576 (20.833 Hz), WSPR 8192 (1.4648 Hz). WSPR starts 1 s into even minutes.
+ * Rounded to whole hertz, WSPR's tones land at 0/1/3/4 Hz instead of 0/1.46/2.93/4.39 Hz,
+ * up to 30% of a spacing off, so it needs a radio that tunes finer than that.
+ */
+static const fsk_mode_t s_fsk_modes[] = {
+    // name    symbols  symbol_us  tone_spacing_mhz  slot_ms  start_delay_ms  max_message_chars  sub_hz_tones  encode
+    {"ft8",  FT8_NN,  160000,    6250,             15000,   0,              FTX_MESSAGE_MAX,   false,        fsk_encode_ft8},
+    {"ft4",  FT4_NN,  48000,     20833,            7500,    0,              FTX_MESSAGE_MAX,   false,        fsk_encode_ft4},
+    {"wspr", WSPR_NN, 682667,    1465,             120000,  1000,           WSPR_MESSAGE_MAX,  true,         wspr_encode   },
+};
+
+const fsk_mode_t * fsk_find_mode (const char * name) {
+    for (const fsk_mode_t & mode : s_fsk_modes)
+        if (strcasecmp (mode.name, name) == 0)
+            return &mode;
+    return nullptr;
+}
+
+const fsk_mode_t * fsk_default_mode () {
+    return &s_fsk_modes[0];
+}
+
+bool fsk_build_tone_commands (const fsk_mode_t * mode, const uint8_t * tones, long base_freq, char * commands, size_t * command_length) {
+    char   command[FT8_TONE_COMMAND_MAX];
+    size_t first_length = 0;
+    for (int i = 0; i < mode->symbols; ++i) {
+        long   frequency = base_freq + (long)((tones[i] * mode->tone_spacing_mhz + 500) / 1000);
+        size_t length    = kxRadio.ft8_tone_command (base_freq, frequency, command, sizeof (command));
+        if (length == 0 || (i > 0 && length != first_length)) {
+            ESP_LOGE (TAG8, "can't build %s tone command %d", mode->name, i);
+            return false;
+        }
+        first_length = length;
+        memcpy (commands + i * length, command, length);
+    }
+    *command_length = first_length;
+    return true;
+}
+
+/**
+ * @return microseconds until the mode's next transmission start, on the disciplined clock.
+ */
+static int64_t fsk_us_until_window (const fsk_mode_t * mode, int slot_parity) {
+    int64_t slot_us  = (int64_t)mode->slot_ms * 1000;
+    int64_t since_us = clock_sync_now_us() - (int64_t)mode->start_delay_ms * 1000;  // since the first slot's start
+    int64_t slot     = (since_us + slot_us - 1) / slot_us;                         // the next slot to start, or this one if it starts now
+
+    if (slot_parity != FSK_SLOT_ANY && (slot & 1) != slot_parity)
+        ++slot;
+    return slot * slot_us - since_us;
+}
+
+long fsk_ms_until_window (const fsk_mode_t * mode, int slot_parity) {
+    return (long)((fsk_us_until_window (mode, slot_parity) + 999) / 1000);
+}
+
+void fsk_wait_for_window (const fsk_mode_t * mode, int slot_parity, bool (*cancelled) ()) {
+    ESP_LOGV (TAG8, "trace: %s()", __func__);
+
+    // Sleep in ticks until the last two, then spin to the window: vTaskDelay() alone is only
+    // good to a tick, which would swamp the error of a disciplined clock
+    const int64_t deadline_us                    = esp_timer_get_time() + fsk_us_until_window (mode, slot_parity);
+    const int64_t spin_us                        = 2 * portTICK_PERIOD_MS * 1000;
+    const int64_t cancellation_check_interval_us = 250000;
+
+    int64_t remaining_us;
+    while ((remaining_us = deadline_us - esp_timer_get_time()) > spin_us) {
+        if (cancelled()) {
+            ESP_LOGI (TAG8, "cancelled while waiting for the %s window", mode->name);
+            return;
+        }
+
+        // Wait for the lesser of the remaining delay or the check interval
+        int64_t wait_us = remaining_us - spin_us < cancellation_check_interval_us ? remaining_us - spin_us : cancellation_check_interval_us;
+        TickType_t ticks = pdMS_TO_TICKS (wait_us / 1000);
+        vTaskDelay (ticks > 0 ? ticks : 1);
+        ESP_ERROR_CHECK (esp_task_wdt_reset());
+    }
+    if (remaining_us > 0)
+        esp_rom_delay_us ((uint32_t)remaining_us);
+}
+
+/**
+ * Tone timer state, shared with the alarm ISR. fsk_play() sets it up before starting the
+ * timer and only reads it back after stopping the timer. The ISR is IRAM-safe
+ * (CONFIG_GPTIMER_ISR_IRAM_SAFE) so NVS and OTA writes don't hold up the symbols; everything
+ * it touches is in DRAM, including the commands, which live in handler_ft8.cpp's buffers.
+ */
+static DRAM_ATTR gptimer_handle_t fsk_tone_timer          = nullptr;
+static uint32_t                   fsk_tone_period_us      = 0;  // alarm period the timer is set to
+static DRAM_ATTR TaskHandle_t     fsk_tone_task           = nullptr;
+static DRAM_ATTR uart_dev_t *     fsk_tone_uart           = nullptr;
+static DRAM_ATTR const char *     fsk_tone_commands       = nullptr;
+static DRAM_ATTR size_t           fsk_tone_command_length = 0;
+static DRAM_ATTR size_t           fsk_tone_symbols        = 0;
+static DRAM_ATTR volatile size_t  fsk_tone_index          = 0;  // next symbol to send, and so the number sent
+static DRAM_ATTR volatile bool    fsk_tone_done           = true;
+static DRAM_ATTR volatile bool    fsk_tone_overrun        = false;
+static DRAM_ATTR int64_t          fsk_symbol_us[FSK_MAX_SYMBOLS];  // esp_timer time each symbol's command went into the FIFO
+
+/**
+ * Alarm ISR, every symbol period: writes the next symbol's command straight into the UART's
+ * TX FIFO, so the symbol clock does not depend on task scheduling. The alarm after the last
+ * symbol ends it and wakes the transmit task. uart_tx_chars() takes the driver's mutex and
+ * can't be used here; the FIFO is ours because the task holds the radio lock throughout and
+ * the driver has no TX ring buffer of its own.
+ */
+static bool IRAM_ATTR fsk_tone_timer_cb (gptimer_handle_t timer, const gptimer_alarm_event_data_t * event, void * arg) {
+    (void)timer;
+    (void)event;
+    (void)arg;
+
+    if (fsk_tone_done)
+        return false;
+
+    size_t idx = fsk_tone_index;
+    if (idx < fsk_tone_symbols) {
+        if (uart_ll_get_txfifo_len (fsk_tone_uart) >= fsk_tone_command_length) {
+            uart_ll_write_txfifo (fsk_tone_uart, (const uint8_t *)fsk_tone_commands + idx * fsk_tone_command_length, fsk_tone_command_length);
+            fsk_symbol_us[idx] = esp_timer_get_time();
+            fsk_tone_index     = idx + 1;
+            return false;
+        }
+        // The radio isn't draining the FIFO; give up rather than send symbols late
+        fsk_tone_overrun = true;
+    }
+
+    fsk_tone_done                    = true;
+    BaseType_t higher_priority_woken = pdFALSE;
+    vTaskNotifyGiveFromISR (fsk_tone_task, &higher_priority_woken);
+    return higher_priority_woken == pdTRUE;
+}
+
+/**
+ * Creates the tone timer on first use (1 MHz), and sets its alarm to the mode's symbol period.
+ */
+static bool fsk_tone_timer_init (const fsk_mode_t * mode) {
+    if (!fsk_tone_timer) {
+        gptimer_config_t timer_config = {};
+        timer_config.clk_src          = GPTIMER_CLK_SRC_DEFAULT;
+        timer_config.direction        = GPTIMER_COUNT_UP;
+        timer_config.resolution_hz    = 1000000;
+
+        gptimer_event_callbacks_t callbacks = {};
+        callbacks.on_alarm                  = &fsk_tone_timer_cb;
+
+        gptimer_handle_t timer = nullptr;
+        if (gptimer_new_timer (&timer_config, &timer) != ESP_OK)
+            return false;
+        if (gptimer_register_event_callbacks (timer, &callbacks, nullptr) != ESP_OK ||
+            gptimer_enable (timer) != ESP_OK) {
+            gptimer_del_timer (timer);
+            return false;
+        }
+        fsk_tone_timer = timer;
+    }
+
+    if (fsk_tone_period_us != mode->symbol_us) {
+        gptimer_alarm_config_t alarm_config     = {};
+        alarm_config.alarm_count                = mode->symbol_us;
+        alarm_config.reload_count               = 0;
+        alarm_config.flags.auto_reload_on_alarm = true;
+        if (gptimer_set_alarm_action (fsk_tone_timer, &alarm_config) != ESP_OK)
+            return false;
+        fsk_tone_period_us = mode->symbol_us;
+    }
+    return true;
+}
+
+static fsk_timing_t      fsk_timing_history[FSK_TIMING_HISTORY];
+static uint32_t          fsk_timing_count = 0;  // transmissions since boot; the newest is at (count - 1) % history
+static SemaphoreHandle_t fsk_timing_mutex = nullptr;
+
+static uint32_t isqrt64 (uint64_t value) {
+    uint64_t root = 0;
+    uint64_t bit  = 1ULL << 62;
+    while (bit > value)
+        bit >>= 2;
+    while (bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+            root >>= 1;
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+/**
+ * Computes a transmission's timing from fsk_symbol_us[], logs it and adds it to the history.
+ * @param symbols_sent Number of symbols whose commands were written.
+ * @param started_unix_us Unix time, in microseconds, symbol 0 was written.
+ * @param aborted Whether the transmission was cut short.
+ */
+static void fsk_record_timing (const fsk_mode_t * mode, size_t symbols_sent, int64_t started_unix_us, bool aborted) {
+    fsk_timing_t timing = {};
+    timing.started_ms   = started_unix_us / 1000;
+    timing.mode         = mode->name;
+    timing.radio        = kxRadio.get_radio_type_string();
+    timing.symbols_sent = symbols_sent;
+    timing.aborted      = aborted;
+
+    int64_t slot_us        = (int64_t)mode->slot_ms * 1000;
+    int64_t slot_offset_us = (started_unix_us - (int64_t)mode->start_delay_ms * 1000) % slot_us;
+    if (slot_offset_us > slot_us / 2)
+        slot_offset_us -= slot_us;
+    timing.slot_offset_us = (int32_t)slot_offset_us;
+
+    if (symbols_sent > 1) {
+        size_t  intervals = symbols_sent - 1;
+        int64_t period_us = mode->symbol_us;
+        int64_t mean_us   = (fsk_symbol_us[intervals] - fsk_symbol_us[0]) / (int64_t)intervals;
+        int64_t sum_sq    = 0;
+        int64_t max_jit   = 0;
+        for (size_t i = 1; i < symbols_sent; ++i) {
+            int64_t interval = fsk_symbol_us[i] - fsk_symbol_us[i - 1];
+            int64_t jitter   = std::llabs (interval - period_us);
+            sum_sq += (interval - mean_us) * (interval - mean_us);
+            if (jitter > max_jit)
+                max_jit = jitter;
+            if (fsk_symbol_us[i] - fsk_symbol_us[0] - (int64_t)i * period_us > FSK_LATE_SYMBOL_US)
+                ++timing.late_symbols;
+        }
+        timing.symbol_interval_mean_us   = (uint32_t)mean_us;
+        timing.symbol_interval_stddev_us = isqrt64 ((uint64_t)(sum_sq / (int64_t)intervals));
+        timing.max_jitter_us             = (uint32_t)max_jit;
+    }
+
+    ESP_LOGI (TAG8, "%s timing: slot offset %ld us, symbol interval %lu +/- %lu us, max jitter %lu us, %u of %u symbols late%s",
+              mode->name,
+              (long)timing.slot_offset_us,
+              (unsigned long)timing.symbol_interval_mean_us,
+              (unsigned long)timing.symbol_interval_stddev_us,
+              (unsigned long)timing.max_jitter_us,
+              (unsigned)timing.late_symbols,
+              (unsigned)timing.symbols_sent,
+              aborted ? " (aborted)" : "");
+
+    if (!fsk_timing_mutex || xSemaphoreTake (fsk_timing_mutex, pdMS_TO_TICKS (100)) != pdTRUE)
+        return;
+    fsk_timing_history[fsk_timing_count % FSK_TIMING_HISTORY] = timing;
+    ++fsk_timing_count;
+    xSemaphoreGive (fsk_timing_mutex);
+}
+
+size_t fsk_get_timing (fsk_timing_t * history, uint32_t * count) {
+    *count = 0;
+    if (!fsk_timing_mutex || xSemaphoreTake (fsk_timing_mutex, pdMS_TO_TICKS (100)) != pdTRUE)
+        return 0;
+
+    size_t copied = 0;
+    for (; copied < fsk_timing_count && copied < FSK_TIMING_HISTORY; ++copied)
+        history[copied] = fsk_timing_history[(fsk_timing_count - 1 - copied) % FSK_TIMING_HISTORY];
+    *count = fsk_timing_count;
+    xSemaphoreGive (fsk_timing_mutex);
+    return copied;
+}
+
+bool fsk_play (const fsk_mode_t * mode, const char * commands, size_t command_length, bool (*cancelled) (),
+               void (*on_air) (void *), void * on_air_arg) {
+    if (!fsk_tone_timer_init (mode)) {
+        ESP_LOGE (TAG8, "Failed to set up the tone timer");
+        return false;
+    }
+
+    // Symbol 0 goes out now; the timer's alarms send the rest and end the last a period later
+    fsk_tone_task           = xTaskGetCurrentTaskHandle();
+    fsk_tone_uart           = UART_LL_GET_HW (UART_NUM);
+    fsk_tone_commands       = commands;
+    fsk_tone_command_length = command_length;
+    fsk_tone_symbols        = mode->symbols;
+    fsk_tone_index          = 1;
+    fsk_tone_overrun        = false;
+    (void)ulTaskNotifyTake (pdTRUE, 0);
+
+    uart_write_bytes (UART_NUM, commands, command_length);
+    fsk_symbol_us[0] = esp_timer_get_time();
+    int64_t started_unix_us = clock_sync_now_us();
+    fsk_tone_done = false;
+
+    bool timer_started = gptimer_set_raw_count (fsk_tone_timer, 0) == ESP_OK && gptimer_start (fsk_tone_timer) == ESP_OK;
+    if (!timer_started)
+        ESP_LOGE (TAG8, "Failed to start the tone timer");
+    else if (on_air)
+        on_air (on_air_arg);
+
+    // Wait for the last symbol, waking every second to feed the watchdog and check for a cancel
+    bool    stalled          = false;
+    int64_t tone_deadline_us = fsk_symbol_us[0] + (int64_t)(mode->symbols + 2) * mode->symbol_us;
+    while (timer_started && !cancelled()) {
+        if (ulTaskNotifyTake (pdTRUE, pdMS_TO_TICKS (1000)) > 0)
+            break;
+        ESP_ERROR_CHECK (esp_task_wdt_reset());
+        if (esp_timer_get_time() > tone_deadline_us) {
+            ESP_LOGW (TAG8, "tone timer stalled at symbol %u", (unsigned)fsk_tone_index);
+            stalled = true;
+            break;
+        }
+    }
+
+    if (timer_started)
+        gptimer_stop (fsk_tone_timer);
+    bool completed = fsk_tone_done && !fsk_tone_overrun && !stalled;
+    fsk_tone_done  = true;
+    if (fsk_tone_overrun)
+        ESP_LOGW (TAG8, "tone commands backed up in the UART; transmission aborted");
+
+    fsk_record_timing (mode, fsk_tone_index, started_unix_us, !completed);
+    return completed;
+}
+
+static fsk_transmission_t fsk_queue[FSK_QUEUE_MAX];
+static size_t             fsk_queue_head  = 0;
+static size_t             fsk_queue_tail  = 0;
+static size_t             fsk_queue_count = 0;
+static SemaphoreHandle_t  fsk_queue_mutex = nullptr;
+
+size_t fsk_queue_size () {
+    if (!fsk_queue_mutex)
+        return 0;
+
+    if (xSemaphoreTake (fsk_queue_mutex, pdMS_TO_TICKS (25)) != pdTRUE)
+        return 0;
+
+    size_t count = fsk_queue_count;
+    xSemaphoreGive (fsk_queue_mutex);
+    return count;
+}
+
+bool fsk_queue_push (const fsk_transmission_t & transmission) {
+    if (!fsk_queue_mutex)
+        return false;
+
+    if (xSemaphoreTake (fsk_queue_mutex, pdMS_TO_TICKS (100)) != pdTRUE)
+        return false;
+
+    if (fsk_queue_count >= FSK_QUEUE_MAX) {
+        xSemaphoreGive (fsk_queue_mutex);
+        return false;
+    }
+
+    fsk_queue[fsk_queue_tail] = transmission;
+    fsk_queue_tail            = (fsk_queue_tail + 1) % FSK_QUEUE_MAX;
+    ++fsk_queue_count;
+
+    xSemaphoreGive (fsk_queue_mutex);
+    return true;
+}
+
+bool fsk_queue_pop (fsk_transmission_t & out_transmission) {
+    if (!fsk_queue_mutex)
+        return false;
+
+    if (xSemaphoreTake (fsk_queue_mutex, pdMS_TO_TICKS (100)) != pdTRUE)
+        return false;
+
+    if (fsk_queue_count == 0) {
+        xSemaphoreGive (fsk_queue_mutex);
+        return false;
+    }
+
+    out_transmission = fsk_queue[fsk_queue_head];
+    fsk_queue_head   = (fsk_queue_head + 1) % FSK_QUEUE_MAX;
+    --fsk_queue_count;
+
+    xSemaphoreGive (fsk_queue_mutex);
+    return true;
+}
+
+bool fsk_queue_pop_with_timeout (fsk_transmission_t & out_transmission, int64_t wait_deadline_us) {
+    while (!fsk_queue_pop (out_transmission)) {
+        if (esp_timer_get_time() >= wait_deadline_us) {
+            return false;
+        }
+        vTaskDelay (pdMS_TO_TICKS (100));
+    }
+    return true;
+}
+
+bool fsk_queue_push_with_timeout (const fsk_transmission_t & transmission, int64_t wait_deadline_us) {
+    while (!fsk_queue_push (transmission)) {
+        if (esp_timer_get_time() >= wait_deadline_us) {
+            return false;
+        }
+        vTaskDelay (pdMS_TO_TICKS (100));
+    }
+    return true;
+}
+
+void fsk_queue_clear () {
+    if (!fsk_queue_mutex)
+        return;
+
+    if (xSemaphoreTake (fsk_queue_mutex, pdMS_TO_TICKS (100)) != pdTRUE)
+        return;
+
+    fsk_queue_head  = 0;
+    fsk_queue_tail  = 0;
+    fsk_queue_count = 0;
+    xSemaphoreGive (fsk_queue_mutex);
+}
+
+void init_fsk_engine () {
+    if (!fsk_pack_mutex)
+        fsk_pack_mutex = xSemaphoreCreateMutex();
+    if (!fsk_timing_mutex)
+        fsk_timing_mutex = xSemaphoreCreateMutex();
+    if (!fsk_queue_mutex)
+        fsk_queue_mutex = xSemaphoreCreateMutex();
+}
+
+static std::atomic<bool> fsk_transmitting {false};
+
+void fsk_set_transmitting (bool transmitting) {
+    fsk_transmitting.store (transmitting, std::memory_order_release);
+}
+
+bool fsk_is_transmitting () {
+    return fsk_transmitting.load (std::memory_order_acquire) || fsk_queue_size() > 0;
+}
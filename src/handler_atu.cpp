@@ -1,4 +1,5 @@
 #include "globals.h"
+#include "jobs.h"
 #include "kx_radio.h"
 #include "timed_lock.h"
 #include "webserver.h"
@@ -6,12 +7,29 @@
 #include <esp_log.h>
 static const char * TAG8 = "sc:hdl_atu.";
 
+/**
+ * Job body for an asynchronous ATU tune.
+ */
+static bool atu_job (job_t * job) {
+    TimedLock lock = kxRadio.timed_lock (RADIO_LOCK_TIMEOUT_CRITICAL_MS, "ATU tune job");
+    if (!lock.acquired())
+        return job_fail (job, "radio busy");
+    if (job_is_cancel_requested (job))
+        return false;
+    job_set_progress (job, 10);
+
+    if (!kxRadio.tune_atu())
+        return job_fail (job, "Failed to send ATU command");
+    return true;
+}
+
 /**
  * Handles an HTTP PUT request to initiate ATU (Antenna Tuning Unit) tuning.
  * This function sends the appropriate command based on the detected radio type:
  * - KX3: SWT44
  * - KX2: SWT20
  * - KH1: SW3T
+ * With "Prefer: respond-async" the tune runs as a job and the reply is 202 with its location.
  *
  * @param req Pointer to the HTTP request structure.
  * @return ESP_OK on success, or an error code on failure.
@@ -21,6 +39,9 @@ esp_err_t handler_atu_put (httpd_req_t * req) {
 
     ESP_LOGV (TAG8, "trace: %s()", __func__);
 
+    if (client_prefers_async (req))
+        return start_job_and_reply (req, JOB_KIND_ATU, atu_job, nullptr, nullptr, 0);
+
     // Tier 3: Critical timeout for ATU tuning operation
     TIMED_LOCK_OR_FAIL (req, kxRadio.timed_lock (RADIO_LOCK_TIMEOUT_CRITICAL_MS, "ATU tune")) {
         if (!kxRadio.tune_atu())
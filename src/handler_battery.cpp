@@ -1,5 +1,6 @@
 #include "battery_monitor.h"
 #include "globals.h"
+#include "json_writer.h"
 #include "webserver.h"
 #include "wifi.h"
 
@@ -34,41 +35,32 @@ esp_err_t handler_batteryInfo_get (httpd_req_t * req) {
 
     ESP_LOGV (TAG8, "trace: %s()", __func__);
 
-    const int     outbuf_size = 200;  // with 8 params the smart case json output is ~185 bytes
-    char          out_buf[outbuf_size];
-    batteryInfo_t bat_info;
-    int           cnt = 0;
+    httpd_resp_set_hdr (req, "Connection", "close");
+    JsonWriter json (req);
+    json.begin_object();
     if (get_battery_is_smart()) {
+        batteryInfo_t bat_info;
         if (get_battery_info (&bat_info) == ESP_OK) {
-            cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "{");
-            cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"is_smart\":true,");
-            cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"voltage_v\":%4.2f,", bat_info.voltage_average);
-            cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"current_ma\":%4.1f,", bat_info.current_average);
-            cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"temp_c\":%4.1f,", bat_info.temperature_average);
-            cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"state_of_charge_pct\":%4.1f,", bat_info.reported_state_of_charge);
-            cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"capacity_mah\":%4.1f,", bat_info.reported_capacity);
-            cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"time_to_empty_hrs\":%4.2f,", bat_info.time_to_empty);
-            cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"time_to_full_hrs\":%4.2f,", bat_info.time_to_full);
-            cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"charging\":%s", (bat_info.charging ? "true" : "false"));
-            cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "}");
-            if (cnt >= outbuf_size) {
-                ESP_LOGE (TAG8, "tried to write past buffer building smart batteryInfo json");
-            }
+            json.boolean ("is_smart", true);
+            json.fixed ("voltage_v", max17260_millivolts (bat_info.voltage_average), 3, 2);
+            json.fixed ("current_ma", max17260_microamps (bat_info.current_average), 3, 1);
+            json.fixed ("temp_c", max17260_millidegrees (bat_info.temperature_average), 3, 1);
+            json.fixed ("state_of_charge_pct", max17260_millipercent (bat_info.reported_state_of_charge), 3, 1);
+            json.fixed ("capacity_mah", max17260_microamp_hours (bat_info.reported_capacity), 3, 1);
+            json.fixed ("time_to_empty_hrs", max17260_seconds (bat_info.time_to_empty) * 1000LL / 3600, 3, 2);
+            json.fixed ("time_to_full_hrs", max17260_seconds (bat_info.time_to_full) * 1000LL / 3600, 3, 2);
+            json.boolean ("charging", bat_info.charging);
         }
         else {
             ESP_LOGE (TAG8, "timed out getting bat_info mutex");
         }
     }
     else {  // analog battery
-        cnt += snprintf (out_buf, sizeof (out_buf), "{");
-        cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"is_smart\":false,");
-        cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"voltage_v\":%4.2f,", get_battery_voltage());
-        cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "\"state_of_charge_pct\":%4.1f", get_battery_percentage());
-        cnt += snprintf (out_buf + cnt, outbuf_size - cnt, "}");
-        if (cnt >= outbuf_size) {
-            ESP_LOGE (TAG8, "tried to write past buffer building analog batteryInfo json");
-        }
+        json.boolean ("is_smart", false);
+        json.fixed ("voltage_v", get_battery_millivolts(), 3, 2);
+        json.fixed ("state_of_charge_pct", get_battery_millipercent(), 3, 1);
     }
-    httpd_resp_set_type (req, "application/json");
-    REPLY_WITH_STRING (req, out_buf, "battery info message");
+    json.end_object();
+    ESP_LOGI (TAG8, "returning battery info");
+    return json.finish();
 }
@@ -1,4 +1,5 @@
 #include "globals.h"
+#include "jobs.h"
 #include "kx_radio.h"
 #include "timed_lock.h"
 #include "webserver.h"
@@ -6,8 +7,6 @@
 #include <cstdlib>
 #include <cstring>
 #include <esp_log.h>
-#include <freertos/FreeRTOS.h>
-#include <freertos/task.h>
 
 static const char * TAG8 = "sc:hdl_cat.";
 
@@ -119,46 +118,38 @@ esp_err_t handler_power_put (httpd_req_t * req) {
 }
 
 /**
- * Background task that actually transmits a CW keyer message. Spawned from the
- * httpd server task so the single httpd worker stays free to service status,
- * frequency, and mode polls during the prolonged on-air transmission.
+ * Job body that actually transmits a CW keyer message. Runs on the worker pool
+ * so the httpd server task stays free to service status, frequency, and mode
+ * polls during the prolonged on-air transmission.
  *
- * Ownership:
- * pvParameter is a heap-allocated, null-terminated message string
- * transferred from handler_keyer_put(); this task frees it.
- * The caller is also responsible for having claimed the keyer via
- * kxRadio.try_begin_keyer_operation(); this task releases the claim via
- * kxRadio.end_keyer_operation().
+ * The job argument is the null-terminated message, copied inline into the job.
+ * A keyer job cannot be interrupted once the radio is keying; cancelling it only
+ * takes effect while it is still queued.
  */
-static void keyer_task (void * pvParameter) {
-    char * message = (char *)pvParameter;
-
-    {
-        // Tier 3: critical timeout - keying can take up to ~15s for long messages.
-        TimedLock lock = kxRadio.timed_lock (RADIO_LOCK_TIMEOUT_CRITICAL_MS, "keyer task");
-        if (lock.acquired()) {
-            if (!kxRadio.send_keyer_message (message))
-                ESP_LOGE (TAG8, "keyer send failed for message '%s'", message);
-        }
-        else {
-            ESP_LOGE (TAG8, "keyer task could not acquire radio lock for '%s'", message);
-        }
-    }
-
-    kxRadio.end_keyer_operation();
-    free (message);
-    vTaskDelete (NULL);
+static bool keyer_job (job_t * job) {
+    const char * message = (const char *)job->arg;
+
+    // Tier 3: critical timeout - keying can take up to ~15s for long messages.
+    TimedLock lock = kxRadio.timed_lock (RADIO_LOCK_TIMEOUT_CRITICAL_MS, "keyer job");
+    if (!lock.acquired())
+        return job_fail (job, "radio busy");
+    if (job_is_cancel_requested (job))
+        return false;
+    job_set_progress (job, 10);
+
+    if (!kxRadio.send_keyer_message (message))
+        return job_fail (job, "keyer send failed");
+    return true;
 }
 
 /**
  * Handles an HTTP PUT request to send a Morse code message.
  *
- * The actual keying is dispatched to a background FreeRTOS task so that this
- * handler (and therefore the single httpd server task) returns immediately
- * and remains available to service status, frequency, and mode polls while
- * the transmission is on the air. handler_connectionStatus_get consults
- * kxRadio.is_keyer_active() to report 🔴 during this window without waiting
- * on the radio mutex.
+ * The actual keying always runs as a job (see keyer_job), so this handler returns
+ * immediately. Legacy clients get "204 No Content" once the job is accepted; clients
+ * sending "Prefer: respond-async" get "202 Accepted" with the job location so they can
+ * follow its progress. handler_connectionStatus_get consults job_is_active(JOB_KIND_KEYER)
+ * to report 🔴 during this window without waiting on the radio mutex.
  *
  * @param req Pointer to the HTTP request structure. The "message" query parameter
  *            is expected to hold the text to be transmitted in Morse code.
@@ -176,19 +167,21 @@ esp_err_t handler_keyer_put (httpd_req_t * req) {
     url_decode_in_place (param_value);
     ESP_LOGI (TAG8, "keying message '%s'", param_value);
 
-    if (!kxRadio.try_begin_keyer_operation())
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "keyer busy, please retry");
+    static_assert (STANDARD_PARAMETER_MAX_SIZE <= JOB_ARG_SIZE, "keyer message must fit in a job argument");
+    size_t message_size = strlen (param_value) + 1;
 
-    char * message_copy = strdup (param_value);
-    if (!message_copy) {
-        kxRadio.end_keyer_operation();
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "heap allocation failed");
-    }
+    if (client_prefers_async (req))
+        return start_job_and_reply (req, JOB_KIND_KEYER, keyer_job, nullptr, param_value, message_size);
 
-    if (xTaskCreate (&keyer_task, "keyer_task", 4096, message_copy, SC_TASK_PRIORITY_NORMAL, NULL) != pdPASS) {
-        free (message_copy);
-        kxRadio.end_keyer_operation();
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "failed to start keyer task");
+    uint32_t job_id = 0;
+    switch (job_start (JOB_KIND_KEYER, keyer_job, nullptr, param_value, message_size, &job_id)) {
+    case JOB_START_OK:
+        break;
+    case JOB_START_KIND_BUSY:
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "keyer busy, please retry");
+    case JOB_START_FULL:
+    default:
+        return reply_service_unavailable (req, 1, "keyer queue full, please retry");
     }
 
     REPLY_WITH_SUCCESS();
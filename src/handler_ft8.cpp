@@ -1,127 +1,169 @@
-#include "../lib/ft8_encoder/ft8/constants.h"
-#include "../lib/ft8_encoder/ft8/encode.h"
-#include "../lib/ft8_encoder/ft8/pack.h"
+#include "clock_sync.h"
+#include "fsk_engine.h"
 #include "globals.h"
 #include "hardware_specific.h"
 #include "idle_status_task.h"
+#include "jobs.h"
+#include "json_writer.h"
 #include "kx_radio.h"
 #include "timed_lock.h"
 #include "webserver.h"
 
-#include <cmath>
 #include <atomic>
 #include <cstdlib>
 #include <driver/gpio.h>
-#include <driver/uart.h>
 #include <esp_task_wdt.h>
 #include <esp_timer.h>
 #include <freertos/FreeRTOS.h>
-#include <freertos/queue.h>
-#include <freertos/semphr.h>
+#include <freertos/task.h>
 #include <cstdint>
 #include <cstring>
-#include <sys/time.h>
+#include <utility>
 
 // Thank-you to KI6SYD for providing key information about the Elecraft KX radios and for initial testing. - AB6D
 
 #include <esp_log.h>
 static const char * TAG8 = "sc:hdl_ft8.";
 
+constexpr size_t FT8_REQUEST_TOKEN_MAX = 64;
+
 /**
- * Holds the timestamp until which the radio should remain in FT8 mode. This variable is used as a watchdog timer;
- * if the system time surpasses this timestamp without any new FT8 activity, the system will automatically exit
- * FT8 mode and revert the radio to its previous state. The value is in microseconds since the Unix epoch.
+ * A transmission encoded for the tone timer: its tones, and the CAT command for every symbol, back to back,
+ * `toneCommandLength` bytes each. `encoded` is false until `tones` and `toneCommands` hold `transmission`.
  */
-static std::atomic<int64_t> CancelRadioFT8ModeTime {0};
+typedef struct
+{
+    fsk_transmission_t transmission;
+    bool               encoded;
+    uint8_t *          tones;
+    char *             toneCommands;
+    size_t             toneCommandLength;
+} ft8_encoded_t;
 
 /**
- * Indicates whether an FT8 transmission task is currently in progress. This boolean flag helps prevent the
- * initiation of multiple concurrent FT8 transmission tasks, ensuring that only one FT8 task operates at any
- * given time, thus avoiding conflicts or resource contention in radio usage.
+ * Everything the session task needs to transmit and to put the radio back afterwards:
+ * - `mode`: FT8, FT4 or WSPR; the engine's symbol count, timing and tone spacing.
+ * - `rfFreq`/`audioFreq`/`messageText`: the original prepare request payload used to detect identical prepare calls.
+ * - `first`: the transmission the session task starts with, set by /ft8 before it hands the session over.
+ * - `onAir`: the transmission being played, or about to be. The tone timer writes its commands to the UART as they are.
+ * - `next`: the following transmission from the queue, encoded while `onAir` plays so it can go out in the next slot.
+ * - `kx_state`: the radio's state before it was prepared, restored when the session ends.
+ * There is one, in static storage; the encoded buffers point into static arrays sized for the longest mode.
  */
-static std::atomic<bool> ft8TaskInProgress {false};
+typedef struct
+{
+    const fsk_mode_t * mode;
+    long               rfFreq;
+    int                audioFreq;
+    char               messageText[FSK_MESSAGE_MAX + 1];
+    fsk_transmission_t first;
+    ft8_encoded_t      onAir;
+    ft8_encoded_t      next;
+    bool               nextFailed;  // the queue's head couldn't be encoded; the sequence stops after onAir
+    kx_state_t         kx_state;
+} ft8_task_pack_t;
 
-static inline int64_t ft8_get_cancel_deadline_us () {
-    return CancelRadioFT8ModeTime.load (std::memory_order_acquire);
-}
+/**
+ * The lifecycle of an FT8 session. Only /prepareft8 (or the auto-prepare in /ft8) leaves `idle`, and
+ * only the session task enters `restoring`; the transitions out of `prepared` are compare-and-swaps,
+ * so a transmit request and the end of the session can't both win.
+ */
+enum class ft8_session_state_t
+{
+    idle,          // the radio is the user's
+    prepared,      // the radio is set up for FSK; waiting for /ft8 until the deadline
+    transmitting,  // the session task is waiting for a window, on the air, or sending the queue
+    restoring      // the session task is putting the radio back
+};
 
-static inline bool ft8_is_cancel_requested () {
-    return ft8_get_cancel_deadline_us() <= 1;
+/**
+ * The one FT8 session. The deadline timer and cancel requests notify the session task, which
+ * otherwise sleeps: it transmits when /ft8 moves the session to `transmitting`, and restores the
+ * radio once a prepared session is cancelled or outlives its deadline.
+ */
+typedef struct
+{
+    std::atomic<ft8_session_state_t> state;
+    std::atomic<bool>                cancelRequested;
+    std::atomic<int64_t>             deadlineUs;            // esp_timer time a prepared session ends, unless extended
+    std::atomic<uint32_t>            lastAcceptedSequence;  // of /ft8 requests in this session; 0 before the first
+    uint32_t                         requestTokenHash;      // of the prepare request; /ft8 must carry the same token
+    ft8_task_pack_t                  pack;
+    TaskHandle_t                     task;
+    esp_timer_handle_t               deadlineTimer;
+} ft8_session_t;
+
+static ft8_session_t ft8Session;
+static uint8_t       ft8Tones[2][FSK_MAX_SYMBOLS];
+static char          ft8ToneCommands[2][FSK_MAX_SYMBOLS * (FT8_TONE_COMMAND_MAX - 1)];
+bool                 Ft8RadioExclusive = false;
+
+static inline ft8_session_state_t ft8_get_state () {
+    return ft8Session.state.load (std::memory_order_acquire);
 }
 
-static inline void ft8_set_cancel_deadline_us (int64_t deadline_us) {
-    CancelRadioFT8ModeTime.store (deadline_us, std::memory_order_release);
+static inline bool ft8_transition (ft8_session_state_t from, ft8_session_state_t to) {
+    return ft8Session.state.compare_exchange_strong (from, to, std::memory_order_acq_rel, std::memory_order_acquire);
 }
 
-static inline void ft8_request_cancel () {
-    ft8_set_cancel_deadline_us (1);
+static inline bool ft8_is_cancel_requested () {
+    return ft8Session.cancelRequested.load (std::memory_order_acquire);
 }
 
-static inline void ft8_extend_cancel_deadline_us (int64_t deadline_us) {
-    int64_t current = ft8_get_cancel_deadline_us();
-    while (deadline_us > current &&
-           !CancelRadioFT8ModeTime.compare_exchange_weak (current, deadline_us, std::memory_order_acq_rel, std::memory_order_acquire)) {
-        // retry until the larger deadline wins
-    }
+static inline void ft8_notify_session () {
+    if (ft8Session.task)
+        xTaskNotifyGive (ft8Session.task);
 }
 
-static inline bool ft8_is_task_in_progress () {
-    return ft8TaskInProgress.load (std::memory_order_acquire);
+/**
+ * Ends the session as soon as possible: a transmission stops at once, and the radio is restored.
+ */
+static void ft8_request_cancel () {
+    if (ft8_get_state() == ft8_session_state_t::idle)
+        return;
+    ft8Session.cancelRequested.store (true, std::memory_order_release);
+    ft8_notify_session();
 }
 
-static inline void ft8_set_task_in_progress (bool in_progress) {
-    ft8TaskInProgress.store (in_progress, std::memory_order_release);
+static inline uint32_t ft8_get_last_accepted_sequence () {
+    return ft8Session.lastAcceptedSequence.load (std::memory_order_acquire);
 }
 
-static inline bool ft8_try_claim_task_in_progress () {
-    bool expected = false;
-    return ft8TaskInProgress.compare_exchange_strong (expected, true, std::memory_order_acq_rel, std::memory_order_acquire);
+static inline void ft8_set_last_accepted_sequence (uint32_t sequence_number) {
+    ft8Session.lastAcceptedSequence.store (sequence_number, std::memory_order_release);
 }
 
-constexpr size_t FT8_REQUEST_TOKEN_MAX = 64;
-
 /**
- * A pointer to an `ft8_task_pack_t` structure containing configuration information needed for the FT8 transmission.
- * This includes:
- * - `baseFreq`: the current transmit base frequency used by the tone scheduler.
- * - `rfFreq`/`audioFreq`/`messageText`: the original prepare request payload used to detect identical prepare calls.
- * - `tones` and `kx_state`: resources that are released by cleanup_ft8_task().
- * This pointer is initially set to NULL and is allocated when preparing for an FT8 transmission.
- * It must be properly managed to avoid memory leaks and is cleaned up after the transmission completes or is cancelled.
+ * Arms the one-shot deadline timer for the session's current deadline.
  */
-typedef struct
-{
-    long         baseFreq;
-    long         rfFreq;
-    int          audioFreq;
-    char         messageText[14];
-    uint8_t *    tones;
-    kx_state_t * kx_state;
-} ft8_task_pack_t;
-
-static std::atomic<ft8_task_pack_t *> ft8ConfigInfo {nullptr};
-bool                                  Ft8RadioExclusive = false;
-
-static inline ft8_task_pack_t * ft8_get_config_info () {
-    return ft8ConfigInfo.load (std::memory_order_acquire);
+static void ft8_arm_deadline_timer () {
+    int64_t remaining_us = ft8Session.deadlineUs.load (std::memory_order_acquire) - esp_timer_get_time();
+    esp_timer_stop (ft8Session.deadlineTimer);  // ESP_ERR_INVALID_STATE if it wasn't running
+    esp_timer_start_once (ft8Session.deadlineTimer, remaining_us > 0 ? remaining_us : 1);
 }
 
-static inline void ft8_set_config_info (ft8_task_pack_t * config) {
-    ft8ConfigInfo.store (config, std::memory_order_release);
+/**
+ * Deadline timer callback. A transmission is left alone, since a notification would cut its tone
+ * timer wait short; the session task looks at the deadline again when the transmission ends.
+ */
+static void ft8_deadline_timer_fired (void * arg) {
+    if (ft8_get_state() != ft8_session_state_t::transmitting)
+        ft8_notify_session();
 }
 
-static std::atomic<long>     ft8PreparedRfFreq {0};
-static std::atomic<int>      ft8PreparedAudioFreq {0};
-static std::atomic<uint32_t> ft8PreparedMessageHash {0};
-static std::atomic<uint32_t> ft8PreparedRequestTokenHash {0};
-static std::atomic<uint32_t> ft8LastAcceptedSequence {0};
-
-static inline uint32_t ft8_get_last_accepted_sequence () {
-    return ft8LastAcceptedSequence.load (std::memory_order_acquire);
+static void ft8_set_deadline_us (int64_t deadline_us) {
+    ft8Session.deadlineUs.store (deadline_us, std::memory_order_release);
+    ft8_arm_deadline_timer();
 }
 
-static inline void ft8_set_last_accepted_sequence (uint32_t sequence_number) {
-    ft8LastAcceptedSequence.store (sequence_number, std::memory_order_release);
+static void ft8_extend_deadline_us (int64_t deadline_us) {
+    int64_t current = ft8Session.deadlineUs.load (std::memory_order_acquire);
+    while (deadline_us > current &&
+           !ft8Session.deadlineUs.compare_exchange_weak (current, deadline_us, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        // retry until the larger deadline wins
+    }
+    if (deadline_us > current)
+        ft8_arm_deadline_timer();
 }
 
 static uint32_t ft8_hash_string (const char * text) {
@@ -146,406 +188,155 @@ static uint32_t ft8_hash_optional_string (const char * text) {
     return ft8_hash_string (text);
 }
 
-static void ft8_clear_prepare_identity ();
-
-constexpr size_t         FT8_QUEUE_MAX = 4;
-constexpr int64_t        FT8_QUEUE_WAIT_TIMEOUT_US = 2000LL * 1000LL;
-static long              ft8_queue[FT8_QUEUE_MAX];
-static size_t            ft8_queue_head  = 0;
-static size_t            ft8_queue_tail  = 0;
-static size_t            ft8_queue_count = 0;
-static SemaphoreHandle_t ft8_queue_mutex = nullptr;
-
-struct Ft8ToneEvent {
-    long frequency;
-};
-
-static QueueHandle_t      ft8_tone_queue  = nullptr;
-static esp_timer_handle_t ft8_tone_timer  = nullptr;
-static volatile size_t    ft8_tone_index  = 0;
-static volatile bool      ft8_tone_active = false;
-static ft8_task_pack_t *  ft8_tone_info   = nullptr;
-
-static void ft8_tone_timer_cb (void * arg) {
-    (void)arg;
-    if (!ft8_tone_active || !ft8_tone_info)
-        return;
-
-    size_t idx = ft8_tone_index;
-    if (idx >= FT8_NN)
-        return;
-
-    long         next_frequency = ft8_tone_info->baseFreq + (long)std::round (ft8_tone_info->tones[idx] * 6.25);
-    Ft8ToneEvent event          = {next_frequency};
-    if (xQueueSend (ft8_tone_queue, &event, 0) == pdTRUE) {
-        ft8_tone_index = idx + 1;
-    }
-    else {
-        // If we can't keep up with tone scheduling, abort the transmission
-        ft8_request_cancel();
-        ft8_tone_index         = FT8_NN;
-    }
-}
+constexpr int64_t FT8_QUEUE_WAIT_TIMEOUT_US = 2000LL * 1000LL;
 
-static void ft8_queue_init () {
-    if (!ft8_queue_mutex) {
-        ft8_queue_mutex = xSemaphoreCreateMutex();
+/**
+ * Encodes a transmission into a buffer, unless the buffer already holds the same message at the same
+ * base frequency. Only encodes and formats; the radio lock is not needed, but the tone timer must not be
+ * playing the buffer.
+ * @return false if the message can't be encoded in the pack's mode, or the radio can't tune to it.
+ */
+static bool ft8_encode_transmission (const ft8_task_pack_t * info, const fsk_transmission_t & transmission, ft8_encoded_t & out) {
+    bool same_tones = out.encoded && strcmp (out.transmission.message, transmission.message) == 0;
+    if (same_tones && out.transmission.base_freq == transmission.base_freq) {
+        out.transmission.slot_parity = transmission.slot_parity;
+        return true;
     }
-}
 
-static size_t ft8_queue_size () {
-    ft8_queue_init();
-    if (!ft8_queue_mutex)
-        return 0;
-
-    if (xSemaphoreTake (ft8_queue_mutex, pdMS_TO_TICKS (25)) != pdTRUE)
-        return 0;
-
-    size_t count = ft8_queue_count;
-    xSemaphoreGive (ft8_queue_mutex);
-    return count;
-}
-
-static bool ft8_queue_push (long base_freq) {
-    ft8_queue_init();
-    if (!ft8_queue_mutex)
-        return false;
-
-    if (xSemaphoreTake (ft8_queue_mutex, pdMS_TO_TICKS (100)) != pdTRUE)
-        return false;
-
-    if (ft8_queue_count >= FT8_QUEUE_MAX) {
-        xSemaphoreGive (ft8_queue_mutex);
+    out.encoded = false;
+    if (!same_tones && info->mode->encode (transmission.message, out.tones) < 0) {
+        ESP_LOGE (TAG8, "can't encode %s message '%s'", info->mode->name, transmission.message);
         return false;
     }
-
-    ft8_queue[ft8_queue_tail] = base_freq;
-    ft8_queue_tail            = (ft8_queue_tail + 1) % FT8_QUEUE_MAX;
-    ++ft8_queue_count;
-
-    xSemaphoreGive (ft8_queue_mutex);
-    return true;
-}
-
-static bool ft8_queue_pop (long & out_base_freq) {
-    ft8_queue_init();
-    if (!ft8_queue_mutex)
-        return false;
-
-    if (xSemaphoreTake (ft8_queue_mutex, pdMS_TO_TICKS (100)) != pdTRUE)
-        return false;
-
-    if (ft8_queue_count == 0) {
-        xSemaphoreGive (ft8_queue_mutex);
+    if (!fsk_build_tone_commands (info->mode, out.tones, transmission.base_freq, out.toneCommands, &out.toneCommandLength))
         return false;
-    }
-
-    out_base_freq  = ft8_queue[ft8_queue_head];
-    ft8_queue_head = (ft8_queue_head + 1) % FT8_QUEUE_MAX;
-    --ft8_queue_count;
-
-    xSemaphoreGive (ft8_queue_mutex);
-    return true;
-}
-
-static bool ft8_queue_pop_with_timeout (long & out_base_freq, int64_t wait_deadline_us) {
-    while (!ft8_queue_pop (out_base_freq)) {
-        if (esp_timer_get_time() >= wait_deadline_us) {
-            return false;
-        }
-        vTaskDelay (pdMS_TO_TICKS (100));
-    }
-    return true;
-}
-
-static bool ft8_queue_push_with_timeout (long base_freq, int64_t wait_deadline_us) {
-    while (!ft8_queue_push (base_freq)) {
-        if (esp_timer_get_time() >= wait_deadline_us) {
-            return false;
-        }
-        vTaskDelay (pdMS_TO_TICKS (100));
-    }
+    out.transmission = transmission;
+    out.encoded      = true;
     return true;
 }
 
-static void ft8_queue_clear () {
-    ft8_queue_init();
-    if (!ft8_queue_mutex)
-        return;
-
-    if (xSemaphoreTake (ft8_queue_mutex, pdMS_TO_TICKS (100)) != pdTRUE)
-        return;
-
-    ft8_queue_head  = 0;
-    ft8_queue_tail  = 0;
-    ft8_queue_count = 0;
-    xSemaphoreGive (ft8_queue_mutex);
-}
-
-/**
- * Calculates the number of milliseconds until the next FT8 transmission window.
- *
- * @return The number of milliseconds until the next 15-second boundary.
- */
-static long msUntilFT8Window () {
-    // Obtain the current time with microsecond precision
-    struct timeval tv_now;
-    gettimeofday (&tv_now, NULL);
-
-    // Convert current time to milliseconds using long long to avoid overflow
-    long long now_ms = (long long)(tv_now.tv_sec) * 1000LL + (tv_now.tv_usec / 1000LL);
-
-    // Calculate delay until the next 15-second boundary
-    long delay_ms = 15000 - (now_ms % 15000LL);
-    if (delay_ms == 15000)
-        delay_ms = 0;  // Adjust if already at boundary
-
-    return delay_ms;
-}
-
 /**
- * Waits for the FT8 transmission window using vTaskDelay to synchronize start time.
+ * Called by the tone engine while the current transmission plays: takes the next transmission from
+ * the queue, if any, and encodes it, so it is ready when the current slot ends.
  */
-static void waitForFT8Window () {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    long       delay_ms                       = msUntilFT8Window();
-    const long cancellation_check_interval_ms = 250;
-
-    // Wait for the next 15-second boundary to start the FT8 transmission
-
-    // Use vTaskDelay to wait for the calculated delay in ticks
-    // Note: pdMS_TO_TICKS converts milliseconds to ticks
-    while (delay_ms > 0) {
-        // If CancelRadioFT8ModeTime is <= 1, exit the function immediately
-        if (ft8_is_cancel_requested()) {
-            ESP_LOGI (TAG8, "CancelRadioFT8ModeTime triggered, returning early.");
-            return;
-        }
-
-        // Wait for the lesser of the remaining delay or the check interval
-        long wait_time = (delay_ms < cancellation_check_interval_ms) ? delay_ms : cancellation_check_interval_ms;
-
-        vTaskDelay (pdMS_TO_TICKS (wait_time));
-        ESP_ERROR_CHECK (esp_task_wdt_reset());
-
-        // Decrease the remaining delay
-        delay_ms -= wait_time;
-    }
+static void ft8_encode_next (void * arg) {
+    ft8_task_pack_t *  info = (ft8_task_pack_t *)arg;
+    fsk_transmission_t transmission;
+    if (info->next.encoded || info->nextFailed || !fsk_queue_pop (transmission))
+        return;
+    info->nextFailed = !ft8_encode_transmission (info, transmission, info->next);
 }
 
-#define EASE_STEPS 1
-
-/**
- * Transitions from a prior frequency to a new frequency smoothly over one or more steps.
- *
- * @param base_frequency The base frequency for the FT8 transmission. Needed for KH offset calculations.
- * @param prior_frequency The frequency at which the previous tone was sent.
- * @param frequency The target frequency for the current tone.
- * @param lastWakeTime The last recorded wake time, used for task delay calculations.
- * @param toneInterval The interval at which tones should be sent, in ticks.
- */
 /**
- * Task function to handle the FT8 transmission process.
+ * Transmits `info->first`, then every transmission queued in time for the following slot.
+ * Runs on the session task while the session is `transmitting`; a failure requests a cancel.
  *
- * @param pvParameter A pointer to the parameter provided when the task is created. Expected to be an `ft8_task_pack_t` struct.
+ * @param info The session's task pack.
  */
-static void xmit_ft8_task (void * pvParameter) {
+static void ft8_transmit (ft8_task_pack_t * info) {
     ESP_LOGV (TAG8, "trace: %s()", __func__);
-    bool wdt_registered = false;
-    bool timer_started  = false;
-    ft8_task_pack_t * info = (ft8_task_pack_t *)pvParameter;
-
-    if (info == NULL) {
-        ESP_LOGE (TAG8, "%s called with pvParameter == NULL", __func__);
-        ft8_set_task_in_progress (false);
-        vTaskDelete (NULL);
-        return;
-    }
-
-    ft8_set_task_in_progress (true);
 
     // this block encapsulates our exclusive access to the radio port
-    {
-        TimedLock lock = kxRadio.timed_lock (RADIO_LOCK_TIMEOUT_FT8_MS, "FT8 transmission");
-        if (!lock.acquired()) {
-            ESP_LOGE (TAG8, "Failed to acquire radio lock for FT8 transmission");
-            ft8_request_cancel();
-            ft8_queue_clear();
-            goto cleanup;
-        }
+    TimedLock lock = kxRadio.timed_lock (RADIO_LOCK_TIMEOUT_FT8_MS, "FT8 transmission");
+    if (!lock.acquired()) {
+        ESP_LOGE (TAG8, "Failed to acquire radio lock for FT8 transmission");
+        ft8_request_cancel();
+        fsk_queue_clear();
+        return;
+    }
 
-        // Register with watchdog timer after lock is acquired
-        ESP_ERROR_CHECK (esp_task_wdt_add (NULL));
-        wdt_registered = true;
+    // Register with watchdog timer after lock is acquired
+    ESP_ERROR_CHECK (esp_task_wdt_add (NULL));
+    fsk_set_transmitting (true);
 
-        ESP_LOGI (TAG8, "ft8 transmission starting--");
+    ESP_LOGI (TAG8, "%s transmission starting--", info->mode->name);
 
-        if (!ft8_tone_queue) {
-            ft8_tone_queue = xQueueCreate (4, sizeof (Ft8ToneEvent));
-            if (!ft8_tone_queue) {
-                ESP_LOGE (TAG8, "Failed to create FT8 tone queue");
-                goto cleanup;
-            }
-        }
+    // The prepared message is usually encoded already; another message or audio offset is encoded before the window, not in it
+    if (!ft8_encode_transmission (info, info->first, info->onAir)) {
+        ft8_request_cancel();
+        fsk_queue_clear();
+        fsk_set_transmitting (false);
+        esp_task_wdt_delete (NULL);
+        return;
+    }
+    info->next.encoded = false;
+    info->nextFailed   = false;
 
-        if (!ft8_tone_timer) {
-            const esp_timer_create_args_t timer_args = {
-                .callback              = &ft8_tone_timer_cb,
-                .arg                   = nullptr,
-                .dispatch_method       = ESP_TIMER_TASK,
-                .name                  = "ft8_tone",
-                .skip_unhandled_events = false,
-            };
-            if (esp_timer_create (&timer_args, &ft8_tone_timer) != ESP_OK) {
-                ESP_LOGE (TAG8, "Failed to create FT8 tone timer");
-                goto cleanup;
-            }
+    while (true) {
+        fsk_wait_for_window (info->mode, info->onAir.transmission.slot_parity, ft8_is_cancel_requested);
+        if (ft8_is_cancel_requested()) {
+            ESP_LOGI (TAG8, "FT8 transmit cancelled before window start");
+            fsk_queue_clear();
+            break;
         }
 
-        while (true) {
-            waitForFT8Window();
-            if (ft8_is_cancel_requested()) {
-                ESP_LOGI (TAG8, "FT8 transmit cancelled before window start");
-                ft8_queue_clear();
-                goto cleanup;
-            }
-
-            // Update the timer for when to cancel the radio FT8 mode
-            int64_t watchdogTime = esp_timer_get_time() + (15LL * 1000LL * 1000LL);  // 15 seconds from now, converted to microseconds
-            ft8_extend_cancel_deadline_us (watchdogTime);
-
-            int64_t startTime = esp_timer_get_time();  // Capture the current time to calculate the total time
-
-            // Reset watchdog before starting time-critical FT8 transmission
-            ESP_ERROR_CHECK (esp_task_wdt_reset());
+        // Keep the session prepared for one slot from now
+        ft8_extend_deadline_us (esp_timer_get_time() + (int64_t)info->mode->slot_ms * 1000LL);
 
-            // Tell the radio to turn on the CW tone
-            kxRadio.ft8_tone_on();
-
-            // Prepare timer-driven tone scheduling
-            (void)xQueueReset (ft8_tone_queue);
-            ft8_tone_info   = info;
-            ft8_tone_index  = 1;  // tone 0 is sent immediately
-            ft8_tone_active = true;
-
-            long first_frequency = info->baseFreq + (long)std::round (info->tones[0] * 6.25);
-            kxRadio.ft8_set_tone (info->baseFreq, first_frequency);
-
-            timer_started = (esp_timer_start_periodic (ft8_tone_timer, 160000) == ESP_OK);
-            if (!timer_started) {
-                ESP_LOGE (TAG8, "Failed to start FT8 tone timer");
-                ft8_request_cancel();
-            }
-
-            // Now tell the radio to play the remaining tones (1..78)
-            for (int j = 1; j < FT8_NN; ++j) {
-                if (ft8_is_cancel_requested())
-                    break;
-
-                Ft8ToneEvent event;
-                if (xQueueReceive (ft8_tone_queue, &event, pdMS_TO_TICKS (200)) != pdTRUE) {
-                    ESP_LOGW (TAG8, "FT8 tone queue timeout");
-                    ft8_request_cancel();
-                    break;
-                }
-
-                kxRadio.ft8_set_tone (info->baseFreq, event.frequency);
-                ESP_ERROR_CHECK (esp_task_wdt_reset());
-            }
+        int64_t startTime = esp_timer_get_time();  // Capture the current time to calculate the total time
 
-            if (timer_started) {
-                esp_timer_stop (ft8_tone_timer);
-                timer_started = false;
-            }
-            ft8_tone_active = false;
+        // Reset watchdog before starting time-critical FT8 transmission
+        ESP_ERROR_CHECK (esp_task_wdt_reset());
 
-            // Tell the radio to turn off the CW tone
-            kxRadio.ft8_tone_off();
+        // Tell the radio to turn on the CW tone, then play the precomputed tone commands,
+        // encoding the next queued transmission while they play
+        kxRadio.ft8_tone_on();
+        if (!fsk_play (info->mode, info->onAir.toneCommands, info->onAir.toneCommandLength, ft8_is_cancel_requested, ft8_encode_next, info))
+            ft8_request_cancel();
 
-            // Reset watchdog after completing time-critical FT8 transmission
-            ESP_ERROR_CHECK (esp_task_wdt_reset());
+        // Tell the radio to turn off the CW tone
+        kxRadio.ft8_tone_off();
 
-            // Stop the timer and calculate the total time
-            int64_t endTime   = esp_timer_get_time();
-            long    totalTime = (endTime - startTime) / 1000;  // Convert microseconds to milliseconds
-            ESP_LOGI (TAG8, "ft8 transmission time: %ld ms", totalTime);
+        // Reset watchdog after completing time-critical FT8 transmission
+        ESP_ERROR_CHECK (esp_task_wdt_reset());
 
-            if (ft8_is_cancel_requested()) {
-                ft8_queue_clear();
-                break;
-            }
+        // Stop the timer and calculate the total time
+        int64_t endTime   = esp_timer_get_time();
+        long    totalTime = (endTime - startTime) / 1000;  // Convert microseconds to milliseconds
+        ESP_LOGI (TAG8, "%s transmission time: %ld ms", info->mode->name, totalTime);
 
-            long next_base_freq = 0;
-            if (ft8_queue_pop (next_base_freq)) {
-                info->baseFreq = next_base_freq;
-                ESP_LOGI (TAG8, "queued FT8 transmit scheduled");
-                continue;
-            }
+        if (ft8_is_cancel_requested()) {
+            fsk_queue_clear();
+            break;
+        }
 
+        // A transmission queued after the slot started is encoded now, still ahead of the next window
+        ft8_encode_next (info);
+        if (info->nextFailed) {
+            ft8_request_cancel();
+            fsk_queue_clear();
             break;
         }
+        if (info->next.encoded) {
+            std::swap (info->onAir, info->next);
+            info->next.encoded = false;
+            ESP_LOGI (TAG8, "queued %s transmit scheduled: '%s'", info->mode->name, info->onAir.transmission.message);
+            continue;
+        }
+
+        break;
     }
-    // TimedLock auto-unlocks here
 
-    // Note that the cleanup will happen in the watchdog 'cleanup_ft8_task' function
-    ft8_set_task_in_progress (false);
     ESP_LOGI (TAG8, "--ft8 transmission completed.");
-    if (wdt_registered)
-        esp_task_wdt_delete (NULL);  // Unregister before deletion
-    vTaskDelete (NULL);
-    return;
-
-cleanup:
-    ft8_set_task_in_progress (false);
-    if (timer_started)
-        esp_timer_stop (ft8_tone_timer);
-    ft8_tone_active = false;
-    if (wdt_registered)
-        esp_task_wdt_delete (NULL);
-    vTaskDelete (NULL);
+    fsk_set_transmitting (false);
+    esp_task_wdt_delete (NULL);  // Unregister before the lock is released
 }
 
 /**
- * Task function to clean up after an FT8 transmission has ended.
- * Gets called 15 seconds after the FT8 transmission starts so that we can clean up.
- * This acts as a watchdog which can be reset when repeated FT8 transmissions are sent, but
- * a few seconds after the last transmission, the watchdog will trigger and clean up.
- *
- * @param pvParameter Unused parameter, expected to be NULL.
+ * Restores the radio's prior state (including TUN PWR) and returns the session to idle.
+ * Runs on the session task while the session is `restoring`.
  */
-static void cleanup_ft8_task (void * pvParameter) {
+static void ft8_restore_radio () {
     ESP_LOGV (TAG8, "trace: %s()", __func__);
 
     // Register with watchdog timer
     ESP_ERROR_CHECK (esp_task_wdt_add (NULL));
 
-    while (esp_timer_get_time() < ft8_get_cancel_deadline_us() ||
-           ft8_is_task_in_progress() ||
-           CommandInProgress.load (std::memory_order_acquire)) {
-        ESP_ERROR_CHECK (esp_task_wdt_reset());  // Reset watchdog during wait
-        vTaskDelay (pdMS_TO_TICKS (250));
-    }
-
-    ft8_set_cancel_deadline_us (0);
-    ft8_task_pack_t * configInfo = ft8_get_config_info();
-
-    if (configInfo == NULL) {
-        // This should never happen, but just in case...
-        ESP_LOGE (TAG8, "cleanup_ft8_task called with ft8ConfigInfo == NULL");
-        ft8_clear_prepare_identity();
-        Ft8RadioExclusive = false;
-        esp_task_wdt_delete (NULL);  // Unregister before deletion
-        vTaskDelete (NULL);
-        return;
-    }
-
-    // Restore the radio to its prior state (including TUN PWR)
     bool restored = false;
     int  attempts = 0;
     while (!restored) {
-        TimedLock lock2 = kxRadio.timed_lock (RADIO_LOCK_TIMEOUT_CRITICAL_MS, "FT8 cleanup");
-        if (!lock2.acquired()) {
+        TimedLock lock = kxRadio.timed_lock (RADIO_LOCK_TIMEOUT_CRITICAL_MS, "FT8 cleanup");
+        if (!lock.acquired()) {
             ++attempts;
             if (attempts % 4 == 0) {
                 ESP_LOGW (TAG8, "Still waiting for radio lock for FT8 cleanup");
@@ -556,23 +347,83 @@ static void cleanup_ft8_task (void * pvParameter) {
         }
 
         ESP_LOGI (TAG8, "Restoring radio state including TUN PWR to original settings");
-        kxRadio.restore_radio_state (configInfo->kx_state, 4);
+        kxRadio.restore_radio_state (&ft8Session.pack.kx_state, 4);
         restored = true;
         // TimedLock auto-unlocks here
     }
 
-    // Release ft8ConfigInfo
-    // Safe to free here: cleanup waits for ft8TaskInProgress to clear, so xmit no longer uses ft8ConfigInfo.
-    ft8_set_config_info (NULL);
-    ft8_clear_prepare_identity();
-    delete configInfo->kx_state;
-    delete[] configInfo->tones;
-    delete configInfo;
-
+    esp_timer_stop (ft8Session.deadlineTimer);
+    ft8Session.deadlineUs.store (0, std::memory_order_release);
+    ft8Session.cancelRequested.store (false, std::memory_order_release);
+    ft8Session.requestTokenHash = 0;
+    ft8_set_last_accepted_sequence (0);
     Ft8RadioExclusive = false;
-    ESP_LOGI (TAG8, "cleanup_ft8_task() completed.");
-    esp_task_wdt_delete (NULL);  // Unregister before deletion
-    vTaskDelete (NULL);
+    ft8Session.state.store (ft8_session_state_t::idle, std::memory_order_release);
+
+    ESP_LOGI (TAG8, "FT8 session ended.");
+    esp_task_wdt_delete (NULL);  // Unregister before going back to sleep
+}
+
+/**
+ * The session task: sleeps until notified by /ft8, a cancel or the deadline timer, then moves the
+ * session along. It lives as long as the device, so a session costs no task creation.
+ *
+ * @param pvParameter Unused parameter, expected to be NULL.
+ */
+static void ft8_session_task (void * pvParameter) {
+    while (true) {
+        (void)ulTaskNotifyTake (pdTRUE, portMAX_DELAY);
+
+        if (ft8_get_state() == ft8_session_state_t::transmitting) {
+            ft8_transmit (&ft8Session.pack);
+            ft8_transition (ft8_session_state_t::transmitting, ft8_session_state_t::prepared);
+        }
+        if (ft8_get_state() != ft8_session_state_t::prepared)
+            continue;
+
+        // Woken early, or by a timer armed before the deadline moved: sleep until the new one
+        if (!ft8_is_cancel_requested() && esp_timer_get_time() < ft8Session.deadlineUs.load (std::memory_order_acquire)) {
+            ft8_arm_deadline_timer();
+            continue;
+        }
+        if (ft8_transition (ft8_session_state_t::prepared, ft8_session_state_t::restoring))
+            ft8_restore_radio();
+    }
+}
+
+/**
+ * Creates the session task and the deadline timer the first time a session is prepared.
+ * @return false if either can't be created.
+ */
+static bool ft8_start_session_task () {
+    if (ft8Session.task)
+        return true;
+
+    if (!ft8Session.deadlineTimer) {
+        const esp_timer_create_args_t timer_args = {
+            .callback              = ft8_deadline_timer_fired,
+            .arg                   = nullptr,
+            .dispatch_method       = ESP_TIMER_TASK,
+            .name                  = "ft8_deadline",
+            .skip_unhandled_events = true};
+        if (esp_timer_create (&timer_args, &ft8Session.deadlineTimer) != ESP_OK) {
+            ESP_LOGE (TAG8, "Failed to create the FT8 deadline timer");
+            ft8Session.deadlineTimer = nullptr;
+            return false;
+        }
+    }
+
+    ft8Session.pack.onAir.tones        = ft8Tones[0];
+    ft8Session.pack.onAir.toneCommands = ft8ToneCommands[0];
+    ft8Session.pack.next.tones         = ft8Tones[1];
+    ft8Session.pack.next.toneCommands  = ft8ToneCommands[1];
+
+    if (xTaskCreate (&ft8_session_task, "ft8_session_task", 8192, NULL, SC_TASK_PRIORITY_HIGHEST, &ft8Session.task) != pdPASS) {
+        ESP_LOGE (TAG8, "Failed to create the FT8 session task");
+        ft8Session.task = nullptr;
+        return false;
+    }
+    return true;
 }
 
 /**
@@ -581,64 +432,45 @@ static void cleanup_ft8_task (void * pvParameter) {
  */
 typedef struct
 {
-    char    messageText[64];
-    char    requestToken[FT8_REQUEST_TOKEN_MAX];
-    int64_t nowTimeUTCms;
-    long    rfFreq;
-    int     audioFreq;
+    const fsk_mode_t * mode;
+    char               messageText[64];
+    char               requestToken[FT8_REQUEST_TOKEN_MAX];
+    int64_t            nowTimeUTCms;
+    long               rfFreq;
+    int                audioFreq;
 } ft8_prepare_request_t;
 
-static void ft8_clear_prepare_identity () {
-    ft8PreparedRfFreq.store (0, std::memory_order_release);
-    ft8PreparedAudioFreq.store (0, std::memory_order_release);
-    ft8PreparedMessageHash.store (0, std::memory_order_release);
-    ft8PreparedRequestTokenHash.store (0, std::memory_order_release);
-    ft8_set_last_accepted_sequence (0);
-}
-
-static void ft8_record_prepare_identity (const ft8_prepare_request_t & request) {
-    ft8PreparedRfFreq.store (request.rfFreq, std::memory_order_release);
-    ft8PreparedAudioFreq.store (request.audioFreq, std::memory_order_release);
-    ft8PreparedMessageHash.store (ft8_hash_string (request.messageText), std::memory_order_release);
-    ft8PreparedRequestTokenHash.store (ft8_hash_optional_string (request.requestToken), std::memory_order_release);
-}
-
+/**
+ * @return true if a prepared session was prepared by the same request, so preparing again can
+ * just extend its deadline.
+ */
 static bool ft8_is_same_prepare_request (const ft8_prepare_request_t & request) {
-    if (ft8PreparedRfFreq.load (std::memory_order_acquire) != request.rfFreq) {
+    const ft8_task_pack_t & prepared = ft8Session.pack;
+    if (prepared.mode != request.mode || prepared.rfFreq != request.rfFreq || prepared.audioFreq != request.audioFreq) {
         return false;
     }
-    if (ft8PreparedAudioFreq.load (std::memory_order_acquire) != request.audioFreq) {
+    if (strcmp (prepared.messageText, request.messageText) != 0) {
         return false;
     }
-    if (ft8PreparedMessageHash.load (std::memory_order_acquire) != ft8_hash_string (request.messageText)) {
-        return false;
-    }
-
-    uint32_t prepared_token_hash = ft8PreparedRequestTokenHash.load (std::memory_order_acquire);
-    uint32_t request_token_hash  = ft8_hash_optional_string (request.requestToken);
-    if (prepared_token_hash != 0 || request_token_hash != 0) {
-        return prepared_token_hash == request_token_hash;
-    }
-
-    return true;
+    return ft8Session.requestTokenHash == ft8_hash_optional_string (request.requestToken);
 }
 
-static uint32_t ft8_parse_request_token_hash_from_query (const char * unsafe_buf) {
+static uint32_t ft8_parse_request_token_hash_from_query (const request_query_t & query) {
     char request_token[FT8_REQUEST_TOKEN_MAX];
     request_token[0] = '\0';
 
-    if (httpd_query_key_value (unsafe_buf, "requestToken", request_token, sizeof (request_token)) == ESP_OK) {
+    if (request_query_copy (query, "requestToken", request_token, sizeof (request_token)) == ESP_OK) {
         (void)url_decode_in_place (request_token);
     }
 
     return ft8_hash_optional_string (request_token);
 }
 
-static bool ft8_parse_sequence_number_from_query (const char * unsafe_buf, uint32_t & out_sequence_number) {
+static bool ft8_parse_sequence_number_from_query (const request_query_t & query, uint32_t & out_sequence_number) {
     char sequence_number_str[16];
     sequence_number_str[0] = '\0';
 
-    if (httpd_query_key_value (unsafe_buf, "sequenceNumber", sequence_number_str, sizeof (sequence_number_str)) != ESP_OK) {
+    if (request_query_copy (query, "sequenceNumber", sequence_number_str, sizeof (sequence_number_str)) != ESP_OK) {
         return false;
     }
 
@@ -652,6 +484,44 @@ static bool ft8_parse_sequence_number_from_query (const char * unsafe_buf, uint3
     return true;
 }
 
+/**
+ * Parse the transmission an /ft8 request asks for: 'rfFrequency' plus 'audioFrequency', and the optional
+ * 'messageText' and 'slot' ("even" or "odd"). Without 'messageText' the message is left empty, meaning
+ * the prepared one.
+ */
+static bool ft8_parse_transmission_from_query (const request_query_t & query, fsk_transmission_t & out) {
+    char rfFreq_str[32];
+    long rfFreq = 0;
+    char audioFreq_str[16];
+    int  audioFreq = 0;
+    char slot_str[8];
+
+    if (!(request_query_copy (query, "rfFrequency", rfFreq_str, sizeof (rfFreq_str)) == ESP_OK &&
+          (rfFreq = atol (rfFreq_str)) > 0 &&
+          request_query_copy (query, "audioFrequency", audioFreq_str, sizeof (audioFreq_str)) == ESP_OK &&
+          (audioFreq = atoi (audioFreq_str)) > 0)) {
+        return false;
+    }
+    out.base_freq = rfFreq + audioFreq;
+
+    out.message[0] = '\0';
+    if (request_query_copy (query, "messageText", out.message, sizeof (out.message)) == ESP_OK &&
+        !url_decode_in_place (out.message)) {
+        return false;
+    }
+
+    out.slot_parity = FSK_SLOT_ANY;
+    if (request_query_copy (query, "slot", slot_str, sizeof (slot_str)) == ESP_OK) {
+        if (strcmp (slot_str, "even") == 0)
+            out.slot_parity = 0;
+        else if (strcmp (slot_str, "odd") == 0)
+            out.slot_parity = 1;
+        else
+            return false;
+    }
+    return true;
+}
+
 enum class ft8_sequence_decision_t
 {
     accept,
@@ -681,35 +551,43 @@ static ft8_sequence_decision_t ft8_classify_sequence_number (uint32_t requested_
 }
 
 /**
- * Parse and validate all query parameters required for FT8 preparation.
+ * Parse and validate all query parameters required for FT8 preparation. The optional 'mode'
+ * parameter selects FT4 or WSPR instead.
  */
-static bool ft8_parse_prepare_request_from_query (const char * unsafe_buf, ft8_prepare_request_t & out) {
+static bool ft8_parse_prepare_request_from_query (const request_query_t & query, ft8_prepare_request_t & out) {
+    char   mode_str[8];
     char   nowTimeUTCms_str[64];
     char   rfFreq_str[32];
     char   audioFreq_str[16];
     char * timeStringEndChar = NULL;
 
+    out.mode = fsk_default_mode();
+    if (request_query_copy (query, "mode", mode_str, sizeof (mode_str)) == ESP_OK &&
+        !(out.mode = fsk_find_mode (mode_str))) {
+        return false;
+    }
+
     out.nowTimeUTCms = 0;
     out.rfFreq       = 0;
     out.audioFreq    = 0;
     out.messageText[0] = '\0';
     out.requestToken[0] = '\0';
 
-    if (httpd_query_key_value (unsafe_buf, "requestToken", out.requestToken, sizeof (out.requestToken)) == ESP_OK) {
+    if (request_query_copy (query, "requestToken", out.requestToken, sizeof (out.requestToken)) == ESP_OK) {
         (void)url_decode_in_place (out.requestToken);
     }
     if (out.requestToken[0] == '\0') {
         return false;
     }
 
-    if (!(httpd_query_key_value (unsafe_buf, "messageText", out.messageText, sizeof (out.messageText)) == ESP_OK &&
+    if (!(request_query_copy (query, "messageText", out.messageText, sizeof (out.messageText)) == ESP_OK &&
           url_decode_in_place (out.messageText) &&
-          strnlen (out.messageText, sizeof (out.messageText)) <= 13 &&
-          httpd_query_key_value (unsafe_buf, "timeNow", nowTimeUTCms_str, sizeof (nowTimeUTCms_str)) == ESP_OK &&
+          strnlen (out.messageText, sizeof (out.messageText)) <= out.mode->max_message_chars &&
+          request_query_copy (query, "timeNow", nowTimeUTCms_str, sizeof (nowTimeUTCms_str)) == ESP_OK &&
           (out.nowTimeUTCms = strtoll (nowTimeUTCms_str, &timeStringEndChar, 10)) > 0 &&
-          httpd_query_key_value (unsafe_buf, "rfFrequency", rfFreq_str, sizeof (rfFreq_str)) == ESP_OK &&
+          request_query_copy (query, "rfFrequency", rfFreq_str, sizeof (rfFreq_str)) == ESP_OK &&
           (out.rfFreq = atol (rfFreq_str)) > 0 &&
-          httpd_query_key_value (unsafe_buf, "audioFrequency", audioFreq_str, sizeof (audioFreq_str)) == ESP_OK &&
+          request_query_copy (query, "audioFrequency", audioFreq_str, sizeof (audioFreq_str)) == ESP_OK &&
           (out.audioFreq = atoi (audioFreq_str)) > 0)) {
         return false;
     }
@@ -717,113 +595,152 @@ static bool ft8_parse_prepare_request_from_query (const char * unsafe_buf, ft8_p
     return true;
 }
 
-static void ft8_extend_prepare_deadline () {
+static void ft8_extend_prepare_deadline (const fsk_mode_t * mode) {
     // We have prepared the radio to send FT8, but we don't know if the user will
     // cancel or send FT8. Ensure we keep the radio prepared long enough for the
     // next transmit request, even if prepare happens close to a window boundary.
     int64_t now_us              = esp_timer_get_time();
-    int64_t next_window_timeout = now_us + ((msUntilFT8Window() + 1000) * 1000LL);
+    int64_t next_window_timeout = now_us + ((fsk_ms_until_window (mode) + 1000) * 1000LL);
     int64_t min_prepare_timeout = now_us + (20LL * 1000LL * 1000LL);
-    ft8_set_cancel_deadline_us ((next_window_timeout > min_prepare_timeout) ? next_window_timeout : min_prepare_timeout);
+    ft8_set_deadline_us ((next_window_timeout > min_prepare_timeout) ? next_window_timeout : min_prepare_timeout);
 }
 
+/**
+ * Prepares an idle session: encodes the message, saves the radio's state and sets the radio up for
+ * FSK. Callers hold CommandInProgress, so only one prepare runs at a time.
+ */
 static bool ft8_prepare_internal (const ft8_prepare_request_t & request, const char ** error_message) {
-    // Set the system clock based on the time received from the phone
-    struct timeval nowTimeUTC;
-    nowTimeUTC.tv_sec  = request.nowTimeUTCms / 1000;
-    nowTimeUTC.tv_usec = (request.nowTimeUTCms % 1000) * 1000;
+    if (ft8_get_state() != ft8_session_state_t::idle) {
+        *error_message = "ft8 already prepared";
+        return false;
+    }
+    if (!ft8_start_session_task()) {
+        *error_message = "failed to start FT8 session";
+        return false;
+    }
+
+    // Set the clock to the time received from the phone, unless round trips to /clock have
+    // already disciplined it better than a timestamp of unknown HTTP latency can
+    clock_sync_set_coarse (request.nowTimeUTCms);
 
     // Resetting system time can make inactivity logic think we jumped forward, so
     // refresh the activity timer immediately after applying the phone timestamp.
-    // Set the system's clock to the time received from the cell phone
-    settimeofday (&nowTimeUTC, NULL);
 
     // Reset the activity timer to prevent idle watchdog from triggering
     resetActivityTimer();
 
-    // First, pack the text data into an FT8 binary message
-    uint8_t packed[FTX_LDPC_K_BYTES];
-    int     rc = pack77 (request.messageText, packed);
-    if (rc < 0) {
-        *error_message = "can't parse FT8 message";
+    // Encode the message as a sequence of FSK tones, and build the radio's command for every tone,
+    // so transmitting is only a matter of timing. The second buffer takes the next queued message.
+    const fsk_mode_t * mode       = request.mode;
+    ft8_task_pack_t *  configInfo = &ft8Session.pack;
+    configInfo->mode              = mode;
+    configInfo->rfFreq            = request.rfFreq;
+    configInfo->audioFreq         = request.audioFreq;
+    strlcpy (configInfo->messageText, request.messageText, sizeof (configInfo->messageText));
+    configInfo->onAir.encoded = false;
+    configInfo->next.encoded  = false;
+    configInfo->nextFailed    = false;
+
+    strlcpy (configInfo->first.message, request.messageText, sizeof (configInfo->first.message));
+    configInfo->first.base_freq   = request.rfFreq + request.audioFreq;
+    configInfo->first.slot_parity = FSK_SLOT_ANY;
+    if (mode->encode (request.messageText, configInfo->onAir.tones) < 0) {
+        *error_message = mode == fsk_default_mode() ? "can't parse FT8 message" : "can't parse message for this mode";
         return false;
     }
-
-    // Second, encode the binary message as a sequence of FSK tones
-    uint8_t * tones = new uint8_t[FT8_NN];  // Array of 79 tones (symbols)
-    if (tones == NULL) {
-        *error_message = "can't allocate memory for FT8 tones";
+    if (!fsk_build_tone_commands (mode, configInfo->onAir.tones, configInfo->first.base_freq, configInfo->onAir.toneCommands, &configInfo->onAir.toneCommandLength)) {
+        *error_message = "can't build FT8 tone commands for this radio";
         return false;
     }
-
-    ft8_encode (packed, tones);
+    configInfo->onAir.transmission = configInfo->first;
+    configInfo->onAir.encoded      = true;
 
     // this block encapsulates our exclusive access to the radio port
     {
         TimedLock lock = kxRadio.timed_lock (RADIO_LOCK_TIMEOUT_CRITICAL_MS, "FT8 setup");
         if (!lock.acquired()) {
-            delete[] tones;
             *error_message = "radio busy, please retry";
             return false;
         }
 
         // First capture the current state of the radio before changing it:
-        kx_state_t * kx_state = new kx_state_t;
-        if (!kxRadio.get_radio_state (kx_state)) {
-            delete kx_state;
-            delete[] tones;
+        if (!kxRadio.get_radio_state (&configInfo->kx_state)) {
             *error_message = "failed to read radio state";
             return false;
         }
 
         // Prepare the radio to send the FT8 FSK tones using CW tone with proper power setting.
-        long baseFreq = request.rfFreq + request.audioFreq;
-
-        if (!kxRadio.ft8_prepare (baseFreq)) {
-            kxRadio.restore_radio_state (kx_state, 2);
-            delete kx_state;
-            delete[] tones;
+        if (!kxRadio.ft8_prepare (configInfo->first.base_freq)) {
+            kxRadio.restore_radio_state (&configInfo->kx_state, 2);
             Ft8RadioExclusive = false;
             *error_message    = "failed to prepare radio for ft8";
             return false;
         }
 
-        // Offload playing the FT8 audio
-        ft8_task_pack_t * configInfo = new ft8_task_pack_t;
-        configInfo->baseFreq         = baseFreq;
-        configInfo->rfFreq           = request.rfFreq;
-        configInfo->audioFreq        = request.audioFreq;
-        strlcpy (configInfo->messageText, request.messageText, sizeof (configInfo->messageText));
-        configInfo->tones            = tones;
-        configInfo->kx_state         = kx_state;  // will be deleted later in cleanup
-        ft8_set_config_info (configInfo);
-        ft8_record_prepare_identity (request);
+        ft8Session.requestTokenHash = ft8_hash_optional_string (request.requestToken);
+        ft8_set_last_accepted_sequence (0);
+        ft8Session.cancelRequested.store (false, std::memory_order_release);
         Ft8RadioExclusive = true;
     }  // TimedLock auto-unlocks here
 
-    ft8_extend_prepare_deadline();
-
-    // Start the cleanup watchdog now. It owns teardown of ft8ConfigInfo and radio
-    // state restoration after cancel deadline expiry and/or task completion.
-    xTaskCreate (&cleanup_ft8_task, "cleanup_ft8_task", 5120, NULL, SC_TASK_PRIORITY_NORMAL, NULL);
+    // The deadline timer now owns the end of the session: the session task restores the radio
+    // when it fires, unless /ft8 or another prepare has moved the deadline on
+    ft8_extend_prepare_deadline (request.mode);
+    ft8Session.state.store (ft8_session_state_t::prepared, std::memory_order_release);
     return true;
 }
 
+/**
+ * Job body for an asynchronous /prepareft8. The handler hands over its claim on
+ * CommandInProgress (and the busy LED); this job releases both when it finishes.
+ */
+static bool ft8_prepare_job (job_t * job) {
+    const ft8_prepare_request_t * request = (const ft8_prepare_request_t *)job->arg;
+
+    const char * prepare_error = NULL;
+    bool         prepared      = !job_is_cancel_requested (job) && ft8_prepare_internal (*request, &prepare_error);
+
+    // A cancel that raced with the radio setup must win over the deadline that
+    // ft8_prepare_internal() just extended; the session task restores the radio.
+    if (prepared && job_is_cancel_requested (job))
+        ft8_request_cancel();
+
+    gpio_set_level (LED_BLUE, LED_OFF);
+    CommandInProgress.store (false, std::memory_order_release);
+
+    if (!prepared && prepare_error)
+        return job_fail (job, prepare_error);
+    return prepared;
+}
+
+/**
+ * Cancel hook for a running FT8 prepare job: asks the session task to restore the radio.
+ */
+static void ft8_prepare_job_cancel (job_t * job) {
+    ft8_request_cancel();
+}
+
 /**
  * HTTP request handler to prepare the radio and system for an FT8 transmission.
+ * With "Prefer: respond-async" the radio setup runs as a job and the reply is 202
+ * with its location; poll the job before calling /ft8.
  *
  * @param req A pointer to the HTTP request.
  *            expects the following parameters in the URL query string:
  *            - 'messageText': The text message to be encoded into the FT8 format. This text is then converted
  *              into a sequence of audio tones for transmission.
  *            - 'timeNow': The current time in milliseconds since epoch. This time is used to synchronize the
- *              system's clock for timing the FT8 transmission accurately.
+ *              system's clock for timing the FT8 transmission, unless /clock round trips have already
+ *              disciplined it to within CLOCK_SYNC_TRUSTED_US.
  *            - 'rfFrequency': The radio frequency (in Hz) at which the base radio signal should be set. This
  *              frequency is used to calculate the actual transmission frequency by adding the audio frequency.
  *            - 'audioFrequency': The frequency offset (in Hz) added to the 'rfFrequency' to derive the actual
  *              transmission frequency. This offset represents the audio tone frequency in the FT8 signal.
  *            - 'requestToken': A workflow token generated by the client to correlate retries and
  *              reject stale requests from previous sessions.
+ *            - 'mode' (optional): "ft8" (the default), "ft4" or "wspr". A WSPR 'messageText' is
+ *              "CALL GRID DBM", e.g. "K1ABC FN42 37". WSPR is refused with 400 on radios
+ *              that tune only in whole hertz, which is all of them for now.
  *
  * @return ESP_OK on success or ESP_FAIL on failure.
  */
@@ -853,18 +770,22 @@ esp_err_t handler_prepareft8_post (httpd_req_t * req) {
     // Keep CommandInProgress from getting stuck true on any early return from
     // this handler, including REPLY_WITH_FAILURE paths inside STANDARD_DECODE_QUERY.
 
-    STANDARD_DECODE_QUERY (req, unsafe_buf);
+    STANDARD_DECODE_QUERY (req, query);
     gpio_set_level (LED_BLUE, LED_ON);  // LED on
 
     ft8_prepare_request_t request;
-    if (!ft8_parse_prepare_request_from_query (unsafe_buf, request)) {
+    if (!ft8_parse_prepare_request_from_query (query, request)) {
         gpio_set_level (LED_BLUE, LED_OFF);
         REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "parameter parsing error");
     }
+    if (request.mode->sub_hz_tones && !kxRadio.supports_sub_hz_tuning()) {
+        gpio_set_level (LED_BLUE, LED_OFF);
+        REPLY_WITH_FAILURE (req, HTTPD_400_BAD_REQUEST, "this radio tunes in whole hertz, too coarse for WSPR tones");
+    }
 
-    ft8_task_pack_t * existingConfig = ft8_get_config_info();
-    if (existingConfig != NULL) {
-        if (ft8_get_cancel_deadline_us() <= 0) {
+    ft8_session_state_t state = ft8_get_state();
+    if (state != ft8_session_state_t::idle) {
+        if (state == ft8_session_state_t::restoring || ft8_is_cancel_requested()) {
             gpio_set_level (LED_BLUE, LED_OFF);
             REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "ft8 cleanup in progress");
         }
@@ -873,7 +794,7 @@ esp_err_t handler_prepareft8_post (httpd_req_t * req) {
         // FT8 remains prepared, just extend the deadline instead of re-encoding tones
         // and reconfiguring the radio.
         if (ft8_is_same_prepare_request (request)) {
-            ft8_extend_prepare_deadline();
+            ft8_extend_prepare_deadline (request.mode);
             gpio_set_level (LED_BLUE, LED_OFF);
             CommandInProgress.store (false, std::memory_order_release);
             commandGuard.dismiss();
@@ -884,6 +805,16 @@ esp_err_t handler_prepareft8_post (httpd_req_t * req) {
         REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "ft8 already prepared with different parameters");
     }
 
+    if (client_prefers_async (req)) {
+        static_assert (sizeof (ft8_prepare_request_t) <= JOB_ARG_SIZE, "prepare request must fit in a job argument");
+        esp_err_t result = start_job_and_reply (req, JOB_KIND_FT8_PREPARE, ft8_prepare_job, ft8_prepare_job_cancel, &request, sizeof (request));
+        if (result == ESP_OK)
+            commandGuard.dismiss();  // ownership of CommandInProgress passes to ft8_prepare_job
+        else
+            gpio_set_level (LED_BLUE, LED_OFF);
+        return result;
+    }
+
     const char * prepare_error = NULL;
     if (!ft8_prepare_internal (request, &prepare_error)) {
         gpio_set_level (LED_BLUE, LED_OFF);
@@ -898,11 +829,16 @@ esp_err_t handler_prepareft8_post (httpd_req_t * req) {
 }
 
 /**
- * HTTP request handler to initiate the FT8 transmission.
+ * HTTP request handler to initiate the FT8 transmission. Requests made while one is in progress
+ * are queued, and each queued transmission is encoded while the one before it is on the air, so
+ * a sequence such as CQ, report, RR73 goes out in consecutive slots without preparing the radio again.
  *
  * @param req A pointer to the HTTP request structure. Query parameters
  *            'rfFrequency' and 'audioFrequency' are used to compute the base
  *            transmission frequency and proper encoding of the FT8 signal.
+ *            'messageText' (optional) is the message to send; the prepared message by default.
+ *            'slot' (optional) is "even" or "odd" to send only in those slots (FT8 :00/:30 or :15/:45);
+ *            by default the next slot.
  *            'sequenceNumber' identifies the repeat within a workflow so retries
  *            can be handled idempotently.
  *            'requestToken' binds the request to a specific workflow session.
@@ -913,35 +849,25 @@ esp_err_t handler_ft8_post (httpd_req_t * req) {
 
     ESP_LOGV (TAG8, "trace: %s()", __func__);
 
-    STANDARD_DECODE_QUERY (req, unsafe_buf);
-
-    char rfFreq_str[32];
-    long rfFreq = 0;
-    char audioFreq_str[16];
-    int  audioFreq = 0;
+    STANDARD_DECODE_QUERY (req, query);
 
-    // Parse the 'messageText' parameter from the query
-    if (!(httpd_query_key_value (unsafe_buf, "rfFrequency", rfFreq_str, sizeof (rfFreq_str)) == ESP_OK &&
-          (rfFreq = atol (rfFreq_str)) > 0 &&
-          httpd_query_key_value (unsafe_buf, "audioFrequency", audioFreq_str, sizeof (audioFreq_str)) == ESP_OK &&
-          (audioFreq = atoi (audioFreq_str)) > 0)) {
+    fsk_transmission_t transmission;
+    if (!ft8_parse_transmission_from_query (query, transmission)) {
         CommandInProgress.store (false, std::memory_order_release);
         REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "parameter parsing error");
     }
-
-    long baseFreq = rfFreq + audioFreq;
-    uint32_t request_token_hash = ft8_parse_request_token_hash_from_query (unsafe_buf);
+    uint32_t request_token_hash = ft8_parse_request_token_hash_from_query (query);
     if (request_token_hash == 0) {
         CommandInProgress.store (false, std::memory_order_release);
         REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "missing or invalid requestToken");
     }
     uint32_t sequence_number    = 0;
-    if (!ft8_parse_sequence_number_from_query (unsafe_buf, sequence_number)) {
+    if (!ft8_parse_sequence_number_from_query (query, sequence_number)) {
         CommandInProgress.store (false, std::memory_order_release);
         REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "missing or invalid sequenceNumber");
     }
 
-    if (!ft8_is_task_in_progress() && ft8_get_cancel_deadline_us() <= 0 && ft8_get_config_info() == NULL) {
+    if (ft8_get_state() == ft8_session_state_t::idle) {
         // Nobody has called /prepareft8 yet; prepare internally without sending a nested HTTP response.
         bool expected_command = false;
         if (!CommandInProgress.compare_exchange_strong (expected_command, true, std::memory_order_acq_rel, std::memory_order_acquire)) {
@@ -962,7 +888,7 @@ esp_err_t handler_ft8_post (httpd_req_t * req) {
         } commandGuard (&CommandInProgress);
 
         ft8_prepare_request_t request;
-        if (!ft8_parse_prepare_request_from_query (unsafe_buf, request)) {
+        if (!ft8_parse_prepare_request_from_query (query, request)) {
             REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "parameter parsing error");
         }
 
@@ -981,7 +907,7 @@ esp_err_t handler_ft8_post (httpd_req_t * req) {
 
     // If the radio was prepared with a client token, only allow /ft8 requests from
     // that same workflow to guard against stale delayed packets.
-    uint32_t prepared_token_hash = ft8PreparedRequestTokenHash.load (std::memory_order_acquire);
+    uint32_t prepared_token_hash = ft8Session.requestTokenHash;
     if (prepared_token_hash != 0 && request_token_hash != prepared_token_hash) {
         CommandInProgress.store (false, std::memory_order_release);
         REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "ft8 request token mismatch");
@@ -1004,40 +930,37 @@ esp_err_t handler_ft8_post (httpd_req_t * req) {
     }
 
     // If cleanup is in progress, do not try to transmit with stale state.
-    if (ft8_get_cancel_deadline_us() <= 0 && ft8_get_config_info() != NULL) {
+    ft8_session_state_t state = ft8_get_state();
+    if (state == ft8_session_state_t::restoring || ft8_is_cancel_requested()) {
         CommandInProgress.store (false, std::memory_order_release);
         REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "ft8 cleanup in progress");
     }
-
-    if (ft8_get_config_info() == NULL) {
-        ft8_queue_clear();
-        ft8_set_task_in_progress (false);
+    if (state == ft8_session_state_t::idle) {
+        fsk_queue_clear();
         CommandInProgress.store (false, std::memory_order_release);
         REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "ft8 not prepared");
     }
 
-    if (ft8_is_task_in_progress()) {
-        int64_t wait_deadline = esp_timer_get_time() + FT8_QUEUE_WAIT_TIMEOUT_US;
-        if (!ft8_queue_push_with_timeout (baseFreq, wait_deadline)) {
+    ft8_task_pack_t * preparedInfo = &ft8Session.pack;
+    if (transmission.message[0] == '\0')
+        strlcpy (transmission.message, preparedInfo->messageText, sizeof (transmission.message));
+    else if (strlen (transmission.message) > preparedInfo->mode->max_message_chars) {
+        CommandInProgress.store (false, std::memory_order_release);
+        REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "parameter parsing error");
+    }
+    else {
+        // Refuse a message the mode can't encode now: once queued, its failure would end the session
+        uint8_t tones[FSK_MAX_SYMBOLS];
+        if (preparedInfo->mode->encode (transmission.message, tones) < 0) {
             CommandInProgress.store (false, std::memory_order_release);
-            REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "FT8 queue full");
+            REPLY_WITH_FAILURE (req, HTTPD_400_BAD_REQUEST, "message can't be encoded in this mode");
         }
-        ft8_set_last_accepted_sequence (sequence_number);
-        CommandInProgress.store (false, std::memory_order_release);
-        REPLY_WITH_SUCCESS();
     }
 
-    long initial_base_freq = baseFreq;
-    bool has_orphan_work   = (ft8_queue_size() > 0);
-
-    // Atomically claim task startup (false -> true). This prevents two concurrent /ft8
-    // requests from both launching a new transmit task.
-    bool started_transmit_task = ft8_try_claim_task_in_progress();
-    if (!started_transmit_task) {
-        // Another request already has an FT8 task running, so queue this request for
-        // the next transmit slot instead of starting a second task.
+    if (state == ft8_session_state_t::transmitting) {
+        // The session task takes this from the queue for the slot after the current one
         int64_t wait_deadline = esp_timer_get_time() + FT8_QUEUE_WAIT_TIMEOUT_US;
-        if (!ft8_queue_push_with_timeout (baseFreq, wait_deadline)) {
+        if (!fsk_queue_push_with_timeout (transmission, wait_deadline)) {
             CommandInProgress.store (false, std::memory_order_release);
             REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "FT8 queue full");
         }
@@ -1046,47 +969,37 @@ esp_err_t handler_ft8_post (httpd_req_t * req) {
         REPLY_WITH_SUCCESS();
     }
 
-    if (has_orphan_work) {
+    // Queued work left behind by a transmission that ended as it was queued goes out first
+    fsk_transmission_t first = transmission;
+    if (fsk_queue_size() > 0) {
         int64_t wait_deadline = esp_timer_get_time() + FT8_QUEUE_WAIT_TIMEOUT_US;
-        long    queued_base   = 0;
-        if (!ft8_queue_pop_with_timeout (queued_base, wait_deadline)) {
-            ft8_set_task_in_progress (false);
+        if (!fsk_queue_pop_with_timeout (first, wait_deadline)) {
             CommandInProgress.store (false, std::memory_order_release);
             REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "FT8 queue busy");
         }
-        initial_base_freq = queued_base;
-        if (!ft8_queue_push_with_timeout (baseFreq, wait_deadline)) {
-            ft8_set_task_in_progress (false);
+        if (!fsk_queue_push_with_timeout (transmission, wait_deadline)) {
             CommandInProgress.store (false, std::memory_order_release);
             REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "FT8 queue full");
         }
-        ESP_LOGW (TAG8, "FT8 queue orphan detected; restarting transmit task");
-    }
-
-    // Offload playing the FT8 audio
-    ft8_task_pack_t * configInfo = ft8_get_config_info();
-    if (configInfo == NULL) {
-        ft8_set_task_in_progress (false);
-        CommandInProgress.store (false, std::memory_order_release);
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "ft8 not prepared");
+        ESP_LOGW (TAG8, "FT8 queue orphan detected; restarting transmission");
     }
-    configInfo->baseFreq = initial_base_freq;
-
-    // Update the watchdog timer to be 1 second after the next FT8 window starts.
-    // The xmit_ft8_task will reset the watchdog timer if it is called again.
-    int64_t watchdogTime = esp_timer_get_time() + ((msUntilFT8Window() + 1000) * 1000LL);  // 1 second after the next FT8 window starts, converted to microseconds
-    ft8_extend_cancel_deadline_us (watchdogTime);
 
-    // The watchdog timer will clean up after the FT8 transmission is done.
-    if (xTaskCreate (&xmit_ft8_task, "xmit_ft8_task", 8192, configInfo, SC_TASK_PRIORITY_HIGHEST, NULL) != pdPASS) {
-        ft8_set_task_in_progress (false);
+    // The session task doesn't look at a prepared session's pack, so `first` can be set before handing it over.
+    // Keep the session prepared until 1 second after the next window starts; the session task extends
+    // the deadline by a slot at every window it transmits in.
+    preparedInfo->first = first;
+    ft8_extend_deadline_us (esp_timer_get_time() + ((fsk_ms_until_window (preparedInfo->mode, first.slot_parity) + 1000) * 1000LL));
+    if (!ft8_transition (ft8_session_state_t::prepared, ft8_session_state_t::transmitting)) {
+        // The deadline passed, or a cancel arrived, while this request was handled
+        fsk_queue_clear();
         CommandInProgress.store (false, std::memory_order_release);
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "failed to start FT8 transmission task");
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "ft8 cleanup in progress");
     }
+    ft8_notify_session();
 
-    // This HTTP command is complete once the transmit task is launched. Keep
-    // CommandInProgress scoped to request handling so cleanup watchdog timing
-    // depends on FT8 activity/deadlines, not a sticky command flag.
+    // This HTTP command is complete once the session task has the transmission. Keep
+    // CommandInProgress scoped to request handling; the session's end depends only on
+    // its deadline and cancels.
     ft8_set_last_accepted_sequence (sequence_number);
     CommandInProgress.store (false, std::memory_order_release);
     REPLY_WITH_SUCCESS();
@@ -1101,9 +1014,57 @@ esp_err_t handler_ft8_post (httpd_req_t * req) {
 esp_err_t handler_cancelft8_post (httpd_req_t * req) {
     ESP_LOGV (TAG8, "trace: %s()", __func__);
 
-    // Tell the watchdog timer to cancel the FT8 mode and restore the radio to its prior state
+    // Tell the session task to stop transmitting and restore the radio to its prior state
     ft8_request_cancel();
-    ft8_queue_clear();
+    fsk_queue_clear();
 
     REPLY_WITH_SUCCESS();
 }
+
+/**
+ * HTTP request handler for the on-air timing of recent FT8, FT4 and WSPR transmissions, newest
+ * first: symbol 0's offset from the slot boundary, the symbol interval's mean and standard
+ * deviation, the largest jitter, and the number of late symbols.
+ *
+ * @param req A pointer to the HTTP request.
+ * @return ESP_OK on success.
+ */
+esp_err_t handler_ft8_stats_get (httpd_req_t * req) {
+    showActivity();
+
+    ESP_LOGV (TAG8, "trace: %s()", __func__);
+
+    fsk_timing_t history[FSK_TIMING_HISTORY];
+    uint32_t     count   = 0;
+    size_t       entries = fsk_get_timing (history, &count);
+
+    JsonWriter json (req);
+    json.begin_object();
+    json.integer ("transmissions", count);
+    json.integer ("lateThresholdUs", FSK_LATE_SYMBOL_US);
+
+    clock_sync_status_t clock;
+    clock_sync_get_status (&clock);
+    json.boolean ("clockSynced", clock.synced);
+    if (clock.synced)
+        json.integer ("clockUncertaintyUs", clock.uncertainty_us);
+    json.begin_array ("recent");
+    for (size_t n = 0; n < entries; ++n) {
+        const fsk_timing_t & timing = history[n];
+        json.begin_object();
+        json.integer ("startedMs", timing.started_ms);
+        json.string ("mode", timing.mode);
+        json.string ("radio", timing.radio);
+        json.integer ("slotOffsetUs", timing.slot_offset_us);
+        json.integer ("symbolsSent", timing.symbols_sent);
+        json.integer ("symbolIntervalMeanUs", timing.symbol_interval_mean_us);
+        json.integer ("symbolIntervalStddevUs", timing.symbol_interval_stddev_us);
+        json.integer ("maxJitterUs", timing.max_jitter_us);
+        json.integer ("lateSymbols", timing.late_symbols);
+        json.boolean ("aborted", timing.aborted);
+        json.end_object();
+    }
+    json.end_array();
+    json.end_object();
+    return json.finish();
+}
@@ -0,0 +1,139 @@
+#include "globals.h"
+#include "jobs.h"
+#include "json_writer.h"
+#include "webserver.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:hdl_jobs";
+
+bool client_prefers_async (httpd_req_t * req) {
+    char prefer[64];
+    if (httpd_req_get_hdr_value_str (req, "Prefer", prefer, sizeof (prefer)) != ESP_OK)
+        return false;
+    return strstr (prefer, "respond-async") != nullptr;
+}
+
+/**
+ * Writes one job as a JSON object (an array element, or the whole document).
+ */
+static void write_job_json (JsonWriter & json, const job_info_t & info) {
+    json.begin_object();
+    json.integer ("id", info.id);
+    json.string ("kind", job_kind_name (info.kind));
+    json.string ("state", job_state_name (info.state));
+    json.integer ("progress", info.progress);
+    json.boolean ("cancelRequested", info.cancel_requested);
+    json.integer ("ageMs", info.age_ms);
+    if (info.error[0])
+        json.string ("error", info.error);
+    json.end_object();
+}
+
+/**
+ * Sends a "409 Conflict" JSON error: a job of the same kind is already running. esp_http_server
+ * has no httpd_err_code_t for it, so the status line is set by hand.
+ * @return ESP_FAIL, so callers can `return` the result directly.
+ */
+static esp_err_t reply_conflict (httpd_req_t * req, const char * message) {
+    ESP_LOGW (TAG8, "%s", message);
+    httpd_resp_set_status (req, "409 Conflict");
+    JsonWriter json (req);
+    json.begin_object();
+    json.string ("error", message);
+    json.end_object();
+    json.finish();
+    return ESP_FAIL;
+}
+
+esp_err_t start_job_and_reply (httpd_req_t * req, job_kind_t kind, job_fn_t fn, job_cancel_fn_t on_cancel, const void * arg, size_t arg_len) {
+    uint32_t job_id = 0;
+    switch (job_start (kind, fn, on_cancel, arg, arg_len, &job_id)) {
+    case JOB_START_OK:
+        break;
+    case JOB_START_KIND_BUSY:
+        return reply_conflict (req, "operation already in progress, please retry");
+    case JOB_START_FULL:
+    default:
+        return reply_service_unavailable (req, 1, "job queue full, please retry");
+    }
+
+    job_info_t info;
+    if (!job_get_info (job_id, &info))
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "job vanished");
+
+    char location[32];
+    snprintf (location, sizeof (location), "/api/v1/jobs/%lu", (unsigned long)job_id);
+
+    ESP_LOGI (TAG8, "accepted job %lu (%s)", (unsigned long)job_id, job_kind_name (kind));
+    httpd_resp_set_status (req, "202 Accepted");
+    httpd_resp_set_hdr (req, "Location", location);
+    httpd_resp_set_hdr (req, "Preference-Applied", "respond-async");
+    JsonWriter json (req);
+    write_job_json (json, info);
+    json.finish();
+    return ESP_OK;
+}
+
+/**
+ * Extracts the job id from ".../jobs/<id>[?query]".
+ * @return the id, or 0 if the URI names no job (a request for the whole list).
+ */
+static uint32_t job_id_from_uri (const char * uri) {
+    const char * slash = strstr (uri, "/jobs/");
+    if (!slash)
+        return 0;
+    return strtoul (slash + sizeof ("/jobs/") - 1, nullptr, 10);
+}
+
+/**
+ * Handles an HTTP GET request for one job (/api/v1/jobs/<id>) or for all recent
+ * jobs (/api/v1/jobs).
+ *
+ * @param req Pointer to the HTTP request structure.
+ * @return ESP_OK on success, ESP_FAIL if the job is unknown.
+ */
+esp_err_t handler_jobs_get (httpd_req_t * req) {
+    ESP_LOGV (TAG8, "trace: %s()", __func__);
+
+    uint32_t job_id = job_id_from_uri (req->uri);
+    httpd_resp_set_hdr (req, "Cache-Control", "no-store");
+
+    if (job_id != 0) {
+        job_info_t info;
+        if (!job_get_info (job_id, &info))
+            REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "unknown job");
+        JsonWriter json (req);
+        write_job_json (json, info);
+        return json.finish();
+    }
+
+    job_info_t infos[JOB_SLOTS];
+    size_t     count = job_list (infos, JOB_SLOTS);
+    JsonWriter json (req);
+    json.begin_array();
+    for (size_t i = 0; i < count; ++i)
+        write_job_json (json, infos[i]);
+    json.end_array();
+    return json.finish();
+}
+
+/**
+ * Handles an HTTP DELETE request to cancel a job (/api/v1/jobs/<id>).
+ * Queued jobs are dropped before they touch the radio; running jobs stop at their
+ * next safe point. Cancelling a finished job is a no-op.
+ *
+ * @param req Pointer to the HTTP request structure.
+ * @return ESP_OK on success, ESP_FAIL if the job is unknown.
+ */
+esp_err_t handler_jobs_delete (httpd_req_t * req) {
+    showActivity();
+    ESP_LOGV (TAG8, "trace: %s()", __func__);
+
+    if (!job_cancel (job_id_from_uri (req->uri)))
+        REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "unknown job");
+
+    REPLY_WITH_SUCCESS();
+}
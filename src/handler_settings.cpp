@@ -1,71 +1,216 @@
+#include "fsk_engine.h"
 #include "globals.h"
+#include "json_reader.h"
+#include "json_writer.h"
 #include "kx_radio.h"
+#include "request_arena.h"
 #include "settings.h"
 #include "webserver.h"
+#include "worker_pool.h"
 
 #include <esp_err.h>
 #include <esp_mac.h>
+#include <esp_random.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <nvs_flash.h>
 
-#include <memory>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
 
 #include <esp_log.h>
 static const char * TAG8 = "sc:hdl_setg";
 
 /**
- * Definitions for Wi-Fi SSID and password keys and their corresponding global storage variables.
- *
- * - SSID and password keys for STA1 and STA2 (station mode) and AP (access point mode) are defined as constants.
- *   Note: NVS_KEY_NAME_MAX_SIZE is 16 -- size of partition or key names, so the key lengths must abide.
- * - Corresponding global variables (`g_*`) hold the runtime values for these Wi-Fi credentials, with separate
- *   variables for the SSIDs and passwords of STA1, STA2, and the AP, adhering to maximum size constraints.
- */
-static const char s_sta1_ssid_key[] = "sta1_ssid";
-char              g_sta1_ssid[MAX_WIFI_SSID_SIZE];
-static const char s_sta1_pass_key[] = "sta1_pass";
-char              g_sta1_pass[MAX_WIFI_PASS_SIZE];
-static const char s_sta2_ssid_key[] = "sta2_ssid";
-char              g_sta2_ssid[MAX_WIFI_SSID_SIZE];
-static const char s_sta2_pass_key[] = "sta2_pass";
-char              g_sta2_pass[MAX_WIFI_PASS_SIZE];
-static const char s_sta3_ssid_key[] = "sta3_ssid";
-char              g_sta3_ssid[MAX_WIFI_SSID_SIZE];
-static const char s_sta3_pass_key[] = "sta3_pass";
-char              g_sta3_pass[MAX_WIFI_PASS_SIZE];
-static const char s_sta1_ip_pin_key[] = "sta1_ip_pin";
-bool              g_sta1_ip_pin       = false;
-static const char s_sta2_ip_pin_key[] = "sta2_ip_pin";
-bool              g_sta2_ip_pin       = false;
-static const char s_sta3_ip_pin_key[] = "sta3_ip_pin";
-bool              g_sta3_ip_pin       = false;
-static const char s_ap_ssid_key[]     = "ap_ssid";
-char              g_ap_ssid[MAX_WIFI_SSID_SIZE];
-static const char s_ap_pass_key[] = "ap_pass";
-char              g_ap_pass[MAX_WIFI_PASS_SIZE];
-static const char s_gps_lat_key[] = "gps_lat";
-char              g_gps_lat[MAX_GPS_LAT_SIZE];
-static const char s_gps_lon_key[] = "gps_lon";
-char              g_gps_lon[MAX_GPS_LON_SIZE];
-static const char s_callsign_key[] = "callsign";
-char              g_callsign[MAX_CALLSIGN_SIZE];
-static const char s_license_class_key[] = "license";
-char              g_license_class[MAX_LICENSE_CLASS_SIZE];
-
-// Tune targets - URLs to open when tuning (e.g., WebSDR, KiwiSDR)
-static const char s_tune_targets_key[] = "tune_targets";
-char              g_tune_targets[MAX_TUNE_TARGETS_JSON];
-static const char s_tune_targets_mobile_key[] = "tune_mobile";
-bool              g_tune_targets_mobile       = false;
-
-// CW Macros - configurable keyer buttons with placeholder support
-static const char s_cw_macros_key[] = "cw_macros";
-char              g_cw_macros[MAX_CW_MACROS_JSON];
+ * Global storage for the settings that are used all the time (Wi-Fi credentials, GPS location,
+ * callsign, ...). They are loaded from NVS at boot and always current; see s_settings for
+ * their keys and defaults. The large JSON settings (tune targets, CW macros) have no global:
+ * they stay in NVS and are read only while a request needs them.
+ */
+char g_sta1_ssid[MAX_WIFI_SSID_SIZE];
+char g_sta1_pass[MAX_WIFI_PASS_SIZE];
+char g_sta2_ssid[MAX_WIFI_SSID_SIZE];
+char g_sta2_pass[MAX_WIFI_PASS_SIZE];
+char g_sta3_ssid[MAX_WIFI_SSID_SIZE];
+char g_sta3_pass[MAX_WIFI_PASS_SIZE];
+bool g_sta1_ip_pin = false;
+bool g_sta2_ip_pin = false;
+bool g_sta3_ip_pin = false;
+char g_ap_ssid[MAX_WIFI_SSID_SIZE];
+char g_ap_pass[MAX_WIFI_PASS_SIZE];
+char g_gps_lat[MAX_GPS_LAT_SIZE];
+char g_gps_lon[MAX_GPS_LON_SIZE];
+char g_callsign[MAX_CALLSIGN_SIZE];
+char g_license_class[MAX_LICENSE_CLASS_SIZE];
+bool g_tune_targets_mobile = false;
+
+/**
+ * Default AP SSID, amended with the last bytes of the MAC address by populate_settings().
+ */
+static char s_default_ap_ssid[] = "SOTAcat-1234";
 
 /**
  * Handle to our Non-Volatile Storage while we're in communication with it.
  */
 static nvs_handle_t s_nvs_settings_handle;
 
+// ====================================================================================================
+// Schema
+// ====================================================================================================
+
+typedef enum {
+    SETTING_STRING,  // char[] global
+    SETTING_BOOL,    // bool global, stored as u8
+    SETTING_BLOB,    // JSON array, kept as text in NVS and read on demand
+} setting_type_t;
+
+/**
+ * Endpoints that read and write the settings; each GET/POST covers one group.
+ */
+typedef enum {
+    GROUP_WIFI,
+    GROUP_GPS,
+    GROUP_CALLSIGN,
+    GROUP_LICENSE,
+    GROUP_TUNE_TARGETS,
+    GROUP_CW_MACROS,
+    GROUP_COUNT
+} setting_group_t;
+
+typedef struct {
+    const char * endpoint;         // API name, also the group's member in /api/v1/config
+    bool         applied_at_boot;  // a change closes the connection and reboots the device to apply it
+} setting_group_info_t;
+
+static const setting_group_info_t s_groups[GROUP_COUNT] = {
+    {"settings", true},      // GROUP_WIFI
+    {"gps", false},          // GROUP_GPS
+    {"callsign", false},     // GROUP_CALLSIGN
+    {"license", false},      // GROUP_LICENSE
+    {"tuneTargets", false},  // GROUP_TUNE_TARGETS
+    {"cwMacros", false},     // GROUP_CW_MACROS
+};
+
+/**
+ * Checks a POSTed value (of len bytes, not necessarily NUL-terminated) before it is stored.
+ */
+typedef bool (*setting_validator_t) (const char * value, size_t len);
+
+typedef struct {
+    setting_group_t     group;
+    const char *        member;         // name in the JSON object
+    const char *        key;            // NVS key; NVS_KEY_NAME_MAX_SIZE is 16, so at most 15 characters
+    setting_type_t      type;
+    void *              value;          // the g_* variable, or nullptr for a blob
+    size_t              size;           // bytes the value may take, including the NUL
+    const char *        default_value;  // for a bool, "true" or "false"
+    setting_validator_t validate;       // nullptr accepts any value that fits
+} setting_t;
+
+static bool is_latitude (const char * value, size_t len);
+static bool is_longitude (const char * value, size_t len);
+static bool is_callsign (const char * value, size_t len);
+static bool is_license_class (const char * value, size_t len);
+
+#define STRING_VALUE(var) SETTING_STRING, var, sizeof (var)
+#define BOOL_VALUE(var)   SETTING_BOOL, &var, sizeof (var)
+#define BLOB_VALUE(size)  SETTING_BLOB, nullptr, size
+
+/**
+ * Every setting, in the order its endpoint reports them. A new setting is one line here
+ * (plus its g_* variable if it is used outside this file).
+ */
+static const setting_t s_settings[] = {
+    // group             member         key             type and storage                    default            validate
+    {GROUP_WIFI,         "sta1_ssid",   "sta1_ssid",    STRING_VALUE (g_sta1_ssid),         "ham-hotspot",     nullptr},
+    {GROUP_WIFI,         "sta1_pass",   "sta1_pass",    STRING_VALUE (g_sta1_pass),         "sotapota",        nullptr},
+    {GROUP_WIFI,         "sta2_ssid",   "sta2_ssid",    STRING_VALUE (g_sta2_ssid),         "",                nullptr},
+    {GROUP_WIFI,         "sta2_pass",   "sta2_pass",    STRING_VALUE (g_sta2_pass),         "",                nullptr},
+    {GROUP_WIFI,         "sta3_ssid",   "sta3_ssid",    STRING_VALUE (g_sta3_ssid),         "",                nullptr},
+    {GROUP_WIFI,         "sta3_pass",   "sta3_pass",    STRING_VALUE (g_sta3_pass),         "",                nullptr},
+    {GROUP_WIFI,         "ap_ssid",     "ap_ssid",      STRING_VALUE (g_ap_ssid),           s_default_ap_ssid, nullptr},
+    {GROUP_WIFI,         "ap_pass",     "ap_pass",      STRING_VALUE (g_ap_pass),           "12345678",        nullptr},
+    {GROUP_WIFI,         "sta1_ip_pin", "sta1_ip_pin",  BOOL_VALUE (g_sta1_ip_pin),         "false",           nullptr},
+    {GROUP_WIFI,         "sta2_ip_pin", "sta2_ip_pin",  BOOL_VALUE (g_sta2_ip_pin),         "false",           nullptr},
+    {GROUP_WIFI,         "sta3_ip_pin", "sta3_ip_pin",  BOOL_VALUE (g_sta3_ip_pin),         "false",           nullptr},
+    {GROUP_GPS,          "gps_lat",     "gps_lat",      STRING_VALUE (g_gps_lat),           "",                is_latitude},
+    {GROUP_GPS,          "gps_lon",     "gps_lon",      STRING_VALUE (g_gps_lon),           "",                is_longitude},
+    {GROUP_CALLSIGN,     "callsign",    "callsign",     STRING_VALUE (g_callsign),          "",                is_callsign},
+    {GROUP_LICENSE,      "license",     "license",      STRING_VALUE (g_license_class),     "",                is_license_class},
+    {GROUP_TUNE_TARGETS, "targets",     "tune_targets", BLOB_VALUE (MAX_TUNE_TARGETS_JSON), "[]",              nullptr},
+    {GROUP_TUNE_TARGETS, "mobile",      "tune_mobile",  BOOL_VALUE (g_tune_targets_mobile), "false",           nullptr},
+    {GROUP_CW_MACROS,    "macros",      "cw_macros",    BLOB_VALUE (MAX_CW_MACROS_JSON),    "[]",              nullptr},
+};
+
+#define SETTINGS_COUNT std::size (s_settings)
+static_assert (SETTINGS_COUNT <= 32, "s_dirty_settings has one bit per setting");
+
+static bool is_in_range (const char * value, size_t len, double limit) {
+    if (len == 0)
+        return true;  // not set
+    char * end;
+    double degrees = strtod (value, &end);
+    return end == value + len && degrees >= -limit && degrees <= limit;
+}
+
+static bool is_latitude (const char * value, size_t len) {
+    return is_in_range (value, len, 90.0);
+}
+
+static bool is_longitude (const char * value, size_t len) {
+    return is_in_range (value, len, 180.0);
+}
+
+static bool is_callsign (const char * value, size_t len) {
+    for (size_t i = 0; i < len; ++i)
+        if (!isalnum ((unsigned char)value[i]) && value[i] != '/')
+            return false;
+    return true;
+}
+
+static bool is_license_class (const char * value, size_t len) {
+    return len == 0 || (len == 1 && strchr ("NTGAE", value[0]));
+}
+
+// ====================================================================================================
+// Storage
+// ====================================================================================================
+
+/**
+ * The g_* variables are the authoritative copy of the settings; NVS is written behind.
+ *
+ * A POST updates a variable only if the new value differs, and marks its setting dirty.
+ * A changed blob is held in a heap copy until it is written. Once POSTs have been quiet
+ * for SETTINGS_FLUSH_DELAY_US, a worker writes just the dirty settings and commits them
+ * in one nvs_commit(). A flush that falls due while FT8/FT4/WSPR is on the air waits for the
+ * transmission to end, since writing flash stalls the CPU and competes with the transmit task.
+ * flush_settings() writes at once, and runs before a restart (as a shutdown handler) and
+ * before deep sleep.
+ */
+#define SETTINGS_FLUSH_DELAY_US 1000000  // quiet time after the last change before NVS is written
+#define SETTINGS_FLUSH_RETRY_US 250000   // how often a flush held off by a transmission checks again
+
+static SemaphoreHandle_t  s_settings_mutex;                // guards the g_* values, the dirty state and the unsaved blobs
+static uint32_t           s_dirty_settings;                // bit n: s_settings[n] has changed since it was written to NVS
+static char *             s_unsaved_blobs[SETTINGS_COUNT];  // heap copies of changed blobs, until written
+static esp_timer_handle_t s_settings_flush_timer;          // one-shot, restarted by every change
+
+/**
+ * Version of the settings: bumped on every change and saved with them, so it only ever grows.
+ * The ETag of the settings GETs adds a random tag drawn at boot, so that a client's cached copy
+ * never looks current after a reboot, even one that lost changes not yet written.
+ */
+static const char            s_settings_version_key[] = "cfg_version";
+static uint32_t              s_settings_boot_tag;
+static std::atomic<uint32_t> s_settings_generation{0};
+
+#define SETTINGS_ETAG_SIZE 24
+
 /**
  * Initialize the NVS (Non-Volatile Storage) for the application.
  *
@@ -101,46 +246,75 @@ static void get_nv_string (const char * key, char * value, const char * default_
 }
 
 /**
- * Populate application settings with values from NVS, or meaningful defaults.
+ * Populate the resident settings with values from NVS, or their defaults. Blobs are left in NVS.
  */
 static void populate_settings () {
-    // create a default AP SSID, amended with mac address
-    char    default_ap_ssid[] = "SOTAcat-1234";
-    uint8_t base_mac_addr[6]  = {0};
+    // complete the default AP SSID with the mac address
+    uint8_t base_mac_addr[6] = {0};
     ESP_ERROR_CHECK (esp_read_mac (base_mac_addr, ESP_MAC_EFUSE_FACTORY));
     ESP_LOGI (TAG8, "base mac addr: %02X:%02X:%02X:%02X:%02X:%02X", base_mac_addr[0], base_mac_addr[1], base_mac_addr[2], base_mac_addr[3], base_mac_addr[4], base_mac_addr[5]);
-    snprintf (&default_ap_ssid[8], 5, "%02X%02X", base_mac_addr[4], base_mac_addr[5]);
-
-#define GET_NV_STRING(base, def) get_nv_string (s_##base##_key, g_##base, def, sizeof (g_##base) - 1)
-
-    GET_NV_STRING (sta1_ssid, "ham-hotspot");
-    GET_NV_STRING (sta1_pass, "sotapota");
-    GET_NV_STRING (sta2_ssid, "");
-    GET_NV_STRING (sta2_pass, "");
-    GET_NV_STRING (sta3_ssid, "");
-    GET_NV_STRING (sta3_pass, "");
-    GET_NV_STRING (ap_ssid, default_ap_ssid);
-    GET_NV_STRING (ap_pass, "12345678");
-    GET_NV_STRING (gps_lat, "");
-    GET_NV_STRING (gps_lon, "");
-    GET_NV_STRING (callsign, "");
-    GET_NV_STRING (license_class, "");
-    GET_NV_STRING (tune_targets, "");
-    GET_NV_STRING (cw_macros, "");
-
-#define GET_NV_BOOL(base)                                                       \
-    {                                                                           \
-        uint8_t val = 0;                                                        \
-        if (nvs_get_u8 (s_nvs_settings_handle, s_##base##_key, &val) == ESP_OK) \
-            g_##base = (val != 0);                                              \
-        else                                                                    \
-            g_##base = false;                                                   \
+    snprintf (&s_default_ap_ssid[8], 5, "%02X%02X", base_mac_addr[4], base_mac_addr[5]);
+
+    for (const setting_t & setting : s_settings) {
+        if (setting.type == SETTING_STRING)
+            get_nv_string (setting.key, (char *)setting.value, setting.default_value, setting.size);
+        else if (setting.type == SETTING_BOOL) {
+            uint8_t val = 0;
+            if (nvs_get_u8 (s_nvs_settings_handle, setting.key, &val) == ESP_OK)
+                *(bool *)setting.value = (val != 0);
+            else
+                *(bool *)setting.value = (strcmp (setting.default_value, "true") == 0);
+        }
+    }
+}
+
+/**
+ * Read a blob setting: its unsaved copy if it has changed, else its value in NVS, else its default.
+ * @param on_heap Read it into a heap buffer, which the caller frees, rather than into the request
+ *                arena, which releases it when the request ends.
+ * @return the NUL-terminated text, or nullptr if there is no memory for it.
+ */
+static char * load_blob (size_t index, bool on_heap) {
+    const setting_t & setting = s_settings[index];
+    char *            text    = (char *)(on_heap ? malloc (setting.size) : request_arena_alloc (setting.size));
+    if (!text)
+        return nullptr;
+
+    xSemaphoreTake (s_settings_mutex, portMAX_DELAY);
+    size_t size = setting.size;
+    if (s_unsaved_blobs[index])
+        strlcpy (text, s_unsaved_blobs[index], setting.size);
+    else if (nvs_get_str (s_nvs_settings_handle, setting.key, text, &size) != ESP_OK || text[0] == '\0')
+        strlcpy (text, setting.default_value, setting.size);
+    xSemaphoreGive (s_settings_mutex);
+    return text;
+}
+
+/**
+ * Worker-pool entry point for the write-behind flush. A transmission may have started since
+ * the timer fired; then the flush waits for it like the timer does.
+ */
+static void flush_settings_work (void *) {
+    if (fsk_is_transmitting()) {
+        esp_timer_start_once (s_settings_flush_timer, SETTINGS_FLUSH_RETRY_US);
+        return;
     }
+    flush_settings();
+}
 
-    GET_NV_BOOL (tune_targets_mobile);
-    GET_NV_BOOL (sta1_ip_pin);
-    GET_NV_BOOL (sta2_ip_pin);
-    GET_NV_BOOL (sta3_ip_pin);
+/**
+ * Timer callback: hands the flush to a worker rather than writing flash on the esp_timer
+ * task, or checks back shortly if a transmission is running, so the flush lands just after it.
+ */
+static void settings_flush_timer_fired (void *) {
+    if (fsk_is_transmitting()) {
+        esp_timer_start_once (s_settings_flush_timer, SETTINGS_FLUSH_RETRY_US);
+        return;
+    }
+    if (!worker_pool_submit (flush_settings_work, nullptr)) {
+        ESP_LOGW (TAG8, "worker pool busy, deferring settings flush");
+        esp_timer_start_once (s_settings_flush_timer, SETTINGS_FLUSH_DELAY_US);
+    }
 }
 
 /**
@@ -152,597 +326,641 @@ void init_settings () {
     // Initialize NVS
     ESP_ERROR_CHECK (initialize_nvs());
     populate_settings();
+    s_settings_boot_tag = esp_random();
+    uint32_t version    = 0;
+    nvs_get_u32 (s_nvs_settings_handle, s_settings_version_key, &version);
+    s_settings_generation.store (version, std::memory_order_relaxed);
+
+    s_settings_mutex                         = xSemaphoreCreateMutex();
+    const esp_timer_create_args_t timer_args = {
+        .callback              = settings_flush_timer_fired,
+        .arg                   = nullptr,
+        .dispatch_method       = ESP_TIMER_TASK,
+        .name                  = "settings_flush",
+        .skip_unhandled_events = true};
+    ESP_ERROR_CHECK (esp_timer_create (&timer_args, &s_settings_flush_timer));
+    ESP_ERROR_CHECK (esp_register_shutdown_handler ([] { flush_settings(); }));
 }
 
 /**
- * Construct and return a JSON string containing the current settings for Wi-Fi SSIDs and passwords.
- * The JSON structure includes pairs of keys and values for
- *   station 1 SSID and password,
- *   station 2 SSID and password, and
- *   access point SSID and password.
- *
- * The function dynamically allocates memory for the JSON string.
- * Usage of std::shared_ptr for the character array ensures automatic memory
- * management, preventing memory leaks by deallocating the memory when the
- * shared_ptr is destroyed or goes out of scope.
- *
- * Example of the JSON output:
- *   {"sta1_ssid":"foo","sta1_pass":"barbarbar","sta2_ssid":"baz","sta2_pass":"quuxquux","ap_ssid":"SOTAcat-A480","ap_pass":"12345678"}
- *
- * @return std::shared_ptr<char[]> A shared pointer to a character array containing the JSON string of settings.
+ * Write every dirty setting to NVS and commit them together.
+ * Settings that fail to write stay dirty, so the next flush retries them.
  */
-static std::shared_ptr<char[]> get_settings_json () {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    // It is critically important that the
-    // required_size, format, and sprintf varargs
-    // are all in close correspondence.
-
-    // {              // 1
-    // "foo":"bar",   // sizeof(foo) + sizeof(bar) + 6 for extras
-    // "foo":false,   // sizeof(foo) + sizeof(false) + 4 for extras
-    // }              // 1
-    size_t required_size = 1 +
-                           sizeof (s_sta1_ssid_key) + sizeof (g_sta1_ssid) + 6 +
-                           sizeof (s_sta1_pass_key) + sizeof (g_sta1_pass) + 6 +
-                           sizeof (s_sta2_ssid_key) + sizeof (g_sta2_ssid) + 6 +
-                           sizeof (s_sta2_pass_key) + sizeof (g_sta2_pass) + 6 +
-                           sizeof (s_sta3_ssid_key) + sizeof (g_sta3_ssid) + 6 +
-                           sizeof (s_sta3_pass_key) + sizeof (g_sta3_pass) + 6 +
-                           sizeof (s_ap_ssid_key) + sizeof (g_ap_ssid) + 6 +
-                           sizeof (s_ap_pass_key) + sizeof (g_ap_pass) + 6 +
-                           sizeof (s_sta1_ip_pin_key) + 5 + 4 +
-                           sizeof (s_sta2_ip_pin_key) + 5 + 4 +
-                           sizeof (s_sta3_ip_pin_key) + 5 + 4 +
-                           1;
-    const char format[] = "{\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":%s,\"%s\":%s,\"%s\":%s}";
-
-    std::shared_ptr<char[]> buf (new char[required_size]);
-    snprintf (buf.get(), required_size, format, s_sta1_ssid_key, g_sta1_ssid, s_sta1_pass_key, g_sta1_pass, s_sta2_ssid_key, g_sta2_ssid, s_sta2_pass_key, g_sta2_pass, s_sta3_ssid_key, g_sta3_ssid, s_sta3_pass_key, g_sta3_pass, s_ap_ssid_key, g_ap_ssid, s_ap_pass_key, g_ap_pass, s_sta1_ip_pin_key, g_sta1_ip_pin ? "true" : "false", s_sta2_ip_pin_key, g_sta2_ip_pin ? "true" : "false", s_sta3_ip_pin_key, g_sta3_ip_pin ? "true" : "false");
-
-    return buf;
-}
-
-/**
- * Helper function to store string key-value pairs in NVS.
- * Simply a convenient aliasing to keep the caller clean.
- */
-static esp_err_t process (const char * key, const char * value) {
-    // Log the key-value pair to the console.
-    ESP_LOGI (TAG8, "Storing into NVS the key: %s, with value: %s", key, value);
-    return nvs_set_str (s_nvs_settings_handle, key, value);
-}
-
-/**
- * Helper function to store boolean key-value pairs in NVS.
- * Booleans are stored as u8 (0 = false, 1 = true).
- */
-static esp_err_t process (const char * key, bool value) {
-    ESP_LOGI (TAG8, "Storing into NVS the key: %s, with bool value: %s", key, value ? "true" : "false");
-    return nvs_set_u8 (s_nvs_settings_handle, key, value ? 1 : 0);
-}
-
-/**
- * Parse the JSON string in content and call the process function for each key-value pair.
- * Incoming string will look like:
- *   {"sta1_ssid":"foo","sta1_pass":"barbarbar","sta2_ssid":"baz","sta2_pass":"quuxquux","ap_ssid":"SOTAcat-A480","ap_pass":"12345678"}
- * Also handles boolean values (unquoted true/false):
- *   {"sta1_ip_pin":true,"sta2_ip_pin":false}
- * NOTE: incoming json variable's content is modified during this operation
- */
-static void parse_and_process_json (char * json) {
-    char * keyStart  = nullptr;
-    char * valStart  = nullptr;
-    bool   isKey     = true;   // Start by assuming the first token will be a key.
-    bool   isBoolVal = false;  // Track if current value is a boolean
-    bool   boolValue = false;  // Store the boolean value
-
-    for (char * p = json; *p; ++p) {
-        if (*p == '\\') {
-            // Shift characters one to the left to overwrite the backslash.
-            char * q = p;
-            do
-                *q = *(q + 1);
-            while (*q++);
-            // Since we've shifted everything left, *p now points to the "actual" character.
+esp_err_t flush_settings () {
+    if (!s_settings_mutex)
+        return ESP_ERR_INVALID_STATE;
+    xSemaphoreTake (s_settings_mutex, portMAX_DELAY);
+
+    esp_err_t ret     = ESP_OK;
+    uint32_t  written = 0;
+    for (size_t i = 0; i < SETTINGS_COUNT; ++i) {
+        if (!(s_dirty_settings & (1u << i)))
+            continue;
+        const setting_t & setting = s_settings[i];
+        esp_err_t         err;
+        switch (setting.type) {
+        case SETTING_STRING: err = nvs_set_str (s_nvs_settings_handle, setting.key, (const char *)setting.value); break;
+        case SETTING_BOOL: err = nvs_set_u8 (s_nvs_settings_handle, setting.key, *(const bool *)setting.value ? 1 : 0); break;
+        case SETTING_BLOB: err = nvs_set_str (s_nvs_settings_handle, setting.key, s_unsaved_blobs[i]); break;
+        default: err = ESP_ERR_INVALID_ARG; break;
         }
-        else if (*p == '\"') {   // Quotes mark transitions
-            if (isKey) {         // Processing a key.
-                if (keyStart) {  // If we already have a start, this is the end.
-                    *p    = '\0';
-                    isKey = false;  // Next token will be a value.
-                }
-                else  // This is the start of a key.
-                    keyStart = p + 1;
-            }
-            else {               // Processing a value.
-                if (valStart) {  // If we already have a start, this is the end.
-                    *p = '\0';
-                    process (keyStart, valStart);   // Process the current key-value pair.
-                    keyStart = valStart = nullptr;  // Reset for the next pair.
-                    isKey               = true;     // Next token will be a key.
-                    isBoolVal           = false;
-                }
-                else  // This is the start of a value.
-                    valStart = p + 1;
-            }
+        if (err == ESP_OK)
+            written |= 1u << i;
+        else {
+            ESP_LOGE (TAG8, "failed to write setting %s: %s", setting.key, esp_err_to_name (err));
+            ret = err;
         }
-        else if (*p == ':') {
-            // Check if the value is an unquoted boolean (true/false)
-            if (!isKey && !valStart) {
-                if (*(p + 1) == 't' && strncmp (p + 1, "true", 4) == 0) {
-                    valStart  = p + 1;
-                    isBoolVal = true;
-                    boolValue = true;
-                    p += 4;  // Skip to 'e' of 'true', loop will increment past it
-                }
-                else if (*(p + 1) == 'f' && strncmp (p + 1, "false", 5) == 0) {
-                    valStart  = p + 1;
-                    isBoolVal = true;
-                    boolValue = false;
-                    p += 5;  // Skip to 'e' of 'false', loop will increment past it
+    }
+    if (written) {
+        nvs_set_u32 (s_nvs_settings_handle, s_settings_version_key, s_settings_generation.load (std::memory_order_relaxed));
+        esp_err_t err = nvs_commit (s_nvs_settings_handle);
+        if (err == ESP_OK) {
+            s_dirty_settings &= ~written;
+            for (size_t i = 0; i < SETTINGS_COUNT; ++i)
+                if ((written & (1u << i)) && s_unsaved_blobs[i]) {
+                    free (s_unsaved_blobs[i]);
+                    s_unsaved_blobs[i] = nullptr;
                 }
-            }
-            // If not a boolean, continue (next char should be '"' for string value)
+            ESP_LOGI (TAG8, "committed %d changed settings to nvs", __builtin_popcount (written));
         }
-        else if (*p == ',' || *p == '}') {
-            if (keyStart && valStart) {
-                if (isBoolVal) {
-                    process (keyStart, boolValue);  // Boolean overload
-                }
-                else {
-                    process (keyStart, valStart);  // String overload
-                }
-                keyStart = valStart = nullptr;
-                isBoolVal           = false;
-            }
-            isKey = true;  // Reset for the next key-value pair.
+        else {
+            ESP_LOGE (TAG8, "failed to commit settings: %s", esp_err_to_name (err));
+            ret = err;
         }
     }
+
+    xSemaphoreGive (s_settings_mutex);
+    return ret;
 }
 
 /**
- * Retrieve settings from NVS, expressed as JSON structure,
- * and respond to the http request
+ * Have the settings changed by a POST written to NVS once POSTs go quiet.
+ * Restarting the timer on every change folds a burst of saves into a single commit.
+ * If the timer can't be armed, writes them right away instead.
  */
-esp_err_t retrieve_and_send_settings (httpd_req_t * req) {
-    std::shared_ptr<char[]> buf = get_settings_json();
-    if (!buf)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "heap allocation failed");
+static esp_err_t schedule_settings_flush () {
+    xSemaphoreTake (s_settings_mutex, portMAX_DELAY);
+    bool dirty = (s_dirty_settings != 0);
+    xSemaphoreGive (s_settings_mutex);
+    if (!dirty)
+        return ESP_OK;
 
-    httpd_resp_set_type (req, "application/json");
-    REPLY_WITH_STRING (req, buf.get(), "settings");
+    esp_timer_stop (s_settings_flush_timer);  // ESP_ERR_INVALID_STATE if it wasn't running; either way it's stopped
+    if (esp_timer_start_once (s_settings_flush_timer, SETTINGS_FLUSH_DELAY_US) == ESP_OK)
+        return ESP_OK;
+    return flush_settings();
 }
 
-// ====================================================================================================
-
 /**
- * Respond to the GET request by returning the current settings,
- * expressed as a json string
+ * Mark a setting changed: advance the settings version, and have it written behind.
+ * Called with s_settings_mutex held.
  */
-esp_err_t handler_settings_get (httpd_req_t * req) {
-    showActivity();
-
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    return retrieve_and_send_settings (req);
+static void mark_dirty (size_t index) {
+    s_dirty_settings |= 1u << index;
+    s_settings_generation.fetch_add (1, std::memory_order_relaxed);
 }
 
 /**
- * Respond to the POST request by parsing the incoming JSON key/value pairs,
- * storing those in NVS.  Subsequently, return those values as confirmation.
+ * Update a string setting, unless it already holds the value.
+ * @return true if the value changed.
  */
-esp_err_t handler_settings_post (httpd_req_t * req) {
-    showActivity();
-
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    std::unique_ptr<char[]> buf (new char[req->content_len + 1]);
-    if (!buf)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "heap allocation failed");
-
-    char * unsafe_buf = buf.get();  // reference to an ephemeral buffer
-
-    // Get the content
-    int ret = httpd_req_recv (req, unsafe_buf, req->content_len);
-    if (ret <= 0)
-        REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "post content not received");
-
-    unsafe_buf[req->content_len] = '\0';  // Null-terminate for string operations
-
-    parse_and_process_json (unsafe_buf);
-
-    if (nvs_commit (s_nvs_settings_handle) != ESP_OK)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "failed commit settings to nvs");
-
-    populate_settings();
-
-    esp_err_t result = retrieve_and_send_settings (req);
-
-    if (result == ESP_OK) {
-        // Reboot with the new settings
-        ESP_LOGI (TAG8, "rebooting to apply new settings");
-
-        result = schedule_deferred_reboot (req);
-        if (result != ESP_OK)
-            REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to schedule reboot");
-
-        REPLY_WITH_SUCCESS();
+static bool store_string (size_t index, const char * value, size_t len) {
+    const setting_t & setting = s_settings[index];
+    char *            current = (char *)setting.value;
+
+    xSemaphoreTake (s_settings_mutex, portMAX_DELAY);
+    bool changed = strncmp (current, value, len) != 0 || current[len] != '\0';
+    if (changed) {
+        memcpy (current, value, len);
+        current[len] = '\0';
+        mark_dirty (index);
     }
+    xSemaphoreGive (s_settings_mutex);
 
-    return result;
+    ESP_LOGI (TAG8, "setting %s %s: %.*s", setting.key, changed ? "changed" : "unchanged", (int)len, value);
+    return changed;
 }
 
-static std::shared_ptr<char[]> get_gps_settings_json () {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    size_t required_size = 1 +
-                           sizeof (s_gps_lat_key) + sizeof (g_gps_lat) + 6 +
-                           sizeof (s_gps_lon_key) + sizeof (g_gps_lon) + 6 +
-                           1;
-    const char format[] = "{\"%s\":\"%s\",\"%s\":\"%s\"}";
-
-    std::shared_ptr<char[]> buf (new char[required_size]);
-    snprintf (buf.get(), required_size, format, s_gps_lat_key, g_gps_lat, s_gps_lon_key, g_gps_lon);
-
-    return buf;
-}
-
-static esp_err_t retrieve_and_send_gps_settings (httpd_req_t * req) {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    httpd_resp_set_type (req, "application/json");
-    auto settings_json = get_gps_settings_json();
-    return httpd_resp_send (req, settings_json.get(), HTTPD_RESP_USE_STRLEN);
-}
-
-esp_err_t handler_gps_settings_get (httpd_req_t * req) {
-    showActivity();
-
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
+/**
+ * Update a boolean setting, unless it already holds the value.
+ * @return true if the value changed.
+ */
+static bool store_bool (size_t index, bool value) {
+    const setting_t & setting = s_settings[index];
+    bool *            current = (bool *)setting.value;
+
+    xSemaphoreTake (s_settings_mutex, portMAX_DELAY);
+    bool changed = (*current != value);
+    if (changed) {
+        *current = value;
+        mark_dirty (index);
+    }
+    xSemaphoreGive (s_settings_mutex);
 
-    return retrieve_and_send_gps_settings (req);
+    ESP_LOGI (TAG8, "setting %s %s: %s", setting.key, changed ? "changed" : "unchanged", value ? "true" : "false");
+    return changed;
 }
 
-esp_err_t handler_gps_settings_post (httpd_req_t * req) {
-    showActivity();
-
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    std::unique_ptr<char[]> buf (new char[req->content_len + 1]());
-    if (!buf)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "heap allocation failed");
-
-    char * unsafe_buf = buf.get();
-
-    int ret = httpd_req_recv (req, unsafe_buf, req->content_len);
-    if (ret <= 0) {
-        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
-            httpd_resp_send_408 (req);
-        }
-        return ESP_FAIL;
+/**
+ * Update a blob setting, unless it already holds the value. A changed blob is kept in a heap
+ * copy until it is written to NVS.
+ * @param current The blob's present text, from load_blob(); takes the new value.
+ * @param copy Heap copy of the new value, from the caller; freed here if it isn't kept.
+ * @return true if the value changed.
+ */
+static bool store_blob (size_t index, char * current, char * copy) {
+    const setting_t & setting = s_settings[index];
+    if (strcmp (current, copy) == 0) {
+        ESP_LOGI (TAG8, "setting %s unchanged", setting.key);
+        free (copy);
+        return false;
     }
+    strcpy (current, copy);  // both hold at most setting.size bytes
 
-    unsafe_buf[req->content_len] = '\0';
+    xSemaphoreTake (s_settings_mutex, portMAX_DELAY);
+    free (s_unsaved_blobs[index]);
+    s_unsaved_blobs[index] = copy;
+    mark_dirty (index);
+    xSemaphoreGive (s_settings_mutex);
 
-    parse_and_process_json (unsafe_buf);
-
-    if (nvs_commit (s_nvs_settings_handle) != ESP_OK)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "failed commit settings to nvs");
-
-    populate_settings();
-
-    return retrieve_and_send_gps_settings (req);
+    ESP_LOGI (TAG8, "setting %s changed: %s", setting.key, copy);
+    return true;
 }
 
-static std::shared_ptr<char[]> get_callsign_settings_json () {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    size_t required_size = 1 +
-                           sizeof (s_callsign_key) + sizeof (g_callsign) + 6 +
-                           1;
-    const char format[] = "{\"%s\":\"%s\"}";
-
-    std::shared_ptr<char[]> buf (new char[required_size]);
-    snprintf (buf.get(), required_size, format, s_callsign_key, g_callsign);
+// ====================================================================================================
+// GET and POST
+// ====================================================================================================
 
-    return buf;
+/**
+ * Tag a settings GET with the current settings version, and answer "304 Not Modified"
+ * if the client already holds it.
+ * @param etag Buffer of SETTINGS_ETAG_SIZE bytes that must outlive the response.
+ * @return true if the 304 was sent and the handler is done.
+ */
+static bool settings_not_modified (httpd_req_t * req, char * etag) {
+    snprintf (etag, SETTINGS_ETAG_SIZE, "\"%08lx-%lu\"", (unsigned long)s_settings_boot_tag, (unsigned long)s_settings_generation.load (std::memory_order_relaxed));
+    // no-cache: revalidate on every use, which is what makes 304s possible
+    return reply_not_modified_if_match (req, etag, "no-cache", nullptr);
 }
 
-static esp_err_t retrieve_and_send_callsign_settings (httpd_req_t * req) {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
+/**
+ * The values a settings reply is written from, indexed like s_settings.
+ */
+typedef struct {
+    char *   text[SETTINGS_COUNT];  // strings and blobs, in the request arena
+    uint32_t bools;                 // bit n: s_settings[n] is a boolean, and true
+} settings_values_t;
 
-    httpd_resp_set_type (req, "application/json");
-    auto settings_json = get_callsign_settings_json();
-    return httpd_resp_send (req, settings_json.get(), HTTPD_RESP_USE_STRLEN);
-}
+static_assert (MAX_TUNE_TARGETS_JSON + MAX_CW_MACROS_JSON + 4 * (MAX_WIFI_SSID_SIZE + MAX_WIFI_PASS_SIZE) + MAX_GPS_LAT_SIZE + MAX_GPS_LON_SIZE +
+                       MAX_CALLSIGN_SIZE + MAX_LICENSE_CLASS_SIZE + 256 <=
+                   REQUEST_ARENA_SIZE,
+               "the request arena must hold a copy of every setting, for GET /api/v1/config");
 
-esp_err_t handler_callsign_settings_get (httpd_req_t * req) {
-    showActivity();
-
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
+/**
+ * Load the values of the groups selected by group_mask, for a reply. The resident values are
+ * copied under s_settings_mutex, so the reply, sent after it is released, never shows a value
+ * that a POST is half-way through changing. Blobs the caller already holds are kept.
+ * @return false if the request arena is exhausted.
+ */
+static bool load_values (uint32_t group_mask, settings_values_t & values) {
+    bool loaded = true;
+    xSemaphoreTake (s_settings_mutex, portMAX_DELAY);
+    for (size_t i = 0; i < SETTINGS_COUNT && loaded; ++i) {
+        const setting_t & setting = s_settings[i];
+        if (!(group_mask & (1u << setting.group)))
+            continue;
+        if (setting.type == SETTING_STRING) {
+            size_t len     = strlen ((const char *)setting.value);
+            values.text[i] = (char *)request_arena_alloc (len + 1);
+            if (values.text[i])
+                memcpy (values.text[i], setting.value, len + 1);
+            loaded = values.text[i] != nullptr;
+        }
+        else if (setting.type == SETTING_BOOL && *(const bool *)setting.value)
+            values.bools |= 1u << i;
+    }
+    xSemaphoreGive (s_settings_mutex);
 
-    return retrieve_and_send_callsign_settings (req);
+    for (size_t i = 0; i < SETTINGS_COUNT && loaded; ++i)
+        if ((group_mask & (1u << s_settings[i].group)) && s_settings[i].type == SETTING_BLOB && !values.text[i]) {
+            values.text[i] = load_blob (i, false);  // takes s_settings_mutex itself
+            loaded         = values.text[i] != nullptr;
+        }
+    return loaded;
 }
 
-esp_err_t handler_callsign_settings_post (httpd_req_t * req) {
-    showActivity();
-
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    std::unique_ptr<char[]> buf (new char[req->content_len + 1]());
-    if (!buf)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "heap allocation failed");
-
-    char * unsafe_buf = buf.get();
-
-    int ret = httpd_req_recv (req, unsafe_buf, req->content_len);
-    if (ret <= 0) {
-        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
-            httpd_resp_send_408 (req);
+/**
+ * Write the settings of a group as the members of the current JSON object.
+ * @param values The group's values, from load_values().
+ */
+static void write_group (JsonWriter & json, setting_group_t group, const settings_values_t & values) {
+    for (size_t i = 0; i < SETTINGS_COUNT; ++i) {
+        const setting_t & setting = s_settings[i];
+        if (setting.group != group)
+            continue;
+        switch (setting.type) {
+        case SETTING_STRING: json.string (setting.member, values.text[i]); break;
+        case SETTING_BOOL: json.boolean (setting.member, values.bools & (1u << i)); break;
+        case SETTING_BLOB: json.raw (setting.member, values.text[i]); break;
         }
-        return ESP_FAIL;
     }
+}
 
-    unsafe_buf[req->content_len] = '\0';
+/**
+ * Respond with the settings of a group, as a JSON object of their members, e.g. for Wi-Fi:
+ *   {"sta1_ssid":"foo","sta1_pass":"barbarbar",...,"ap_ssid":"SOTAcat-A480","ap_pass":"12345678",
+ *    "sta1_ip_pin":false,"sta2_ip_pin":false,"sta3_ip_pin":false}
+ * and for tune targets, whose array is a blob: {"targets":[...],"mobile":false}
+ * @param values Holds the text of any blobs the caller has already loaded; the group's other
+ *               values are loaded here.
+ */
+static esp_err_t send_settings (httpd_req_t * req, setting_group_t group, settings_values_t & values) {
+    ESP_LOGI (TAG8, "returning %s settings", s_groups[group].endpoint);
 
-    parse_and_process_json (unsafe_buf);
+    if (!load_values (1u << group, values))
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "request arena exhausted");
 
-    if (nvs_commit (s_nvs_settings_handle) != ESP_OK)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "failed commit settings to nvs");
+    if (s_groups[group].applied_at_boot)
+        httpd_resp_set_hdr (req, "Connection", "close");
 
-    populate_settings();
-
-    return retrieve_and_send_callsign_settings (req);
+    JsonWriter json (req);
+    json.begin_object();
+    write_group (json, group, values);
+    json.end_object();
+    return json.finish();
 }
 
-// ====================================================================================================
-// License Class Settings
-// ====================================================================================================
-
-static std::shared_ptr<char[]> get_license_settings_json () {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
+/**
+ * Values of a settings POST or PATCH, collected (and checked) before any is stored, so that
+ * a request is applied whole or not at all. The strings point into the request body.
+ * The body and the blobs are on the heap, for this request only: release_settings() frees them.
+ */
+typedef struct {
+    char *          body;                   // the request body, parsed in place
+    char *          blobs[SETTINGS_COUNT];  // present text of the blobs set, indexed like s_settings
+    int             depth;  // of the setting members: 1 in a POST, 2 in a config PATCH
+    setting_group_t group;  // of the members being read
+    struct {
+        size_t       index;
+        const char * text;  // string or blob
+        size_t       len;
+        bool         boolean;
+    } values[SETTINGS_COUNT];
+    size_t   count;
+    uint32_t changed_groups;  // bit per group, set by apply_settings()
+    char     error[64];       // why the request is refused
+} settings_post_t;
+
+static json_action_t reject (settings_post_t & post, const char * member, const char * reason) {
+    snprintf (post.error, sizeof (post.error), "%s %s", member, reason);
+    return JSON_STOP;
+}
 
-    size_t required_size = 1 +
-                           sizeof (s_license_class_key) + sizeof (g_license_class) + 6 +
-                           1;
-    const char format[] = "{\"%s\":\"%s\"}";
+/**
+ * json_parse_in_place() callback for a settings POST: collects the members of the object
+ * at post.depth that are settings of post.group, checking each against the schema.
+ * Other members are ignored.
+ */
+static json_action_t collect_setting (const json_event_t & event, void * ctx) {
+    settings_post_t & post = *(settings_post_t *)ctx;
+    if (event.depth != post.depth || !event.key)
+        return JSON_CONTINUE;
+
+    size_t index = 0;
+    while (index < SETTINGS_COUNT && (s_settings[index].group != post.group || strcmp (s_settings[index].member, event.key) != 0))
+        ++index;
+    if (index == SETTINGS_COUNT) {
+        if (event.type == JSON_RAW)
+            return JSON_CONTINUE;  // the end of an unknown member already skipped
+        ESP_LOGW (TAG8, "ignoring unknown %s setting %s", s_groups[post.group].endpoint, event.key);
+        return (event.type == JSON_OBJECT_BEGIN || event.type == JSON_ARRAY_BEGIN) ? JSON_CAPTURE : JSON_CONTINUE;
+    }
 
-    std::shared_ptr<char[]> buf (new char[required_size]);
-    snprintf (buf.get(), required_size, format, s_license_class_key, g_license_class);
+    const setting_t & setting = s_settings[index];
+    const char *      text    = nullptr;
+    size_t            len     = 0;
+    switch (setting.type) {
+    case SETTING_STRING:
+        if (event.type != JSON_STRING)
+            return reject (post, setting.member, "must be a string");
+        text = event.string;
+        len  = strlen (text);
+        break;
+    case SETTING_BOOL:
+        if (event.type != JSON_BOOL)
+            return reject (post, setting.member, "must be true or false");
+        break;
+    case SETTING_BLOB:
+        if (event.type == JSON_ARRAY_BEGIN)
+            return JSON_CAPTURE;  // comes back as JSON_RAW
+        if (event.type != JSON_RAW)
+            return reject (post, setting.member, "must be an array");
+        text = event.raw;
+        len  = event.raw_len;
+        break;
+    }
+    if (text && len >= setting.size)
+        return reject (post, setting.member, "is too long");
+    if (setting.validate && !setting.validate (text, len))
+        return reject (post, setting.member, "is not valid");
+    if (post.count == SETTINGS_COUNT)
+        return reject (post, setting.member, "is repeated too often");
 
-    return buf;
+    post.values[post.count++] = {index, text, len, event.boolean};
+    return JSON_CONTINUE;
 }
 
-static esp_err_t retrieve_and_send_license_settings (httpd_req_t * req) {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    httpd_resp_set_type (req, "application/json");
-    auto settings_json = get_license_settings_json();
-    return httpd_resp_send (req, settings_json.get(), HTTPD_RESP_USE_STRLEN);
+/**
+ * json_parse_in_place() callback for a config PATCH: each member of the top-level object
+ * named after a settings group holds an object of some of that group's settings.
+ *   {"callsign":{"callsign":"AB6D"},"license":{"license":"E"}}
+ */
+static json_action_t collect_config_member (const json_event_t & event, void * ctx) {
+    settings_post_t & post = *(settings_post_t *)ctx;
+    if (event.depth != 1 || !event.key)
+        return collect_setting (event, ctx);
+
+    if (event.type == JSON_OBJECT_BEGIN)
+        for (size_t group = 0; group < GROUP_COUNT; ++group)
+            if (strcmp (s_groups[group].endpoint, event.key) == 0) {
+                post.group = (setting_group_t)group;
+                return JSON_CONTINUE;
+            }
+    if (event.type == JSON_OBJECT_END || event.type == JSON_RAW)
+        return JSON_CONTINUE;
+    ESP_LOGW (TAG8, "ignoring config member %s", event.key);  // e.g. "version", sent back
+    return (event.type == JSON_OBJECT_BEGIN || event.type == JSON_ARRAY_BEGIN) ? JSON_CAPTURE : JSON_CONTINUE;
 }
 
-esp_err_t handler_license_settings_get (httpd_req_t * req) {
-    showActivity();
-
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
+/**
+ * Longest body of a settings POST or PATCH: a config PATCH of every setting, at its longest,
+ * with room to spare for formatting. It and the blobs it sets are too large to keep in the
+ * request arena for every request, so they are taken from the heap while the request runs;
+ * the arena holds the collected values, and the reply.
+ */
+#define SETTINGS_BODY_MAX 4096
+static_assert (sizeof (settings_post_t) + MAX_TUNE_TARGETS_JSON + 256 <= REQUEST_ARENA_SIZE,
+               "the request arena must hold a settings POST's values and the blob its reply reads back");
 
-    return retrieve_and_send_license_settings (req);
+/**
+ * Free the heap memory of a settings POST or PATCH: its body and the blobs it loaded.
+ */
+static void release_settings (settings_post_t * post) {
+    free (post->body);
+    for (char * blob : post->blobs)
+        free (blob);
 }
 
-esp_err_t handler_license_settings_post (httpd_req_t * req) {
-    showActivity();
-
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
+/**
+ * Receive the body of a settings POST or PATCH, and collect its values.
+ * A body over SETTINGS_BODY_MAX is refused with "413 Content Too Large" before it is read.
+ * @param on_event collect_setting() or collect_config_member().
+ * @param out Receives the collected values, in the request arena; pass them to
+ *            release_settings() once the request is done.
+ * @return ESP_OK, or ESP_FAIL once the failure has been answered.
+ */
+static esp_err_t receive_settings (httpd_req_t * req, setting_group_t group, int depth, json_event_fn_t on_event, settings_post_t ** out) {
+    if (req->content_len > SETTINGS_BODY_MAX) {
+        ESP_LOGE (TAG8, "settings body of %u bytes is too large", (unsigned)req->content_len);
+        httpd_resp_set_status (req, "413 Content Too Large");  // esp_http_server has no httpd_err_code_t for it
+        httpd_resp_set_hdr (req, "Connection", "close");       // rather than read the rest of the body
+        JsonWriter json (req);
+        json.begin_object();
+        json.string ("error", "settings body too large");
+        json.end_object();
+        json.finish();
+        return ESP_FAIL;
+    }
 
-    std::unique_ptr<char[]> buf (new char[req->content_len + 1]());
-    if (!buf)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "heap allocation failed");
+    settings_post_t * post = (settings_post_t *)request_arena_calloc (sizeof (settings_post_t));
+    if (!post)
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "request arena exhausted");
+    post->depth = depth;
+    post->group = group;
 
-    char * unsafe_buf = buf.get();
+    post->body = (char *)malloc (req->content_len + 1);
+    if (!post->body)
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "out of memory for the settings body");
 
-    int ret = httpd_req_recv (req, unsafe_buf, req->content_len);
+    int ret = httpd_req_recv (req, post->body, req->content_len);
     if (ret <= 0) {
-        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+        release_settings (post);
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT)
             httpd_resp_send_408 (req);
-        }
         return ESP_FAIL;
     }
+    post->body[ret] = '\0';  // Null-terminate for string operations
 
-    unsafe_buf[req->content_len] = '\0';
-
-    parse_and_process_json (unsafe_buf);
-
-    if (nvs_commit (s_nvs_settings_handle) != ESP_OK)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "failed commit settings to nvs");
-
-    populate_settings();
+    if (!json_parse_in_place (post->body, on_event, post)) {
+        release_settings (post);
+        REPLY_WITH_FAILURE (req, HTTPD_400_BAD_REQUEST, post->error[0] ? post->error : "malformed settings JSON");
+    }
 
-    return retrieve_and_send_license_settings (req);
+    *out = post;
+    return ESP_OK;
 }
 
-// ====================================================================================================
-// Tune Targets Settings
-// ====================================================================================================
-
-static std::shared_ptr<char[]> get_tune_targets_json () {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    // Return JSON: {"targets": [...], "mobile": true/false}
-    size_t     required_size = 32 + sizeof (g_tune_targets);
-    const char format[]      = "{\"targets\":%s,\"mobile\":%s}";
-
-    std::shared_ptr<char[]> buf (new char[required_size]);
-    // If g_tune_targets is empty, use empty array
-    const char * targets = (g_tune_targets[0] == '\0') ? "[]" : g_tune_targets;
-    snprintf (buf.get(), required_size, format, targets, g_tune_targets_mobile ? "true" : "false");
+/**
+ * Store the collected values, and have the changes written behind. The memory the blobs need,
+ * their present text (into post.blobs) and copies of the new values, is taken before anything
+ * is stored, so a request that runs out of it changes nothing.
+ * @return ESP_ERR_NO_MEM, with no setting changed, if the blobs could not be held; otherwise
+ *         the result of scheduling the write.
+ */
+static esp_err_t apply_settings (settings_post_t & post) {
+    char ** blobs = post.blobs;
+    char * copies[SETTINGS_COUNT] = {};  // indexed like post.values
+    for (size_t i = 0; i < post.count; ++i) {
+        size_t index = post.values[i].index;
+        if (s_settings[index].type != SETTING_BLOB)
+            continue;
+        if (!blobs[index])
+            blobs[index] = load_blob (index, true);
+        copies[i] = (char *)malloc (post.values[i].len + 1);
+        if (!blobs[index] || !copies[i]) {
+            ESP_LOGE (TAG8, "no memory for setting %s; nothing stored", s_settings[index].key);
+            for (char * copy : copies)
+                free (copy);
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy (copies[i], post.values[i].text, post.values[i].len);
+        copies[i][post.values[i].len] = '\0';
+    }
 
-    return buf;
+    for (size_t i = 0; i < post.count; ++i) {
+        size_t            index   = post.values[i].index;
+        const setting_t & setting = s_settings[index];
+        bool              changed = false;
+        switch (setting.type) {
+        case SETTING_STRING: changed = store_string (index, post.values[i].text, post.values[i].len); break;
+        case SETTING_BOOL: changed = store_bool (index, post.values[i].boolean); break;
+        case SETTING_BLOB: changed = store_blob (index, blobs[index], copies[i]); break;
+        }
+        if (changed)
+            post.changed_groups |= 1u << setting.group;
+    }
+    return schedule_settings_flush();
 }
 
-static esp_err_t retrieve_and_send_tune_targets (httpd_req_t * req) {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    httpd_resp_set_type (req, "application/json");
-    auto settings_json = get_tune_targets_json();
-    return httpd_resp_send (req, settings_json.get(), HTTPD_RESP_USE_STRLEN);
+/**
+ * Answer a settings POST or PATCH that apply_settings() could not complete.
+ */
+static esp_err_t reply_apply_failure (httpd_req_t * req, esp_err_t err) {
+    if (err == ESP_ERR_NO_MEM)
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "out of memory for the settings; none were changed");
+    REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "failed to commit settings to nvs");
 }
 
-esp_err_t handler_tune_targets_get (httpd_req_t * req) {
+static esp_err_t settings_get (httpd_req_t * req, setting_group_t group) {
     showActivity();
 
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
+    ESP_LOGV (TAG8, "trace: %s(%s)", __func__, s_groups[group].endpoint);
 
-    return retrieve_and_send_tune_targets (req);
+    char etag[SETTINGS_ETAG_SIZE];
+    if (settings_not_modified (req, etag))
+        return ESP_OK;
+
+    settings_values_t values = {};
+    return send_settings (req, group, values);
 }
 
-esp_err_t handler_tune_targets_post (httpd_req_t * req) {
+/**
+ * Store the settings POSTed as a JSON object of members, and respond with the group's
+ * settings as confirmation. A group applied at boot then reboots the device.
+ */
+static esp_err_t settings_post (httpd_req_t * req, setting_group_t group) {
     showActivity();
 
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    std::unique_ptr<char[]> buf (new char[req->content_len + 1]());
-    if (!buf)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "heap allocation failed");
-
-    char * unsafe_buf = buf.get();
+    ESP_LOGV (TAG8, "trace: %s(%s)", __func__, s_groups[group].endpoint);
 
-    int ret = httpd_req_recv (req, unsafe_buf, req->content_len);
-    if (ret <= 0) {
-        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
-            httpd_resp_send_408 (req);
-        }
+    settings_post_t * post = nullptr;
+    if (receive_settings (req, group, 1, collect_setting, &post) != ESP_OK)
         return ESP_FAIL;
-    }
 
-    unsafe_buf[req->content_len] = '\0';
-
-    // Parse JSON to extract "targets" array and "mobile" boolean
-    // Expected format: {"targets": ["url1", "url2"], "mobile": true}
-
-    // Find targets array
-    char * targets_start = strstr (unsafe_buf, "\"targets\"");
-    if (targets_start) {
-        char * array_start = strchr (targets_start, '[');
-        if (array_start) {
-            char * array_end = strchr (array_start, ']');
-            if (array_end) {
-                size_t array_len = array_end - array_start + 1;
-                if (array_len < sizeof (g_tune_targets)) {
-                    snprintf (g_tune_targets, sizeof (g_tune_targets), "%.*s", (int)array_len, array_start);
-                    nvs_set_str (s_nvs_settings_handle, s_tune_targets_key, g_tune_targets);
-                    ESP_LOGI (TAG8, "Stored tune targets: %s", g_tune_targets);
-                }
-            }
-        }
+    esp_err_t err = apply_settings (*post);
+    if (err != ESP_OK) {
+        release_settings (post);
+        return reply_apply_failure (req, err);
     }
 
-    // Find mobile boolean
-    char * mobile_start = strstr (unsafe_buf, "\"mobile\"");
-    if (mobile_start) {
-        g_tune_targets_mobile = (strstr (mobile_start, "true") != nullptr);
-        nvs_set_u8 (s_nvs_settings_handle, s_tune_targets_mobile_key, g_tune_targets_mobile ? 1 : 0);
-        ESP_LOGI (TAG8, "Stored tune targets mobile: %s", g_tune_targets_mobile ? "true" : "false");
-    }
-
-    if (nvs_commit (s_nvs_settings_handle) != ESP_OK)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "failed commit settings to nvs");
-
-    return retrieve_and_send_tune_targets (req);
-}
+    settings_values_t values = {};
+    memcpy (values.text, post->blobs, sizeof (values.text));  // the reply shows the blobs as just compared
+    esp_err_t result = send_settings (req, group, values);
+    release_settings (post);
 
-// ====================================================================================================
-// CW Macros Settings
-// ====================================================================================================
-
-static std::shared_ptr<char[]> get_cw_macros_json () {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
+    if (result == ESP_OK && s_groups[group].applied_at_boot) {
+        // Reboot with the new settings
+        ESP_LOGI (TAG8, "rebooting to apply new settings");
 
-    // Return JSON: {"macros": [...]}
-    size_t     required_size = 16 + sizeof (g_cw_macros);
-    const char format[]      = "{\"macros\":%s}";
+        result = schedule_deferred_reboot (req);
+        if (result != ESP_OK)
+            REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to schedule reboot");
 
-    std::shared_ptr<char[]> buf (new char[required_size]);
-    // If g_cw_macros is empty, use empty array
-    const char * macros = (g_cw_macros[0] == '\0') ? "[]" : g_cw_macros;
-    snprintf (buf.get(), required_size, format, macros);
+        REPLY_WITH_SUCCESS();
+    }
 
-    return buf;
+    return result;
 }
 
-static esp_err_t retrieve_and_send_cw_macros (httpd_req_t * req) {
-    ESP_LOGV (TAG8, "trace: %s()", __func__);
-
-    httpd_resp_set_type (req, "application/json");
-    auto settings_json = get_cw_macros_json();
-    return httpd_resp_send (req, settings_json.get(), HTTPD_RESP_USE_STRLEN);
-}
+// ====================================================================================================
+// Configuration bundle
+// ====================================================================================================
 
-esp_err_t handler_cw_macros_get (httpd_req_t * req) {
+/**
+ * Respond with every settings group in one document, each under its endpoint's name:
+ *   {"version":42,"settings":{...},"gps":{...},"callsign":{...},"license":{...},
+ *    "tuneTargets":{"targets":[...],"mobile":false},"cwMacros":{"macros":[...]}}
+ * The version only ever grows; it and the ETag change whenever any setting does.
+ */
+esp_err_t handler_config_get (httpd_req_t * req) {
     showActivity();
 
     ESP_LOGV (TAG8, "trace: %s()", __func__);
 
-    return retrieve_and_send_cw_macros (req);
+    char etag[SETTINGS_ETAG_SIZE];
+    if (settings_not_modified (req, etag))
+        return ESP_OK;
+
+    settings_values_t values = {};
+    if (!load_values (~0u, values))
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "request arena exhausted");
+
+    JsonWriter json (req);
+    json.begin_object();
+    json.integer ("version", s_settings_generation.load (std::memory_order_relaxed));
+    for (size_t group = 0; group < GROUP_COUNT; ++group) {
+        json.begin_object (s_groups[group].endpoint);
+        write_group (json, (setting_group_t)group, values);
+        json.end_object();
+    }
+    json.end_object();
+    return json.finish();
 }
 
-esp_err_t handler_cw_macros_post (httpd_req_t * req) {
+/**
+ * Update any settings, of any groups, from a partial config document, and respond with the
+ * new version (and ETag):
+ *   PATCH {"callsign":{"callsign":"AB6D"},"tuneTargets":{"mobile":true}}
+ *   -> {"version":43,"reboot":false}
+ * Members left out keep their values. If a setting that is applied at boot changed, the
+ * device reboots, as after a Wi-Fi settings POST.
+ */
+esp_err_t handler_config_patch (httpd_req_t * req) {
     showActivity();
 
     ESP_LOGV (TAG8, "trace: %s()", __func__);
 
-    std::unique_ptr<char[]> buf (new char[req->content_len + 1]());
-    if (!buf)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "heap allocation failed");
-
-    char * unsafe_buf = buf.get();
-
-    int ret = httpd_req_recv (req, unsafe_buf, req->content_len);
-    if (ret <= 0) {
-        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
-            httpd_resp_send_408 (req);
-        }
+    settings_post_t * post = nullptr;
+    if (receive_settings (req, GROUP_WIFI, 2, collect_config_member, &post) != ESP_OK)
         return ESP_FAIL;
-    }
 
-    unsafe_buf[req->content_len] = '\0';
-
-    // Parse JSON to extract "macros" array
-    // Expected format: {"macros": [{"label":"...","template":"..."},...]  }
-    char * macros_start = strstr (unsafe_buf, "\"macros\"");
-    if (macros_start) {
-        char * array_start = strchr (macros_start, '[');
-        if (array_start) {
-            // Find matching closing bracket (handles nested objects)
-            int    depth     = 0;
-            char * array_end = nullptr;
-            for (char * p = array_start; *p; ++p) {
-                if (*p == '[')
-                    depth++;
-                else if (*p == ']') {
-                    depth--;
-                    if (depth == 0) {
-                        array_end = p;
-                        break;
-                    }
-                }
-            }
-            if (array_end) {
-                size_t array_len = array_end - array_start + 1;
-                if (array_len < sizeof (g_cw_macros)) {
-                    snprintf (g_cw_macros, sizeof (g_cw_macros), "%.*s", (int)array_len, array_start);
-                    nvs_set_str (s_nvs_settings_handle, s_cw_macros_key, g_cw_macros);
-                    ESP_LOGI (TAG8, "Stored CW macros: %s", g_cw_macros);
-                }
-            }
-        }
+    esp_err_t err = apply_settings (*post);
+    release_settings (post);
+    if (err != ESP_OK)
+        return reply_apply_failure (req, err);
+
+    bool reboot = false;
+    for (size_t group = 0; group < GROUP_COUNT; ++group)
+        if ((post->changed_groups & (1u << group)) && s_groups[group].applied_at_boot)
+            reboot = true;
+
+    char etag[SETTINGS_ETAG_SIZE];
+    snprintf (etag, sizeof (etag), "\"%08lx-%lu\"", (unsigned long)s_settings_boot_tag, (unsigned long)s_settings_generation.load (std::memory_order_relaxed));
+    httpd_resp_set_hdr (req, "ETag", etag);
+    if (reboot)
+        httpd_resp_set_hdr (req, "Connection", "close");
+
+    JsonWriter json (req);
+    json.begin_object();
+    json.integer ("version", s_settings_generation.load (std::memory_order_relaxed));
+    json.boolean ("reboot", reboot);
+    json.end_object();
+    esp_err_t result = json.finish();
+
+    if (result == ESP_OK && reboot) {
+        ESP_LOGI (TAG8, "rebooting to apply new settings");
+        result = schedule_deferred_reboot (req);
     }
+    return result;
+}
 
-    if (nvs_commit (s_nvs_settings_handle) != ESP_OK)
-        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "failed commit settings to nvs");
+/**
+ * The GET and POST handlers of a settings group, for api_handlers[].
+ */
+#define SETTINGS_HANDLERS(prefix, group)          \
+    esp_err_t prefix##_get (httpd_req_t * req) {  \
+        return settings_get (req, group);         \
+    }                                             \
+    esp_err_t prefix##_post (httpd_req_t * req) { \
+        return settings_post (req, group);        \
+    }
 
-    return retrieve_and_send_cw_macros (req);
-}
+SETTINGS_HANDLERS (handler_settings, GROUP_WIFI)
+SETTINGS_HANDLERS (handler_gps_settings, GROUP_GPS)
+SETTINGS_HANDLERS (handler_callsign_settings, GROUP_CALLSIGN)
+SETTINGS_HANDLERS (handler_license_settings, GROUP_LICENSE)
+SETTINGS_HANDLERS (handler_tune_targets, GROUP_TUNE_TARGETS)
+SETTINGS_HANDLERS (handler_cw_macros, GROUP_CW_MACROS)
 
 // ====================================================================================================
 // Radio Type
@@ -1,8 +1,13 @@
 #include "globals.h"
+#include "jobs.h"
+#include "json_writer.h"
 #include "kx_radio.h"
+#include "server_load.h"
 #include "timed_lock.h"
 #include "webserver.h"
 
+#include <cstdio>
+
 #include <esp_log.h>
 static const char * TAG8 = "sc:hdl_stat";
 
@@ -26,7 +31,7 @@ esp_err_t handler_connectionStatus_get (httpd_req_t * req) {
     else if (Ft8RadioExclusive) {
         symbol = "⚪";
     }
-    else if (kxRadio.is_keyer_active()) {
+    else if (job_is_active (JOB_KIND_KEYER)) {
         // CW keyer holds the radio mutex for the full transmit duration; report
         // transmitting directly instead of timing out trying to take the lock.
         symbol = "🔴";
@@ -54,3 +59,52 @@ esp_err_t handler_connectionStatus_get (httpd_req_t * req) {
 
     REPLY_WITH_STRING (req, symbol, "connection status");
 }
+
+/**
+ * Handles an HTTP GET request for the web server's load and admission counters, for
+ * monitoring: the current poll interval hint and what it is made of, requests admitted
+ * and refused (429) per class since boot, and the clients currently tracked.
+ *
+ * @param req Pointer to the HTTP request structure.
+ * @return ESP_OK if the counters were sent; otherwise, an error code.
+ */
+esp_err_t handler_serverLoad_get (httpd_req_t * req) {
+    showActivity();
+
+    ESP_LOGV (TAG8, "trace: %s()", __func__);
+
+    server_load_stats_t stats;
+    server_load_get_stats (&stats);
+
+    JsonWriter json (req);
+    json.begin_object();
+    json.integer ("pollIntervalMs", server_load_poll_interval_ms());
+    json.integer ("activeClients", server_load_active_clients());
+    json.integer ("radioLockWaitMs", kxRadio.lock_contention().average_wait_ms());
+    json.integer ("radioLockTimeouts", kxRadio.lock_contention().timeouts());
+
+    json.begin_object ("classes");
+    for (int c = 0; c < RATE_CLASS_COUNT; ++c) {
+        json.begin_object (rate_class_name ((rate_class_t)c));
+        json.integer ("admitted", stats.classes[c].admitted);
+        json.integer ("limited", stats.classes[c].limited);
+        json.end_object();
+    }
+    json.end_object();
+
+    json.begin_array ("clients");
+    for (int i = 0; i < stats.client_count; ++i) {
+        const client_stats_t & client = stats.clients[i];
+        const uint8_t *        octets = (const uint8_t *)&client.address;  // network byte order
+        char                   address[16];
+        snprintf (address, sizeof (address), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+        json.begin_object();
+        json.string ("address", address);
+        json.integer ("idleMs", client.idle_ms);
+        json.integer ("limited", client.limited);
+        json.end_object();
+    }
+    json.end_array();
+    json.end_object();
+    return json.finish();
+}
@@ -1,4 +1,7 @@
+#include "clock_sync.h"
 #include "globals.h"
+#include "jobs.h"
+#include "json_writer.h"
 #include "kx_radio.h"
 #include "radio_driver.h"
 #include "timed_lock.h"
@@ -10,6 +13,8 @@
 #include <ctime>
 #include <memory>
 
+#include <esp_timer.h>
+
 #include <esp_log.h>
 static const char * TAG8 = "sc:hdl_time";
 
@@ -40,8 +45,42 @@ static bool convert_client_time (long int long_time, RadioTimeHms * client_time)
     return false;
 }
 
+/**
+ * Argument of a time-sync job: the client's clock, plus when we received it so the
+ * time can be advanced by however long the job waited in the queue. Both are kept finer
+ * than a second, so a wait of 1.9 s moves the clock by 2 s rather than 1 s.
+ */
+typedef struct {
+    int64_t client_time_ms;
+    int64_t accepted_us;
+} time_job_arg_t;
+
+/**
+ * Job body for an asynchronous time sync.
+ */
+static bool time_job (job_t * job) {
+    const time_job_arg_t * arg = (const time_job_arg_t *)job->arg;
+
+    TimedLock lock = kxRadio.timed_lock (RADIO_LOCK_TIMEOUT_CRITICAL_MS, "time SET job");
+    if (!lock.acquired())
+        return job_fail (job, "radio busy");
+    if (job_is_cancel_requested (job))
+        return false;
+    job_set_progress (job, 10);
+
+    int64_t      queued_ms = (esp_timer_get_time() - arg->accepted_us) / 1000;
+    int64_t      now_ms    = arg->client_time_ms + queued_ms;
+    RadioTimeHms client_time;
+    if (!convert_client_time ((long)((now_ms + 500) / 1000), &client_time))  // nearest second
+        return job_fail (job, "invalid time value");
+    if (!kxRadio.sync_time (client_time))
+        return job_fail (job, "failed to sync radio time");
+    return true;
+}
+
 /**
  * Handles an HTTP PUT request to update the time setting on the radio.
+ * With "Prefer: respond-async" the sync runs as a job and the reply is 202 with its location.
  *
  * @param req Pointer to the HTTP request structure.  The "time" query parameter
  *            is expected to hold the seconds since UTC epoch.
@@ -58,6 +97,11 @@ esp_err_t handler_time_put (httpd_req_t * req) {
     if (!convert_client_time (time_value, &client_time))
         REPLY_WITH_FAILURE (req, HTTPD_400_BAD_REQUEST, "invalid time value");
 
+    if (client_prefers_async (req)) {
+        time_job_arg_t arg = {(int64_t)time_value * 1000, esp_timer_get_time()};
+        return start_job_and_reply (req, JOB_KIND_TIME, time_job, nullptr, &arg, sizeof (arg));
+    }
+
     // Tier 3: Critical timeout for time setting
     TIMED_LOCK_OR_FAIL (req, kxRadio.timed_lock (RADIO_LOCK_TIMEOUT_CRITICAL_MS, "time SET")) {
         if (!kxRadio.sync_time (client_time))
@@ -66,3 +110,77 @@ esp_err_t handler_time_put (httpd_req_t * req) {
 
     REPLY_WITH_SUCCESS();
 }
+
+/**
+ * @return the query parameter as milliseconds since the epoch, or 0 if it is absent or malformed.
+ */
+static double client_time_ms (const request_query_t & query, const char * name) {
+    const char * value = request_query_value (query, name);
+    if (!value || !*value)
+        return 0;
+    char * end;
+    double ms = strtod (value, &end);
+    return (*end == '\0' && ms > 0) ? ms : 0;
+}
+
+/**
+ * Handles an HTTP GET request for one round trip of the clock discipline exchange (clock_sync.h).
+ * A burst is a few of these back to back; each request completes the round trip before it.
+ * Answered on the httpd task, never queued behind the radio, to keep the round trip short.
+ *
+ * @param req Pointer to the HTTP request structure. All query parameters are optional:
+ *            - 't1': the client's clock when it sent this request, in ms since the epoch;
+ *              starts a round trip.
+ *            - 'prev' and 't4': t1 of the previous round trip, and the client's clock when its
+ *              reply arrived; completes that round trip.
+ *            Replies with t1, the device's receive and reply times t2 and t3 (ms since the epoch),
+ *            and the state of the clock: offsetMs of the latest sample, drift, and uncertainty.
+ */
+esp_err_t handler_clock_get (httpd_req_t * req) {
+    int64_t received_us = esp_timer_get_time();
+    int64_t t2_us       = clock_sync_now_us();
+    showActivity();
+
+    ESP_LOGV (TAG8, "trace: %s()", __func__);
+
+    request_query_t query;
+    esp_err_t       err = request_query_parse (req, &query);
+    if (err == ESP_ERR_NO_MEM)
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "request arena exhausted");
+    if (err != ESP_OK && err != ESP_ERR_NOT_FOUND)
+        REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "query parsing error");
+
+    double t1   = client_time_ms (query, "t1");
+    double prev = client_time_ms (query, "prev");
+    double t4   = client_time_ms (query, "t4");
+    if (prev > 0 && t4 > 0 && !clock_sync_complete_exchange (prev, t4))
+        ESP_LOGD (TAG8, "round trip %.0f not counted", prev);
+
+    clock_sync_status_t status;
+    clock_sync_get_status (&status);
+
+    JsonWriter json (req);
+    json.begin_object();
+    if (t1 > 0) {
+        int64_t replied_us = esp_timer_get_time();
+        int64_t t3_us      = clock_sync_now_us();
+        clock_sync_begin_exchange (t1, received_us, replied_us);
+        json.number ("t1", t1, 3);
+        json.number ("t2", t2_us / 1000.0, 3);
+        json.number ("t3", t3_us / 1000.0, 3);
+    }
+    json.boolean ("synced", status.synced);
+    json.integer ("samples", status.samples);
+    json.integer ("steps", status.steps);
+    if (status.synced) {
+        json.number ("offsetMs", status.offset_us / 1000.0, 3);
+        json.number ("delayMs", status.delay_us / 1000.0, 3);
+        json.number ("driftPpm", status.drift_ppb / 1000.0, 3);
+        json.boolean ("driftEstimated", status.drift_estimated);
+        json.number ("slewRemainingMs", status.slew_remaining_us / 1000.0, 3);
+        json.number ("uncertaintyMs", status.uncertainty_us / 1000.0, 3);
+        json.integer ("lastSampleAgoS", status.last_sample_ago_us / 1000000);
+    }
+    json.end_object();
+    return json.finish();
+}
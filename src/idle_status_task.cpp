@@ -67,7 +67,7 @@ void idle_status_task (void * _pvParameter) {
         // If battery is sufficient, we reset timers instead of shutting down (allows indefinite
         // operation when charging via USB, since battery stays above threshold).
         if (blinks > 4) {
-            if (get_battery_percentage() < BATTERY_SHUTOFF_PERCENTAGE) {
+            if (get_battery_millipercent() < BATTERY_SHUTOFF_PERCENTAGE * 1000) {
                 gpio_set_level (LED_BLUE, LED_ON);
                 gpio_set_level (LED_RED, LED_ON);
                 vTaskDelay (LED_FLASH_MSEC * 15 / portTICK_PERIOD_MS);
@@ -0,0 +1,224 @@
+#include "jobs.h"
+#include "worker_pool.h"
+
+#include <cstring>
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:jobs....";
+
+static job_t             s_jobs[JOB_SLOTS];
+static uint32_t          s_next_job_id = 1;
+static SemaphoreHandle_t s_jobs_mutex  = nullptr;
+
+static const char * const s_kind_names[JOB_KIND_COUNT] = {"time", "atu", "ft8prepare", "keyer"};
+
+const char * job_kind_name (job_kind_t kind) {
+    return (kind < JOB_KIND_COUNT) ? s_kind_names[kind] : "unknown";
+}
+
+const char * job_state_name (job_state_t state) {
+    switch (state) {
+    case JOB_QUEUED: return "queued";
+    case JOB_RUNNING: return "running";
+    case JOB_SUCCEEDED: return "succeeded";
+    case JOB_FAILED: return "failed";
+    case JOB_CANCELLED: return "cancelled";
+    }
+    return "unknown";
+}
+
+static inline bool is_finished (job_state_t state) {
+    return state == JOB_SUCCEEDED || state == JOB_FAILED || state == JOB_CANCELLED;
+}
+
+void init_jobs () {
+    if (!s_jobs_mutex)
+        s_jobs_mutex = xSemaphoreCreateMutex();
+}
+
+static bool lock_jobs () {
+    return s_jobs_mutex && xSemaphoreTake (s_jobs_mutex, portMAX_DELAY) == pdTRUE;
+}
+
+static void unlock_jobs () {
+    xSemaphoreGive (s_jobs_mutex);
+}
+
+/**
+ * Worker-pool entry point: runs one job body and records its outcome.
+ */
+static void run_job (void * arg) {
+    job_t *    job  = (job_t *)arg;
+    uint32_t   id   = job->id;  // the slot may be recycled as soon as the final state is published
+    job_kind_t kind = job->kind;
+
+    job->state.store (JOB_RUNNING, std::memory_order_release);
+    ESP_LOGI (TAG8, "job %lu (%s) running", (unsigned long)id, job_kind_name (kind));
+
+    job_state_t final;
+    if (job->fn (job)) {
+        final = JOB_SUCCEEDED;
+        job->progress.store (100, std::memory_order_relaxed);
+    }
+    else if (job_is_cancel_requested (job) && job->error[0] == '\0')
+        final = JOB_CANCELLED;
+    else
+        final = JOB_FAILED;
+    ESP_LOGI (TAG8, "job %lu (%s) %s%s%s", (unsigned long)id, job_kind_name (kind), job_state_name (final),
+              job->error[0] ? ": " : "", job->error);
+
+    job->finished_us = esp_timer_get_time();
+    job->state.store (final, std::memory_order_release);
+}
+
+job_start_result_t job_start (job_kind_t kind, job_fn_t fn, job_cancel_fn_t on_cancel, const void * arg, size_t arg_len, uint32_t * out_id) {
+    ESP_LOGV (TAG8, "trace: %s(kind=%s)", __func__, job_kind_name (kind));
+
+    if (arg_len > JOB_ARG_SIZE || !lock_jobs())
+        return JOB_START_FULL;
+
+    // Pick a slot: refuse if this kind is already in flight, otherwise recycle the
+    // never-used or oldest finished slot.
+    job_t * slot = nullptr;
+    for (job_t & job : s_jobs) {
+        job_state_t state = job.state.load (std::memory_order_acquire);
+        if (job.id != 0 && !is_finished (state)) {
+            if (job.kind == kind) {
+                unlock_jobs();
+                return JOB_START_KIND_BUSY;
+            }
+            continue;
+        }
+        if (!slot || job.id == 0 || (slot->id != 0 && job.finished_us < slot->finished_us))
+            slot = &job;
+    }
+    if (!slot) {
+        unlock_jobs();
+        return JOB_START_FULL;
+    }
+
+    slot->id   = s_next_job_id++;
+    slot->kind = kind;
+    slot->state.store (JOB_QUEUED, std::memory_order_relaxed);
+    slot->progress.store (0, std::memory_order_relaxed);
+    slot->cancel_requested.store (false, std::memory_order_relaxed);
+    slot->fn          = fn;
+    slot->on_cancel   = on_cancel;
+    slot->created_us  = esp_timer_get_time();
+    slot->finished_us = 0;
+    slot->error[0]    = '\0';
+    if (arg_len)
+        memcpy (slot->arg, arg, arg_len);
+
+    if (!worker_pool_submit (run_job, slot)) {
+        // Hand the slot back as an already-finished job so it is recycled first.
+        slot->id          = 0;
+        slot->finished_us = 0;
+        slot->state.store (JOB_CANCELLED, std::memory_order_release);
+        unlock_jobs();
+        return JOB_START_FULL;
+    }
+
+    *out_id = slot->id;
+    unlock_jobs();
+    ESP_LOGI (TAG8, "job %lu (%s) queued", (unsigned long)*out_id, job_kind_name (kind));
+    return JOB_START_OK;
+}
+
+static void snapshot (const job_t & job, job_info_t * out, int64_t now_us) {
+    out->id               = job.id;
+    out->kind             = job.kind;
+    out->state            = job.state.load (std::memory_order_acquire);
+    out->progress         = job.progress.load (std::memory_order_relaxed);
+    out->cancel_requested = job.cancel_requested.load (std::memory_order_relaxed);
+    out->age_ms           = (now_us - job.created_us) / 1000;
+    // The error text is written by the job body before the final state is published.
+    if (is_finished (out->state))
+        strlcpy (out->error, job.error, sizeof (out->error));
+    else
+        out->error[0] = '\0';
+}
+
+bool job_get_info (uint32_t id, job_info_t * out) {
+    if (id == 0 || !lock_jobs())
+        return false;
+
+    bool found = false;
+    for (const job_t & job : s_jobs)
+        if (job.id == id) {
+            snapshot (job, out, esp_timer_get_time());
+            found = true;
+            break;
+        }
+
+    unlock_jobs();
+    return found;
+}
+
+size_t job_list (job_info_t * out, size_t max_entries) {
+    if (!lock_jobs())
+        return 0;
+
+    int64_t now_us = esp_timer_get_time();
+    size_t  count  = 0;
+    for (const job_t & job : s_jobs)
+        if (job.id != 0 && count < max_entries) {
+            // insertion sort, newest (highest id) first
+            size_t pos = count++;
+            while (pos > 0 && out[pos - 1].id < job.id) {
+                out[pos] = out[pos - 1];
+                --pos;
+            }
+            snapshot (job, &out[pos], now_us);
+        }
+
+    unlock_jobs();
+    return count;
+}
+
+bool job_cancel (uint32_t id) {
+    if (id == 0 || !lock_jobs())
+        return false;
+
+    job_t * target = nullptr;
+    for (job_t & job : s_jobs)
+        if (job.id == id) {
+            target = &job;
+            break;
+        }
+
+    if (target && !is_finished (target->state.load (std::memory_order_acquire))) {
+        ESP_LOGI (TAG8, "cancel requested for job %lu (%s)", (unsigned long)id, job_kind_name (target->kind));
+        target->cancel_requested.store (true, std::memory_order_release);
+        if (target->state.load (std::memory_order_acquire) == JOB_RUNNING && target->on_cancel)
+            target->on_cancel (target);
+    }
+
+    unlock_jobs();
+    return target != nullptr;
+}
+
+bool job_is_active (job_kind_t kind) {
+    // Lock-free on purpose: status polls use this to avoid waiting on anything.
+    for (const job_t & job : s_jobs)
+        if (job.id != 0 && job.kind == kind && !is_finished (job.state.load (std::memory_order_acquire)))
+            return true;
+    return false;
+}
+
+void job_set_progress (job_t * job, uint8_t percent) {
+    job->progress.store (percent > 100 ? 100 : percent, std::memory_order_relaxed);
+}
+
+bool job_is_cancel_requested (const job_t * job) {
+    return job->cancel_requested.load (std::memory_order_acquire);
+}
+
+bool job_fail (job_t * job, const char * message) {
+    strlcpy (job->error, message, sizeof (job->error));
+    return false;
+}
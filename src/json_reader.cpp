@@ -0,0 +1,330 @@
+#include "json_reader.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:json_rea";
+
+typedef struct {
+    char *          p;      // next character to read
+    const char *    start;  // for error positions
+    json_event_fn_t on_event;
+    void *          ctx;
+    bool            stopped;
+} json_reader_t;
+
+static bool fail (json_reader_t & r, const char * what) {
+    if (!r.stopped)
+        ESP_LOGW (TAG8, "json: %s at offset %u", what, (unsigned)(r.p - r.start));
+    return false;
+}
+
+static void skip_whitespace (json_reader_t & r) {
+    while (*r.p == ' ' || *r.p == '\t' || *r.p == '\n' || *r.p == '\r')
+        ++r.p;
+}
+
+static int hex_value (char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Reads the four hex digits of a \u escape starting at s.
+ * @return the code unit, or -1 if malformed.
+ */
+static int32_t read_hex4 (const char * s) {
+    int32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        int digit = hex_value (s[i]);
+        if (digit < 0)
+            return -1;
+        value = (value << 4) | digit;
+    }
+    return value;
+}
+
+/**
+ * Writes a code point as UTF-8.
+ * @return the position after the written bytes.
+ */
+static char * put_utf8 (char * out, uint32_t cp) {
+    if (cp < 0x80)
+        *out++ = (char)cp;
+    else if (cp < 0x800) {
+        *out++ = (char)(0xc0 | (cp >> 6));
+        *out++ = (char)(0x80 | (cp & 0x3f));
+    }
+    else if (cp < 0x10000) {
+        *out++ = (char)(0xe0 | (cp >> 12));
+        *out++ = (char)(0x80 | ((cp >> 6) & 0x3f));
+        *out++ = (char)(0x80 | (cp & 0x3f));
+    }
+    else {
+        *out++ = (char)(0xf0 | (cp >> 18));
+        *out++ = (char)(0x80 | ((cp >> 12) & 0x3f));
+        *out++ = (char)(0x80 | ((cp >> 6) & 0x3f));
+        *out++ = (char)(0x80 | (cp & 0x3f));
+    }
+    return out;
+}
+
+/**
+ * Reads the string whose opening quote is at r.p. With unescape, decodes it in place:
+ * the write position never passes the read position, since no escape is shorter than
+ * what it stands for. Otherwise only validates it, leaving the bytes untouched.
+ * @return start of the (unescaped, NUL-terminated) string, or nullptr if malformed.
+ */
+static char * read_string (json_reader_t & r, bool unescape) {
+    char * start = ++r.p;
+    char * out   = start;
+    for (;;) {
+        char c = *r.p;
+        if (c == '"')
+            break;
+        if (c == '\0') {
+            fail (r, "unterminated string");
+            return nullptr;
+        }
+        if ((unsigned char)c < 0x20) {
+            fail (r, "control character in string");
+            return nullptr;
+        }
+        if (c != '\\') {
+            if (unescape)
+                *out++ = c;
+            ++r.p;
+            continue;
+        }
+
+        char     e  = r.p[1];
+        uint32_t cp = 0;
+        switch (e) {
+        case '"':
+        case '\\':
+        case '/': cp = e; break;
+        case 'b': cp = '\b'; break;
+        case 'f': cp = '\f'; break;
+        case 'n': cp = '\n'; break;
+        case 'r': cp = '\r'; break;
+        case 't': cp = '\t'; break;
+        case 'u': {
+            int32_t unit = read_hex4 (r.p + 2);
+            if (unit < 0) {
+                fail (r, "bad \\u escape");
+                return nullptr;
+            }
+            cp = (uint32_t)unit;
+            if (cp >= 0xd800 && cp < 0xdc00 && r.p[6] == '\\' && r.p[7] == 'u') {
+                int32_t low = read_hex4 (r.p + 8);
+                if (low >= 0xdc00 && low < 0xe000) {
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (uint32_t)(low - 0xdc00);
+                    r.p += 6;  // the low surrogate's escape
+                }
+            }
+            r.p += 4;  // the hex digits
+            break;
+        }
+        default:
+            fail (r, "bad escape");
+            return nullptr;
+        }
+        r.p += 2;
+        if (unescape)
+            out = put_utf8 (out, cp);
+    }
+    if (unescape)
+        *out = '\0';
+    ++r.p;  // closing quote
+    return start;
+}
+
+/**
+ * Checks the number at r.p against the JSON grammar and moves past it.
+ */
+static bool skip_number (json_reader_t & r) {
+    char * s = r.p;
+    if (*s == '-')
+        ++s;
+    if (*s == '0')
+        ++s;
+    else if (*s >= '1' && *s <= '9')
+        while (*s >= '0' && *s <= '9')
+            ++s;
+    else
+        return fail (r, "bad number");
+    if (*s == '.') {
+        if (!(*++s >= '0' && *s <= '9'))
+            return fail (r, "bad number");
+        while (*s >= '0' && *s <= '9')
+            ++s;
+    }
+    if (*s == 'e' || *s == 'E') {
+        if (*++s == '+' || *s == '-')
+            ++s;
+        if (!(*s >= '0' && *s <= '9'))
+            return fail (r, "bad number");
+        while (*s >= '0' && *s <= '9')
+            ++s;
+    }
+    r.p = s;
+    return true;
+}
+
+static bool skip_literal (json_reader_t & r, const char * word, size_t len) {
+    if (strncmp (r.p, word, len) != 0)
+        return fail (r, "unexpected token");
+    r.p += len;
+    return true;
+}
+
+static bool emit (json_reader_t & r, const json_event_t & event, json_action_t * action = nullptr) {
+    json_action_t result = r.on_event (event, r.ctx);
+    if (action)
+        *action = result;
+    if (result == JSON_STOP) {
+        r.stopped = true;
+        return false;
+    }
+    return true;
+}
+
+static bool read_value (json_reader_t & r, int depth, const char * key, bool capture);
+
+/**
+ * Reads the members of an object or the elements of an array; r.p is just past the
+ * opening bracket. In capture mode nothing is reported and nothing is modified.
+ */
+static bool read_container (json_reader_t & r, int depth, bool is_object, bool capture) {
+    char close = is_object ? '}' : ']';
+    skip_whitespace (r);
+    if (*r.p == close) {
+        ++r.p;
+        return true;
+    }
+    for (;;) {
+        const char * key = nullptr;
+        if (is_object) {
+            skip_whitespace (r);
+            if (*r.p != '"')
+                return fail (r, "expected member name");
+            key = read_string (r, !capture);
+            if (!key)
+                return false;
+            skip_whitespace (r);
+            if (*r.p != ':')
+                return fail (r, "expected ':'");
+            ++r.p;
+        }
+        if (!read_value (r, depth + 1, key, capture))
+            return false;
+        skip_whitespace (r);
+        if (*r.p == ',') {
+            ++r.p;
+            continue;
+        }
+        if (*r.p == close) {
+            ++r.p;
+            return true;
+        }
+        return fail (r, is_object ? "expected ',' or '}'" : "expected ',' or ']'");
+    }
+}
+
+/**
+ * Reads one value and reports it (unless capturing an enclosing value).
+ * @param depth Depth of the value: 0 for the document, 1 for its members, ...
+ */
+static bool read_value (json_reader_t & r, int depth, const char * key, bool capture) {
+    skip_whitespace (r);
+
+    json_event_t event = {};
+    event.depth        = depth;
+    event.key          = key;
+
+    char c = *r.p;
+    if (c == '{' || c == '[') {
+        if (depth >= JSON_READER_MAX_DEPTH)
+            return fail (r, "nested too deeply");
+        bool is_object = (c == '{');
+        if (capture) {
+            ++r.p;
+            return read_container (r, depth, is_object, true);
+        }
+
+        char *        start  = r.p++;
+        json_action_t action = JSON_CONTINUE;
+        event.type           = is_object ? JSON_OBJECT_BEGIN : JSON_ARRAY_BEGIN;
+        if (!emit (r, event, &action))
+            return false;
+
+        bool take_whole = (action == JSON_CAPTURE);
+        if (!read_container (r, depth, is_object, take_whole))
+            return false;
+
+        if (take_whole) {
+            event.type    = JSON_RAW;
+            event.raw     = start;
+            event.raw_len = r.p - start;
+        }
+        else
+            event.type = is_object ? JSON_OBJECT_END : JSON_ARRAY_END;
+        return emit (r, event);
+    }
+
+    if (c == '"') {
+        char * value = read_string (r, !capture);
+        if (!value)
+            return false;
+        if (capture)
+            return true;
+        event.type   = JSON_STRING;
+        event.string = value;
+        return emit (r, event);
+    }
+
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        char * start = r.p;
+        if (!skip_number (r))
+            return false;
+        if (capture)
+            return true;
+        event.type   = JSON_NUMBER;
+        event.number = strtod (start, nullptr);
+        return emit (r, event);
+    }
+
+    if (c == 't' || c == 'f') {
+        event.boolean = (c == 't');
+        if (!(event.boolean ? skip_literal (r, "true", 4) : skip_literal (r, "false", 5)))
+            return false;
+        event.type = JSON_BOOL;
+        return capture || emit (r, event);
+    }
+
+    if (c == 'n') {
+        if (!skip_literal (r, "null", 4))
+            return false;
+        event.type = JSON_NULL;
+        return capture || emit (r, event);
+    }
+
+    return fail (r, "unexpected character");
+}
+
+bool json_parse_in_place (char * json, json_event_fn_t on_event, void * ctx) {
+    json_reader_t r = {json, json, on_event, ctx, false};
+    if (!read_value (r, 0, nullptr, false))
+        return false;
+    skip_whitespace (r);
+    if (*r.p != '\0')
+        return fail (r, "trailing characters");
+    return true;
+}
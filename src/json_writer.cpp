@@ -0,0 +1,205 @@
+#include "json_writer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:json_wri";
+
+JsonWriter::JsonWriter (httpd_req_t * req)
+    : m_req (req)
+    , m_error (ESP_OK)
+    , m_len (0)
+    , m_depth (0)
+    , m_has_members (0) {
+    httpd_resp_set_type (req, "application/json");
+}
+
+void JsonWriter::flush () {
+    if (m_len == 0 || m_error != ESP_OK)
+        return;
+    m_error = httpd_resp_send_chunk (m_req, m_buf, m_len);
+    if (m_error != ESP_OK)
+        ESP_LOGW (TAG8, "sending json chunk failed: %s", esp_err_to_name (m_error));
+    m_len = 0;
+}
+
+void JsonWriter::put (char c) {
+    if (m_error != ESP_OK)
+        return;
+    if (m_len == sizeof (m_buf))
+        flush();
+    m_buf[m_len++] = c;
+}
+
+void JsonWriter::put (const char * s, size_t len) {
+    while (len > 0 && m_error == ESP_OK) {
+        if (m_len == sizeof (m_buf))
+            flush();
+        size_t n = sizeof (m_buf) - m_len;
+        if (n > len)
+            n = len;
+        memcpy (m_buf + m_len, s, n);
+        m_len += n;
+        s += n;
+        len -= n;
+    }
+}
+
+void JsonWriter::put_escaped (const char * s) {
+    put ('"');
+    for (const char * run = s;; ++s) {
+        unsigned char c = (unsigned char)*s;
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        put (run, s - run);  // the unescaped stretch before this character
+        if (c == '\0')
+            break;
+        switch (c) {
+        case '"': put ("\\\"", 2); break;
+        case '\\': put ("\\\\", 2); break;
+        case '\b': put ("\\b", 2); break;
+        case '\f': put ("\\f", 2); break;
+        case '\n': put ("\\n", 2); break;
+        case '\r': put ("\\r", 2); break;
+        case '\t': put ("\\t", 2); break;
+        default: {
+            char escape[7];
+            snprintf (escape, sizeof (escape), "\\u%04x", c);
+            put (escape, 6);
+        }
+        }
+        run = s + 1;
+    }
+    put ('"');
+}
+
+/**
+ * Writes the separator and key (if any) that precede a value.
+ */
+void JsonWriter::begin_value (const char * key) {
+    uint32_t bit = 1u << m_depth;
+    if (m_has_members & bit)
+        put (',');
+    m_has_members |= bit;
+    if (key) {
+        put_escaped (key);
+        put (':');
+    }
+}
+
+/**
+ * Enters a container, or fails the whole document if it would nest deeper than
+ * JSON_WRITER_MAX_DEPTH: a container left out would make the rest of the output invalid.
+ */
+bool JsonWriter::begin_container (const char * key, char open) {
+    if (m_depth + 1 >= JSON_WRITER_MAX_DEPTH) {
+        ESP_LOGE (TAG8, "json nested deeper than %d", JSON_WRITER_MAX_DEPTH);
+        if (m_error == ESP_OK)
+            m_error = ESP_ERR_INVALID_SIZE;
+        return false;
+    }
+    begin_value (key);
+    put (open);
+    m_has_members &= ~(1u << ++m_depth);
+    return m_error == ESP_OK;
+}
+
+bool JsonWriter::begin_object (const char * key) {
+    return begin_container (key, '{');
+}
+
+void JsonWriter::end_object () {
+    if (m_depth > 0)
+        --m_depth;
+    put ('}');
+}
+
+bool JsonWriter::begin_array (const char * key) {
+    return begin_container (key, '[');
+}
+
+void JsonWriter::end_array () {
+    if (m_depth > 0)
+        --m_depth;
+    put (']');
+}
+
+void JsonWriter::string (const char * key, const char * value) {
+    begin_value (key);
+    put_escaped (value ? value : "");
+}
+
+void JsonWriter::integer (const char * key, long long value) {
+    char text[24];
+    int  len = snprintf (text, sizeof (text), "%lld", value);
+    begin_value (key);
+    put (text, len);
+}
+
+void JsonWriter::number (const char * key, double value, int decimals) {
+    if (!std::isfinite (value)) {
+        null (key);
+        return;
+    }
+    char text[32];
+    int  len = snprintf (text, sizeof (text), "%.*f", decimals, value);
+    begin_value (key);
+    put (text, (len > 0 && (size_t)len < sizeof (text)) ? len : 0);
+}
+
+void JsonWriter::fixed (const char * key, long long value, int scale, int decimals) {
+    bool               negative  = value < 0;
+    unsigned long long magnitude = negative ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    unsigned long long unit      = 1;
+    for (int i = 0; i < decimals; ++i)
+        unit *= 10;
+    if (scale > decimals) {
+        unsigned long long divisor = 1;
+        for (int i = decimals; i < scale; ++i)
+            divisor *= 10;
+        magnitude = (magnitude + divisor / 2) / divisor;
+    }
+    for (int i = scale; i < decimals; ++i)
+        magnitude *= 10;
+
+    char text[32];
+    int  len;
+    if (decimals > 0)
+        len = snprintf (text, sizeof (text), "%s%llu.%0*llu", negative && magnitude ? "-" : "", magnitude / unit, decimals, magnitude % unit);
+    else
+        len = snprintf (text, sizeof (text), "%s%llu", negative && magnitude ? "-" : "", magnitude);
+    begin_value (key);
+    put (text, (len > 0 && (size_t)len < sizeof (text)) ? len : 0);
+}
+
+void JsonWriter::boolean (const char * key, bool value) {
+    begin_value (key);
+    if (value)
+        put ("true", 4);
+    else
+        put ("false", 5);
+}
+
+void JsonWriter::null (const char * key) {
+    begin_value (key);
+    put ("null", 4);
+}
+
+void JsonWriter::raw (const char * key, const char * json) {
+    begin_value (key);
+    put (json, strlen (json));
+}
+
+esp_err_t JsonWriter::finish () {
+    if (m_depth != 0 && m_error == ESP_OK) {
+        ESP_LOGE (TAG8, "json finished with %u unclosed containers", m_depth);
+        m_error = ESP_ERR_INVALID_STATE;
+    }
+    flush();
+    if (m_error != ESP_OK)
+        return m_error;
+    return httpd_resp_send_chunk (m_req, nullptr, 0);
+}
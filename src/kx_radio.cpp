@@ -61,7 +61,7 @@ static bool uart_get_command (const char * command, char * response, int expecte
     int64_t start_time     = esp_timer_get_time();
     int     returned_chars = uart_read_bytes (UART_NUM, response, expected_chars, pdMS_TO_TICKS (wait_ms));
     int64_t end_time       = esp_timer_get_time();
-    float   elapsed_ms     = (end_time - start_time) / 1000.0;
+    long    elapsed_us     = (long)(end_time - start_time);
 
     // Null-terminate the response buffer safely
     if (returned_chars > 0)
@@ -72,7 +72,7 @@ static bool uart_get_command (const char * command, char * response, int expecte
     else
         response[0] = '\0';  // No characters received, so ensure it's an empty string
 
-    ESP_LOGD (TAG8, "command '%s' returned %d chars, '%s', after %.3f ms", command, returned_chars, response, elapsed_ms);
+    ESP_LOGD (TAG8, "command '%s' returned %d chars, '%s', after %ld us", command, returned_chars, response, elapsed_us);
 
     // Return if valid response achieved
     if (response[0] == command[0] && response[1] == command[1] &&  // got what we asked for
@@ -81,7 +81,7 @@ static bool uart_get_command (const char * command, char * response, int expecte
         return true;                                               // success
 
     // Invalid response, retry
-    ESP_LOGE (TAG8, "bad response from command '%s' after %.3f ms, expected %d bytes, received %d bytes, response=%c%c%c%c%c%c...", command, elapsed_ms, expected_chars, returned_chars, response[0], response[1], response[2], response[3], response[4], response[5]);
+    ESP_LOGE (TAG8, "bad response from command '%s' after %ld us, expected %d bytes, received %d bytes, response=%c%c%c%c%c%c...", command, elapsed_us, expected_chars, returned_chars, response[0], response[1], response[2], response[3], response[4], response[5]);
     if ((returned_chars == 2 && response[0] == '?' && response[1] == ';') ||  // radio busy, don't count as retry
         --tries > 0) {
         ESP_LOGI (TAG8, "Retrying...");
@@ -131,8 +131,15 @@ KXRadio & KXRadio::getInstance() {
     return instance;
 }
 
+// Waits for the radio mutex, for the server's load hints
+static LockContention s_lock_contention;
+
 TimedLock KXRadio::timed_lock (TickType_t timeout_ms, const char * operation) {
-    return TimedLock (m_mutex, timeout_ms, operation);
+    return TimedLock (m_mutex, timeout_ms, operation, &s_lock_contention);
+}
+
+const LockContention & KXRadio::lock_contention () const {
+    return s_lock_contention;
 }
 
 void KXRadio::select_driver() {
@@ -560,8 +567,8 @@ DELEGATE_BOOL (tune_atu,            ())
 
 DELEGATE_BOOL_CONST (supports_keyer)
 DELEGATE_BOOL_CONST (supports_volume)
+DELEGATE_BOOL_CONST (supports_sub_hz_tuning)
 
-DELEGATE_VOID (ft8_set_tone, (long base_freq, long frequency), base_freq, frequency)
 DELEGATE_VOID (ft8_tone_off, ())
 DELEGATE_VOID (ft8_tone_on,  ())
 // clang-format on
@@ -570,6 +577,13 @@ DELEGATE_VOID (ft8_tone_on,  ())
 #undef DELEGATE_BOOL_CONST
 #undef DELEGATE_VOID
 
+/**
+ * Formatting only touches the driver, not the UART, so it needs no lock.
+ */
+size_t KXRadio::ft8_tone_command (long base_freq, long frequency, char * command, size_t size) const {
+    return m_driver ? m_driver->ft8_tone_command (base_freq, frequency, command, size) : 0;
+}
+
 /**
  * Detects the type of radio (KX2 or KX3) by using the OM command.
  * According to the programmer's reference, the OM response format differs:
@@ -62,17 +62,41 @@ const uint8_t  FSTAT_DNR_RETRIES         = 10;
 // https://www.analog.com/media/en/technical-documentation/user-guides/modelgauge-m5-host-side-software-implementation-guide.pdf
 const float rSense_ohms        = 10.0e-3;  // Must match the PCB current-sense resistor (R_SENSE on the schematic)
 const float mAh_per_bit        = 0.5;      // datasheet page 16 (uVh/mOhms ?)
-const float uV_per_bit         = 78.125;
 const float uA_per_bit         = 1.5625 / rSense_ohms;  // (1.5625uV/ohm)*10mOhms = 156.25uA per bit
-const float uW_per_bit         = 8.0 / 10e-3;
-const float pct_SOC_per_bit    = 1.0 / 256.0;  // See page 16 of datasheet
-const float degC_per_bit       = 0.00391;
-const float sec_per_bit        = 5.625;
-const float sec_per_min        = 60.0;
-const float sec_per_hour       = 60.0 * sec_per_min;
 const float vempty_v_per_bit   = 0.010;  // default 3.30  -- voltage at which to declare SOC 0%
 const float vrecover_v_per_bit = 0.040;  // default 3.88 -- voltage at which to clear empty
 
+// The same units in integers, for polling: rSense in milliohms, and each register's LSB as a fraction
+const int32_t rSense_milliohms = 10;
+
+int32_t max17260_millivolts (uint16_t voltage) {
+    return ((int32_t)voltage * 5 + 32) / 64;  // 78.125uV
+}
+
+int32_t max17260_microamps (int16_t current) {
+    return (int32_t)current * 3125 / (2 * rSense_milliohms);  // 1.5625uV / rSense
+}
+
+int32_t max17260_microamp_hours (uint16_t capacity) {
+    return (int32_t)capacity * 5000 / rSense_milliohms;  // 5.0uVh / rSense
+}
+
+int32_t max17260_millipercent (uint16_t state_of_charge) {
+    return ((int32_t)state_of_charge * 1000 + 128) / 256;  // 1/256%
+}
+
+int32_t max17260_seconds (uint16_t time) {
+    return ((int32_t)time * 45 + 4) / 8;  // 5.625s
+}
+
+int32_t max17260_millidegrees (int16_t temperature) {
+    return (int32_t)temperature * 1000 / 256;  // 1/256 degC
+}
+
+int32_t max17260_microwatts (int16_t power) {
+    return (int32_t)power * 8000 / rSense_milliohms;  // 8uV^2 / rSense
+}
+
 // Registers like capacity are odd and can cause problems if the units are incorrect
 // Divide by units_per_bit to set a register, multiply when reading for display
 
@@ -140,6 +164,7 @@ esp_err_t Max17620::init (smbus_info_t * smb, max17620_setup_t * setup) {
 
     m_smb = smb;
     std::memcpy (&m_setup, setup, sizeof (max17620_setup_t));
+    m_charging_current = (int16_t)(0.125 * setup->i_chg_term * 1000 / uA_per_bit);
 
     if (ESP_OK != present())
         return ESP_FAIL;
@@ -234,7 +259,7 @@ esp_err_t Max17620::read_learned_params (max17260_saved_params_t * params) {
     smbus_read_word (m_smb, CYCLES, &(params->Cycles));          // Read Cycles
     smbus_read_word (m_smb, FULLCAPNOM, &(params->FullCapNom));  // Read FullCapNom
 
-    ESP_LOGV (TAG8, "RCOMP0: %d TempCo: %d, FullCapRep: %3.1f, Cycles: %3.2f, FullCapNom: %3.1f", params->RCOMP0, params->TempCo, params->FullCapRep * mAh_per_bit, (float)params->Cycles * 0.01, params->FullCapNom * mAh_per_bit);
+    ESP_LOGV (TAG8, "RCOMP0: %d TempCo: %d, FullCapRep: %ldmAh, Cycles: %d.%02d, FullCapNom: %ldmAh", params->RCOMP0, params->TempCo, (long)max17260_microamp_hours (params->FullCapRep) / 1000, params->Cycles / 100, params->Cycles % 100, (long)max17260_microamp_hours (params->FullCapNom) / 1000);
 
     return ESP_OK;
 }
@@ -262,55 +287,29 @@ esp_err_t Max17620::poll (max17260_info_t * info) {
     if (ESP_OK != check_POR())  // chip is not already configured
         init (m_smb, &m_setup);
 
-    uint16_t RepCap         = 0;
-    uint16_t RepSOC         = 0;
-    uint16_t TimeToEmpty    = 0;
-    uint16_t TimeToFull     = 0;
-    uint16_t VCell          = 0;
-    uint16_t VCellAvg       = 0;
-    int16_t  Current        = 0;
-    int16_t  CurrentAvg     = 0;
-    int16_t  Temperature    = 0;
-    int16_t  TemperatureAvg = 0;
-    int16_t  Power          = 0;
-    int16_t  PowerAvg       = 0;
-
-    smbus_read_word (m_smb, REPCAPREG, &RepCap);
-    smbus_read_word (m_smb, REPSOC, &RepSOC);
-    smbus_read_word (m_smb, TTEREG, &TimeToEmpty);
-    smbus_read_word (m_smb, TTFREG, &TimeToFull);
-
-    smbus_read_word (m_smb, VCELL, &VCell);
-    smbus_read_word (m_smb, VCELLAVG, &VCellAvg);
-
-    smbus_read_word (m_smb, CURRENT, (uint16_t *)&Current);        // 8uV^2 / Rsense
-    smbus_read_word (m_smb, CURRENTAVG, (uint16_t *)&CurrentAvg);  // 8uV^2 / Rsense
-
-    smbus_read_word (m_smb, TEMPERATURE, (uint16_t *)&Temperature);
-    smbus_read_word (m_smb, TEMPERATUREAVG, (uint16_t *)&TemperatureAvg);
-
-    smbus_read_word (m_smb, POWER, (uint16_t *)&Power);
-    smbus_read_word (m_smb, POWERAVG, (uint16_t *)&PowerAvg);
-
-    info->voltage                  = (float)VCell * uV_per_bit * 1e-6;
-    info->voltage_average          = (float)VCellAvg * uV_per_bit * 1e-6;
-    info->current                  = (float)Current * uA_per_bit * 1e-3;
-    info->current_average          = (float)CurrentAvg * uA_per_bit * 1e-3;
-    info->reported_capacity        = RepCap * mAh_per_bit;
-    info->reported_state_of_charge = (float)RepSOC * pct_SOC_per_bit;
-    info->time_to_empty            = TimeToEmpty * sec_per_bit / sec_per_hour;
-    info->time_to_full             = TimeToFull * sec_per_bit / sec_per_hour;
-    info->temperature              = (float)Temperature * degC_per_bit;
-    info->temperature_average      = (float)TemperatureAvg * degC_per_bit;
-    info->power                    = (float)Power * uW_per_bit * 1e-3;
-    info->power_average            = (float)PowerAvg * uW_per_bit * 1e-3;
-
-    info->charging = info->current_average > (0.125 * m_setup.i_chg_term);
+    smbus_read_word (m_smb, REPCAPREG, &info->reported_capacity);
+    smbus_read_word (m_smb, REPSOC, &info->reported_state_of_charge);
+    smbus_read_word (m_smb, TTEREG, &info->time_to_empty);
+    smbus_read_word (m_smb, TTFREG, &info->time_to_full);
+
+    smbus_read_word (m_smb, VCELL, &info->voltage);
+    smbus_read_word (m_smb, VCELLAVG, &info->voltage_average);
+
+    smbus_read_word (m_smb, CURRENT, (uint16_t *)&info->current);             // 8uV^2 / Rsense
+    smbus_read_word (m_smb, CURRENTAVG, (uint16_t *)&info->current_average);  // 8uV^2 / Rsense
+
+    smbus_read_word (m_smb, TEMPERATURE, (uint16_t *)&info->temperature);
+    smbus_read_word (m_smb, TEMPERATUREAVG, (uint16_t *)&info->temperature_average);
+
+    smbus_read_word (m_smb, POWER, (uint16_t *)&info->power);
+    smbus_read_word (m_smb, POWERAVG, (uint16_t *)&info->power_average);
+
+    info->charging = info->current_average > m_charging_current;
     // TODO: Consider using the FSTAT.FQ bit when charging to detect full.
 
-    ESP_LOGV (TAG8, "RemCap: %3.1fmAh SOC: %2.1f%% TTE: %3.2fhr TTF: %3.2fhr", info->reported_capacity, info->reported_state_of_charge, info->time_to_empty, info->time_to_full);
-    ESP_LOGV (TAG8, "V: %3.2fV Va: %3.2fV I: %3.2fmA Ia: %3.2fmA", info->voltage, info->voltage_average, info->current, info->current_average);
-    ESP_LOGV (TAG8, "T: %2.1f Ta: %2.1f P: %3.2fmW Pa: %3.2fmW", info->temperature, info->temperature_average, info->power, info->power_average);
+    ESP_LOGV (TAG8, "RemCap: %ldmAh SOC: %ld.%03ld%% TTE: %lds TTF: %lds", (long)max17260_microamp_hours (info->reported_capacity) / 1000, (long)max17260_millipercent (info->reported_state_of_charge) / 1000, (long)max17260_millipercent (info->reported_state_of_charge) % 1000, (long)max17260_seconds (info->time_to_empty), (long)max17260_seconds (info->time_to_full));
+    ESP_LOGV (TAG8, "V: %ldmV Va: %ldmV I: %lduA Ia: %lduA", (long)max17260_millivolts (info->voltage), (long)max17260_millivolts (info->voltage_average), (long)max17260_microamps (info->current), (long)max17260_microamps (info->current_average));
+    ESP_LOGV (TAG8, "T: %ldmC Ta: %ldmC P: %lduW Pa: %lduW", (long)max17260_millidegrees (info->temperature), (long)max17260_millidegrees (info->temperature_average), (long)max17260_microwatts (info->power), (long)max17260_microwatts (info->power_average));
 
     read_learned_params (&m_saved_params);
 
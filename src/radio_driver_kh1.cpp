@@ -27,8 +27,25 @@ static bool get_kh1_display_frequency (KXRadio & radio, long & out_hz) {
 
     snprintf (freq_char, sizeof (freq_char), "%.*s", 8, response + 3);  // Characters 4-11 represent frequency as a string
 
-    double freq_dec = strtod (freq_char, NULL);
-    out_hz          = static_cast<long> (freq_dec * 1000);
+    // kHz with up to three decimals, read as whole hertz without floating point
+    const char * c        = freq_char;
+    int          decimals = -1;  // digits read after the point, once it is seen
+    out_hz                = 0;
+    while (*c == ' ')
+        ++c;
+    for (; *c; ++c) {
+        if (*c == '.' && decimals < 0)
+            decimals = 0;
+        else if (*c >= '0' && *c <= '9' && decimals < 3) {
+            out_hz = out_hz * 10 + (*c - '0');
+            if (decimals >= 0)
+                ++decimals;
+        }
+        else
+            break;
+    }
+    for (int d = decimals < 0 ? 0 : decimals; d < 3; ++d)
+        out_hz *= 10;
     return out_hz > 0;
 }
 
@@ -131,6 +148,10 @@ bool KH1RadioDriver::supports_volume() const {
     return true;
 }
 
+bool KH1RadioDriver::supports_sub_hz_tuning() const {
+    return false;  // FO offsets are whole hertz
+}
+
 bool KH1RadioDriver::get_frequency (KXRadio & radio, long & out_hz) {
     return get_kh1_display_frequency (radio, out_hz);
 }
@@ -269,7 +290,7 @@ bool KH1RadioDriver::send_keyer_message (KXRadio & radio, const char * message)
             vTaskDelay (pdMS_TO_TICKS (4 * ditPeriod));  // 7 total (last char includes 3)
         else {
             // send the character
-            char * ptr = std::strchr (morse, ch);
+            const char * ptr = std::strchr (morse, ch);
             if (!ptr) {
                 ESP_LOGW (TAG8, "Character '%c' not found in Morse code array, skipping", ch);
                 continue;
@@ -344,10 +365,8 @@ void KH1RadioDriver::ft8_tone_off (KXRadio & radio) {
     uart_write_bytes (UART_NUM, "FO99;", sizeof ("FO99;") - 1);
 }
 
-void KH1RadioDriver::ft8_set_tone (KXRadio & radio, long base_freq, long frequency) {
-    (void)radio;
-    char     command[8];
+size_t KH1RadioDriver::ft8_tone_command (long base_freq, long frequency, char * command, size_t size) const {
     unsigned offset = static_cast<unsigned> ((frequency - base_freq) % 100);
-    snprintf (command, sizeof (command), "FO%02u;", offset);
-    uart_write_bytes (UART_NUM, command, 5);
+    int      length = snprintf (command, size, "FO%02u;", offset);
+    return (length > 0 && (size_t)length < size) ? length : 0;
 }
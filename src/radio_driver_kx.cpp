@@ -56,6 +56,10 @@ bool KXRadioDriver::supports_volume() const {
     return true;
 }
 
+bool KXRadioDriver::supports_sub_hz_tuning() const {
+    return false;  // FA takes whole hertz
+}
+
 bool KXRadioDriver::get_frequency (KXRadio & radio, long & out_hz) {
     long frequency = radio.get_from_kx ("FA", SC_KX_COMMUNICATION_RETRIES, 11);
     if (frequency <= 0)
@@ -378,11 +382,9 @@ void KXRadioDriver::ft8_tone_off (KXRadio & radio) {
     uart_write_bytes (UART_NUM, "SWH16;", sizeof ("SWH16;") - 1);
 }
 
-void KXRadioDriver::ft8_set_tone (KXRadio & radio, long base_freq, long frequency) {
-    (void)radio;
+size_t KXRadioDriver::ft8_tone_command (long base_freq, long frequency, char * command, size_t size) const {
     (void)base_freq;
 
-    char command[16];
-    snprintf (command, sizeof (command), "FA%011ld;", frequency);
-    uart_write_bytes (UART_NUM, command, 14);
+    int length = snprintf (command, size, "FA%011ld;", frequency);
+    return (length > 0 && (size_t)length < size) ? length : 0;
 }
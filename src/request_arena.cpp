@@ -0,0 +1,91 @@
+#include "request_arena.h"
+#include "worker_pool.h"
+
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <stdint.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:req_arna";
+
+typedef struct {
+    std::atomic<TaskHandle_t> owner;
+    uint8_t *                 base;
+    size_t                    size;
+    size_t                    used;
+    size_t                    high_water;  // most bytes any single request has needed
+} request_arena_t;
+
+alignas (8) static uint8_t s_httpd_arena_buf[REQUEST_ARENA_SIZE];
+alignas (8) static uint8_t s_worker_arena_bufs[WORKER_POOL_TASK_COUNT][REQUEST_ARENA_WORKER_SIZE];
+
+static request_arena_t s_arenas[1 + WORKER_POOL_TASK_COUNT];
+
+/**
+ * @return the calling task's arena, or nullptr if it has not claimed one.
+ */
+static request_arena_t * current_arena () {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    for (request_arena_t & arena : s_arenas)
+        if (arena.owner.load (std::memory_order_acquire) == self)
+            return &arena;
+    return nullptr;
+}
+
+bool request_arena_begin () {
+    request_arena_t * arena = current_arena();
+    if (!arena) {
+        TaskHandle_t self = xTaskGetCurrentTaskHandle();
+        for (size_t i = 0; i < std::size (s_arenas) && !arena; ++i) {
+            TaskHandle_t unowned = nullptr;
+            if (s_arenas[i].owner.compare_exchange_strong (unowned, self, std::memory_order_acq_rel)) {
+                arena       = &s_arenas[i];
+                arena->base = (i == 0) ? s_httpd_arena_buf : s_worker_arena_bufs[i - 1];
+                arena->size = (i == 0) ? sizeof (s_httpd_arena_buf) : sizeof (s_worker_arena_bufs[0]);
+                ESP_LOGI (TAG8, "%s owns a %u byte request arena", pcTaskGetName (NULL), (unsigned)arena->size);
+            }
+        }
+        if (!arena) {
+            ESP_LOGE (TAG8, "no request arena left for %s", pcTaskGetName (NULL));
+            return false;
+        }
+    }
+    arena->used = 0;
+    return true;
+}
+
+void request_arena_end () {
+    request_arena_t * arena = current_arena();
+    if (!arena)
+        return;
+    if (arena->used > arena->high_water) {
+        arena->high_water = arena->used;
+        ESP_LOGD (TAG8, "request arena high water on %s: %u of %u bytes", pcTaskGetName (NULL), (unsigned)arena->used, (unsigned)arena->size);
+    }
+    arena->used = 0;
+}
+
+void * request_arena_alloc (size_t size) {
+    request_arena_t * arena = current_arena();
+    if (!arena)
+        return nullptr;
+
+    size_t start = (arena->used + 7) & ~(size_t)7;
+    if (start > arena->size || size > arena->size - start) {
+        ESP_LOGW (TAG8, "request arena exhausted: %u bytes wanted, %u of %u in use", (unsigned)size, (unsigned)arena->used, (unsigned)arena->size);
+        return nullptr;
+    }
+    arena->used = start + size;
+    return arena->base + start;
+}
+
+void * request_arena_calloc (size_t size) {
+    void * p = request_arena_alloc (size);
+    if (p)
+        memset (p, 0, size);
+    return p;
+}
@@ -0,0 +1,214 @@
+#include "server_load.h"
+#include "kx_radio.h"
+#include "request_arena.h"
+#include "timed_lock.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <lwip/sockets.h>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:srv_load";
+
+typedef struct {
+    uint16_t burst;       // tokens a full bucket holds: requests allowed back to back
+    uint16_t per_minute;  // tokens added per minute: the sustained rate
+} rate_limit_t;
+
+/**
+ * Token buckets per class, for each client. The web UI at its normal pace stays well
+ * inside these: a cold page load fetches about 30 assets, the pollers make a few status
+ * and radio requests every few seconds, and a job is polled twice a second.
+ */
+static const rate_limit_t s_rate_limits[RATE_CLASS_COUNT] = {
+    // burst  per_minute
+    {60, 600},  // RATE_CLASS_STATIC
+    {20, 240},  // RATE_CLASS_STATUS
+    {12, 120},  // RATE_CLASS_RADIO_GET
+    {10, 120},  // RATE_CLASS_RADIO_SET
+    {10, 30},   // RATE_CLASS_SETTINGS
+};
+
+static const char * const s_rate_class_names[RATE_CLASS_COUNT] = {
+    "static",
+    "status",
+    "radioGet",
+    "radioSet",
+    "settings",
+};
+
+typedef struct {
+    uint32_t milli_tokens;  // thousandths of a token, so slow classes refill smoothly
+    int64_t  refilled_us;   // esp_timer time milli_tokens was last brought up to date
+} token_bucket_t;
+
+typedef struct {
+    uint32_t       address;       // client IPv4 address, or a fold of its IPv6 address; 0 = free slot
+    int64_t        last_seen_us;  // esp_timer time of its last request
+    uint32_t       limited;       // requests refused since the client took this slot
+    token_bucket_t buckets[RATE_CLASS_COUNT];
+} client_entry_t;
+
+static client_entry_t    s_clients[SERVER_LOAD_MAX_CLIENTS];
+static rate_counters_t   s_class_counters[RATE_CLASS_COUNT];
+static SemaphoreHandle_t s_clients_mutex = nullptr;
+
+void init_server_load () {
+    if (!s_clients_mutex)
+        s_clients_mutex = xSemaphoreCreateMutex();
+}
+
+/**
+ * Identifies the peer of a request's socket by its address (the port changes with every
+ * connection, so it is left out).
+ * @return the address key, or 0 if the peer is unknown.
+ */
+static uint32_t client_address (httpd_req_t * req) {
+    struct sockaddr_storage peer;
+    socklen_t               len = sizeof (peer);
+    if (getpeername (httpd_req_to_sockfd (req), (struct sockaddr *)&peer, &len) != 0)
+        return 0;
+
+    if (peer.ss_family == AF_INET)
+        return ((struct sockaddr_in *)&peer)->sin_addr.s_addr;
+    if (peer.ss_family == AF_INET6) {
+        uint32_t words[4];
+        memcpy (words, &((struct sockaddr_in6 *)&peer)->sin6_addr, sizeof (words));
+        // An IPv4-mapped address (::ffff:a.b.c.d) keys the same as plain IPv4
+        if (words[0] == 0 && words[1] == 0 && words[2] == htonl (0xffff))
+            return words[3];
+        return words[0] ^ words[1] ^ words[2] ^ words[3];
+    }
+    return 0;
+}
+
+const char * rate_class_name (rate_class_t rate_class) {
+    return rate_class < RATE_CLASS_COUNT ? s_rate_class_names[rate_class] : "unknown";
+}
+
+/**
+ * Finds a client's slot, or gives it a free one, or the one idle the longest, with full
+ * buckets. Call with s_clients_mutex held.
+ */
+static client_entry_t & client_slot (uint32_t address, int64_t now) {
+    client_entry_t * slot = nullptr;
+    for (client_entry_t & client : s_clients) {
+        if (client.address == address)
+            return client;
+        if (!slot || (slot->address && (!client.address || client.last_seen_us < slot->last_seen_us)))
+            slot = &client;
+    }
+
+    ESP_LOGD (TAG8, "new client %08lx", (unsigned long)address);
+    slot->address = address;
+    slot->limited = 0;
+    for (int c = 0; c < RATE_CLASS_COUNT; ++c) {
+        slot->buckets[c].milli_tokens = s_rate_limits[c].burst * 1000u;
+        slot->buckets[c].refilled_us  = now;
+    }
+    return *slot;
+}
+
+/**
+ * Adds the tokens earned since the last refill, up to the bucket's burst.
+ */
+static void refill (token_bucket_t & bucket, const rate_limit_t & limit, int64_t now) {
+    // (elapsed_us / 60e6 minutes) * per_minute tokens * 1000 milli-tokens
+    int64_t earned = (now - bucket.refilled_us) * limit.per_minute / 60000;
+    int64_t full   = limit.burst * 1000;
+    if (earned <= 0)
+        return;
+    bucket.milli_tokens = (uint32_t)(bucket.milli_tokens + earned < full ? bucket.milli_tokens + earned : full);
+    // Advance by the time actually converted, so rounding never loses refill time
+    bucket.refilled_us = bucket.milli_tokens == full ? now : bucket.refilled_us + earned * 60000 / limit.per_minute;
+}
+
+bool server_load_admit (httpd_req_t * req, rate_class_t rate_class, int * retry_after_s) {
+    uint32_t address = client_address (req);
+    if (!address || !s_clients_mutex || rate_class >= RATE_CLASS_COUNT)
+        return true;
+
+    const rate_limit_t & limit    = s_rate_limits[rate_class];
+    int64_t              now      = esp_timer_get_time();
+    bool                 admitted = true;
+
+    xSemaphoreTake (s_clients_mutex, portMAX_DELAY);
+    client_entry_t & client = client_slot (address, now);
+    client.last_seen_us     = now;
+
+    token_bucket_t & bucket = client.buckets[rate_class];
+    refill (bucket, limit, now);
+    if (bucket.milli_tokens >= 1000) {
+        bucket.milli_tokens -= 1000;
+        s_class_counters[rate_class].admitted++;
+    }
+    else {
+        int64_t wait_us = (int64_t)(1000 - bucket.milli_tokens) * 60000 / limit.per_minute;
+        *retry_after_s  = (int)((wait_us + 999999) / 1000000);
+        client.limited++;
+        s_class_counters[rate_class].limited++;
+        admitted = false;
+    }
+    xSemaphoreGive (s_clients_mutex);
+
+    if (!admitted)
+        ESP_LOGI (TAG8, "client %08lx over its %s rate, retry in %d s", (unsigned long)address, rate_class_name (rate_class), *retry_after_s);
+    return admitted;
+}
+
+void server_load_get_stats (server_load_stats_t * stats) {
+    memset (stats, 0, sizeof (*stats));
+    if (!s_clients_mutex)
+        return;
+
+    int64_t now = esp_timer_get_time();
+    xSemaphoreTake (s_clients_mutex, portMAX_DELAY);
+    memcpy (stats->classes, s_class_counters, sizeof (stats->classes));
+    for (const client_entry_t & client : s_clients) {
+        if (!client.address)
+            continue;
+        client_stats_t & out = stats->clients[stats->client_count++];
+        out.address          = client.address;
+        out.idle_ms          = (uint32_t)((now - client.last_seen_us) / 1000);
+        out.limited          = client.limited;
+    }
+    xSemaphoreGive (s_clients_mutex);
+}
+
+int server_load_active_clients () {
+    if (!s_clients_mutex)
+        return 0;
+
+    int64_t now    = esp_timer_get_time();
+    int     active = 0;
+    xSemaphoreTake (s_clients_mutex, portMAX_DELAY);
+    for (const client_entry_t & client : s_clients)
+        if (client.address && now - client.last_seen_us < SERVER_LOAD_CLIENT_ACTIVE_US)
+            ++active;
+    xSemaphoreGive (s_clients_mutex);
+    return active;
+}
+
+uint32_t server_load_poll_interval_ms () {
+    int      clients  = server_load_active_clients();
+    uint32_t interval = POLL_INTERVAL_PER_CLIENT_MS * (clients > 0 ? clients : 1) +
+                        POLL_INTERVAL_PER_WAIT * kxRadio.lock_contention().average_wait_ms();
+    return interval < POLL_INTERVAL_MAX_MS ? interval : POLL_INTERVAL_MAX_MS;
+}
+
+int server_load_retry_after_s () {
+    return (int)((server_load_poll_interval_ms() + 999) / 1000);
+}
+
+void server_load_set_hints (httpd_req_t * req) {
+    char * interval = (char *)request_arena_alloc (12);
+    if (!interval)
+        return;
+    snprintf (interval, 12, "%lu", (unsigned long)server_load_poll_interval_ms());
+    httpd_resp_set_hdr (req, "X-Poll-Interval", interval);
+}
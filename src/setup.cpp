@@ -1,6 +1,8 @@
 #include "setup.h"
 #include "battery_monitor.h"
+#include "clock_sync.h"
 #include "enter_deep_sleep.h"
+#include "fsk_engine.h"
 #include "globals.h"
 #include "hardware_specific.h"
 #include "idle_status_task.h"
@@ -35,7 +37,7 @@ void startup_watchdog_timer (void * _) {
     }
     // We will never turn off if the unit is plugged in and is charging,
     // as the battery voltage will never dip below 80%.
-    while (get_battery_percentage() >= BATTERY_SHUTOFF_PERCENTAGE);
+    while (get_battery_millipercent() >= BATTERY_SHUTOFF_PERCENTAGE * 1000);
 
     ESP_LOGI (TAG8, "Startup watchdog timer expired, and battery not charged; shutting down.");
     enter_deep_sleep();
@@ -109,6 +111,8 @@ void setup () {
 
     // Initialize and restore settings
     init_settings();
+    init_clock_sync();
+    init_fsk_engine();
 
     // Start battery monitoring by enabling the ADC
     setup_adc();
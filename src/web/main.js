@@ -27,6 +27,10 @@ const CONNECTION_STATUS_TIMEOUT_MS = 3000;  // < 5 sec polling interval
 const BATTERY_INFO_TIMEOUT_MS = 30000;      // < 60 sec polling interval
 const VFO_TIMEOUT_MS = 2000;                // < 3 sec polling interval
 
+// Long-running radio jobs (ATU tune, time sync) - see runRadioJob()
+const JOB_POLL_INTERVAL_MS = 500;
+const JOB_POLL_TIMEOUT_MS = 30000;
+
 // ============================================================================
 // Frequency Constants
 // ============================================================================
@@ -73,6 +77,127 @@ function fetchQuiet(url, options = {}, context = "Fetch") {
     return fetch(url, options).catch((err) => Log.error(context)(url, err.message));
 }
 
+// Run a slow radio command as a job: ask for "202 Accepted" and poll the job until it
+// finishes. Firmware without job support answers the command synchronously, which is
+// treated as already finished. Resolves on success, throws with the device's error text.
+async function runRadioJob(url, options = {}) {
+    const headers = Object.assign({}, options.headers, { Prefer: "respond-async" });
+    const response = await fetch(url, Object.assign({}, options, { headers }));
+    if (response.status !== 202) {
+        if (response.ok) return;
+        const data = await response.json().catch(() => ({}));
+        throw new Error(data.error || `HTTP ${response.status}`);
+    }
+
+    const job = await response.json();
+    const jobUrl = response.headers.get("Location") || `/api/v1/jobs/${job.id}`;
+    const deadline = Date.now() + JOB_POLL_TIMEOUT_MS;
+    while (Date.now() < deadline) {
+        await new Promise((resolve) => setTimeout(resolve, JOB_POLL_INTERVAL_MS));
+        const poll = await fetch(jobUrl);
+        if (!poll.ok) throw new Error(`job ${job.id} lost (HTTP ${poll.status})`);
+        const state = await poll.json();
+        if (state.state === "succeeded") return;
+        if (state.state === "failed" || state.state === "cancelled") {
+            throw new Error(state.error || `job ${state.state}`);
+        }
+    }
+    throw new Error(`job ${job.id} timed out`);
+}
+
+// ============================================================================
+// Server Load Hints
+// ============================================================================
+// API replies carry X-Poll-Interval (ms): how often each client should poll, given how
+// many clients the device is serving and how contended the radio is. "Busy" replies (503),
+// and "too many requests" replies (429) to a client over its rate limit, carry
+// Retry-After (s). Pollers run by startPolling() follow both, so polling slows down
+// under load instead of piling retries onto a busy radio.
+
+const ServerLoad = {
+    pollIntervalMs: 0, // latest X-Poll-Interval; 0 = none seen (older firmware)
+    retryAt: 0, // Date.now() before which no poll should be sent
+};
+
+// Record the load hints of an API response
+function noteServerLoad(response) {
+    if (!response || !response.headers) return;
+    const interval = parseInt(response.headers.get("X-Poll-Interval"), 10);
+    if (interval > 0) ServerLoad.pollIntervalMs = interval;
+    if (response.status === 503 || response.status === 429) {
+        const retryAfterS = parseInt(response.headers.get("Retry-After"), 10) || 1;
+        ServerLoad.retryAt = Math.max(ServerLoad.retryAt, Date.now() + retryAfterS * 1000);
+    }
+}
+
+// Delay before the next run of a poller whose own interval is baseMs
+function nextPollDelay(baseMs) {
+    return Math.max(baseMs, ServerLoad.pollIntervalMs, ServerLoad.retryAt - Date.now());
+}
+
+// Run poll() repeatedly, each run nextPollDelay(baseMs) after the previous one completed.
+// Returns a handle for stopPolling().
+function startPolling(poll, baseMs) {
+    const poller = { timer: null, stopped: false };
+    const tick = async () => {
+        try {
+            await poll();
+        } finally {
+            if (!poller.stopped) poller.timer = setTimeout(tick, nextPollDelay(baseMs));
+        }
+    };
+    poller.timer = setTimeout(tick, nextPollDelay(baseMs));
+    return poller;
+}
+
+function stopPolling(poller) {
+    if (!poller) return;
+    poller.stopped = true;
+    clearTimeout(poller.timer);
+}
+
+// ============================================================================
+// Device Clock Discipline
+// ============================================================================
+// FT8 and FT4 transmit on the 15 s and 7.5 s slot boundaries of the device's clock. A burst
+// of timestamped round trips to /api/v1/clock lets the device measure its offset from this
+// browser's clock, NTP style, and trust the quickest round trip, which queued the least.
+// Bursts repeated over time let it estimate its crystal's drift. Each request completes the
+// round trip before it by reporting when that reply arrived (t4).
+
+const CLOCK_SYNC_ROUNDS = 8;
+const CLOCK_SYNC_INTERVAL_MS = 600000; // 10 min: spread-out bursts give the drift rate
+
+// Run one burst of round trips; resolves to the device's clock state after the last one
+async function syncDeviceClock(rounds = CLOCK_SYNC_ROUNDS) {
+    let previous = null; // { t1, t4 } of the round trip before
+    let state = null;
+    for (let i = 0; i <= rounds; i++) {
+        const params = [];
+        const t1 = Date.now();
+        if (i < rounds) params.push(`t1=${t1}`);
+        if (previous) params.push(`prev=${previous.t1}`, `t4=${previous.t4}`);
+        const response = await fetch(`/api/v1/clock?${params.join("&")}`);
+        const t4 = Date.now();
+        noteServerLoad(response);
+        if (!response.ok) throw new Error(`HTTP ${response.status}`);
+        state = await response.json();
+        previous = { t1: t1, t4: t4 };
+    }
+    return state;
+}
+
+async function runClockSync() {
+    try {
+        const state = await syncDeviceClock();
+        if (state && state.synced) {
+            Log.debug("Clock")(`offset ${state.offsetMs} ms, uncertainty ${state.uncertaintyMs} ms, drift ${state.driftPpm} ppm`);
+        }
+    } catch (error) {
+        Log.debug("Clock")("sync failed:", error.message); // older firmware has no /clock
+    }
+}
+
 // ============================================================================
 // Global Application State
 // ============================================================================
@@ -108,7 +233,7 @@ const AppState = {
     vfoFrequencyHz: null,   // null = unknown/not connected
     vfoMode: null,
     vfoLastUpdated: 0,
-    vfoUpdateInterval: null,
+    vfoUpdateInterval: null, // poller handle from startPolling()
     vfoChangeCallbacks: [], // subscribers for VFO change notifications
 
     // Tune targets (WebSDR, KiwiSDR URLs)
@@ -119,6 +244,9 @@ const AppState = {
     // CW Macros (configurable keyer buttons)
     cwMacros: null,            // null = not loaded, [] = loaded but empty
 
+    // Version of the device configuration last applied from /api/v1/config
+    configVersion: null,       // null = not loaded
+
     // Transmit state (shared between Spot and Chase pages)
     isXmitActive: false,
 };
@@ -155,26 +283,70 @@ function normalizeTuneTargets(targets) {
     });
 }
 
+// ============================================================================
+// Configuration Bundle
+// ============================================================================
+
+// How long a fetched config is reused, so the loaders run on page entry share one request
+const CONFIG_REUSE_MS = 3000;
+
+let configFetchPromise = null;
+
+// Fetch all user configuration from /api/v1/config in one round trip, and apply it to AppState.
+// Calls within CONFIG_REUSE_MS of a fetch share it. Resolves to the config, or null if the
+// device is unavailable.
+function fetchConfig() {
+    if (!configFetchPromise) {
+        configFetchPromise = fetch("/api/v1/config")
+            .then((response) => (response.ok ? response.json() : null))
+            .then((config) => {
+                if (config) applyConfig(config);
+                return config;
+            })
+            .catch((error) => {
+                Log.warn("App")("Failed to load config:", error);
+                return null;
+            });
+        setTimeout(invalidateConfig, CONFIG_REUSE_MS);
+    }
+    return configFetchPromise;
+}
+
+// Forget the fetched config, so the next fetchConfig() asks the device (call after saving)
+function invalidateConfig() {
+    configFetchPromise = null;
+}
+
+// Copy the device configuration into AppState and the localStorage caches.
+// Skipped when the config version hasn't changed since it was last applied.
+function applyConfig(config) {
+    if (config.version === AppState.configVersion) return;
+    AppState.configVersion = config.version;
+
+    if (config.callsign) AppState.callSign = (config.callsign.callsign || "").toUpperCase();
+    if (config.license) AppState.licenseClass = (config.license.license || "").toUpperCase();
+    if (config.tuneTargets) {
+        AppState.tuneTargets = normalizeTuneTargets(config.tuneTargets.targets);
+        AppState.tuneTargetsMobile = config.tuneTargets.mobile || false;
+        saveTuneTargetsToLocalStorage(AppState.tuneTargets, AppState.tuneTargetsMobile);
+    }
+    if (config.cwMacros) {
+        AppState.cwMacros = Array.isArray(config.cwMacros.macros) ? config.cwMacros.macros : [];
+        saveCwMacrosToLocalStorage(AppState.cwMacros);
+    }
+    Log.debug("App")("Config version", config.version, "applied");
+}
+
 // Load tune targets into AppState - called at app startup for Safari compatibility
 // IMPORTANT: Must be called early so openTuneTargets can be synchronous
 // Falls back to localStorage cache when hardware API is unavailable (e.g., local dev)
 async function loadTuneTargetsAsync() {
-    try {
-        const response = await fetch("/api/v1/tuneTargets");
-        if (response.ok) {
-            const data = await response.json();
-            AppState.tuneTargets = normalizeTuneTargets(data.targets);
-            AppState.tuneTargetsMobile = data.mobile || false;
-            // Cache to localStorage for offline/local dev use
-            saveTuneTargetsToLocalStorage(AppState.tuneTargets, AppState.tuneTargetsMobile);
-            Log.debug("App")("Tune targets loaded from API:", AppState.tuneTargets.length);
-        } else {
-            // API returned error - fall back to localStorage
-            loadTuneTargetsFromLocalStorage();
-        }
-    } catch (error) {
-        Log.warn("App")("Failed to load tune targets from API:", error);
-        // Fall back to localStorage cache
+    // applyConfig() caches them to localStorage for offline/local dev use
+    const config = await fetchConfig();
+    if (config && config.tuneTargets) {
+        Log.debug("App")("Tune targets loaded from API:", AppState.tuneTargets.length);
+    } else {
+        // API unavailable - fall back to localStorage cache
         loadTuneTargetsFromLocalStorage();
     }
 }
@@ -217,18 +389,10 @@ function loadTuneTargetsFromLocalStorage() {
 // Load CW macros into AppState - called at app startup
 // Falls back to localStorage cache when hardware API is unavailable
 async function loadCwMacrosAsync() {
-    try {
-        const response = await fetch("/api/v1/cwMacros");
-        if (response.ok) {
-            const data = await response.json();
-            AppState.cwMacros = Array.isArray(data.macros) ? data.macros : [];
-            saveCwMacrosToLocalStorage(AppState.cwMacros);
-            Log.debug("App")("CW macros loaded from API:", AppState.cwMacros.length);
-        } else {
-            loadCwMacrosFromLocalStorage();
-        }
-    } catch (error) {
-        Log.warn("App")("Failed to load CW macros from API:", error);
+    const config = await fetchConfig();
+    if (config && config.cwMacros) {
+        Log.debug("App")("CW macros loaded from API:", AppState.cwMacros.length);
+    } else {
         loadCwMacrosFromLocalStorage();
     }
 }
@@ -355,15 +519,7 @@ async function ensureCallSignLoaded() {
     if (AppState.callSign) {
         return AppState.callSign;
     }
-    try {
-        const response = await fetch("/api/v1/callsign");
-        const data = await response.json();
-        if (data.callsign) {
-            AppState.callSign = data.callsign.toUpperCase();
-        }
-    } catch (error) {
-        Log.warn("App")("Failed to load callsign:", error);
-    }
+    await fetchConfig();
     return AppState.callSign;
 }
 
@@ -373,14 +529,8 @@ async function ensureLicenseClassLoaded() {
     if (AppState.licenseClass !== null) {
         return AppState.licenseClass;
     }
-    try {
-        const response = await fetch("/api/v1/license");
-        const data = await response.json();
-        AppState.licenseClass = (data.license || "").toUpperCase();
-    } catch (error) {
-        Log.warn("App")("Failed to load license class:", error);
-        AppState.licenseClass = "";
-    }
+    const config = await fetchConfig();
+    if (!config) AppState.licenseClass = "";
     return AppState.licenseClass;
 }
 
@@ -808,6 +958,8 @@ async function fetchVfoState() {
             fetch("/api/v1/frequency", { signal: vfoController.signal }),
             fetch("/api/v1/mode", { signal: vfoController.signal }),
         ]);
+        noteServerLoad(freqResponse);
+        noteServerLoad(modeResponse);
 
         if (!freqResponse.ok || !modeResponse.ok) {
             Log.warn("VFO")("Failed to fetch VFO state");
@@ -858,15 +1010,15 @@ function startGlobalVfoPolling() {
     // Fetch immediately
     fetchVfoState();
 
-    // Start polling interval
-    AppState.vfoUpdateInterval = setInterval(fetchVfoState, VFO_POLLING_INTERVAL_MS);
+    // Keep polling, as often as the device allows
+    AppState.vfoUpdateInterval = startPolling(fetchVfoState, VFO_POLLING_INTERVAL_MS);
 }
 
 // Stop global VFO polling
 function stopGlobalVfoPolling() {
     if (AppState.vfoUpdateInterval) {
         Log.debug("VFO")("Stopping global VFO polling");
-        clearInterval(AppState.vfoUpdateInterval);
+        stopPolling(AppState.vfoUpdateInterval);
         AppState.vfoUpdateInterval = null;
     }
 }
@@ -970,6 +1122,7 @@ async function updateBatteryInfo() {
             fetch("/api/v1/batteryInfo", { signal: batteryController.signal }),
             fetch("/api/v1/rssi", { signal: batteryController.signal }),
         ]);
+        noteServerLoad(batteryInfoResponse);
 
         if (batteryInfoResponse.ok) {
             const info = await batteryInfoResponse.json();
@@ -1017,8 +1170,12 @@ async function updateConnectionStatus() {
         const response = await fetch("/api/v1/connectionStatus", {
             signal: connectionStatusController.signal,
         });
+        noteServerLoad(response);
 
-        if (response.ok) {
+        if (response.status === 503 || response.status === 429) {
+            // The device answered, but is busy: still connected, try again later
+            Log.debug("App")("Device busy, connection status deferred");
+        } else if (response.ok) {
             // Success - reset failure tracking
             AppState.consecutiveFailures = 0;
             AppState.lastSuccessfulPoll = Date.now();
@@ -1158,12 +1315,19 @@ async function tuneRadioHz(frequency, mode) {
     }
 }
 
+// Map a web asset's file name to the URL it is served from. Firmware builds serve assets
+// under content-hashed names and define ASSET_URLS in index.html; in development (mock
+// server) there is no map and the plain name is used.
+function assetUrl(name) {
+    return (typeof ASSET_URLS !== "undefined" && ASSET_URLS[name]) || name;
+}
+
 // Track loaded tab scripts to avoid duplicates
 const loadedTabScripts = new Set();
 
 // Load tab-specific JavaScript file if not already loaded (tabName: 'chase', 'cat', 'settings', 'about')
 async function loadTabScriptIfNeeded(tabName) {
-    const scriptPath = `${tabName}.js`;
+    const scriptPath = assetUrl(`${tabName}.js`);
     Log.debug("Script")(`Checking: ${scriptPath}`);
 
     if (loadedTabScripts.has(scriptPath)) {
@@ -1237,7 +1401,7 @@ async function openTab(tabName) {
         // Save the active tab to localStorage
         saveActiveTab(AppState.currentTabName);
 
-        const contentPath = `${AppState.currentTabName}.html`;
+        const contentPath = assetUrl(`${AppState.currentTabName}.html`);
         Log.debug("Tab")(`Fetching: ${contentPath}`);
 
         const response = await fetch(contentPath);
@@ -1338,11 +1502,15 @@ setInterval(refreshUTCClock, UTC_CLOCK_UPDATE_INTERVAL_MS);
 
 // Battery info - update every 1 minute
 updateBatteryInfo();
-setInterval(updateBatteryInfo, BATTERY_INFO_UPDATE_INTERVAL_MS);
+startPolling(updateBatteryInfo, BATTERY_INFO_UPDATE_INTERVAL_MS);
 
-// Connection status - update every 5 seconds
+// Connection status - update every 5 seconds, or less often when the device asks
 updateConnectionStatus();
-setInterval(updateConnectionStatus, CONNECTION_STATUS_UPDATE_INTERVAL_MS);
+startPolling(updateConnectionStatus, CONNECTION_STATUS_UPDATE_INTERVAL_MS);
+
+// Device clock - a burst of round trips now, and every 10 minutes for the drift estimate
+runClockSync();
+startPolling(runClockSync, CLOCK_SYNC_INTERVAL_MS);
 
 // ============================================================================
 // Page Visibility — Immediate Resume on Foreground
@@ -1413,6 +1581,7 @@ async function saveGpsToDevice(lat, lon) {
     });
 
     if (response.ok) {
+        invalidateConfig();
         // Update cached location to new value (don't clear - needed for location-based keys)
         AppState.gpsOverride = { latitude: lat, longitude: lon };
         localStorage.setItem("cachedGpsLocation", JSON.stringify(AppState.gpsOverride));
@@ -1562,8 +1731,8 @@ async function getLocation() {
 
     // Try to fetch from NVRAM (authoritative source)
     try {
-        const response = await fetch("/api/v1/gps");
-        const data = await response.json();
+        const config = await fetchConfig();
+        const data = (config && config.gps) || {};
         if (data.gps_lat && data.gps_lon) {
             Log.debug("GPS")("Using location from NVRAM");
             AppState.gpsOverride = { latitude: parseFloat(data.gps_lat), longitude: parseFloat(data.gps_lon) };
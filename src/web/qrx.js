@@ -13,16 +13,9 @@ async function syncTime() {
     const now = Math.round(Date.now() / 1000);
 
     try {
-        // Create the PUT request using Fetch API
-        const response = await fetch(`/api/v1/time?time=${now}`, { method: "PUT" });
-
-        if (response.status === 204) {
-            Log.debug("QRX")("Time sync successful");
-            return; // No content, sync was successful
-        } else if (!response.ok) {
-            const data = await response.json();
-            throw new Error(data.error || "Unknown error");
-        }
+        // The device compensates for the time the job spends queued behind other radio work
+        await runRadioJob(`/api/v1/time?time=${now}`, { method: "PUT" });
+        Log.debug("QRX")("Time sync successful");
     } catch (error) {
         Log.error("QRX")("Time sync failed:", error.message);
     }
@@ -11,7 +11,7 @@
 // Note: VFO frequency/mode are stored in global AppState for cross-page sharing
 const RunState = {
     // VFO polling state (frequency/mode stored in AppState)
-    vfoUpdateInterval: null,
+    vfoUpdateInterval: null, // poller handle from startPolling()
     lastUserAction: 0,
     isUpdatingVfo: false,
     pendingFrequencyUpdate: null,
@@ -1038,6 +1038,8 @@ async function getCurrentVfoState() {
             fetch("/api/v1/frequency", { method: "GET" }),
             fetch("/api/v1/mode", { method: "GET" }),
         ]);
+        noteServerLoad(frequencyResponse);
+        noteServerLoad(modeResponse);
 
         const frequency = frequencyResponse.ok ? await frequencyResponse.text() : null;
         const mode = modeResponse.ok ? await modeResponse.text() : null;
@@ -1089,7 +1091,7 @@ async function getCurrentVfoState() {
 // Start periodic VFO state polling
 async function startVfoUpdates() {
     if (RunState.vfoUpdateInterval) {
-        clearInterval(RunState.vfoUpdateInterval);
+        stopPolling(RunState.vfoUpdateInterval);
     }
 
     // Reset error tracking
@@ -1129,9 +1131,9 @@ async function startVfoUpdates() {
     } finally {
         RunState.isUpdatingVfo = false;
 
-        // Start periodic updates (every 3 seconds, respecting user actions)
-        RunState.vfoUpdateInterval = setInterval(() => {
-            getCurrentVfoState();
+        // Start periodic updates (every 3 seconds or as the device asks, respecting user actions)
+        RunState.vfoUpdateInterval = startPolling(async () => {
+            await getCurrentVfoState();
 
             // Reset error counter if we've been stable for a while
             if (
@@ -1148,7 +1150,7 @@ async function startVfoUpdates() {
 // Stop VFO state polling
 function stopVfoUpdates() {
     if (RunState.vfoUpdateInterval) {
-        clearInterval(RunState.vfoUpdateInterval);
+        stopPolling(RunState.vfoUpdateInterval);
         RunState.vfoUpdateInterval = null;
     }
 
@@ -1168,12 +1170,7 @@ function stopVfoUpdates() {
 // Initiate ATU auto-tune cycle
 async function tuneAtu() {
     try {
-        const response = await fetch("/api/v1/atu", { method: "PUT" });
-
-        if (!response.ok) {
-            Log.error("Spot")("ATU tune failed");
-            return;
-        }
+        await runRadioJob("/api/v1/atu", { method: "PUT" });
 
         // Visual feedback
         const atuBtn = document.querySelector(".btn-tune");
@@ -1184,7 +1181,7 @@ async function tuneAtu() {
             }, ATU_FEEDBACK_DURATION_MS);
         }
     } catch (error) {
-        Log.error("Spot")("ATU fetch error:", error);
+        Log.error("Spot")("ATU tune failed:", error.message);
     }
 }
 
@@ -73,33 +73,23 @@ async function saveCallSign() {
     }
 
     try {
-        // Save callsign to device
-        const callsignResponse = await fetch("/api/v1/callsign", {
-            method: "POST",
+        // Save callsign and license class to device in one request
+        const response = await fetch("/api/v1/config", {
+            method: "PATCH",
             headers: { "Content-Type": "application/json" },
-            body: JSON.stringify({ callsign: callSign }),
+            body: JSON.stringify({ callsign: { callsign: callSign }, license: { license: licenseClass } }),
         });
 
-        if (!callsignResponse.ok) {
-            const data = await callsignResponse.json();
+        const data = await response.json();
+        if (!response.ok) {
             throw new Error(data.error || "Failed to save callsign");
         }
 
-        // Save license class to device
-        const licenseResponse = await fetch("/api/v1/license", {
-            method: "POST",
-            headers: { "Content-Type": "application/json" },
-            body: JSON.stringify({ license: licenseClass }),
-        });
-
-        if (!licenseResponse.ok) {
-            const data = await licenseResponse.json();
-            throw new Error(data.error || "Failed to save license class");
-        }
-
         // Update the global AppState
+        invalidateConfig();
         AppState.callSign = callSign;
         AppState.licenseClass = licenseClass;
+        AppState.configVersion = data.version;
 
         // Update original values and reset save button
         originalCallSignValue = callSignInput.value;
@@ -135,16 +125,11 @@ async function loadTuneTargets() {
     const saveBtn = document.getElementById("save-tune-targets-button");
 
     let loadedFromDevice = false;
-    try {
-        const response = await fetch("/api/v1/tuneTargets");
-        if (response.ok) {
-            const data = await response.json();
-            originalTuneTargets = normalizeTuneTargets(data.targets);
-            originalTuneTargetsMobile = data.mobile || false;
-            loadedFromDevice = true;
-        }
-    } catch (error) {
-        Log.warn("Settings")("Device unavailable for tune targets load:", error);
+    const config = await fetchConfig();
+    if (config && config.tuneTargets) {
+        originalTuneTargets = normalizeTuneTargets(config.tuneTargets.targets);
+        originalTuneTargetsMobile = config.tuneTargets.mobile || false;
+        loadedFromDevice = true;
     }
 
     // Fall back to AppState if device unavailable (may have session or cached data)
@@ -421,6 +406,7 @@ async function saveTuneTargets() {
 
         if (response.ok) {
             savedToDevice = true;
+            invalidateConfig();
         }
     } catch (error) {
         Log.warn("Settings")("Device unavailable for tune targets save:", error);
@@ -464,15 +450,10 @@ async function loadCwMacros() {
     const saveBtn = document.getElementById("save-cw-macros-button");
 
     let loadedFromDevice = false;
-    try {
-        const response = await fetch("/api/v1/cwMacros");
-        if (response.ok) {
-            const data = await response.json();
-            originalCwMacros = data.macros || [];
-            loadedFromDevice = true;
-        }
-    } catch (error) {
-        Log.warn("Settings")("Device unavailable for CW macros load:", error);
+    const config = await fetchConfig();
+    if (config && config.cwMacros) {
+        originalCwMacros = config.cwMacros.macros || [];
+        loadedFromDevice = true;
     }
 
     if (!loadedFromDevice) {
@@ -690,6 +671,7 @@ async function saveCwMacros() {
 
         if (response.ok) {
             savedToDevice = true;
+            invalidateConfig();
         }
     } catch (error) {
         Log.warn("Settings")("Device unavailable for CW macros save:", error);
@@ -963,8 +945,9 @@ function updateWifiSaveButton() {
 async function fetchSettings() {
     if (isLocalhost) return;
     try {
-        const response = await fetch("/api/v1/settings", { method: "GET" });
-        const data = await response.json();
+        const config = await fetchConfig();
+        if (!config) throw new Error("device unavailable");
+        const data = config.settings;
 
         document.getElementById("sta1-ssid").value = data.sta1_ssid;
         document.getElementById("sta1-pass").value = data.sta1_pass;
@@ -1,10 +1,18 @@
 #include "webserver.h"
 #include "globals.h"
+#include "jobs.h"
+#include "json_writer.h"
 #include "kx_radio.h"
+#include "perfect_hash.h"
+#include "server_load.h"
 #include "settings.h"
+#include "worker_pool.h"
 
+#include <algorithm>
 #include <ctype.h>
+#include <iterator>
 #include <memory>
+#include <string_view>
 
 #include <esp_timer.h>
 
@@ -15,69 +23,62 @@ static const char * TAG8 = "sc:webserve";
     extern const uint8_t asset##_end[] asm ("_binary_" #asset "_end"); \
     extern const uint8_t asset##_srt[] asm ("_binary_" #asset "_start");
 
-DECLARE_ASSET (about_htmlgz)
-DECLARE_ASSET (about_jsgz)
-DECLARE_ASSET (bandprivileges_jsgz)
-DECLARE_ASSET (run_htmlgz)
-DECLARE_ASSET (run_jsgz)
-DECLARE_ASSET (chase_api_jsgz)
-DECLARE_ASSET (chase_htmlgz)
-DECLARE_ASSET (chase_jsgz)
-DECLARE_ASSET (favicon_ico)
-DECLARE_ASSET (index_htmlgz)
-DECLARE_ASSET (main_jsgz)
-DECLARE_ASSET (sclogo_jpg)
-DECLARE_ASSET (settings_htmlgz)
-DECLARE_ASSET (settings_jsgz)
-DECLARE_ASSET (spots_jsgz)
-DECLARE_ASSET (style_cssgz)
-DECLARE_ASSET (qrx_htmlgz)
-DECLARE_ASSET (qrx_jsgz)
+// All web assets, packed back to back by scripts/build_web_assets.py
+DECLARE_ASSET (web_assets_bin)
 
 /**
- * Structure to map web URI to embedded binary asset locations.
+ * Content codings an asset can be stored in; the order matches the variant columns
+ * written by scripts/build_web_assets.py.
+ */
+typedef enum {
+    ASSET_IDENTITY,
+    ASSET_GZIP,
+    ASSET_BROTLI,
+    ASSET_ENCODING_COUNT
+} asset_encoding_t;
+
+// Content-Encoding header value and Accept-Encoding token of each coding
+static const char * const asset_encoding_names[ASSET_ENCODING_COUNT] = {"identity", "gzip", "br"};
+
+/**
+ * One stored representation of an asset inside the embedded web_assets.bin blob.
+ */
+typedef struct
+{
+    uint32_t     offset;  // into web_assets.bin
+    uint32_t     size;    // bytes, as served; 0 if the asset has no variant in this coding
+    const char * etag;    // Content hash plus coding, for If-None-Match
+} asset_variant_t;
+
+/**
+ * Structure to map web URI to an asset and its stored variants.
  */
 typedef struct
 {
     const char *    uri;
-    const uint8_t * asset_start;
-    const uint8_t * asset_end;
     const char *    asset_type;
-    bool            gzipped;
-    long            cache_time;  // Cache time in seconds
+    const char *    cache_control;  // "immutable" for content-hashed URLs; pages revalidate
+    asset_variant_t variants[ASSET_ENCODING_COUNT];
 } asset_entry_t;
 
 /**
  * Represents an array of asset entries to facilitate URI to asset mapping.
+ * Generated from src/web by the pre-build step: adding a file there is enough to serve it.
+ * Looked up through asset_index; the order of entries does not matter.
  */
-static const asset_entry_t asset_map[] = {
-    // uri                 asset_start              asset_end                asset_type         gzip   cache_time
-    // =================== ======================== ======================== ================== ====== ==============
-    // HTML pages - short cache (content may change)
-    {"/",                  index_htmlgz_srt,        index_htmlgz_end,        "text/html",       true,  300  }, // 5 min
-    {"/index.html",        index_htmlgz_srt,        index_htmlgz_end,        "text/html",       true,  300  },
-    {"/about.html",        about_htmlgz_srt,        about_htmlgz_end,        "text/html",       true,  300  },
-    {"/run.html",          run_htmlgz_srt,          run_htmlgz_end,          "text/html",       true,  300  },
-    {"/chase.html",        chase_htmlgz_srt,        chase_htmlgz_end,        "text/html",       true,  300  },
-    {"/settings.html",     settings_htmlgz_srt,     settings_htmlgz_end,     "text/html",       true,  300  },
-    {"/qrx.html",          qrx_htmlgz_srt,          qrx_htmlgz_end,          "text/html",       true,  300  },
-    // JS/CSS - medium cache (versioned with firmware)
-    {"/about.js",          about_jsgz_srt,          about_jsgz_end,          "text/javascript", true,  300  }, // 5 min
-    {"/bandprivileges.js", bandprivileges_jsgz_srt, bandprivileges_jsgz_end, "text/javascript", true,  3600 },
-    {"/run.js",            run_jsgz_srt,            run_jsgz_end,            "text/javascript", true,  3600 },
-    {"/chase.js",          chase_jsgz_srt,          chase_jsgz_end,          "text/javascript", true,  3600 },
-    {"/chase_api.js",      chase_api_jsgz_srt,      chase_api_jsgz_end,      "text/javascript", true,  3600 },
-    {"/main.js",           main_jsgz_srt,           main_jsgz_end,           "text/javascript", true,  3600 },
-    {"/settings.js",       settings_jsgz_srt,       settings_jsgz_end,       "text/javascript", true,  3600 },
-    {"/qrx.js",            qrx_jsgz_srt,            qrx_jsgz_end,            "text/javascript", true,  3600 },
-    {"/spots.js",          spots_jsgz_srt,          spots_jsgz_end,          "text/javascript", true,  3600 },
-    {"/style.css",         style_cssgz_srt,         style_cssgz_end,         "text/css",        true,  300  },
-    // Images - long cache (never change)
-    {"/favicon.ico",       favicon_ico_srt,         favicon_ico_end,         "image/x-icon",    false, 86400}, // 1 day
-    {"/sclogo.jpg",        sclogo_jpg_srt,          sclogo_jpg_end,          "image/jpeg",      false, 86400},
-    {NULL,                 NULL,                    NULL,                    NULL,              true,  0    }  // Sent to mark end of array
+static constexpr asset_entry_t asset_map[] = {
+#include "web/build/web_asset_table.inc"
 };
 
+/**
+ * Assets are served for any method, so their key is the path alone.
+ */
+static constexpr perfect_hash_key_t asset_key (const asset_entry_t & asset) {
+    return {0, asset.uri};
+}
+
+static constexpr auto asset_index = build_perfect_hash<perfect_hash_slots (std::size (asset_map))> (asset_map, asset_key);
+
 /**
  * Structure mapping API names to their corresponding handler functions.
  */
@@ -86,129 +87,321 @@ typedef struct
     int          method;
     const char * api_name;
     esp_err_t (*handler_func) (httpd_req_t *);
-    bool requires_radio;
+    bool         requires_radio;
+    bool         offload;     // run on the worker pool so a slow radio operation doesn't stall the httpd task
+    rate_class_t rate_class;  // token bucket the request is admitted through (server_load.h)
 } api_handler_t;
 
 /**
- *  GET, PUT, POST handlers
+ *  GET, PUT, POST, PATCH, DELETE handlers, keyed on method and exact name (the path after /api/v1/).
+ *  A name ending in '/' also serves every sub-path below it, e.g. "jobs/" for jobs/<id>.
+ *  Looked up through api_index; the order of entries does not matter.
  */
-static const api_handler_t api_handlers[] = {
-    // method     api_name            handler_func                  requires_radio
-    // ========  ================== =============================== =============
-    {HTTP_GET,  "connectionStatus", handler_connectionStatus_get,   false}, // disconnected radio /is/ a status
-    {HTTP_GET,  "batteryInfo",      handler_batteryInfo_get,        false},
-    {HTTP_GET,  "rssi",             handler_rssi_get,               false},
-    {HTTP_GET,  "frequency",        handler_frequency_get,          true },
-    {HTTP_GET,  "mode",             handler_mode_get,               true },
-    {HTTP_GET,  "power",            handler_power_get,              true },
-    {HTTP_GET,  "volume",           handler_volume_get,             true },
-    {HTTP_GET,  "reboot",           handler_reboot_get,             false},
-    {HTTP_GET,  "settings",         handler_settings_get,           false},
-    {HTTP_GET,  "version",          handler_version_get,            false},
-    {HTTP_PUT,  "frequency",        handler_frequency_put,          true },
-    {HTTP_PUT,  "keyer",            handler_keyer_put,              true },
-    {HTTP_PUT,  "mode",             handler_mode_put,               true },
-    {HTTP_PUT,  "msg",              handler_msg_put,                true },
-    {HTTP_PUT,  "power",            handler_power_put,              true },
-    {HTTP_PUT,  "volume",           handler_volume_put,             true },
-    {HTTP_PUT,  "time",             handler_time_put,               true },
-    {HTTP_PUT,  "xmit",             handler_xmit_put,               true },
-    {HTTP_PUT,  "atu",              handler_atu_put,                true },
-    {HTTP_POST, "prepareft8",       handler_prepareft8_post,        true },
-    {HTTP_POST, "ft8",              handler_ft8_post,               true },
-    {HTTP_POST, "cancelft8",        handler_cancelft8_post,         true },
-    {HTTP_POST, "settings",         handler_settings_post,          false},
-    {HTTP_POST, "ota",              handler_ota_post,               false},
-    {HTTP_GET,  "gps",              handler_gps_settings_get,       false},
-    {HTTP_POST, "gps",              handler_gps_settings_post,      false},
-    {HTTP_GET,  "callsign",         handler_callsign_settings_get,  false},
-    {HTTP_POST, "callsign",         handler_callsign_settings_post, false},
-    {HTTP_GET,  "license",          handler_license_settings_get,   false},
-    {HTTP_POST, "license",          handler_license_settings_post,  false},
-    {HTTP_GET,  "tuneTargets",      handler_tune_targets_get,       false},
-    {HTTP_POST, "tuneTargets",      handler_tune_targets_post,      false},
-    {HTTP_GET,  "cwMacros",         handler_cw_macros_get,          false},
-    {HTTP_POST, "cwMacros",         handler_cw_macros_post,         false},
-    {HTTP_GET,  "radioType",        handler_radio_type_get,         false},
-    {0,         NULL,               NULL,                           false}  // Sentinel to mark end of array
+static constexpr api_handler_t api_handlers[] = {
+    // method     api_name            handler_func                    requires_radio  offload  rate_class
+    // =========  ================  ==============================  ==============  =======  ====================
+    {HTTP_GET,    "connectionStatus", handler_connectionStatus_get,   false, false, RATE_CLASS_STATUS   }, // disconnected radio /is/ a status
+    {HTTP_GET,    "batteryInfo",      handler_batteryInfo_get,        false, false, RATE_CLASS_STATUS   },
+    {HTTP_GET,    "rssi",             handler_rssi_get,               false, false, RATE_CLASS_STATUS   },
+    {HTTP_GET,    "frequency",        handler_frequency_get,          true,  false, RATE_CLASS_RADIO_GET},
+    {HTTP_GET,    "mode",             handler_mode_get,               true,  false, RATE_CLASS_RADIO_GET},
+    {HTTP_GET,    "power",            handler_power_get,              true,  false, RATE_CLASS_RADIO_GET},
+    {HTTP_GET,    "volume",           handler_volume_get,             true,  false, RATE_CLASS_RADIO_GET},
+    {HTTP_GET,    "reboot",           handler_reboot_get,             false, false, RATE_CLASS_SETTINGS },
+    {HTTP_GET,    "settings",         handler_settings_get,           false, false, RATE_CLASS_SETTINGS },
+    {HTTP_GET,    "version",          handler_version_get,            false, false, RATE_CLASS_STATUS   },
+    {HTTP_PUT,    "frequency",        handler_frequency_put,          true,  false, RATE_CLASS_RADIO_SET},
+    {HTTP_PUT,    "keyer",            handler_keyer_put,              true,  false, RATE_CLASS_RADIO_SET},
+    {HTTP_PUT,    "mode",             handler_mode_put,               true,  false, RATE_CLASS_RADIO_SET},
+    {HTTP_PUT,    "msg",              handler_msg_put,                true,  false, RATE_CLASS_RADIO_SET},
+    {HTTP_PUT,    "power",            handler_power_put,              true,  true,  RATE_CLASS_RADIO_SET},
+    {HTTP_PUT,    "volume",           handler_volume_put,             true,  false, RATE_CLASS_RADIO_SET},
+    {HTTP_PUT,    "time",             handler_time_put,               true,  true,  RATE_CLASS_RADIO_SET},
+    {HTTP_GET,    "clock",            handler_clock_get,              false, false, RATE_CLASS_STATUS   }, // clock discipline round trips
+    {HTTP_PUT,    "xmit",             handler_xmit_put,               true,  true,  RATE_CLASS_RADIO_SET},
+    {HTTP_PUT,    "atu",              handler_atu_put,                true,  true,  RATE_CLASS_RADIO_SET},
+    {HTTP_POST,   "prepareft8",       handler_prepareft8_post,        true,  true,  RATE_CLASS_RADIO_SET},
+    {HTTP_POST,   "ft8",              handler_ft8_post,               true,  false, RATE_CLASS_RADIO_SET},
+    {HTTP_POST,   "cancelft8",        handler_cancelft8_post,         true,  false, RATE_CLASS_RADIO_SET},
+    {HTTP_GET,    "ft8/stats",        handler_ft8_stats_get,          false, false, RATE_CLASS_STATUS   },
+    {HTTP_POST,   "settings",         handler_settings_post,          false, false, RATE_CLASS_SETTINGS },
+    {HTTP_POST,   "ota",              handler_ota_post,               false, false, RATE_CLASS_SETTINGS },
+    {HTTP_GET,    "gps",              handler_gps_settings_get,       false, false, RATE_CLASS_SETTINGS },
+    {HTTP_POST,   "gps",              handler_gps_settings_post,      false, false, RATE_CLASS_SETTINGS },
+    {HTTP_GET,    "callsign",         handler_callsign_settings_get,  false, false, RATE_CLASS_SETTINGS },
+    {HTTP_POST,   "callsign",         handler_callsign_settings_post, false, false, RATE_CLASS_SETTINGS },
+    {HTTP_GET,    "license",          handler_license_settings_get,   false, false, RATE_CLASS_SETTINGS },
+    {HTTP_POST,   "license",          handler_license_settings_post,  false, false, RATE_CLASS_SETTINGS },
+    {HTTP_GET,    "tuneTargets",      handler_tune_targets_get,       false, false, RATE_CLASS_SETTINGS },
+    {HTTP_POST,   "tuneTargets",      handler_tune_targets_post,      false, false, RATE_CLASS_SETTINGS },
+    {HTTP_GET,    "cwMacros",         handler_cw_macros_get,          false, false, RATE_CLASS_SETTINGS },
+    {HTTP_POST,   "cwMacros",         handler_cw_macros_post,         false, false, RATE_CLASS_SETTINGS },
+    {HTTP_GET,    "config",           handler_config_get,             false, false, RATE_CLASS_SETTINGS },
+    {HTTP_PATCH,  "config",           handler_config_patch,           false, false, RATE_CLASS_SETTINGS },
+    {HTTP_GET,    "radioType",        handler_radio_type_get,         false, false, RATE_CLASS_STATUS   },
+    {HTTP_GET,    "serverLoad",       handler_serverLoad_get,         false, false, RATE_CLASS_STATUS   },
+    {HTTP_GET,    "jobs",             handler_jobs_get,               false, false, RATE_CLASS_STATUS   },
+    {HTTP_GET,    "jobs/",            handler_jobs_get,               false, false, RATE_CLASS_STATUS   }, // jobs/<id>
+    {HTTP_DELETE, "jobs/",            handler_jobs_delete,            false, false, RATE_CLASS_STATUS   },
 };
 
+static constexpr perfect_hash_key_t api_key (const api_handler_t & handler) {
+    return {(uint8_t)handler.method, handler.api_name};
+}
+
+static constexpr auto api_index = build_perfect_hash<perfect_hash_slots (std::size (api_handlers))> (api_handlers, api_key);
+
+/**
+ * Sends a JSON error with a Retry-After hint. esp_http_server has no httpd_err_code_t
+ * for these statuses, so the status line is set by hand.
+ * @param req Pointer to the HTTP request.
+ * @param status Status line, e.g. "503 Service Unavailable".
+ * @param retry_after_s Suggested client back-off, in seconds.
+ * @param message Error text for the log and the JSON body.
+ * @return ESP_FAIL, so callers can `return` the result directly.
+ */
+static esp_err_t reply_retry_after (httpd_req_t * req, const char * status, int retry_after_s, const char * message) {
+    ESP_LOGW (TAG8, "%s", message);
+    char retry_after[12];
+    snprintf (retry_after, sizeof (retry_after), "%d", retry_after_s);
+    httpd_resp_set_status (req, status);
+    httpd_resp_set_hdr (req, "Retry-After", retry_after);
+    JsonWriter json (req);
+    json.begin_object();
+    json.string ("error", message);
+    json.end_object();
+    json.finish();
+    return ESP_FAIL;
+}
+
+/**
+ * Sends a "503 Service Unavailable" JSON error with a Retry-After hint: the server is busy.
+ */
+esp_err_t reply_service_unavailable (httpd_req_t * req, int retry_after_s, const char * message) {
+    return reply_retry_after (req, "503 Service Unavailable", retry_after_s, message);
+}
+
+/**
+ * Sends a "429 Too Many Requests" JSON error with a Retry-After hint: the client is over its rate.
+ */
+static esp_err_t reply_too_many_requests (httpd_req_t * req, int retry_after_s) {
+    return reply_retry_after (req, "429 Too Many Requests", retry_after_s, "too many requests, please slow down");
+}
+
+/**
+ * Sets the ETag and caching headers of the response, and answers "304 Not Modified" instead of
+ * the body when the client's If-None-Match already names the tag (weak comparison, as RFC 9110
+ * requires for this header).
+ * httpd_resp_send() always writes a Content-Length, which on a 304 would claim the representation
+ * is empty, so the 304 is written raw, repeating the caching headers the 200 would carry.
+ * @param req Pointer to the HTTP request.
+ * @param etag Quoted entity tag; must stay valid until the response is sent.
+ * @param cache_control Cache-Control value; must stay valid until the response is sent.
+ * @param vary Vary value, or nullptr if the representation doesn't vary.
+ * @return true if the 304 was sent and the caller is done, false if the caller should send the body.
+ */
+bool reply_not_modified_if_match (httpd_req_t * req, const char * etag, const char * cache_control, const char * vary) {
+    httpd_resp_set_hdr (req, "ETag", etag);
+    httpd_resp_set_hdr (req, "Cache-Control", cache_control);
+    if (vary)
+        httpd_resp_set_hdr (req, "Vary", vary);
+
+    char if_none_match[128];
+    if (httpd_req_get_hdr_value_str (req, "If-None-Match", if_none_match, sizeof (if_none_match)) != ESP_OK)
+        return false;  // absent, or too long to be one of ours
+    if (strcmp (if_none_match, "*") != 0 && !strstr (if_none_match, etag))
+        return false;
+
+    char head[192];
+    int  len = snprintf (head, sizeof (head), "HTTP/1.1 304 Not Modified\r\nETag: %s\r\nCache-Control: %s\r\n%s%s%s\r\n", etag, cache_control, vary ? "Vary: " : "", vary ? vary : "", vary ? "\r\n" : "");
+    if (len <= 0 || (size_t)len >= sizeof (head))
+        return false;  // can't happen with our tags; the full response is still correct
+    if (httpd_send (req, head, len) != len)
+        ESP_LOGW (TAG8, "sending 304 failed");
+    return true;
+}
+
+/**
+ * Worker-side half of an offloaded request: runs the API handler against the
+ * detached request copy, then hands the socket back to the httpd task.
+ * @param arg The request copy from httpd_req_async_handler_begin(); its user_ctx
+ *            points at the api_handler_t to run.
+ */
+static void run_offloaded_api_handler (void * arg) {
+    httpd_req_t *         req     = (httpd_req_t *)arg;
+    const api_handler_t * handler = (const api_handler_t *)req->user_ctx;
+
+    request_arena_begin();
+    server_load_set_hints (req);
+    if (handler->handler_func (req) != ESP_OK)
+        ESP_LOGW (TAG8, "offloaded handler for '%s' failed", handler->api_name);
+    request_arena_end();
+
+    httpd_req_async_handler_complete (req);
+}
+
+/**
+ * Detaches a request from the httpd task and queues it for the worker pool, so that
+ * slow radio operations don't hold up other clients (page assets, status polls).
+ * Replies 503 immediately if the worker queue is full.
+ * @param handler The API handler to run on the worker.
+ * @param req Pointer to the HTTP request.
+ * @return ESP_OK once queued (the worker sends the response), ESP_FAIL otherwise.
+ */
+static esp_err_t offload_api_handler (const api_handler_t * handler, httpd_req_t * req) {
+    httpd_req_t * async_req = nullptr;
+    if (httpd_req_async_handler_begin (req, &async_req) != ESP_OK)
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "failed to detach request");
+
+    async_req->user_ctx = (void *)handler;
+    if (!worker_pool_submit (run_offloaded_api_handler, async_req)) {
+        httpd_req_async_handler_complete (async_req);
+        return reply_service_unavailable (req, server_load_retry_after_s(), "server busy, please retry");
+    }
+
+    ESP_LOGD (TAG8, "offloaded '%s' to worker pool", handler->api_name);
+    return ESP_OK;
+}
+
+/**
+ * Finds the API handler for a request: an exact match on method and name first, then
+ * the handler of the enclosing "name/" for a sub-path such as jobs/<id>.
+ * @param method The HTTP method of the incoming request.
+ * @param name The path after /api/v1/, without query string.
+ * @return the handler, or nullptr if there is none.
+ */
+static const api_handler_t * find_api_handler (int method, std::string_view name) {
+    const api_handler_t * handler = api_index.find (api_handlers, api_key, {(uint8_t)method, name});
+    if (handler)
+        return handler;
+
+    size_t slash = name.find ('/');
+    if (slash == std::string_view::npos)
+        return nullptr;
+    return api_index.find (api_handlers, api_key, {(uint8_t)method, name.substr (0, slash + 1)});
+}
+
 /**
  * Handles incoming HTTP requests by matching them against registered API handlers.
  * @param method The HTTP method of the incoming request.
  * @param api_name The endpoint of the API being requested.
- * @param handlers Array of handler structures.
  * @param req Pointer to the HTTP request.
  * @return ESP_OK on success, ESP_FAIL on failure.
  */
-static int find_and_execute_api_handler (int method, const char * api_name, const api_handler_t * handlers, httpd_req_t * req) {
+static int find_and_execute_api_handler (int method, const char * api_name, httpd_req_t * req) {
     ESP_LOGV (TAG8, "trace: %s(method=%d, api='%s')", __func__, method, api_name);
 
     // Ignore any query string if there is one:
-    size_t compare_length = strcspn (api_name, "?");
-
-    for (const api_handler_t * handler = handlers; handler->api_name != NULL; ++handler)
-        if (method == handler->method &&
-            strncmp (api_name, handler->api_name, compare_length) == 0) {
-            if (kxRadio.is_connected() || !handler->requires_radio)
-                return handler->handler_func (req);
-            else
-                REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "radio not connected");
-        }
-
-    REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "handler not found");
+    const api_handler_t * handler = find_api_handler (method, std::string_view (api_name, strcspn (api_name, "?")));
+    if (!handler)
+        REPLY_WITH_FAILURE (req, HTTPD_404_NOT_FOUND, "handler not found");
+
+    int retry_after_s = 0;
+    if (!server_load_admit (req, handler->rate_class, &retry_after_s))
+        return reply_too_many_requests (req, retry_after_s);
+    if (!kxRadio.is_connected() && handler->requires_radio)
+        REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "radio not connected");
+    if (handler->offload)
+        return offload_api_handler (handler, req);  // the worker adds the load hints
+    server_load_set_hints (req);
+    return handler->handler_func (req);
 }
 
-static const size_t CHUNK_SIZE = 8192;  // Increased from 1KB to 8KB for efficiency
-
 /**
- * Sends a memory region as an HTTP chunked response with retry logic.
+ * Sends an embedded asset as one fixed-length response: status line and headers (with
+ * Content-Length), then the body written straight from the memory-mapped flash blob.
+ *
+ * httpd_resp_send() hands the whole body to the session's send function, and the socket
+ * is blocking with send_wait_timeout, so each send() takes as much as the TCP send buffer
+ * has room for and otherwise waits for the peer's ACKs to open it up. No copy into a
+ * staging buffer, no chunk framing, and no fixed sleeps while the window is closed.
  * @param req Pointer to the HTTP request.
- * @param start Pointer to the beginning of the data buffer.
- * @param end Pointer to one past the last byte of the data buffer.
- * @return ESP_OK on successful transmission, or an error code if the send fails.
+ * @param data Start of the asset bytes.
+ * @param size Number of bytes to send.
+ * @return ESP_OK on success, or the error from httpd_resp_send().
  */
-static esp_err_t send_file_chunked (httpd_req_t * req, const uint8_t * start, const uint8_t * end) {
-    const int MAX_RETRIES    = 3;
-    const int RETRY_DELAY_MS = 10;
-    size_t    total_size     = end - start;
-    size_t    sent           = 0;
-
-    while (sent < total_size) {
-        size_t to_send = MIN (CHUNK_SIZE, total_size - sent);
-        int    ret     = ESP_FAIL;
-
-        // Retry loop for EAGAIN/EWOULDBLOCK errors
-        for (int retry = 0; retry <= MAX_RETRIES; retry++) {
-            ret = httpd_resp_send_chunk (req, (const char *)(start + sent), to_send);
-
-            if (ret == ESP_OK) {
-                break;  // Success, continue with next chunk
-            }
-
-            // If error is not EAGAIN or we've exhausted retries, give up
-            if (ret != ESP_ERR_HTTPD_RESP_SEND && retry >= MAX_RETRIES) {
-                ESP_LOGW (TAG8, "Failed to send chunk after %d retries, error: %d", MAX_RETRIES, ret);
-                httpd_resp_send_chunk (req, NULL, 0);  // Terminate chunked response
-                return ret;
-            }
+static esp_err_t send_asset_body (httpd_req_t * req, const uint8_t * data, size_t size) {
+    int64_t   start_us = esp_timer_get_time();
+    esp_err_t ret      = httpd_resp_send (req, (const char *)data, size);
+    if (ret != ESP_OK)
+        ESP_LOGW (TAG8, "asset send failed after %lld ms: %s", (long long)((esp_timer_get_time() - start_us) / 1000), esp_err_to_name (ret));
+    else
+        ESP_LOGI (TAG8, "sent %u byte asset in %lld ms", (unsigned)size, (long long)((esp_timer_get_time() - start_us) / 1000));
+    return ret;
+}
 
-            // EAGAIN error - wait and retry
-            if (retry < MAX_RETRIES) {
-                vTaskDelay (pdMS_TO_TICKS (RETRY_DELAY_MS));
+/**
+ * Checks whether an Accept-Encoding header value allows a content coding. A coding is
+ * accepted when listed (or matched by "*") without "q=0"; identity is acceptable unless
+ * explicitly refused (RFC 9110, section 12.5.3).
+ * @param accept Accept-Encoding header value.
+ * @param coding Coding token, e.g. "gzip".
+ * @return true if the client accepts the coding.
+ */
+static bool accepts_encoding (const char * accept, const char * coding) {
+    std::string_view wanted (coding);
+    int              wildcard = -1;  // q of "*": -1 not listed, 0 refused, 1 accepted
+    for (const char * p = accept; *p;) {
+        const char * end  = p + strcspn (p, ",");
+        const char * semi = (const char *)memchr (p, ';', end - p);
+        const char * name = p + strspn (p, " \t");
+        size_t       len  = (semi ? semi : end) - name;
+        while (len > 0 && (name[len - 1] == ' ' || name[len - 1] == '\t'))
+            --len;
+
+        // "q=0", "q=0.0", "q=0.000" refuse the coding; anything else accepts it
+        bool refused = false;
+        if (semi) {
+            const char * q = strstr (semi, "q=");
+            if (q && q < end) {
+                q += 2;
+                refused = *q == '0';
+                for (++q; refused && q < end && *q != ' ' && *q != ';'; ++q)
+                    refused = *q == '0' || *q == '.';
             }
         }
 
-        sent += to_send;
+        std::string_view token (name, len);
+        if (token.size () == wanted.size () &&
+            std::equal (token.begin (), token.end (), wanted.begin (), [] (char a, char b) { return tolower (a) == b; }))
+            return !refused;
+        if (token == "*")
+            wildcard = refused ? 0 : 1;
 
-        // Cooperative yield every 4 chunks to allow other tasks to run
-        if (sent < total_size && (sent % (CHUNK_SIZE * 4)) == 0) {
-            taskYIELD();
-        }
+        p = *end ? end + 1 : end;
+    }
+    if (wildcard >= 0)
+        return wildcard == 1;
+    return wanted == "identity";
+}
+
+/**
+ * Picks the variant of an asset to send: the smallest one the client accepts. Clients that
+ * send no Accept-Encoding, or one too long to read, get gzip when the asset is compressed,
+ * as they always have, and never Brotli.
+ * @param req Pointer to the HTTP request.
+ * @param asset Asset being served.
+ * @return the chosen coding.
+ */
+static asset_encoding_t choose_asset_encoding (httpd_req_t * req, const asset_entry_t & asset) {
+    char accept[128];
+    bool has_accept = httpd_req_get_hdr_value_str (req, "Accept-Encoding", accept, sizeof (accept)) == ESP_OK;
+
+    asset_encoding_t best = ASSET_ENCODING_COUNT;
+    for (int e = 0; e < ASSET_ENCODING_COUNT; ++e) {
+        const asset_variant_t & variant = asset.variants[e];
+        if (variant.size == 0)
+            continue;
+        if (has_accept ? !accepts_encoding (accept, asset_encoding_names[e]) : e == ASSET_BROTLI)
+            continue;
+        if (best == ASSET_ENCODING_COUNT || variant.size < asset.variants[best].size)
+            best = (asset_encoding_t)e;
     }
+    if (best != ASSET_ENCODING_COUNT)
+        return best;
 
-    // Send final chunk
-    return httpd_resp_send_chunk (req, NULL, 0);
+    // Nothing acceptable: text assets only exist compressed, and every browser handles gzip.
+    return asset.variants[ASSET_IDENTITY].size ? ASSET_IDENTITY : ASSET_GZIP;
 }
 
 /**
@@ -220,84 +413,78 @@ static esp_err_t dynamic_file_handler (httpd_req_t * req) {
     const char * requested_path = req->uri;
 
     // Ignore any query string when matching assets
-    size_t path_length = strcspn (requested_path, "?");
+    std::string_view path (requested_path, strcspn (requested_path, "?"));
 
-    bool                  found_file = false;
-    const asset_entry_t * asset_ptr  = asset_map;
+    const asset_entry_t * asset_ptr = asset_index.find (asset_map, asset_key, {0, path});
+    if (!asset_ptr)
+        return ESP_FAIL;
 
-    while (asset_ptr->uri != NULL && !found_file)
-        if (strlen (asset_ptr->uri) == path_length &&
-            strncmp (requested_path, asset_ptr->uri, path_length) == 0)
-            found_file = true;
-        else
-            ++asset_ptr;
+    asset_encoding_t        encoding = choose_asset_encoding (req, *asset_ptr);
+    const asset_variant_t & variant  = asset_ptr->variants[encoding];
 
-    if (!found_file)
-        return ESP_FAIL;
+    // The representation depends on Accept-Encoding, so caches must key on it too
+    const char * vary = encoding != ASSET_IDENTITY ? "Accept-Encoding" : nullptr;
 
-    // Set headers
-    httpd_resp_set_type (req, asset_ptr->asset_type);
-    if (asset_ptr->gzipped)
-        httpd_resp_set_hdr (req, "Content-Encoding", "gzip");
-
-    // Add cache headers with immutable directive for long-cached assets
-    char cache_header[64];
-    if (asset_ptr->cache_time > 0) {
-        if (asset_ptr->cache_time >= 86400) {
-            // Long cache: add immutable directive (browser never revalidates)
-            snprintf (cache_header, sizeof (cache_header), "max-age=%ld, immutable", asset_ptr->cache_time);
-        }
-        else {
-            snprintf (cache_header, sizeof (cache_header), "max-age=%ld", asset_ptr->cache_time);
-        }
-    }
-    else {
-        snprintf (cache_header, sizeof (cache_header), "max-age=31536000, immutable");  // 1 year (cache forever)
-    }
-    httpd_resp_set_hdr (req, "Cache-Control", cache_header);
-
-    // Use chunked transfer for large files
-    size_t file_size = asset_ptr->asset_end - asset_ptr->asset_start;
-    if (file_size > CHUNK_SIZE) {  // Chunk large files
-        ESP_LOGI (TAG8, "sending chunked asset");
-        return send_file_chunked (req,
-                                  asset_ptr->asset_start,
-                                  asset_ptr->asset_end);
-    }
-    else {  // Small files can be sent in one go
-        ESP_LOGI (TAG8, "sending bulk (unchunked) asset");
-        return httpd_resp_send (req, (const char *)asset_ptr->asset_start, file_size);
+    // Revalidation of an unchanged asset (expired max-age, or a reload) costs no body
+    if (reply_not_modified_if_match (req, variant.etag, asset_ptr->cache_control, vary)) {
+        ESP_LOGI (TAG8, "asset not modified");
+        return ESP_OK;
     }
+
+    httpd_resp_set_type (req, asset_ptr->asset_type);
+    if (encoding != ASSET_IDENTITY)
+        httpd_resp_set_hdr (req, "Content-Encoding", asset_encoding_names[encoding]);
+
+    return send_asset_body (req, web_assets_bin_srt + variant.offset, variant.size);
 }
 
 /**
- * Main handler for HTTP requests, routes to appropriate API or file handler.
+ * Routes a request to the matching API handler or web asset.
  * @param req Pointer to the HTTP request.
  * @return ESP_OK on successful handling, ESP_FAIL on error or if no handler is found.
  */
-static esp_err_t my_http_request_handler (httpd_req_t * req) {
-    ESP_LOGI (TAG8, "HTTP Request received: %s %s from %s session", req->method == HTTP_GET ? "GET" : req->method == HTTP_POST ? "POST"
-                                                                                                  : req->method == HTTP_PUT    ? "PUT"
-                                                                                                                               : "OTHER",
-              req->uri,
-              req->sess_ctx ? "existing" : "new");
+static esp_err_t route_request (httpd_req_t * req) {
     const char * requested_uri = req->uri;
 
     // 1. Check for REST API calls
     if (starts_with (requested_uri, "/api/v1/")) {
         const char * api_name = requested_uri + sizeof ("/api/v1/") - 1;  // Correct the offset
-        return find_and_execute_api_handler (req->method, api_name, api_handlers, req);
+        return find_and_execute_api_handler (req->method, api_name, req);
     }
 
     // 2. Check for Web Page Assets
-    if (starts_with (requested_uri, "/"))
+    if (starts_with (requested_uri, "/")) {
+        int retry_after_s = 0;
+        if (!server_load_admit (req, RATE_CLASS_STATIC, &retry_after_s))
+            return reply_too_many_requests (req, retry_after_s);
         return dynamic_file_handler (req);
+    }
 
     // 3. Default / Not Found - should not be possible to reach this code.
     //    Not found errors would happen in the dynamic_file_handler in step 2.
     return ESP_FAIL;
 }
 
+/**
+ * Main handler for HTTP requests: logs the request, and routes it with a fresh request arena.
+ * @param req Pointer to the HTTP request.
+ * @return ESP_OK on successful handling, ESP_FAIL on error or if no handler is found.
+ */
+static esp_err_t my_http_request_handler (httpd_req_t * req) {
+    ESP_LOGI (TAG8, "HTTP Request received: %s %s from %s session", req->method == HTTP_GET ? "GET" : req->method == HTTP_POST ? "POST"
+                                                                                                  : req->method == HTTP_PUT    ? "PUT"
+                                                                                                  : req->method == HTTP_DELETE ? "DELETE"
+                                                                                                  : req->method == HTTP_PATCH  ? "PATCH"
+                                                                                                                               : "OTHER",
+              req->uri,
+              req->sess_ctx ? "existing" : "new");
+
+    request_arena_begin();
+    esp_err_t result = route_request (req);
+    request_arena_end();
+    return result;
+}
+
 /**
  * Custom URI matcher matches all, allowing passage to our request handler
  * @param _uri1 unused
@@ -305,7 +492,7 @@ static esp_err_t my_http_request_handler (httpd_req_t * req) {
  * @param _uri_len unused
  * @return Always returns true, implementing a catch-all matcher.
  */
-static bool custom_uri_matcher (const char * _uri1, const char * _uri2, unsigned int _uri_len) {
+static bool custom_uri_matcher (const char * _uri1, const char * _uri2, size_t _uri_len) {
     return true;  // since we want a catch-all, we always match
 }
 
@@ -329,6 +516,11 @@ void start_webserver () {
     config.keep_alive_interval = 5;  // 5 seconds
     config.keep_alive_count    = 3;  // 3 probes
 
+    // Slow radio handlers are offloaded to this pool (see api_handler_t::offload)
+    start_worker_pool();
+    init_jobs();
+    init_server_load();
+
     httpd_handle_t server = NULL;
     esp_err_t      ret    = httpd_start (&server, &config);
     if (ret != ESP_OK) {
@@ -346,11 +538,82 @@ void start_webserver () {
         httpd_register_uri_handler (server, &uri_api);
         uri_api.method = HTTP_POST;
         httpd_register_uri_handler (server, &uri_api);
+        uri_api.method = HTTP_DELETE;
+        httpd_register_uri_handler (server, &uri_api);
+        uri_api.method = HTTP_PATCH;
+        httpd_register_uri_handler (server, &uri_api);
 
         ESP_LOGI (TAG8, "defined webserver callbacks.");
     }
 }
 
+/**
+ * Splits the URL query of a request into name/value pairs. The query is copied once into the
+ * request arena and cut up in place there: no per-parameter buffers, no heap.
+ * @param req Pointer to the HTTP request.
+ * @param query Receives the parameters; a name without "=" gets an empty value. Parameters
+ *              beyond REQUEST_QUERY_MAX_PARAMS are ignored.
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if there is no query, ESP_ERR_NO_MEM if the arena is full,
+ *         or the error from httpd_req_get_url_query_str().
+ */
+esp_err_t request_query_parse (httpd_req_t * req, request_query_t * query) {
+    query->count = 0;
+
+    size_t len = httpd_req_get_url_query_len (req);
+    if (len == 0)
+        return ESP_ERR_NOT_FOUND;
+    char * buf = (char *)request_arena_alloc (len + 1);
+    if (!buf)
+        return ESP_ERR_NO_MEM;
+    esp_err_t err = httpd_req_get_url_query_str (req, buf, len + 1);
+    if (err != ESP_OK)
+        return err;
+    ESP_LOGV (TAG8, "query[%u] = \"%s\"", (unsigned)len, buf);
+
+    for (char * p = buf; *p;) {
+        char * end  = p + strcspn (p, "&");
+        char * eq   = (char *)memchr (p, '=', end - p);
+        bool   last = (*end == '\0');
+        *end        = '\0';
+        if (end != p) {
+            if (query->count == REQUEST_QUERY_MAX_PARAMS) {
+                ESP_LOGW (TAG8, "ignoring query parameters beyond the first %d", REQUEST_QUERY_MAX_PARAMS);
+                break;
+            }
+            if (eq)
+                *eq = '\0';
+            query->params[query->count].name  = p;
+            query->params[query->count].value = eq ? eq + 1 : end;
+            query->count++;
+        }
+        p = last ? end : end + 1;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @param query Parsed query.
+ * @param name Parameter name (exact, case-sensitive match).
+ * @return the URL-encoded value of the first parameter with that name, or nullptr.
+ */
+char * request_query_value (const request_query_t & query, const char * name) {
+    for (size_t i = 0; i < query.count; ++i)
+        if (strcmp (query.params[i].name, name) == 0)
+            return query.params[i].value;
+    return nullptr;
+}
+
+/**
+ * Copies a parameter value into a caller buffer, with the semantics of httpd_query_key_value().
+ * @return ESP_OK, ESP_ERR_NOT_FOUND, or ESP_ERR_HTTPD_RESULT_TRUNC if the value was cut short.
+ */
+esp_err_t request_query_copy (const request_query_t & query, const char * name, char * out, size_t out_size) {
+    const char * value = request_query_value (query, name);
+    if (!value)
+        return ESP_ERR_NOT_FOUND;
+    return strlcpy (out, value, out_size) < out_size ? ESP_OK : ESP_ERR_HTTPD_RESULT_TRUNC;
+}
+
 /**
  * Decodes a URL-encoded string in place, replacing special characters.
  * @param str A pointer to the character array holding the URL-encoded string.
@@ -0,0 +1,65 @@
+#include "worker_pool.h"
+#include "globals.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:workers.";
+
+typedef struct {
+    worker_fn_t fn;
+    void *      arg;
+} work_item_t;
+
+static QueueHandle_t s_work_queue = nullptr;
+
+/**
+ * Worker task body: runs queued work items one at a time, forever.
+ */
+static void worker_task (void * _) {
+    work_item_t item;
+    for (;;)
+        if (xQueueReceive (s_work_queue, &item, portMAX_DELAY) == pdTRUE) {
+            ESP_LOGV (TAG8, "running work item on %s", pcTaskGetName (NULL));
+            item.fn (item.arg);
+        }
+}
+
+void start_worker_pool () {
+    ESP_LOGV (TAG8, "trace: %s()", __func__);
+
+    if (s_work_queue)
+        return;
+
+    s_work_queue = xQueueCreate (WORKER_POOL_QUEUE_DEPTH, sizeof (work_item_t));
+    if (!s_work_queue) {
+        ESP_LOGE (TAG8, "failed to create work queue");
+        return;
+    }
+
+    for (int i = 0; i < WORKER_POOL_TASK_COUNT; ++i) {
+        char name[16];
+        snprintf (name, sizeof (name), "worker_%d", i);
+        if (xTaskCreate (&worker_task, name, WORKER_POOL_STACK_SIZE, NULL, SC_TASK_PRIORITY_NORMAL, NULL) != pdPASS)
+            ESP_LOGE (TAG8, "failed to start %s", name);
+    }
+    ESP_LOGI (TAG8, "worker pool started: %d tasks, queue depth %d", WORKER_POOL_TASK_COUNT, WORKER_POOL_QUEUE_DEPTH);
+}
+
+bool worker_pool_submit (worker_fn_t fn, void * arg) {
+    if (!s_work_queue)
+        return false;
+
+    work_item_t item = {fn, arg};
+    if (xQueueSend (s_work_queue, &item, 0) != pdTRUE) {
+        ESP_LOGW (TAG8, "work queue full, rejecting work item");
+        return false;
+    }
+    return true;
+}
+
+size_t worker_pool_pending () {
+    return s_work_queue ? uxQueueMessagesWaiting (s_work_queue) : 0;
+}
@@ -0,0 +1,65 @@
+#include "battery_monitor.h"
+#include "enter_deep_sleep.h"
+#include "globals.h"
+#include "idle_status_task.h"
+#include "webserver.h"
+#include "wifi.h"
+
+#include <cstdlib>
+#include <ctime>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:hostboard";
+
+/**
+ * What the host build leaves out of the firmware: the board's setup, WiFi, the battery
+ * monitor, the idle and power-off tasks, and OTA. These stand in for them, as a board on USB
+ * power with a good WiFi link and a full battery would report.
+ */
+
+time_t            LastUserActivityUnixTime;
+std::atomic<bool> CommandInProgress {false};
+TaskHandle_t      xInactivityWatchdogHandle = NULL;
+
+void resetActivityTimer () {
+    std::time (&LastUserActivityUnixTime);
+}
+
+void showActivity () {
+    std::time (&LastUserActivityUnixTime);
+}
+
+bool is_wifi_connected () {
+    return true;
+}
+
+int8_t get_rssi () {
+    return -50;
+}
+
+bool get_battery_is_smart () {
+    return false;
+}
+
+int32_t get_battery_millivolts () {
+    return 4100;
+}
+
+int32_t get_battery_millipercent () {
+    return 90 * 1000;
+}
+
+esp_err_t get_battery_info (batteryInfo_t * info) {
+    (void)info;
+    return ESP_ERR_NOT_SUPPORTED;  // only for smart batteries
+}
+
+void enter_deep_sleep () {
+    ESP_LOGI (TAG8, "deep sleep requested; exiting");
+    exit (0);
+}
+
+esp_err_t handler_ota_post (httpd_req_t * req) {
+    showActivity();
+    REPLY_WITH_FAILURE (req, HTTPD_500_INTERNAL_SERVER_ERROR, "OTA update not supported on the host");
+}
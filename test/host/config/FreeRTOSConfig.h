@@ -0,0 +1,77 @@
+#pragma once
+
+/**
+ * FreeRTOS configuration for the POSIX port, as close to the firmware's ESP-IDF kernel as the
+ * port allows: 1 kHz tick, 25 priorities, 16 character task names, preemption and task
+ * notifications. Task stacks are pthread stacks here, sized in words rather than bytes, so
+ * every task gets several times the stack it has on the ESP32.
+ */
+
+#include <limits.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void vAssertCalled (const char * file, unsigned long line);
+#ifdef __cplusplus
+}
+#endif
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_TIME_SLICING                  1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configUSE_IDLE_HOOK                     0
+#define configUSE_TICK_HOOK                     0
+#define configUSE_DAEMON_TASK_STARTUP_HOOK      0
+#define configTICK_RATE_HZ                      1000
+#define configMAX_PRIORITIES                    25
+#define configMINIMAL_STACK_SIZE                ((unsigned short)PTHREAD_STACK_MIN)
+#define configMAX_TASK_NAME_LEN                 16
+#define configTICK_TYPE_WIDTH_IN_BITS           TICK_TYPE_WIDTH_32_BITS
+#define configIDLE_SHOULD_YIELD                 1
+#define configTOTAL_HEAP_SIZE                   ((size_t)(4 * 1024 * 1024))  // unused by heap_3, which is malloc()
+
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   1
+#define configUSE_MUTEXES                       1
+#define configUSE_RECURSIVE_MUTEXES             1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configQUEUE_REGISTRY_SIZE               16
+#define configUSE_QUEUE_SETS                    0
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 2
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define configSUPPORT_STATIC_ALLOCATION         0
+
+#define configUSE_TIMERS                        1
+#define configTIMER_TASK_PRIORITY               (configMAX_PRIORITIES - 1)
+#define configTIMER_QUEUE_LENGTH                32
+#define configTIMER_TASK_STACK_DEPTH            (configMINIMAL_STACK_SIZE * 2)
+
+#define configCHECK_FOR_STACK_OVERFLOW          0  // the port can't check pthread stacks
+#define configUSE_MALLOC_FAILED_HOOK            0
+#define configUSE_TRACE_FACILITY                1
+#define configUSE_STATS_FORMATTING_FUNCTIONS    1
+#define configGENERATE_RUN_TIME_STATS           0
+
+#define INCLUDE_vTaskPrioritySet                1
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_xTaskDelayUntil                 1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetIdleTaskHandle          1
+#define INCLUDE_eTaskGetState                   1
+#define INCLUDE_xSemaphoreGetMutexHolder        1
+#define INCLUDE_xTimerPendFunctionCall          1
+#define INCLUDE_xTaskAbortDelay                 1
+#define INCLUDE_xTaskGetHandle                  1
+
+#define configASSERT(x)                        \
+    do {                                       \
+        if (!(x))                              \
+            vAssertCalled (__FILE__, __LINE__); \
+    } while (0)
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The UART on the host is wired to an emulated radio (kx_emulator.h) rather than a device:
+ * what is written is decoded as CAT commands, and the radio's replies arrive to be read at the
+ * rate the line's baud rate allows. There is no transmit ring buffer, as in the firmware.
+ */
+
+typedef int uart_port_t;
+
+#define UART_NUM_0   0
+#define UART_NUM_1   1
+#define UART_NUM_MAX 2
+
+#define UART_PIN_NO_CHANGE (-1)
+
+typedef enum {
+    UART_DATA_5_BITS,
+    UART_DATA_6_BITS,
+    UART_DATA_7_BITS,
+    UART_DATA_8_BITS
+} uart_word_length_t;
+
+typedef enum {
+    UART_PARITY_DISABLE,
+    UART_PARITY_EVEN = 2,
+    UART_PARITY_ODD
+} uart_parity_t;
+
+typedef enum {
+    UART_STOP_BITS_1 = 1,
+    UART_STOP_BITS_1_5,
+    UART_STOP_BITS_2
+} uart_stop_bits_t;
+
+typedef enum {
+    UART_HW_FLOWCTRL_DISABLE,
+    UART_HW_FLOWCTRL_RTS,
+    UART_HW_FLOWCTRL_CTS,
+    UART_HW_FLOWCTRL_CTS_RTS
+} uart_hw_flowcontrol_t;
+
+typedef enum {
+    UART_SCLK_APB = 1,
+    UART_SCLK_DEFAULT = UART_SCLK_APB
+} uart_sclk_t;
+
+typedef enum {
+    UART_SIGNAL_INV_DISABLE = 0,
+    UART_SIGNAL_RXD_INV     = 1 << 2,
+    UART_SIGNAL_TXD_INV     = 1 << 5
+} uart_signal_inv_t;
+
+typedef struct {
+    int                   baud_rate;
+    uart_word_length_t    data_bits;
+    uart_parity_t         parity;
+    uart_stop_bits_t      stop_bits;
+    uart_hw_flowcontrol_t flow_ctrl;
+    uint8_t               rx_flow_ctrl_thresh;
+    uart_sclk_t           source_clk;
+    struct {
+        uint32_t allow_pd : 1;
+        uint32_t backup_before_sleep : 1;
+    } flags;
+} uart_config_t;
+
+esp_err_t uart_driver_install (uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size, int queue_size, QueueHandle_t * uart_queue, int intr_alloc_flags);
+esp_err_t uart_param_config (uart_port_t uart_num, const uart_config_t * uart_config);
+esp_err_t uart_set_pin (uart_port_t uart_num, int tx_io_num, int rx_io_num, int rts_io_num, int cts_io_num);
+esp_err_t uart_set_line_inverse (uart_port_t uart_num, uint32_t inverse_mask);
+esp_err_t uart_set_baudrate (uart_port_t uart_num, uint32_t baudrate);
+esp_err_t uart_flush (uart_port_t uart_num);
+int       uart_write_bytes (uart_port_t uart_num, const void * src, size_t size);
+int       uart_read_bytes (uart_port_t uart_num, void * buf, uint32_t length, TickType_t ticks_to_wait);
+
+#ifdef __cplusplus
+}
+#endif
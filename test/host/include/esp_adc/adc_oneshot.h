@@ -0,0 +1,17 @@
+#pragma once
+
+// Only the handle types globals.h declares; the ADC itself is not part of the host build
+
+typedef struct adc_oneshot_unit_ctx_t * adc_oneshot_unit_handle_t;
+typedef struct adc_cali_scheme_t *      adc_cali_handle_t;
+
+typedef struct {
+    int unit_id;
+    int clk_src;
+    int ulp_mode;
+} adc_oneshot_unit_init_cfg_t;
+
+typedef struct {
+    int atten;
+    int bitwidth;
+} adc_oneshot_chan_cfg_t;
@@ -0,0 +1,7 @@
+#pragma once
+
+// Placement attributes for the ESP32's memory map; everything is just code and data here
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The subset of ESP-IDF's esp_http_server the firmware uses, served from a local TCP socket.
+ * One httpd task accepts connections and runs the handlers, one request at a time, with
+ * persistent connections, chunked responses, LRU purging and asynchronous requests like the
+ * ESP-IDF server. Sockets are non-blocking and the task yields a tick whenever it would wait,
+ * since a blocking system call would stall every task of the POSIX port.
+ */
+
+#define HTTPD_MAX_URI_LEN     512   // CONFIG_HTTPD_MAX_URI_LEN
+#define HTTPD_MAX_REQ_HDR_LEN 8192  // request line and headers; generous, unlike the ESP32's scratch buffer
+
+#define HTTPD_RESP_USE_STRLEN -1
+
+#define HTTPD_SOCK_ERR_FAIL    -1
+#define HTTPD_SOCK_ERR_INVALID -2
+#define HTTPD_SOCK_ERR_TIMEOUT -3
+
+#define ESP_ERR_HTTPD_HANDLERS_FULL  (ESP_ERR_HTTPD_BASE + 1)
+#define ESP_ERR_HTTPD_HANDLER_EXISTS (ESP_ERR_HTTPD_BASE + 2)
+#define ESP_ERR_HTTPD_INVALID_REQ    (ESP_ERR_HTTPD_BASE + 3)
+#define ESP_ERR_HTTPD_RESULT_TRUNC   (ESP_ERR_HTTPD_BASE + 4)
+#define ESP_ERR_HTTPD_RESP_HDR       (ESP_ERR_HTTPD_BASE + 5)
+#define ESP_ERR_HTTPD_RESP_SEND      (ESP_ERR_HTTPD_BASE + 6)
+#define ESP_ERR_HTTPD_ALLOC_MEM      (ESP_ERR_HTTPD_BASE + 7)
+#define ESP_ERR_HTTPD_TASK           (ESP_ERR_HTTPD_BASE + 8)
+
+// Method numbers of http_parser, which ESP-IDF uses
+enum http_method {
+    HTTP_DELETE  = 0,
+    HTTP_GET     = 1,
+    HTTP_HEAD    = 2,
+    HTTP_POST    = 3,
+    HTTP_PUT     = 4,
+    HTTP_OPTIONS = 6,
+    HTTP_PATCH   = 28
+};
+
+typedef enum http_method httpd_method_t;
+
+typedef enum {
+    HTTPD_500_INTERNAL_SERVER_ERROR = 0,
+    HTTPD_501_METHOD_NOT_IMPLEMENTED,
+    HTTPD_505_VERSION_NOT_SUPPORTED,
+    HTTPD_400_BAD_REQUEST,
+    HTTPD_401_UNAUTHORIZED,
+    HTTPD_403_FORBIDDEN,
+    HTTPD_404_NOT_FOUND,
+    HTTPD_405_METHOD_NOT_ALLOWED,
+    HTTPD_408_REQ_TIMEOUT,
+    HTTPD_411_LENGTH_REQUIRED,
+    HTTPD_414_URI_TOO_LONG,
+    HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE,
+    HTTPD_ERR_CODE_MAX
+} httpd_err_code_t;
+
+typedef void * httpd_handle_t;
+
+typedef void (*httpd_free_ctx_fn_t) (void * ctx);
+
+typedef bool (*httpd_uri_match_func_t) (const char * reference_uri, const char * uri_to_match, size_t match_upto);
+
+typedef struct {
+    unsigned               task_priority;
+    size_t                 stack_size;
+    uint16_t               server_port;
+    uint16_t               max_open_sockets;
+    uint16_t               max_uri_handlers;
+    uint16_t               max_resp_headers;
+    uint16_t               backlog_conn;
+    bool                   lru_purge_enable;
+    uint16_t               recv_wait_timeout;  // seconds
+    uint16_t               send_wait_timeout;  // seconds
+    bool                   keep_alive_enable;
+    int                    keep_alive_idle;
+    int                    keep_alive_interval;
+    int                    keep_alive_count;
+    httpd_uri_match_func_t uri_match_fn;
+} httpd_config_t;
+
+#define HTTPD_DEFAULT_CONFIG()                       \
+    {                                                \
+        .task_priority       = tskIDLE_PRIORITY + 5, \
+        .stack_size          = 4096,                 \
+        .server_port         = 80,                   \
+        .max_open_sockets    = 7,                    \
+        .max_uri_handlers    = 8,                    \
+        .max_resp_headers    = 8,                    \
+        .backlog_conn        = 5,                    \
+        .lru_purge_enable    = false,                \
+        .recv_wait_timeout   = 5,                    \
+        .send_wait_timeout   = 5,                    \
+        .keep_alive_enable   = false,                \
+        .keep_alive_idle     = 0,                    \
+        .keep_alive_interval = 0,                    \
+        .keep_alive_count    = 0,                    \
+        .uri_match_fn        = NULL,                 \
+    }
+
+typedef struct httpd_req {
+    httpd_handle_t      handle;
+    int                 method;
+    const char          uri[HTTPD_MAX_URI_LEN + 1];
+    size_t              content_len;
+    void *              aux;  // the shim's per-request state
+    void *              user_ctx;
+    void *              sess_ctx;
+    httpd_free_ctx_fn_t free_ctx;
+    bool                ignore_sess_ctx_changes;
+} httpd_req_t;
+
+typedef struct httpd_uri {
+    const char *   uri;
+    httpd_method_t method;
+    esp_err_t (*handler) (httpd_req_t * r);
+    void * user_ctx;
+} httpd_uri_t;
+
+/**
+ * Starts the server. The port is config->server_port, unless httpd_host_set_port() has
+ * chosen another, since ports below 1024 need privileges a developer's account won't have.
+ */
+esp_err_t httpd_start (httpd_handle_t * handle, const httpd_config_t * config);
+esp_err_t httpd_register_uri_handler (httpd_handle_t handle, const httpd_uri_t * uri_handler);
+
+void httpd_host_set_port (uint16_t port);
+
+size_t    httpd_req_get_url_query_len (httpd_req_t * r);
+esp_err_t httpd_req_get_url_query_str (httpd_req_t * r, char * buf, size_t buf_len);
+esp_err_t httpd_req_get_hdr_value_str (httpd_req_t * r, const char * field, char * val, size_t val_size);
+int       httpd_req_recv (httpd_req_t * r, char * buf, size_t buf_len);
+int       httpd_req_to_sockfd (httpd_req_t * r);
+
+esp_err_t httpd_req_async_handler_begin (httpd_req_t * r, httpd_req_t ** out);
+esp_err_t httpd_req_async_handler_complete (httpd_req_t * r);
+
+esp_err_t httpd_resp_set_status (httpd_req_t * r, const char * status);
+esp_err_t httpd_resp_set_type (httpd_req_t * r, const char * type);
+esp_err_t httpd_resp_set_hdr (httpd_req_t * r, const char * field, const char * value);
+esp_err_t httpd_resp_send (httpd_req_t * r, const char * buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_chunk (httpd_req_t * r, const char * buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_err (httpd_req_t * req, httpd_err_code_t error, const char * msg);
+int       httpd_send (httpd_req_t * r, const char * buf, size_t buf_len);  // raw: the caller writes the status line and headers
+
+static inline esp_err_t httpd_resp_send_408 (httpd_req_t * r) {
+    return httpd_resp_send_err (r, HTTPD_408_REQ_TIMEOUT, NULL);
+}
+
+#ifdef __cplusplus
+}
+#endif
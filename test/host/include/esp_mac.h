@@ -0,0 +1,24 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_MAC_WIFI_STA,
+    ESP_MAC_WIFI_SOFTAP,
+    ESP_MAC_BASE,
+    ESP_MAC_EFUSE_FACTORY
+} esp_mac_type_t;
+
+/**
+ * @param mac Receives a fixed, locally administered address, the same on every run.
+ */
+esp_err_t esp_read_mac (uint8_t * mac, esp_mac_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Busy-waits like the ROM routine, against CLOCK_MONOTONIC.
+ */
+void esp_rom_delay_us (uint32_t us);
+
+#ifdef __cplusplus
+}
+#endif
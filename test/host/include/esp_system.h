@@ -0,0 +1,21 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*shutdown_handler_t) (void);
+
+/**
+ * Runs on esp_restart(), which on the host runs the shutdown handlers and ends the process.
+ */
+esp_err_t esp_register_shutdown_handler (shutdown_handler_t handle);
+
+void esp_restart (void) __attribute__ ((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
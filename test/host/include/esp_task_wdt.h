@@ -0,0 +1,19 @@
+#pragma once
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// There is no task watchdog on the host: tasks subscribe and feed it, and nothing ever fires
+
+esp_err_t esp_task_wdt_add (TaskHandle_t task_handle);
+esp_err_t esp_task_wdt_reset (void);
+esp_err_t esp_task_wdt_delete (TaskHandle_t task_handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * esp_timer on the host: the time is CLOCK_MONOTONIC since the process started, and timers
+ * are FreeRTOS software timers, so callbacks run on the timer service task much as they run on
+ * the esp_timer task on the ESP32, only with the tick's 1 ms resolution.
+ */
+
+typedef struct esp_timer * esp_timer_handle_t;
+
+typedef void (*esp_timer_cb_t) (void * arg);
+
+typedef enum {
+    ESP_TIMER_TASK,
+    ESP_TIMER_ISR,
+    ESP_TIMER_MAX
+} esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t       callback;
+    void *               arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char *         name;
+    bool                 skip_unhandled_events;
+} esp_timer_create_args_t;
+
+int64_t   esp_timer_get_time (void);
+esp_err_t esp_timer_create (const esp_timer_create_args_t * create_args, esp_timer_handle_t * out_handle);
+esp_err_t esp_timer_start_once (esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_stop (esp_timer_handle_t timer);
+esp_err_t esp_timer_delete (esp_timer_handle_t timer);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,8 @@
+#pragma once
+
+// ESP-IDF keeps the kernel headers under freertos/; the upstream kernel has them at the top
+#include <FreeRTOS.h>
+
+// and, as ESP-IDF's port does, brings in the system API
+#include <esp_err.h>
+#include <esp_system.h>
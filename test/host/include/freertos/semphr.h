@@ -0,0 +1,4 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+#include <semphr.h>
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <driver/uart.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Register-level access to a UART's transmit FIFO, for the tone ISR. Writes go to the same
+ * emulated line as uart_write_bytes(); the FIFO drains at the line's baud rate.
+ */
+
+#define UART_LL_FIFO_DEF_LEN 128
+
+typedef struct {
+    uart_port_t port;
+} uart_dev_t;
+
+uart_dev_t * uart_ll_get_hw (uart_port_t uart_num);
+uint32_t     uart_ll_get_txfifo_len (uart_dev_t * hw);
+void         uart_ll_write_txfifo (uart_dev_t * hw, const uint8_t * buf, uint32_t wr_len);
+
+#define UART_LL_GET_HW(num) uart_ll_get_hw (num)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,8 @@
+#pragma once
+
+// lwIP's BSD socket API is the host's own
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
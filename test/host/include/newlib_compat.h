@@ -0,0 +1,16 @@
+#pragma once
+
+// What the firmware takes from newlib and an older glibc lacks; included ahead of every source
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+#ifdef __cplusplus
+extern "C" {
+#endif
+size_t strlcpy (char * dst, const char * src, size_t size);
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <esp_err.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * NVS on the host is an in-memory store, empty at every start like a freshly erased partition.
+ * Writes are visible at once; nvs_commit() only counts commits, for profiling.
+ */
+
+#define ESP_ERR_NVS_NOT_INITIALIZED   (ESP_ERR_NVS_BASE + 0x01)
+#define ESP_ERR_NVS_NOT_FOUND         (ESP_ERR_NVS_BASE + 0x02)
+#define ESP_ERR_NVS_TYPE_MISMATCH     (ESP_ERR_NVS_BASE + 0x03)
+#define ESP_ERR_NVS_INVALID_HANDLE    (ESP_ERR_NVS_BASE + 0x07)
+#define ESP_ERR_NVS_KEY_TOO_LONG      (ESP_ERR_NVS_BASE + 0x09)
+#define ESP_ERR_NVS_INVALID_LENGTH    (ESP_ERR_NVS_BASE + 0x0c)
+#define ESP_ERR_NVS_NO_FREE_PAGES     (ESP_ERR_NVS_BASE + 0x0d)
+#define ESP_ERR_NVS_NEW_VERSION_FOUND (ESP_ERR_NVS_BASE + 0x10)
+
+#define NVS_KEY_NAME_MAX_SIZE 16  // including the terminator
+
+typedef uint32_t nvs_handle_t;
+
+typedef enum {
+    NVS_READONLY,
+    NVS_READWRITE
+} nvs_open_mode_t;
+
+esp_err_t nvs_open (const char * namespace_name, nvs_open_mode_t open_mode, nvs_handle_t * out_handle);
+void      nvs_close (nvs_handle_t handle);
+esp_err_t nvs_commit (nvs_handle_t handle);
+esp_err_t nvs_set_u8 (nvs_handle_t handle, const char * key, uint8_t value);
+esp_err_t nvs_set_u32 (nvs_handle_t handle, const char * key, uint32_t value);
+esp_err_t nvs_set_str (nvs_handle_t handle, const char * key, const char * value);
+esp_err_t nvs_get_u8 (nvs_handle_t handle, const char * key, uint8_t * out_value);
+esp_err_t nvs_get_u32 (nvs_handle_t handle, const char * key, uint32_t * out_value);
+
+/**
+ * @param out_value Receives the string, or nullptr to only learn its length.
+ * @param length In: the size of out_value. Out: the size the string needs, with the terminator.
+ */
+esp_err_t nvs_get_str (nvs_handle_t handle, const char * key, char * out_value, size_t * length);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,91 @@
+#include "clock_sync.h"
+#include "fsk_engine.h"
+#include "globals.h"
+#include "hardware_specific.h"
+#include "idle_status_task.h"
+#include "kx_radio.h"
+#include "settings.h"
+#include "shim/kx_emulator.h"
+#include "timed_lock.h"
+#include "webserver.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <unistd.h>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:hostmain";
+
+/**
+ * The firmware core on the host: the web server on a local port, and the radio drivers talking
+ * to an emulated KX2 or KX3 (shim/kx_emulator.h), under the FreeRTOS POSIX port. Startup
+ * follows setup(), without the WiFi, battery and LED parts.
+ */
+
+extern "C" void vAssertCalled (const char * file, unsigned long line) {
+    fprintf (stderr, "configASSERT failed at %s:%lu\n", file, line);
+    abort();
+}
+
+static void radio_connection_task (void * _) {
+    ESP_LOGI (TAG8, "Attempting to connect to radio...");
+    {
+        TimedLock lock = kxRadio.timed_lock (portMAX_DELAY, "radio connect");
+        kxRadio.connect();
+    }
+    ESP_LOGI (TAG8, "radio connection established.");
+    vTaskDelete (NULL);
+}
+
+static void setup_task (void * _) {
+    set_hardware_specific();
+    std::time (&LastUserActivityUnixTime);
+    init_settings();
+    init_clock_sync();
+    init_fsk_engine();
+
+    xTaskCreate (&radio_connection_task, "radio_task", 4096, NULL, SC_TASK_PRIORITY_NORMAL, NULL);
+
+    start_webserver();
+    ESP_LOGI (TAG8, "webserver initialized.");
+    vTaskDelete (NULL);
+}
+
+static void usage (const char * program) {
+    fprintf (stderr,
+             "usage: %s [-p port] [-3] [-v]\n"
+             "  -p port  port for the web server (default 8080)\n"
+             "  -3       emulate a KX3 rather than a KX2\n"
+             "  -v       verbose logging; repeat for more\n",
+             program);
+}
+
+int main (int argc, char ** argv) {
+    uint16_t        port       = 8080;
+    char            product_id = '1';
+    esp_log_level_t level      = ESP_LOG_INFO;
+
+    int option;
+    while ((option = getopt (argc, argv, "p:3vh")) != -1) {
+        switch (option) {
+        case 'p': port = (uint16_t)atoi (optarg); break;
+        case '3': product_id = '2'; break;
+        case 'v':
+            if (level < ESP_LOG_VERBOSE)
+                level = (esp_log_level_t)(level + 1);
+            break;
+        default: usage (argv[0]); return option == 'h' ? 0 : 2;
+        }
+    }
+
+    esp_log_level_set ("*", level);
+    httpd_host_set_port (port);
+    kx_emulator_init (product_id);
+
+    xTaskCreate (&setup_task, "setup_task", 8192, NULL, SC_TASK_PRIORITY_NORMAL, NULL);
+    vTaskStartScheduler();
+    return 1;  // only if the scheduler couldn't start
+}
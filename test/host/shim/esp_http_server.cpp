@@ -0,0 +1,718 @@
+#include <esp_http_server.h>
+#include <esp_timer.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <string>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:host_httpd";
+
+/**
+ * A client connection. While a handler has detached a request from it with
+ * httpd_req_async_handler_begin(), the connection belongs to that handler's task, and the
+ * server task leaves it alone until httpd_req_async_handler_complete().
+ */
+typedef struct {
+    int                 fd;
+    std::string         input;  // received and not yet consumed
+    void *              ctx;
+    httpd_free_ctx_fn_t free_ctx;
+    std::atomic<bool>   detached;
+    bool                close_requested;
+    uint64_t            last_used;  // for the LRU purge
+} httpd_session_t;
+
+typedef struct {
+    const char * field;
+    const char * value;
+} httpd_resp_hdr_t;
+
+/**
+ * The state of one request and its response, hung off httpd_req_t::aux.
+ */
+typedef struct {
+    httpd_session_t *             session;
+    std::string                   headers;  // the header lines, each ending in "\r\n"
+    size_t                        body_remaining;
+    bool                          close_after;  // Connection: close, from either side
+    const char *                  status;
+    const char *                  type;
+    std::vector<httpd_resp_hdr_t> resp_headers;
+    bool                          chunked;
+    bool                          response_done;
+    bool                          detached;  // handed to an asynchronous handler, which may finish it at any time
+} httpd_req_aux_t;
+
+typedef struct {
+    httpd_config_t                 config;
+    int                            listen_fd;
+    std::vector<httpd_uri_t>       handlers;  // reserved up front, as the task reads while handlers are added
+    std::atomic<size_t>            handler_count;
+    std::vector<httpd_session_t *> sessions;
+    uint64_t                       use_counter;
+    TaskHandle_t                   task;
+} httpd_server_t;
+
+static uint16_t s_port_override = 0;
+
+void httpd_host_set_port (uint16_t port) {
+    s_port_override = port;
+}
+
+// ====================================================================================================
+// Sockets
+
+/**
+ * Sends all of the data, yielding while the socket's buffer is full.
+ * @return false if the client has gone, or didn't take the data within send_wait_timeout.
+ */
+static bool httpd_send_all (httpd_req_t * r, const char * data, size_t length) {
+    httpd_req_aux_t * aux      = (httpd_req_aux_t *)r->aux;
+    httpd_server_t *  server   = (httpd_server_t *)r->handle;
+    int64_t           deadline = esp_timer_get_time() + server->config.send_wait_timeout * 1000000LL;
+    while (length > 0) {
+        ssize_t sent = send (aux->session->fd, data, length, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent > 0) {
+            data += sent;
+            length -= sent;
+            continue;
+        }
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && esp_timer_get_time() < deadline) {
+            vTaskDelay (1);
+            continue;
+        }
+        aux->session->close_requested = true;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Receives what the socket has, waiting up to recv_wait_timeout for something to arrive.
+ * @return the number of bytes received, or HTTPD_SOCK_ERR_TIMEOUT or HTTPD_SOCK_ERR_FAIL.
+ */
+static int httpd_recv_some (httpd_req_t * r, char * buf, size_t buf_len) {
+    httpd_req_aux_t * aux      = (httpd_req_aux_t *)r->aux;
+    httpd_server_t *  server   = (httpd_server_t *)r->handle;
+    int64_t           deadline = esp_timer_get_time() + server->config.recv_wait_timeout * 1000000LL;
+    while (true) {
+        ssize_t received = recv (aux->session->fd, buf, buf_len, MSG_DONTWAIT);
+        if (received > 0)
+            return (int)received;
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (esp_timer_get_time() >= deadline)
+                return HTTPD_SOCK_ERR_TIMEOUT;
+            vTaskDelay (1);
+            continue;
+        }
+        return HTTPD_SOCK_ERR_FAIL;  // closed by the client, or reset
+    }
+}
+
+int httpd_req_recv (httpd_req_t * r, char * buf, size_t buf_len) {
+    httpd_req_aux_t * aux    = (httpd_req_aux_t *)r->aux;
+    size_t            wanted = buf_len < aux->body_remaining ? buf_len : aux->body_remaining;
+    if (wanted == 0)
+        return 0;
+
+    std::string & input = aux->session->input;
+    if (!input.empty()) {
+        size_t length = wanted < input.size() ? wanted : input.size();
+        memcpy (buf, input.data(), length);
+        input.erase (0, length);
+        aux->body_remaining -= length;
+        return (int)length;
+    }
+    int received = httpd_recv_some (r, buf, wanted);
+    if (received > 0)
+        aux->body_remaining -= received;
+    return received;
+}
+
+/**
+ * Reads and drops whatever the handler left of the body, so the next request can be parsed.
+ */
+static void httpd_purge_body (httpd_req_t * r) {
+    httpd_req_aux_t * aux = (httpd_req_aux_t *)r->aux;
+    char              scratch[512];
+    while (aux->body_remaining > 0 && !aux->session->close_requested)
+        if (httpd_req_recv (r, scratch, sizeof (scratch)) <= 0)
+            aux->session->close_requested = true;
+}
+
+int httpd_req_to_sockfd (httpd_req_t * r) {
+    return r && r->aux ? ((httpd_req_aux_t *)r->aux)->session->fd : -1;
+}
+
+// ====================================================================================================
+// Request
+
+size_t httpd_req_get_url_query_len (httpd_req_t * r) {
+    const char * query = strchr (r->uri, '?');
+    if (!query)
+        return 0;
+    ++query;
+    const char * fragment = strchr (query, '#');
+    return fragment ? (size_t)(fragment - query) : strlen (query);
+}
+
+esp_err_t httpd_req_get_url_query_str (httpd_req_t * r, char * buf, size_t buf_len) {
+    if (!buf || buf_len == 0)
+        return ESP_ERR_INVALID_ARG;
+    const char * query = strchr (r->uri, '?');
+    if (!query)
+        return ESP_ERR_NOT_FOUND;
+
+    size_t length = httpd_req_get_url_query_len (r);
+    size_t copied = length < buf_len - 1 ? length : buf_len - 1;
+    memcpy (buf, query + 1, copied);
+    buf[copied] = '\0';
+    return copied < length ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+/**
+ * Finds a request header, ignoring the case of its name.
+ * @return the start of its value, with the value's length in *length, or nullptr.
+ */
+static const char * httpd_find_hdr (const httpd_req_aux_t * aux, const char * field, size_t * length) {
+    size_t       field_length = strlen (field);
+    const char * line         = aux->headers.c_str();
+    while (*line) {
+        const char * end = strstr (line, "\r\n");
+        if (!end)
+            break;
+        if (strncasecmp (line, field, field_length) == 0 && line[field_length] == ':') {
+            const char * value = line + field_length + 1;
+            while (value < end && (*value == ' ' || *value == '\t'))
+                ++value;
+            const char * value_end = end;
+            while (value_end > value && (value_end[-1] == ' ' || value_end[-1] == '\t'))
+                --value_end;
+            *length = value_end - value;
+            return value;
+        }
+        line = end + 2;
+    }
+    return nullptr;
+}
+
+esp_err_t httpd_req_get_hdr_value_str (httpd_req_t * r, const char * field, char * val, size_t val_size) {
+    if (!r || !field || !val || val_size == 0)
+        return ESP_ERR_INVALID_ARG;
+    size_t       length = 0;
+    const char * value  = httpd_find_hdr ((httpd_req_aux_t *)r->aux, field, &length);
+    if (!value)
+        return ESP_ERR_NOT_FOUND;
+
+    size_t copied = length < val_size - 1 ? length : val_size - 1;
+    memcpy (val, value, copied);
+    val[copied] = '\0';
+    return copied < length ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+// ====================================================================================================
+// Response
+
+esp_err_t httpd_resp_set_status (httpd_req_t * r, const char * status) {
+    ((httpd_req_aux_t *)r->aux)->status = status;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type (httpd_req_t * r, const char * type) {
+    ((httpd_req_aux_t *)r->aux)->type = type;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr (httpd_req_t * r, const char * field, const char * value) {
+    httpd_req_aux_t * aux    = (httpd_req_aux_t *)r->aux;
+    httpd_server_t *  server = (httpd_server_t *)r->handle;
+    if (aux->resp_headers.size() >= server->config.max_resp_headers)
+        return ESP_ERR_HTTPD_RESP_HDR;
+    aux->resp_headers.push_back ({field, value});  // like ESP-IDF, keeps the pointers, not copies
+    if (strcasecmp (field, "Connection") == 0 && strcasecmp (value, "close") == 0)
+        aux->close_after = true;
+    return ESP_OK;
+}
+
+/**
+ * Sends the status line and headers, with either the content length or chunked encoding.
+ */
+static bool httpd_send_head (httpd_req_t * r, const char * framing) {
+    httpd_req_aux_t * aux = (httpd_req_aux_t *)r->aux;
+    std::string       head;
+    head.reserve (256);
+    head.append ("HTTP/1.1 ").append (aux->status).append ("\r\n");
+    head.append ("Content-Type: ").append (aux->type).append ("\r\n");
+    head.append (framing).append ("\r\n");
+    for (const httpd_resp_hdr_t & header : aux->resp_headers)
+        head.append (header.field).append (": ").append (header.value).append ("\r\n");
+    head.append ("\r\n");
+    return httpd_send_all (r, head.data(), head.size());
+}
+
+esp_err_t httpd_resp_send (httpd_req_t * r, const char * buf, ssize_t buf_len) {
+    httpd_req_aux_t * aux = (httpd_req_aux_t *)r->aux;
+    if (buf_len == HTTPD_RESP_USE_STRLEN)
+        buf_len = buf ? strlen (buf) : 0;
+
+    char content_length[40];
+    snprintf (content_length, sizeof (content_length), "Content-Length: %zd", buf_len);
+    aux->response_done = true;
+    if (!httpd_send_head (r, content_length) || !httpd_send_all (r, buf, buf_len))
+        return ESP_ERR_HTTPD_RESP_SEND;
+    return ESP_OK;
+}
+
+int httpd_send (httpd_req_t * r, const char * buf, size_t buf_len) {
+    ((httpd_req_aux_t *)r->aux)->response_done = true;
+    return httpd_send_all (r, buf, buf_len) ? (int)buf_len : HTTPD_SOCK_ERR_FAIL;
+}
+
+esp_err_t httpd_resp_send_chunk (httpd_req_t * r, const char * buf, ssize_t buf_len) {
+    httpd_req_aux_t * aux = (httpd_req_aux_t *)r->aux;
+    if (buf_len == HTTPD_RESP_USE_STRLEN)
+        buf_len = buf ? strlen (buf) : 0;
+
+    if (!aux->chunked) {
+        aux->chunked = true;
+        if (!httpd_send_head (r, "Transfer-Encoding: chunked"))
+            return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    if (!buf || buf_len == 0) {
+        aux->response_done = true;
+        return httpd_send_all (r, "0\r\n\r\n", 5) ? ESP_OK : ESP_ERR_HTTPD_RESP_SEND;
+    }
+
+    char size_line[20];
+    int  size_length = snprintf (size_line, sizeof (size_line), "%zx\r\n", buf_len);
+    if (!httpd_send_all (r, size_line, size_length) || !httpd_send_all (r, buf, buf_len) || !httpd_send_all (r, "\r\n", 2))
+        return ESP_ERR_HTTPD_RESP_SEND;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_err (httpd_req_t * req, httpd_err_code_t error, const char * msg) {
+    static const struct {
+        const char * status;
+        const char * message;
+    } errors[HTTPD_ERR_CODE_MAX] = {
+        {"500 Internal Server Error", "Server has encountered an unexpected error"},
+        {"501 Method Not Implemented", "Request method is not supported by server"},
+        {"505 Version Not Supported", "HTTP version not supported by server"},
+        {"400 Bad Request", "Bad request syntax"},
+        {"401 Unauthorized", "No permission to access"},
+        {"403 Forbidden", "Request is forbidden"},
+        {"404 Not Found", "Nothing matches the given URI"},
+        {"405 Method Not Allowed", "Specified method is invalid for this resource"},
+        {"408 Request Timeout", "Server closed this connection"},
+        {"411 Length Required", "Chunked encoding not supported"},
+        {"414 URI Too Long", "URI is too long"},
+        {"431 Request Header Fields Too Large", "Header fields are too long"},
+    };
+    if (error < 0 || error >= HTTPD_ERR_CODE_MAX)
+        return ESP_ERR_INVALID_ARG;
+
+    httpd_resp_set_status (req, errors[error].status);
+    httpd_resp_set_type (req, "text/plain");
+    return httpd_resp_send (req, msg ? msg : errors[error].message, HTTPD_RESP_USE_STRLEN);
+}
+
+// ====================================================================================================
+// Asynchronous requests
+
+esp_err_t httpd_req_async_handler_begin (httpd_req_t * r, httpd_req_t ** out) {
+    if (!r || !out)
+        return ESP_ERR_INVALID_ARG;
+    httpd_req_t * copy = (httpd_req_t *)calloc (1, sizeof (httpd_req_t));
+    if (!copy)
+        return ESP_ERR_NO_MEM;
+    memcpy ((void *)copy, r, sizeof (httpd_req_t));  // the uri member is const, so no assignment
+    httpd_req_aux_t * aux = (httpd_req_aux_t *)r->aux;
+    copy->aux             = new httpd_req_aux_t (*aux);
+    aux->detached         = true;
+    aux->session->detached.store (true);
+    *out = copy;
+    return ESP_OK;
+}
+
+/**
+ * Hands the connection back to the server. A response that was never finished closes it, as
+ * the client would otherwise wait for the rest.
+ */
+esp_err_t httpd_req_async_handler_complete (httpd_req_t * r) {
+    if (!r)
+        return ESP_ERR_INVALID_ARG;
+    httpd_req_aux_t * aux     = (httpd_req_aux_t *)r->aux;
+    httpd_session_t * session = aux->session;
+    httpd_purge_body (r);
+    if (!aux->response_done || aux->close_after)
+        session->close_requested = true;
+    delete aux;
+    free (r);
+    session->detached.store (false);
+    return ESP_OK;
+}
+
+// ====================================================================================================
+// Server
+
+static void httpd_session_close (httpd_server_t * server, httpd_session_t * session) {
+    if (session->ctx) {
+        if (session->free_ctx)
+            session->free_ctx (session->ctx);
+        else
+            free (session->ctx);
+    }
+    close (session->fd);
+    for (size_t i = 0; i < server->sessions.size(); ++i)
+        if (server->sessions[i] == session) {
+            server->sessions.erase (server->sessions.begin() + i);
+            break;
+        }
+    delete session;
+}
+
+static httpd_method_t httpd_parse_method (const std::string & name, bool * valid) {
+    static const struct {
+        const char *   name;
+        httpd_method_t method;
+    } methods[] = {
+        {"GET", HTTP_GET},
+        {"POST", HTTP_POST},
+        {"PUT", HTTP_PUT},
+        {"DELETE", HTTP_DELETE},
+        {"PATCH", HTTP_PATCH},
+        {"HEAD", HTTP_HEAD},
+        {"OPTIONS", HTTP_OPTIONS},
+    };
+    for (const auto & entry : methods)
+        if (name == entry.name) {
+            *valid = true;
+            return entry.method;
+        }
+    *valid = false;
+    return HTTP_GET;
+}
+
+static bool httpd_uri_matches (const httpd_server_t * server, const httpd_uri_t & handler, const char * uri) {
+    const char * query      = strchr (uri, '?');
+    size_t       uri_length = query ? (size_t)(query - uri) : strlen (uri);
+    if (server->config.uri_match_fn)
+        return server->config.uri_match_fn (handler.uri, uri, uri_length);
+    return strlen (handler.uri) == uri_length && strncmp (handler.uri, uri, uri_length) == 0;
+}
+
+/**
+ * Runs the handler for a request whose head has been taken off the session's input.
+ * @return false if the session is to be closed.
+ */
+static bool httpd_handle_request (httpd_server_t * server, httpd_session_t * session, const std::string & head) {
+    httpd_req_t *   r   = (httpd_req_t *)calloc (1, sizeof (httpd_req_t));
+    httpd_req_aux_t aux = {};
+    aux.session         = session;
+    aux.status          = "200 OK";
+    aux.type            = "text/html";
+    r->handle           = server;
+    r->aux              = &aux;
+    r->sess_ctx         = session->ctx;
+    r->free_ctx         = session->free_ctx;
+
+    size_t      line_end = head.find ("\r\n");
+    std::string line     = head.substr (0, line_end);
+    aux.headers          = head.substr (line_end + 2);
+    size_t method_end    = line.find (' ');
+    size_t uri_end       = method_end == std::string::npos ? std::string::npos : line.find (' ', method_end + 1);
+
+    httpd_err_code_t error        = HTTPD_ERR_CODE_MAX;
+    bool             method_valid = false;
+    if (uri_end == std::string::npos)
+        error = HTTPD_400_BAD_REQUEST;
+    else {
+        r->method           = httpd_parse_method (line.substr (0, method_end), &method_valid);
+        std::string uri     = line.substr (method_end + 1, uri_end - method_end - 1);
+        std::string version = line.substr (uri_end + 1);
+        if (!method_valid)
+            error = HTTPD_501_METHOD_NOT_IMPLEMENTED;
+        else if (version != "HTTP/1.1" && version != "HTTP/1.0")
+            error = HTTPD_505_VERSION_NOT_SUPPORTED;
+        else if (uri.size() > HTTPD_MAX_URI_LEN)
+            error = HTTPD_414_URI_TOO_LONG;
+        else
+            memcpy ((char *)r->uri, uri.c_str(), uri.size() + 1);
+
+        char connection[16];
+        aux.close_after = version == "HTTP/1.0" ||
+                           (httpd_req_get_hdr_value_str (r, "Connection", connection, sizeof (connection)) == ESP_OK &&
+                            strcasecmp (connection, "close") == 0);
+    }
+
+    size_t       length_size    = 0;
+    const char * content_length = httpd_find_hdr (&aux, "Content-Length", &length_size);
+    r->content_len              = content_length ? strtoul (std::string (content_length, length_size).c_str(), nullptr, 10) : 0;
+    aux.body_remaining          = r->content_len;
+    if (error == HTTPD_ERR_CODE_MAX && httpd_find_hdr (&aux, "Transfer-Encoding", &length_size))
+        error = HTTPD_411_LENGTH_REQUIRED;
+
+    const httpd_uri_t * handler = nullptr;
+    if (error == HTTPD_ERR_CODE_MAX) {
+        bool   uri_found = false;
+        size_t count     = server->handler_count.load();
+        for (size_t i = 0; i < count && !handler; ++i)
+            if (httpd_uri_matches (server, server->handlers[i], r->uri)) {
+                uri_found = true;
+                if (server->handlers[i].method == r->method)
+                    handler = &server->handlers[i];
+            }
+        if (!handler)
+            error = uri_found ? HTTPD_405_METHOD_NOT_ALLOWED : HTTPD_404_NOT_FOUND;
+    }
+
+    bool keep = true;
+    if (!handler) {
+        // As in ESP-IDF, a request that reaches no handler closes the connection
+        httpd_resp_send_err (r, error, nullptr);
+        keep = false;
+    }
+    else {
+        r->user_ctx      = handler->user_ctx;
+        esp_err_t result = handler->handler (r);
+        if (aux.detached) {
+            free (r);  // the handler has its own copy now
+            return true;
+        }
+        if (!r->ignore_sess_ctx_changes && r->sess_ctx != session->ctx) {
+            if (session->ctx && session->free_ctx)
+                session->free_ctx (session->ctx);
+            else if (session->ctx)
+                free (session->ctx);
+            session->ctx = r->sess_ctx;
+        }
+        session->free_ctx = r->free_ctx;
+        httpd_purge_body (r);
+        if (result != ESP_OK) {
+            ESP_LOGD (TAG8, "handler for %s returned %s; closing", r->uri, esp_err_to_name (result));
+            keep = false;
+        }
+        else if (!aux.response_done)
+            ESP_LOGW (TAG8, "handler for %s returned without finishing its response", r->uri);
+        keep = keep && !aux.close_after && !session->close_requested;
+    }
+    free (r);
+    return keep;
+}
+
+/**
+ * Handles the complete requests in the session's input, one after another.
+ * @return false if the session is to be closed.
+ */
+static bool httpd_session_process (httpd_server_t * server, httpd_session_t * session) {
+    while (!session->detached.load()) {
+        if (session->close_requested)
+            return false;
+        size_t head_end = session->input.find ("\r\n\r\n");
+        if (head_end == std::string::npos) {
+            if (session->input.size() <= HTTPD_MAX_REQ_HDR_LEN)
+                return true;
+            head_end = HTTPD_MAX_REQ_HDR_LEN;  // handled below
+        }
+        if (head_end >= HTTPD_MAX_REQ_HDR_LEN) {
+            ESP_LOGW (TAG8, "request headers too large on socket %d", session->fd);
+            httpd_req_t *   r   = (httpd_req_t *)calloc (1, sizeof (httpd_req_t));
+            httpd_req_aux_t aux = {};
+            aux.session         = session;
+            r->handle           = server;
+            r->aux              = &aux;
+            httpd_resp_send_err (r, HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE, nullptr);
+            free (r);
+            return false;
+        }
+
+        std::string head = session->input.substr (0, head_end + 2);
+        session->input.erase (0, head_end + 4);
+        session->last_used = ++server->use_counter;
+        if (!httpd_handle_request (server, session, head))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Reads what has arrived on a session.
+ * @return false if the client has closed the connection, or it failed.
+ */
+static bool httpd_session_read (httpd_session_t * session) {
+    char buffer[2048];
+    while (true) {
+        ssize_t received = recv (session->fd, buffer, sizeof (buffer), MSG_DONTWAIT);
+        if (received > 0) {
+            session->input.append (buffer, received);
+            continue;
+        }
+        if (received < 0 && errno == EINTR)
+            continue;
+        return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+static void httpd_accept (httpd_server_t * server) {
+    int fd = accept (server->listen_fd, nullptr, nullptr);
+    if (fd < 0)
+        return;
+
+    if (server->sessions.size() >= server->config.max_open_sockets) {
+        httpd_session_t * oldest = nullptr;
+        for (httpd_session_t * session : server->sessions)
+            if (!session->detached.load() && (!oldest || session->last_used < oldest->last_used))
+                oldest = session;
+        if (!oldest) {
+            close (fd);
+            return;
+        }
+        ESP_LOGD (TAG8, "purging least recently used socket %d", oldest->fd);
+        httpd_session_close (server, oldest);
+    }
+
+    fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) | O_NONBLOCK);
+    // The head and the body go out in separate writes; without this, Nagle's algorithm and
+    // delayed ACKs hold the body back by tens of milliseconds on loopback
+    int one = 1;
+    setsockopt (fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof (one));
+    if (server->config.keep_alive_enable) {
+        setsockopt (fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof (one));
+        setsockopt (fd, IPPROTO_TCP, TCP_KEEPIDLE, &server->config.keep_alive_idle, sizeof (int));
+        setsockopt (fd, IPPROTO_TCP, TCP_KEEPINTVL, &server->config.keep_alive_interval, sizeof (int));
+        setsockopt (fd, IPPROTO_TCP, TCP_KEEPCNT, &server->config.keep_alive_count, sizeof (int));
+    }
+
+    httpd_session_t * session = new httpd_session_t {};
+    session->fd               = fd;
+    session->last_used        = ++server->use_counter;
+    server->sessions.push_back (session);
+}
+
+/**
+ * Polls without blocking, since a blocked system call would stop every task, and sleeps a
+ * tick when there is nothing to do.
+ */
+static void httpd_server_task (void * arg) {
+    httpd_server_t *               server = (httpd_server_t *)arg;
+    std::vector<pollfd>            fds;
+    std::vector<httpd_session_t *> polled;
+    while (true) {
+        // Sessions handed back by asynchronous handlers may have requests waiting, or be done
+        for (size_t i = 0; i < server->sessions.size();) {
+            httpd_session_t * session = server->sessions[i];
+            if (!session->detached.load() && (session->close_requested || !httpd_session_process (server, session)))
+                httpd_session_close (server, session);
+            else
+                ++i;
+        }
+
+        fds.clear();
+        polled.clear();
+        bool accepting = server->config.lru_purge_enable || server->sessions.size() < server->config.max_open_sockets;
+        fds.push_back ({server->listen_fd, (short)(accepting ? POLLIN : 0), 0});
+        for (httpd_session_t * session : server->sessions)
+            if (!session->detached.load()) {
+                fds.push_back ({session->fd, POLLIN, 0});
+                polled.push_back (session);
+            }
+
+        int ready = poll (fds.data(), fds.size(), 0);
+        if (ready <= 0) {
+            vTaskDelay (1);
+            continue;
+        }
+        for (size_t i = 0; i < polled.size(); ++i)
+            if (fds[i + 1].revents) {
+                httpd_session_t * session = polled[i];
+                bool              open    = httpd_session_read (session);
+                if (!httpd_session_process (server, session) || !open)
+                    if (!session->detached.load())
+                        httpd_session_close (server, session);
+            }
+        if (fds[0].revents & POLLIN)
+            httpd_accept (server);
+    }
+}
+
+esp_err_t httpd_start (httpd_handle_t * handle, const httpd_config_t * config) {
+    if (!handle || !config)
+        return ESP_ERR_INVALID_ARG;
+
+    httpd_server_t * server = new httpd_server_t {};
+    server->config          = *config;
+    if (s_port_override)
+        server->config.server_port = s_port_override;
+    server->handlers.resize (config->max_uri_handlers);
+
+    // Dual-stack, so clients on IPv4 and IPv6 loopback both reach it
+    server->listen_fd = socket (AF_INET6, SOCK_STREAM, 0);
+    int one  = 1;
+    int zero = 0;
+    setsockopt (server->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof (one));
+    setsockopt (server->listen_fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof (zero));
+    struct sockaddr_in6 address = {};
+    address.sin6_family         = AF_INET6;
+    address.sin6_addr           = in6addr_any;
+    address.sin6_port           = htons (server->config.server_port);
+    if (server->listen_fd < 0 ||
+        bind (server->listen_fd, (struct sockaddr *)&address, sizeof (address)) != 0 ||
+        listen (server->listen_fd, config->backlog_conn) != 0) {
+        ESP_LOGE (TAG8, "can't listen on port %u: %s", server->config.server_port, strerror (errno));
+        if (server->listen_fd >= 0)
+            close (server->listen_fd);
+        delete server;
+        return ESP_FAIL;
+    }
+    fcntl (server->listen_fd, F_SETFL, fcntl (server->listen_fd, F_GETFL) | O_NONBLOCK);
+
+    if (xTaskCreate (httpd_server_task, "httpd", config->stack_size, server, config->task_priority, &server->task) != pdPASS) {
+        close (server->listen_fd);
+        delete server;
+        return ESP_ERR_HTTPD_TASK;
+    }
+    ESP_LOGI (TAG8, "listening on port %u", server->config.server_port);
+    *handle = server;
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler (httpd_handle_t handle, const httpd_uri_t * uri_handler) {
+    if (!handle || !uri_handler)
+        return ESP_ERR_INVALID_ARG;
+    httpd_server_t * server = (httpd_server_t *)handle;
+    size_t           count  = server->handler_count.load();
+    for (size_t i = 0; i < count; ++i)
+        if (server->handlers[i].method == uri_handler->method && strcmp (server->handlers[i].uri, uri_handler->uri) == 0)
+            return ESP_ERR_HTTPD_HANDLER_EXISTS;
+    if (count == server->handlers.size())
+        return ESP_ERR_HTTPD_HANDLERS_FULL;
+
+    // Copied with malloc() rather than strdup(), whose allocation inside glibc shim/heap.cpp can't guard
+    size_t uri_size = strlen (uri_handler->uri) + 1;
+    char * uri      = (char *)malloc (uri_size);
+    if (!uri)
+        return ESP_ERR_NO_MEM;
+    memcpy (uri, uri_handler->uri, uri_size);
+    server->handlers[count]     = *uri_handler;
+    server->handlers[count].uri = uri;
+    server->handler_count.store (count + 1);
+    return ESP_OK;
+}
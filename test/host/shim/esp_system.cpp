@@ -0,0 +1,167 @@
+#include <esp_err.h>
+#include <esp_log.h>
+#include <esp_mac.h>
+#include <esp_random.h>
+#include <esp_rom_sys.h>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+#include <esp_timer.h>
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <sys/random.h>
+#include <unistd.h>
+
+/**
+ * Logging, errors, restart and the other odds and ends of the ESP-IDF system API.
+ */
+
+const char * esp_err_to_name (esp_err_t code) {
+    switch (code) {
+    case ESP_OK: return "ESP_OK";
+    case ESP_FAIL: return "ESP_FAIL";
+    case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+    default: break;
+    }
+    if (code > ESP_ERR_HTTPD_BASE && code < ESP_ERR_HTTPD_BASE + 0x100)
+        return "ESP_ERR_HTTPD";
+    if (code > ESP_ERR_NVS_BASE && code < ESP_ERR_NVS_BASE + 0x100)
+        return "ESP_ERR_NVS";
+    return "UNKNOWN ERROR";
+}
+
+void _esp_error_check_failed (esp_err_t rc, const char * file, int line, const char * function, const char * expression) {
+    fprintf (stderr, "ESP_ERROR_CHECK failed: esp_err_t 0x%x (%s) at %s:%d\nfunc: %s\nexpression: %s\n",
+             rc, esp_err_to_name (rc), file, line, function, expression);
+    abort();
+}
+
+// ====================================================================================================
+// Logging: one line per write, so lines from different tasks don't interleave
+
+#define LOG_TAG_OVERRIDES 8
+
+typedef struct {
+    char            tag[16];
+    esp_log_level_t level;
+} log_tag_level_t;
+
+static std::atomic<esp_log_level_t> s_log_default_level {ESP_LOG_INFO};
+static log_tag_level_t              s_log_tag_levels[LOG_TAG_OVERRIDES];
+static std::atomic<size_t>          s_log_tag_count {0};
+
+void esp_log_level_set (const char * tag, esp_log_level_t level) {
+    if (strcmp (tag, "*") == 0) {
+        s_log_default_level.store (level);
+        return;
+    }
+    size_t count = s_log_tag_count.load();
+    for (size_t i = 0; i < count; ++i)
+        if (strcmp (s_log_tag_levels[i].tag, tag) == 0) {
+            s_log_tag_levels[i].level = level;
+            return;
+        }
+    if (count < LOG_TAG_OVERRIDES) {
+        strlcpy (s_log_tag_levels[count].tag, tag, sizeof (s_log_tag_levels[count].tag));
+        s_log_tag_levels[count].level = level;
+        s_log_tag_count.store (count + 1);
+    }
+}
+
+static esp_log_level_t log_level_for (const char * tag) {
+    size_t count = s_log_tag_count.load();
+    for (size_t i = 0; i < count; ++i)
+        if (strcmp (s_log_tag_levels[i].tag, tag) == 0)
+            return s_log_tag_levels[i].level;
+    return s_log_default_level.load();
+}
+
+uint32_t esp_log_timestamp () {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+void esp_log_write (esp_log_level_t level, const char * tag, const char * format, ...) {
+    if (level > log_level_for (tag))
+        return;
+
+    char    line[512];
+    va_list args;
+    va_start (args, format);
+    int length = vsnprintf (line, sizeof (line), format, args);
+    va_end (args);
+    if (length < 0)
+        return;
+    if ((size_t)length >= sizeof (line)) {
+        length                  = sizeof (line) - 1;
+        line[sizeof (line) - 2] = '\n';
+    }
+    (void)!write (STDOUT_FILENO, line, length);
+}
+
+// ====================================================================================================
+// Restart: the shutdown handlers run, as on the ESP32, and then the process ends
+
+#define SHUTDOWN_HANDLERS_MAX 4
+
+static shutdown_handler_t s_shutdown_handlers[SHUTDOWN_HANDLERS_MAX];
+static size_t             s_shutdown_handler_count = 0;
+
+esp_err_t esp_register_shutdown_handler (shutdown_handler_t handler) {
+    if (s_shutdown_handler_count == SHUTDOWN_HANDLERS_MAX)
+        return ESP_ERR_NO_MEM;
+    s_shutdown_handlers[s_shutdown_handler_count++] = handler;
+    return ESP_OK;
+}
+
+void esp_restart () {
+    for (size_t i = s_shutdown_handler_count; i > 0; --i)
+        s_shutdown_handlers[i - 1]();
+    static const char message[] = "esp_restart(): exiting\n";
+    (void)!write (STDOUT_FILENO, message, sizeof (message) - 1);
+    _exit (0);
+}
+
+// ====================================================================================================
+
+uint32_t esp_random () {
+    uint32_t value = 0;
+    while (getrandom (&value, sizeof (value), 0) != sizeof (value))
+        ;
+    return value;
+}
+
+esp_err_t esp_read_mac (uint8_t * mac, esp_mac_type_t type) {
+    static const uint8_t host_mac[6] = {0x02, 0x50, 0x43, 0x41, 0x54, 0x00};  // locally administered
+    memcpy (mac, host_mac, sizeof (host_mac));
+    if (type == ESP_MAC_WIFI_SOFTAP)
+        mac[5] += 1;
+    return ESP_OK;
+}
+
+void esp_rom_delay_us (uint32_t us) {
+    int64_t until = esp_timer_get_time() + us;
+    while (esp_timer_get_time() < until)
+        ;
+}
+
+esp_err_t esp_task_wdt_add (TaskHandle_t task_handle) {
+    (void)task_handle;
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_reset () {
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_delete (TaskHandle_t task_handle) {
+    (void)task_handle;
+    return ESP_OK;
+}
@@ -0,0 +1,86 @@
+#include <esp_timer.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
+#include <time.h>
+
+/**
+ * A one-shot esp_timer: a FreeRTOS software timer whose ID points back here.
+ */
+struct esp_timer {
+    TimerHandle_t  timer;
+    esp_timer_cb_t callback;
+    void *         arg;
+};
+
+static int64_t monotonic_us () {
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000LL + now.tv_nsec / 1000;
+}
+
+int64_t esp_timer_get_time () {
+    static const int64_t start_us = monotonic_us();  // time since boot, as on the ESP32
+    return monotonic_us() - start_us;
+}
+
+static void esp_timer_dispatch (TimerHandle_t timer) {
+    esp_timer_handle_t handle = (esp_timer_handle_t)pvTimerGetTimerID (timer);
+    handle->callback (handle->arg);
+}
+
+static void esp_timer_free (void * handle, uint32_t _) {
+    delete (esp_timer_handle_t)handle;
+}
+
+esp_err_t esp_timer_create (const esp_timer_create_args_t * create_args, esp_timer_handle_t * out_handle) {
+    if (!create_args || !create_args->callback || !out_handle)
+        return ESP_ERR_INVALID_ARG;
+
+    esp_timer_handle_t handle = new esp_timer {nullptr, create_args->callback, create_args->arg};
+    handle->timer             = xTimerCreate (create_args->name ? create_args->name : "esp_timer", 1, pdFALSE, handle, esp_timer_dispatch);
+    if (!handle->timer) {
+        delete handle;
+        return ESP_ERR_NO_MEM;
+    }
+    *out_handle = handle;
+    return ESP_OK;
+}
+
+/**
+ * Commands go to the timer service task without blocking, since callbacks, which run on that
+ * task, start and stop timers too. The timer task has the highest priority, so a command has
+ * been carried out by the time the call returns, and xTimerIsTimerActive() is up to date.
+ */
+esp_err_t esp_timer_start_once (esp_timer_handle_t timer, uint64_t timeout_us) {
+    if (!timer)
+        return ESP_ERR_INVALID_ARG;
+    if (xTimerIsTimerActive (timer->timer))
+        return ESP_ERR_INVALID_STATE;
+
+    // Never early: round up to whole ticks, as the alarm can only fire on one
+    const uint64_t tick_us = 1000000 / configTICK_RATE_HZ;
+    TickType_t     ticks   = (TickType_t)((timeout_us + tick_us - 1) / tick_us);
+    return xTimerChangePeriod (timer->timer, ticks > 0 ? ticks : 1, 0) == pdPASS ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_timer_stop (esp_timer_handle_t timer) {
+    if (!timer)
+        return ESP_ERR_INVALID_ARG;
+    if (!xTimerIsTimerActive (timer->timer))
+        return ESP_ERR_INVALID_STATE;
+    return xTimerStop (timer->timer, 0) == pdPASS ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_timer_delete (esp_timer_handle_t timer) {
+    if (!timer)
+        return ESP_ERR_INVALID_ARG;
+    if (xTimerIsTimerActive (timer->timer))
+        return ESP_ERR_INVALID_STATE;
+
+    // The timer task may still expire the timer before it sees the delete, so the handle is
+    // freed by a command queued behind it
+    if (xTimerDelete (timer->timer, 0) != pdPASS || xTimerPendFunctionCall (esp_timer_free, timer, 0, 0) != pdPASS)
+        return ESP_FAIL;
+    return ESP_OK;
+}
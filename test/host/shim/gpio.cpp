@@ -0,0 +1,43 @@
+#include <driver/gpio.h>
+
+static gpio_mode_t s_modes[GPIO_NUM_MAX];
+static uint8_t     s_levels[GPIO_NUM_MAX];
+
+static bool gpio_is_valid (gpio_num_t gpio_num) {
+    return gpio_num >= 0 && gpio_num < GPIO_NUM_MAX;
+}
+
+esp_err_t gpio_config (const gpio_config_t * config) {
+    for (int pin = 0; pin < GPIO_NUM_MAX; ++pin)
+        if (config->pin_bit_mask & (1ULL << pin))
+            s_modes[pin] = config->mode;
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin (gpio_num_t gpio_num) {
+    if (!gpio_is_valid (gpio_num))
+        return ESP_ERR_INVALID_ARG;
+    s_modes[gpio_num]  = GPIO_MODE_INPUT;
+    s_levels[gpio_num] = 0;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction (gpio_num_t gpio_num, gpio_mode_t mode) {
+    if (!gpio_is_valid (gpio_num))
+        return ESP_ERR_INVALID_ARG;
+    s_modes[gpio_num] = mode;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level (gpio_num_t gpio_num, uint32_t level) {
+    if (!gpio_is_valid (gpio_num))
+        return ESP_ERR_INVALID_ARG;
+    s_levels[gpio_num] = level ? 1 : 0;
+    return ESP_OK;
+}
+
+int gpio_get_level (gpio_num_t gpio_num) {
+    if (!gpio_is_valid (gpio_num) || s_modes[gpio_num] != GPIO_MODE_INPUT_OUTPUT)
+        return 0;
+    return s_levels[gpio_num];
+}
@@ -0,0 +1,181 @@
+#include <driver/gptimer.h>
+#include <esp_timer.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define GPTIMER_SPIN_US 2000  // the last stretch before an alarm is spun, as the tick is too coarse
+
+struct gptimer_t {
+    uint32_t           resolution_hz;
+    gptimer_alarm_cb_t on_alarm;
+    void *             user_ctx;
+    uint64_t           alarm_count;
+    uint64_t           reload_count;
+    bool               auto_reload;
+    bool               alarm_armed;  // cleared once a one-shot alarm has fired
+    bool               enabled;
+    bool               running;
+    bool               deleted;
+    uint64_t           count;    // the count at base_us
+    int64_t            base_us;  // esp_timer time of the last start, or auto-reload
+    TaskHandle_t       task;
+};
+
+static int64_t gptimer_counts_to_us (const gptimer_t * timer, uint64_t counts) {
+    return (int64_t)(counts * 1000000ULL / timer->resolution_hz);
+}
+
+/**
+ * The alarm "ISR": sleeps until close to the next alarm, spins up to it, and calls back.
+ * Deadlines come from the start time, so one late alarm doesn't make the rest late.
+ */
+static void gptimer_task (void * arg) {
+    gptimer_t * timer = (gptimer_t *)arg;
+    while (true) {
+        taskENTER_CRITICAL();
+        bool    deleted  = timer->deleted;
+        bool    waiting  = timer->running && timer->alarm_armed && timer->alarm_count >= timer->count;
+        int64_t deadline = waiting ? timer->base_us + gptimer_counts_to_us (timer, timer->alarm_count - timer->count) : 0;
+        taskEXIT_CRITICAL();
+
+        if (deleted)
+            break;
+        if (!waiting) {
+            ulTaskNotifyTake (pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        int64_t remaining_us = deadline - esp_timer_get_time();
+        if (remaining_us > GPTIMER_SPIN_US) {
+            ulTaskNotifyTake (pdTRUE, pdMS_TO_TICKS (remaining_us / 1000 - 1));
+            continue;  // and look again, as the timer may have been stopped or changed
+        }
+        while (esp_timer_get_time() < deadline)
+            ;
+
+        gptimer_alarm_event_data_t event;
+        taskENTER_CRITICAL();
+        bool fire = timer->running && timer->alarm_armed;
+        if (fire) {
+            event.count_value = timer->alarm_count;
+            event.alarm_value = timer->alarm_count;
+            if (timer->auto_reload) {
+                timer->count   = timer->reload_count;
+                timer->base_us = deadline;
+            }
+            else
+                timer->alarm_armed = false;
+        }
+        taskEXIT_CRITICAL();
+        if (fire && timer->on_alarm)
+            timer->on_alarm (timer, &event, timer->user_ctx);
+    }
+    delete timer;
+    vTaskDelete (nullptr);
+}
+
+esp_err_t gptimer_new_timer (const gptimer_config_t * config, gptimer_handle_t * ret_timer) {
+    if (!config || !ret_timer || config->resolution_hz == 0 || config->direction != GPTIMER_COUNT_UP)
+        return ESP_ERR_INVALID_ARG;
+
+    gptimer_t * timer    = new gptimer_t {};
+    timer->resolution_hz = config->resolution_hz;
+    if (xTaskCreate (gptimer_task, "gptimer", configMINIMAL_STACK_SIZE * 2, timer, configMAX_PRIORITIES - 1, &timer->task) != pdPASS) {
+        delete timer;
+        return ESP_ERR_NO_MEM;
+    }
+    *ret_timer = timer;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_del_timer (gptimer_handle_t timer) {
+    if (!timer)
+        return ESP_ERR_INVALID_ARG;
+    taskENTER_CRITICAL();
+    bool enabled = timer->enabled;
+    if (!enabled)
+        timer->deleted = true;
+    taskEXIT_CRITICAL();
+    if (enabled)
+        return ESP_ERR_INVALID_STATE;
+    xTaskNotifyGive (timer->task);
+    return ESP_OK;
+}
+
+esp_err_t gptimer_register_event_callbacks (gptimer_handle_t timer, const gptimer_event_callbacks_t * cbs, void * user_data) {
+    if (!timer || !cbs)
+        return ESP_ERR_INVALID_ARG;
+    if (timer->enabled)
+        return ESP_ERR_INVALID_STATE;
+    timer->on_alarm = cbs->on_alarm;
+    timer->user_ctx = user_data;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_set_alarm_action (gptimer_handle_t timer, const gptimer_alarm_config_t * config) {
+    if (!timer)
+        return ESP_ERR_INVALID_ARG;
+    taskENTER_CRITICAL();
+    timer->alarm_armed = config != nullptr;
+    if (config) {
+        timer->alarm_count  = config->alarm_count;
+        timer->reload_count = config->reload_count;
+        timer->auto_reload  = config->flags.auto_reload_on_alarm;
+    }
+    taskEXIT_CRITICAL();
+    xTaskNotifyGive (timer->task);
+    return ESP_OK;
+}
+
+esp_err_t gptimer_set_raw_count (gptimer_handle_t timer, uint64_t value) {
+    if (!timer)
+        return ESP_ERR_INVALID_ARG;
+    taskENTER_CRITICAL();
+    timer->count   = value;
+    timer->base_us = esp_timer_get_time();
+    taskEXIT_CRITICAL();
+    xTaskNotifyGive (timer->task);
+    return ESP_OK;
+}
+
+esp_err_t gptimer_enable (gptimer_handle_t timer) {
+    if (!timer)
+        return ESP_ERR_INVALID_ARG;
+    if (timer->enabled)
+        return ESP_ERR_INVALID_STATE;
+    timer->enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_start (gptimer_handle_t timer) {
+    if (!timer)
+        return ESP_ERR_INVALID_ARG;
+    taskENTER_CRITICAL();
+    bool startable = timer->enabled && !timer->running;
+    if (startable) {
+        timer->running = true;
+        timer->base_us = esp_timer_get_time();
+    }
+    taskEXIT_CRITICAL();
+    if (!startable)
+        return ESP_ERR_INVALID_STATE;
+    xTaskNotifyGive (timer->task);
+    return ESP_OK;
+}
+
+esp_err_t gptimer_stop (gptimer_handle_t timer) {
+    if (!timer)
+        return ESP_ERR_INVALID_ARG;
+    taskENTER_CRITICAL();
+    bool stoppable = timer->running;
+    if (stoppable) {
+        int64_t elapsed_us = esp_timer_get_time() - timer->base_us;
+        timer->running     = false;
+        timer->count += (uint64_t)elapsed_us * timer->resolution_hz / 1000000ULL;
+    }
+    taskEXIT_CRITICAL();
+    if (!stoppable)
+        return ESP_ERR_INVALID_STATE;
+    xTaskNotifyGive (timer->task);
+    return ESP_OK;
+}
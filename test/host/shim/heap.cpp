@@ -0,0 +1,113 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <new>
+#include <stdlib.h>
+
+/**
+ * The heap, made safe for the POSIX port. The port runs one task's thread at a time and parks
+ * the rest, so a task preempted while it holds one of glibc's heap locks leaves any task that
+ * then allocates blocked in the C library, where the scheduler can't see it; if that task has
+ * the higher priority, the holder never runs again. Every allocation therefore suspends the
+ * scheduler, as heap_3's pvPortMalloc() does.
+ *
+ * malloc() and friends are wrapped at link time (-Wl,--wrap, in CMakeLists.txt), which covers
+ * the firmware, the shims and the kernel; operator new and delete are replaced here so that
+ * the standard library's own allocations come through the same path. Allocations inside glibc
+ * itself are not covered, so the shims avoid the calls that make them (strdup() and the like).
+ */
+
+extern "C" {
+void * __real_malloc (size_t size);
+void   __real_free (void * ptr);
+void * __real_calloc (size_t count, size_t size);
+void * __real_realloc (void * ptr, size_t size);
+}
+
+// Before the scheduler starts there is only the main thread, and nothing to suspend
+static bool heap_lock () {
+    bool running = xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED;
+    if (running)
+        vTaskSuspendAll();
+    return running;
+}
+
+static void heap_unlock (bool locked) {
+    if (locked)
+        xTaskResumeAll();
+}
+
+extern "C" void * __wrap_malloc (size_t size) {
+    bool   locked = heap_lock();
+    void * ptr    = __real_malloc (size);
+    heap_unlock (locked);
+    return ptr;
+}
+
+extern "C" void __wrap_free (void * ptr) {
+    if (!ptr)
+        return;
+    bool locked = heap_lock();
+    __real_free (ptr);
+    heap_unlock (locked);
+}
+
+extern "C" void * __wrap_calloc (size_t count, size_t size) {
+    bool   locked = heap_lock();
+    void * ptr    = __real_calloc (count, size);
+    heap_unlock (locked);
+    return ptr;
+}
+
+extern "C" void * __wrap_realloc (void * ptr, size_t size) {
+    bool   locked = heap_lock();
+    void * result = __real_realloc (ptr, size);
+    heap_unlock (locked);
+    return result;
+}
+
+// ====================================================================================================
+// operator new and delete, on the wrapped malloc() and free()
+
+void * operator new (size_t size) {
+    void * ptr = malloc (size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void * operator new[] (size_t size) {
+    return operator new (size);
+}
+
+void * operator new (size_t size, const std::nothrow_t &) noexcept {
+    return malloc (size ? size : 1);
+}
+
+void * operator new[] (size_t size, const std::nothrow_t &) noexcept {
+    return malloc (size ? size : 1);
+}
+
+void operator delete (void * ptr) noexcept {
+    free (ptr);
+}
+
+void operator delete[] (void * ptr) noexcept {
+    free (ptr);
+}
+
+void operator delete (void * ptr, size_t) noexcept {
+    free (ptr);
+}
+
+void operator delete[] (void * ptr, size_t) noexcept {
+    free (ptr);
+}
+
+void operator delete (void * ptr, const std::nothrow_t &) noexcept {
+    free (ptr);
+}
+
+void operator delete[] (void * ptr, const std::nothrow_t &) noexcept {
+    free (ptr);
+}
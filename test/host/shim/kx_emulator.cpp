@@ -0,0 +1,149 @@
+#include "kx_emulator.h"
+
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#define KX_KEYER_CHARACTER_US 500000  // KY text goes out at about 20 WPM
+#define KX_MENU_NONE          255
+#define KX_MENU_TIME          73
+
+/**
+ * A numeric setting that answers "XX;" with "XXnnn;" and takes "XXnnn;" with that many digits.
+ */
+typedef struct {
+    const char name[3];
+    uint8_t    digits;
+    char       value[12];
+} kx_setting_t;
+
+static kx_setting_t s_settings[] = {
+    {"FA", 11, "00014074000"},
+    {"FB", 11, "00014074000"},
+    {"MD", 1,  "3"          },  // CW
+    {"FR", 1,  "0"          },
+    {"FT", 1,  "0"          },
+    {"AP", 1,  "0"          },
+    {"PC", 3,  "050"        },  // 5.0 W
+    {"AG", 3,  "020"        },
+};
+
+static char     s_product_id       = '1';
+static uint32_t s_baud_rate        = 38400;  // SOTAcat leaves the radio at 38400 baud for FSK
+static uint8_t  s_menu_item        = KX_MENU_NONE;
+static uint16_t s_menu_values[256] = {};
+static bool     s_tuning           = false;
+static int64_t  s_keying_until_us  = 0;
+static time_t   s_clock_offset_s   = 0;  // the radio's clock, relative to the host's UTC
+static time_t   s_clock_step_s     = 1;  // what UP;/DN; move in the time menu
+
+void kx_emulator_init (char product_id) {
+    s_product_id      = product_id;
+    s_menu_values[58] = 30;  // TUN PWR, 3.0 W
+}
+
+uint32_t kx_emulator_baud_rate () {
+    return s_baud_rate;
+}
+
+static bool all_digits (const char * text, size_t length) {
+    if (strlen (text) != length)
+        return false;
+    for (size_t i = 0; i < length; ++i)
+        if (!isdigit ((unsigned char)text[i]))
+            return false;
+    return true;
+}
+
+static size_t reply_with (char * reply, size_t reply_size, const char * format, ...) __attribute__ ((format (printf, 3, 4)));
+
+static size_t reply_with (char * reply, size_t reply_size, const char * format, ...) {
+    va_list args;
+    va_start (args, format);
+    int length = vsnprintf (reply, reply_size, format, args);
+    va_end (args);
+    return (length > 0 && (size_t)length < reply_size) ? length : 0;
+}
+
+size_t kx_emulator_command (const char * command, int64_t now_us, char * reply, size_t reply_size) {
+    if (strlen (command) < 2)
+        return 0;  // empty, or the KH1's "I"
+    const char * arguments = command + 2;
+
+    if (strcmp (command, "RVR") == 0)
+        return reply_with (reply, reply_size, "RVR99.99;");
+    if (strcmp (command, "OM") == 0)
+        return reply_with (reply, reply_size, "OM APF---TBXI0%c;", s_product_id);
+    if (strcmp (command, "TQ") == 0)
+        return reply_with (reply, reply_size, "TQ%d;", (s_tuning || now_us < s_keying_until_us) ? 1 : 0);
+    if (strncmp (command, "BR", 2) == 0) {
+        static const uint32_t rates[] = {4800, 9600, 19200, 38400};
+        if (all_digits (arguments, 1) && arguments[0] <= '3')
+            s_baud_rate = rates[arguments[0] - '0'];
+        return 0;
+    }
+    if (strcmp (command, "SWH16") == 0) {  // TUNE, held: toggles the carrier FT8 is sent on
+        s_tuning = !s_tuning;
+        return 0;
+    }
+    if (strcmp (command, "SWT19") == 0) {  // the time menu's hours, minutes and seconds
+        s_clock_step_s = 3600;
+        return 0;
+    }
+    if (strcmp (command, "SWT27") == 0) {
+        s_clock_step_s = 60;
+        return 0;
+    }
+    if (strcmp (command, "SWT20") == 0) {
+        s_clock_step_s = 1;
+        return 0;
+    }
+    if ((strcmp (command, "UP") == 0 || strcmp (command, "DN") == 0) && s_menu_item == KX_MENU_TIME) {
+        s_clock_offset_s += command[0] == 'U' ? s_clock_step_s : -s_clock_step_s;
+        return 0;
+    }
+    if (strcmp (command, "DS") == 0) {
+        if (s_menu_item != KX_MENU_TIME)
+            return reply_with (reply, reply_size, "DS        @@;");
+        time_t    now = time (nullptr) + s_clock_offset_s;
+        struct tm utc;
+        gmtime_r (&now, &utc);
+        return reply_with (reply, reply_size, "DS@@%02d%02d%02d@@;", utc.tm_hour, utc.tm_min, utc.tm_sec);
+    }
+    if (strncmp (command, "KY ", 3) == 0) {
+        int64_t start     = now_us > s_keying_until_us ? now_us : s_keying_until_us;
+        s_keying_until_us = start + (int64_t)strlen (command + 3) * KX_KEYER_CHARACTER_US;
+        return 0;
+    }
+    if (strncmp (command, "MN", 2) == 0) {
+        if (arguments[0] == '\0')
+            return reply_with (reply, reply_size, "MN%03u;", s_menu_item);
+        if (all_digits (arguments, 3))
+            s_menu_item = (uint8_t)atoi (arguments);
+        return 0;  // MNTIM; and other menu shortcuts just open the menu on the radio
+    }
+    if (strncmp (command, "MP", 2) == 0) {
+        if (s_menu_item == KX_MENU_NONE)
+            return reply_with (reply, reply_size, "?;");
+        if (arguments[0] == '\0')
+            return reply_with (reply, reply_size, "MP%03u;", s_menu_values[s_menu_item]);
+        if (all_digits (arguments, 3))
+            s_menu_values[s_menu_item] = (uint16_t)atoi (arguments);
+        return 0;
+    }
+
+    for (kx_setting_t & setting : s_settings) {
+        if (strncmp (command, setting.name, 2) != 0)
+            continue;
+        if (arguments[0] == '\0')
+            return reply_with (reply, reply_size, "%s%s;", setting.name, setting.value);
+        if (!all_digits (arguments, setting.digits))
+            return reply_with (reply, reply_size, "?;");
+        strcpy (setting.value, arguments);
+        return 0;
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * An Elecraft KX2 or KX3 at the far end of the host's UART, answering the CAT commands the
+ * firmware sends (see the KX2/KX3 Programmer's Reference). It keeps VFO A, mode, power,
+ * volume, audio peaking, the menu, the clock and the transmit state; commands it doesn't know are taken
+ * without a reply, as the firmware's fire-and-forget commands expect.
+ */
+
+#define KX_EMULATOR_REPLY_US 5000  // from the end of a command to the start of its reply
+
+/**
+ * @param product_id The OM product id: '1' for a KX2, '2' for a KX3.
+ */
+void kx_emulator_init (char product_id);
+
+/**
+ * Carries out one command.
+ * @param command The command, without its ';'.
+ * @param now_us esp_timer time the command's last byte reached the radio.
+ * @param reply Receives the reply, with its ';', if there is one.
+ * @return the length of the reply, 0 for none.
+ */
+size_t kx_emulator_command (const char * command, int64_t now_us, char * reply, size_t reply_size);
+
+/**
+ * @return the baud rate the radio's serial port is set to, which BRn; changes.
+ */
+uint32_t kx_emulator_baud_rate ();
@@ -0,0 +1,13 @@
+#include "newlib_compat.h"
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy (char * dst, const char * src, size_t size) {
+    size_t length = strlen (src);
+    if (size > 0) {
+        size_t copied = length < size - 1 ? length : size - 1;
+        memcpy (dst, src, copied);
+        dst[copied] = '\0';
+    }
+    return length;
+}
+#endif
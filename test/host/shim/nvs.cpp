@@ -0,0 +1,160 @@
+#include <nvs.h>
+#include <nvs_flash.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:host_nvs";
+
+typedef enum {
+    NVS_TYPE_U8,
+    NVS_TYPE_U32,
+    NVS_TYPE_STR
+} nvs_type_t;
+
+typedef struct {
+    nvs_type_t  type;
+    uint32_t    number;
+    std::string text;
+} nvs_entry_t;
+
+static SemaphoreHandle_t                  s_nvs_mutex = nullptr;
+static bool                               s_nvs_initialized = false;
+static std::vector<std::string>           s_namespaces;  // handle n is s_namespaces[n - 1]
+static std::map<std::string, nvs_entry_t> s_entries;     // keyed by namespace, '/', key
+static uint32_t                           s_commits = 0;
+
+/**
+ * Serializes access to the store: handler_settings writes from the httpd task and flushes
+ * from the esp_timer task.
+ */
+class NvsLock {
+  public:
+    NvsLock() {
+        if (!s_nvs_mutex)
+            s_nvs_mutex = xSemaphoreCreateMutex();
+        xSemaphoreTake (s_nvs_mutex, portMAX_DELAY);
+    }
+    ~NvsLock() { xSemaphoreGive (s_nvs_mutex); }
+};
+
+esp_err_t nvs_flash_init () {
+    NvsLock lock;
+    s_nvs_initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase () {
+    NvsLock lock;
+    s_entries.clear();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open (const char * namespace_name, nvs_open_mode_t open_mode, nvs_handle_t * out_handle) {
+    (void)open_mode;
+    NvsLock lock;
+    if (!s_nvs_initialized)
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    if (strlen (namespace_name) >= NVS_KEY_NAME_MAX_SIZE)
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+
+    for (size_t i = 0; i < s_namespaces.size(); ++i)
+        if (s_namespaces[i] == namespace_name) {
+            *out_handle = i + 1;
+            return ESP_OK;
+        }
+    s_namespaces.push_back (namespace_name);
+    *out_handle = s_namespaces.size();
+    return ESP_OK;
+}
+
+void nvs_close (nvs_handle_t handle) {
+    (void)handle;
+}
+
+esp_err_t nvs_commit (nvs_handle_t handle) {
+    NvsLock lock;
+    if (handle == 0 || handle > s_namespaces.size())
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    ++s_commits;
+    ESP_LOGD (TAG8, "commit %lu", (unsigned long)s_commits);
+    return ESP_OK;
+}
+
+/**
+ * @return the map key of a namespace's key, or an empty string if the handle or key is invalid.
+ */
+static std::string entry_key (nvs_handle_t handle, const char * key) {
+    if (handle == 0 || handle > s_namespaces.size() || strlen (key) >= NVS_KEY_NAME_MAX_SIZE)
+        return std::string();
+    return s_namespaces[handle - 1] + "/" + key;
+}
+
+static esp_err_t nvs_set (nvs_handle_t handle, const char * key, nvs_type_t type, uint32_t number, const char * text) {
+    NvsLock     lock;
+    std::string name = entry_key (handle, key);
+    if (name.empty())
+        return strlen (key) >= NVS_KEY_NAME_MAX_SIZE ? ESP_ERR_NVS_KEY_TOO_LONG : ESP_ERR_NVS_INVALID_HANDLE;
+    s_entries[name] = {type, number, text ? text : ""};
+    return ESP_OK;
+}
+
+/**
+ * @return the entry of the given type, or nullptr. Call with the lock held.
+ */
+static const nvs_entry_t * nvs_find (nvs_handle_t handle, const char * key, nvs_type_t type) {
+    auto found = s_entries.find (entry_key (handle, key));
+    if (found == s_entries.end() || found->second.type != type)
+        return nullptr;
+    return &found->second;
+}
+
+esp_err_t nvs_set_u8 (nvs_handle_t handle, const char * key, uint8_t value) {
+    return nvs_set (handle, key, NVS_TYPE_U8, value, nullptr);
+}
+
+esp_err_t nvs_set_u32 (nvs_handle_t handle, const char * key, uint32_t value) {
+    return nvs_set (handle, key, NVS_TYPE_U32, value, nullptr);
+}
+
+esp_err_t nvs_set_str (nvs_handle_t handle, const char * key, const char * value) {
+    return nvs_set (handle, key, NVS_TYPE_STR, 0, value);
+}
+
+esp_err_t nvs_get_u8 (nvs_handle_t handle, const char * key, uint8_t * out_value) {
+    NvsLock             lock;
+    const nvs_entry_t * entry = nvs_find (handle, key, NVS_TYPE_U8);
+    if (!entry)
+        return ESP_ERR_NVS_NOT_FOUND;
+    *out_value = (uint8_t)entry->number;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_u32 (nvs_handle_t handle, const char * key, uint32_t * out_value) {
+    NvsLock             lock;
+    const nvs_entry_t * entry = nvs_find (handle, key, NVS_TYPE_U32);
+    if (!entry)
+        return ESP_ERR_NVS_NOT_FOUND;
+    *out_value = entry->number;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_str (nvs_handle_t handle, const char * key, char * out_value, size_t * length) {
+    NvsLock             lock;
+    const nvs_entry_t * entry = nvs_find (handle, key, NVS_TYPE_STR);
+    if (!entry)
+        return ESP_ERR_NVS_NOT_FOUND;
+
+    size_t needed = entry->text.size() + 1;
+    if (out_value) {
+        if (*length < needed)
+            return ESP_ERR_NVS_INVALID_LENGTH;
+        memcpy (out_value, entry->text.c_str(), needed);
+    }
+    *length = needed;
+    return ESP_OK;
+}
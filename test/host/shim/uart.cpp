@@ -0,0 +1,245 @@
+#include "kx_emulator.h"
+
+#include <driver/uart.h>
+#include <esp_timer.h>
+#include <hal/uart_ll.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <esp_log.h>
+static const char * TAG8 = "sc:host_uart";
+
+#define UART_RX_BUFFER_MAX 2048
+
+typedef struct {
+    uint8_t byte;
+    int64_t arrival_us;  // esp_timer time the byte's stop bit ends
+} uart_rx_byte_t;
+
+/**
+ * One serial line, with the radio at the far end. Time on the line is simulated: each byte
+ * written is scheduled after the one before it at 10 bits per byte, and the radio's reply to a
+ * command is scheduled from the end of the command's ';'. Readers see bytes once their time has
+ * come. A byte sent at a baud rate the radio isn't set to is garbled and lost, as are the rest
+ * of the command it was part of.
+ */
+typedef struct {
+    bool           installed;
+    uint32_t       baud_rate;
+    int64_t        tx_idle_us;  // when the last byte written has left the host
+    int64_t        rx_idle_us;  // when the last byte of the radio's replies arrives
+    char           command[64];  // what the radio has received of its next command
+    size_t         command_length;
+    bool           command_garbled;
+    uart_rx_byte_t rx[UART_RX_BUFFER_MAX];
+    size_t         rx_head;
+    size_t         rx_count;
+    size_t         rx_capacity;
+    uart_dev_t     hw;
+} uart_line_t;
+
+static uart_line_t s_lines[UART_NUM_MAX];
+
+static uart_line_t * uart_line (uart_port_t uart_num) {
+    if (uart_num < 0 || uart_num >= UART_NUM_MAX || !s_lines[uart_num].installed) {
+        ESP_LOGE (TAG8, "uart %d not installed", uart_num);
+        return nullptr;
+    }
+    return &s_lines[uart_num];
+}
+
+static int64_t uart_byte_us (uint32_t baud_rate) {
+    return (10 * 1000000LL + baud_rate - 1) / baud_rate;  // 8N1: start, 8 data, stop
+}
+
+/**
+ * The radio's end: collects a command, carries it out and queues its reply. Call in a critical section.
+ */
+static void uart_radio_receive (uart_line_t & line, uint8_t byte, int64_t arrival_us) {
+    if (line.baud_rate != kx_emulator_baud_rate()) {
+        line.command_garbled = true;
+        return;
+    }
+    if (byte != ';') {
+        if (line.command_length < sizeof (line.command) - 1)
+            line.command[line.command_length++] = (char)byte;
+        else
+            line.command_garbled = true;
+        return;
+    }
+
+    line.command[line.command_length] = '\0';
+    bool garbled                      = line.command_garbled;
+    line.command_length               = 0;
+    line.command_garbled              = false;
+    if (garbled)
+        return;
+
+    char   reply[64];
+    size_t reply_length = kx_emulator_command (line.command, arrival_us, reply, sizeof (reply));
+    if (!reply_length)
+        return;
+
+    int64_t byte_us = uart_byte_us (line.baud_rate);
+    int64_t at      = arrival_us + KX_EMULATOR_REPLY_US;
+    if (at < line.rx_idle_us)
+        at = line.rx_idle_us;
+    for (size_t i = 0; i < reply_length; ++i) {
+        at += byte_us;
+        if (line.rx_count == line.rx_capacity)
+            continue;  // the ring buffer overflows and drops bytes, as the driver's does
+        line.rx[(line.rx_head + line.rx_count++) % UART_RX_BUFFER_MAX] = {(uint8_t)reply[i], at};
+    }
+    line.rx_idle_us = at;
+}
+
+/**
+ * Puts bytes on the line, after any still going out. Call in a critical section.
+ */
+static void uart_line_transmit (uart_line_t & line, const uint8_t * data, size_t size) {
+    int64_t byte_us = uart_byte_us (line.baud_rate);
+    int64_t at      = esp_timer_get_time();
+    if (at < line.tx_idle_us)
+        at = line.tx_idle_us;
+    for (size_t i = 0; i < size; ++i) {
+        at += byte_us;
+        uart_radio_receive (line, data[i], at);
+    }
+    line.tx_idle_us = at;
+}
+
+/**
+ * @return the number of bytes written but still in the TX FIFO. Call in a critical section.
+ */
+static uint32_t uart_line_tx_pending (const uart_line_t & line) {
+    int64_t remaining_us = line.tx_idle_us - esp_timer_get_time();
+    if (remaining_us <= 0)
+        return 0;
+    int64_t byte_us = uart_byte_us (line.baud_rate);
+    return (uint32_t)((remaining_us + byte_us - 1) / byte_us);
+}
+
+esp_err_t uart_driver_install (uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size, int queue_size, QueueHandle_t * uart_queue, int intr_alloc_flags) {
+    (void)tx_buffer_size;
+    (void)queue_size;
+    (void)uart_queue;
+    (void)intr_alloc_flags;
+    if (uart_num < 0 || uart_num >= UART_NUM_MAX || rx_buffer_size <= UART_LL_FIFO_DEF_LEN)
+        return ESP_ERR_INVALID_ARG;
+
+    uart_line_t & line = s_lines[uart_num];
+    line.installed     = true;
+    line.baud_rate     = 115200;
+    line.rx_capacity   = rx_buffer_size < UART_RX_BUFFER_MAX ? rx_buffer_size : UART_RX_BUFFER_MAX;
+    line.hw.port       = uart_num;
+    return ESP_OK;
+}
+
+esp_err_t uart_param_config (uart_port_t uart_num, const uart_config_t * uart_config) {
+    return uart_set_baudrate (uart_num, uart_config->baud_rate);
+}
+
+esp_err_t uart_set_pin (uart_port_t uart_num, int tx_io_num, int rx_io_num, int rts_io_num, int cts_io_num) {
+    (void)tx_io_num;
+    (void)rx_io_num;
+    (void)rts_io_num;
+    (void)cts_io_num;
+    return uart_line (uart_num) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t uart_set_line_inverse (uart_port_t uart_num, uint32_t inverse_mask) {
+    (void)inverse_mask;  // the radio sees the same levels either way
+    return uart_line (uart_num) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t uart_set_baudrate (uart_port_t uart_num, uint32_t baudrate) {
+    uart_line_t * line = uart_line (uart_num);
+    if (!line || baudrate == 0)
+        return ESP_FAIL;
+    taskENTER_CRITICAL();
+    line->baud_rate = baudrate;
+    taskEXIT_CRITICAL();
+    return ESP_OK;
+}
+
+/**
+ * Drops what has been received; bytes still on their way arrive afterwards, as on the ESP32.
+ */
+esp_err_t uart_flush (uart_port_t uart_num) {
+    uart_line_t * line = uart_line (uart_num);
+    if (!line)
+        return ESP_FAIL;
+    taskENTER_CRITICAL();
+    int64_t now = esp_timer_get_time();
+    while (line->rx_count && line->rx[line->rx_head].arrival_us <= now) {
+        line->rx_head = (line->rx_head + 1) % UART_RX_BUFFER_MAX;
+        --line->rx_count;
+    }
+    taskEXIT_CRITICAL();
+    return ESP_OK;
+}
+
+/**
+ * With no TX ring buffer, returns once the last of the data is in the FIFO.
+ */
+int uart_write_bytes (uart_port_t uart_num, const void * src, size_t size) {
+    uart_line_t * line = uart_line (uart_num);
+    if (!line)
+        return -1;
+    taskENTER_CRITICAL();
+    uart_line_transmit (*line, (const uint8_t *)src, size);
+    taskEXIT_CRITICAL();
+
+    while (true) {
+        taskENTER_CRITICAL();
+        uint32_t pending = uart_line_tx_pending (*line);
+        taskEXIT_CRITICAL();
+        if (pending <= UART_LL_FIFO_DEF_LEN)
+            return (int)size;
+        vTaskDelay (1);
+    }
+}
+
+int uart_read_bytes (uart_port_t uart_num, void * buf, uint32_t length, TickType_t ticks_to_wait) {
+    uart_line_t * line = uart_line (uart_num);
+    if (!line)
+        return -1;
+
+    uint8_t *  out   = (uint8_t *)buf;
+    uint32_t   read  = 0;
+    TickType_t start = xTaskGetTickCount();
+    while (true) {
+        taskENTER_CRITICAL();
+        int64_t now = esp_timer_get_time();
+        while (read < length && line->rx_count && line->rx[line->rx_head].arrival_us <= now) {
+            out[read++]   = line->rx[line->rx_head].byte;
+            line->rx_head = (line->rx_head + 1) % UART_RX_BUFFER_MAX;
+            --line->rx_count;
+        }
+        taskEXIT_CRITICAL();
+
+        if (read == length || xTaskGetTickCount() - start >= ticks_to_wait)
+            return (int)read;
+        vTaskDelay (1);
+    }
+}
+
+// ====================================================================================================
+
+uart_dev_t * uart_ll_get_hw (uart_port_t uart_num) {
+    return &s_lines[uart_num].hw;
+}
+
+uint32_t uart_ll_get_txfifo_len (uart_dev_t * hw) {
+    taskENTER_CRITICAL();
+    uint32_t pending = uart_line_tx_pending (s_lines[hw->port]);
+    taskEXIT_CRITICAL();
+    return pending < UART_LL_FIFO_DEF_LEN ? UART_LL_FIFO_DEF_LEN - pending : 0;
+}
+
+void uart_ll_write_txfifo (uart_dev_t * hw, const uint8_t * buf, uint32_t wr_len) {
+    taskENTER_CRITICAL();
+    uart_line_transmit (s_lines[hw->port], buf, wr_len);
+    taskEXIT_CRITICAL();
+}
@@ -82,8 +82,13 @@ DEFAULT_STATE = {
     "sta3_pass": "",
     "ap_ssid": "SOTAcat",
     "ap_pass": "12345678",
+    # Version of the settings above; the device bumps it on every change
+    "config_version": 1,
 }
 
+# Endpoints whose POST changes a settings group
+SETTINGS_ENDPOINTS = {"settings", "gps", "callsign", "license", "tuneTargets", "cwMacros"}
+
 
 class MockSOTAcatServer:
     def __init__(self, web_dir: str):
@@ -91,9 +96,37 @@ class MockSOTAcatServer:
         CORS(self.app)  # Allow cross-origin for development
         self.web_dir = Path(web_dir).resolve()
         self.state = dict(DEFAULT_STATE)
+        self.jobs = {}  # id -> job JSON, see _reply_maybe_async()
+        self.next_job_id = 1
         self._setup_routes()
 
+    def _reply_maybe_async(self, kind):
+        """Answer a slow radio command. Clients that send "Prefer: respond-async" get
+        202 and a job; the mock finishes every job immediately."""
+        if "respond-async" not in request.headers.get("Prefer", ""):
+            return "", 200
+        job = {"id": self.next_job_id, "kind": kind, "state": "succeeded",
+               "progress": 100, "cancelRequested": False, "ageMs": 0}
+        self.jobs[job["id"]] = job
+        self.next_job_id += 1
+        print(f"[MOCK] Accepted {kind} job {job['id']}")
+        response = jsonify(dict(job, state="queued", progress=0))
+        response.status_code = 202
+        response.headers["Location"] = f"/api/v1/jobs/{job['id']}"
+        response.headers["Preference-Applied"] = "respond-async"
+        return response
+
     def _setup_routes(self):
+        @self.app.after_request
+        def after_api_request(response):
+            endpoint = request.path.removeprefix("/api/v1/")
+            if request.method == "POST" and endpoint in SETTINGS_ENDPOINTS and response.status_code == 200:
+                self.state["config_version"] += 1
+            if request.path.startswith("/api/v1/"):
+                # One client, no radio contention: the device's minimum poll interval
+                response.headers["X-Poll-Interval"] = "1000"
+            return response
+
         # Static file serving
         @self.app.route("/")
         def index():
@@ -252,6 +285,50 @@ class MockSOTAcatServer:
             print(f"[MOCK] WiFi settings updated")
             return "", 200
 
+        # Configuration bundle: every settings group in one document
+        @self.app.route("/api/v1/config", methods=["GET"])
+        def get_config():
+            return jsonify(
+                {
+                    "version": self.state["config_version"],
+                    "settings": get_settings().get_json(),
+                    "gps": {"gps_lat": self.state["gps_lat"], "gps_lon": self.state["gps_lon"]},
+                    "callsign": {"callsign": self.state["callsign"]},
+                    "license": {"license": self.state["license"]},
+                    "tuneTargets": {
+                        "targets": self.state["tune_targets"],
+                        "mobile": self.state["tune_targets_mobile"],
+                    },
+                    "cwMacros": {"macros": self.state["cw_macros"]},
+                }
+            )
+
+        @self.app.route("/api/v1/config", methods=["PATCH"])
+        def patch_config():
+            data = request.get_json() or {}
+            group = data.get("settings", {})
+            for key in group:
+                if key in self.state:
+                    self.state[key] = group[key]
+            group = data.get("gps", {})
+            for key in ["gps_lat", "gps_lon"]:
+                if key in group:
+                    self.state[key] = group[key]
+            if "callsign" in data.get("callsign", {}):
+                self.state["callsign"] = data["callsign"]["callsign"].upper()
+            if "license" in data.get("license", {}):
+                self.state["license"] = data["license"]["license"].upper()
+            group = data.get("tuneTargets", {})
+            if "targets" in group:
+                self.state["tune_targets"] = group["targets"]
+            if "mobile" in group:
+                self.state["tune_targets_mobile"] = group["mobile"]
+            if "macros" in data.get("cwMacros", {}):
+                self.state["cw_macros"] = data["cwMacros"]["macros"]
+            self.state["config_version"] += 1
+            print(f"[MOCK] Config patched: {', '.join(data.keys())}")
+            return jsonify({"version": self.state["config_version"], "reboot": "settings" in data})
+
         # Battery and Signal
         @self.app.route("/api/v1/batteryInfo", methods=["GET"])
         def get_battery_info():
@@ -278,7 +355,7 @@ class MockSOTAcatServer:
             time_val = request.args.get("time")
             if time_val:
                 print(f"[MOCK] Time sync received: {time_val}")
-            return "", 200
+            return self._reply_maybe_async("time")
 
         # Power control
         @self.app.route("/api/v1/power", methods=["PUT"])
@@ -317,7 +394,25 @@ class MockSOTAcatServer:
         @self.app.route("/api/v1/atu", methods=["PUT"])
         def tune_atu():
             print(f"[MOCK] ATU tune initiated")
-            return "", 200
+            return self._reply_maybe_async("atu")
+
+        # Long-running operation status
+        @self.app.route("/api/v1/jobs", methods=["GET"])
+        def list_jobs():
+            return jsonify(sorted(self.jobs.values(), key=lambda j: -j["id"]))
+
+        @self.app.route("/api/v1/jobs/<int:job_id>", methods=["GET"])
+        def get_job(job_id):
+            if job_id not in self.jobs:
+                return jsonify({"error": "unknown job"}), 404
+            return jsonify(self.jobs[job_id])
+
+        @self.app.route("/api/v1/jobs/<int:job_id>", methods=["DELETE"])
+        def cancel_job(job_id):
+            if job_id not in self.jobs:
+                return jsonify({"error": "unknown job"}), 404
+            print(f"[MOCK] Cancel requested for job {job_id} (already finished)")
+            return "", 204
 
         # OTA update (just acknowledge, don't do anything)
         @self.app.route("/api/v1/ota", methods=["POST"])
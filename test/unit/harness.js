@@ -0,0 +1,51 @@
+/**
+ * Shared harness for the unit tests that run a section of src/web/main.js in a sandbox:
+ * a minimal runner that also waits for async tests, and the section loader.
+ *
+ * Usage:
+ *   const { it, assertEqual, loadMainJs, report } = require('./harness');
+ *   const sb = loadMainJs({ fetch: ... }, /async function f\(\) \{[\s\S]*?\n\}/, 'f');
+ *   it('does something', async () => { assertEqual(await sb.f(), 1); });
+ *   report();
+ */
+const fs = require('fs');
+const path = require('path');
+const vm = require('vm');
+
+const MAIN_JS_PATH = path.join(__dirname, '../../src/web/main.js');
+
+let testsPassed = 0;
+let testsFailed = 0;
+const pending = [];
+
+function it(name, fn) {
+    pending.push(Promise.resolve()
+        .then(fn)
+        .then(() => { testsPassed++; console.log(`  ✓ ${name}`); })
+        .catch((e) => { testsFailed++; console.log(`  ✗ ${name}\n    ${e.message}`); }));
+}
+
+function assertEqual(a, b, m='') {
+    if (a !== b) throw new Error(`${m}: expected ${JSON.stringify(b)}, got ${JSON.stringify(a)}`);
+}
+
+// Runs the part of main.js that `pattern` matches in `sandbox`, followed by `exportCode`
+// (top-level const and let bindings aren't sandbox properties, e.g. "this.X = X;").
+// Returns the sandbox, which now holds the section's functions.
+function loadMainJs(sandbox, pattern, what, exportCode = '') {
+    vm.createContext(sandbox);
+    const section = fs.readFileSync(MAIN_JS_PATH, 'utf8').match(pattern);
+    if (!section) throw new Error(`${what} not found in main.js`);
+    vm.runInContext(section[0] + '\n' + exportCode, sandbox);
+    return sandbox;
+}
+
+// Prints the totals once every test has settled, and fails the run if any test failed.
+function report() {
+    return Promise.all(pending).then(() => {
+        console.log(`\nResults: ${testsPassed} passed, ${testsFailed} failed`);
+        if (testsFailed > 0) process.exit(1);
+    });
+}
+
+module.exports = { it, assertEqual, loadMainJs, report };
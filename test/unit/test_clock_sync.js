@@ -0,0 +1,78 @@
+#!/usr/bin/env node
+/**
+ * Unit tests for the device clock discipline in main.js
+ *
+ * Covers:
+ * - syncDeviceClock: t1 on every round trip but the last, prev/t4 completing the one before,
+ *   the device's state from the last reply, and failures
+ *
+ * Usage:
+ *   node test/unit/test_clock_sync.js
+ */
+const { it, assertEqual, loadMainJs, report } = require('./harness');
+
+// now: fake clock in ms, advanced 5 ms by every request; requests: URLs fetched, in order
+function makeSandbox(status = 200) {
+    const sandbox = {
+        console: console,
+        Date: { now: () => sandbox._now },
+        noteServerLoad: () => {},
+        fetch: async (url) => {
+            sandbox._requests.push(url);
+            sandbox._now += 5;
+            return {
+                status: status,
+                ok: status === 200,
+                json: async () => ({ synced: true, samples: sandbox._requests.length - 1 }),
+            };
+        },
+        _now: 1700000000000,
+        _requests: [],
+    };
+    return loadMainJs(sandbox, /const CLOCK_SYNC_ROUNDS = [\s\S]*?\nasync function syncDeviceClock\([\s\S]*?\n\}/,
+                      'clock discipline', 'this.syncDeviceClock = syncDeviceClock;');
+}
+
+function query(url) {
+    const params = {};
+    const q = url.split('?')[1] || '';
+    for (const pair of q.split('&').filter(Boolean)) {
+        const [name, value] = pair.split('=');
+        params[name] = value;
+    }
+    return params;
+}
+
+console.log('\ndevice clock discipline');
+
+it('starts a round trip with t1 and completes it on the next request', async () => {
+    const sb = makeSandbox();
+    await sb.syncDeviceClock(2);
+    assertEqual(sb._requests.length, 3, 'one request per round trip, and one to complete the last');
+    const [first, second, last] = sb._requests.map(query);
+    assertEqual(first.t1, '1700000000000', 'first t1');
+    assertEqual(first.prev, undefined, 'nothing to complete yet');
+    assertEqual(second.t1, '1700000000005', 'second t1');
+    assertEqual(second.prev, '1700000000000', 'completes the first');
+    assertEqual(second.t4, '1700000000005', 'when the first reply arrived');
+    assertEqual(last.t1, undefined, 'the last request starts nothing');
+    assertEqual(last.prev, '1700000000005', 'completes the second');
+    assertEqual(last.t4, '1700000000010');
+});
+
+it('resolves to the state in the last reply', async () => {
+    const sb = makeSandbox();
+    const state = await sb.syncDeviceClock(3);
+    assertEqual(state.synced, true);
+    assertEqual(state.samples, 3);
+});
+
+it('throws when the device has no clock endpoint', async () => {
+    const sb = makeSandbox(404);
+    let error = null;
+    await sb.syncDeviceClock(2).catch((e) => { error = e; });
+    assertEqual(error && error.message, 'HTTP 404');
+    assertEqual(sb._requests.length, 1, 'stops at the first failure');
+});
+
+report();
@@ -0,0 +1,101 @@
+#!/usr/bin/env node
+const { it, assertEqual, loadMainJs, report } = require('./harness');
+
+function response(status, body, headers = {}) {
+    return {
+        status: status,
+        ok: status >= 200 && status < 300,
+        json: async () => body,
+        headers: { get: (name) => headers[name] || null },
+    };
+}
+
+// replies: list of responses handed out in order, one per fetch call
+function makeSandbox(replies) {
+    const calls = [];
+    return loadMainJs({
+        console: console,
+        Date: Date,
+        Promise: Promise,
+        Object: Object,
+        setTimeout: (fn) => setTimeout(fn, 0),
+        JOB_POLL_INTERVAL_MS: 1,
+        JOB_POLL_TIMEOUT_MS: 1000,
+        fetch: async (url, opts) => {
+            calls.push({ url: url, opts: opts || {} });
+            return replies.shift();
+        },
+        _calls: calls,
+    }, /async function runRadioJob\(url, options = \{\}\) \{[\s\S]*?\n\}/, 'runRadioJob');
+}
+
+async function rejection(promise) {
+    try {
+        await promise;
+    } catch (e) {
+        return e;
+    }
+    throw new Error('expected rejection');
+}
+
+console.log('\nrunRadioJob');
+
+it('asks for an asynchronous reply', async () => {
+    const sb = makeSandbox([response(204)]);
+    await sb.runRadioJob('/api/v1/atu', { method: 'PUT' });
+    assertEqual(sb._calls[0].opts.method, 'PUT');
+    assertEqual(sb._calls[0].opts.headers.Prefer, 'respond-async');
+});
+
+it('treats a synchronous success as finished (older firmware)', async () => {
+    const sb = makeSandbox([response(204)]);
+    await sb.runRadioJob('/api/v1/atu', { method: 'PUT' });
+    assertEqual(sb._calls.length, 1, 'no polling');
+});
+
+it('reports a synchronous failure', async () => {
+    const sb = makeSandbox([response(500, { error: 'radio busy' })]);
+    const e = await rejection(sb.runRadioJob('/api/v1/atu', { method: 'PUT' }));
+    assertEqual(e.message, 'radio busy');
+});
+
+it('polls the job location until it succeeds', async () => {
+    const sb = makeSandbox([
+        response(202, { id: 7, state: 'queued' }, { Location: '/api/v1/jobs/7' }),
+        response(200, { id: 7, state: 'running' }),
+        response(200, { id: 7, state: 'succeeded' }),
+    ]);
+    await sb.runRadioJob('/api/v1/time?time=1', { method: 'PUT' });
+    assertEqual(sb._calls.length, 3);
+    assertEqual(sb._calls[1].url, '/api/v1/jobs/7');
+});
+
+it('reports the error text of a failed job', async () => {
+    const sb = makeSandbox([
+        response(202, { id: 3, state: 'queued' }, { Location: '/api/v1/jobs/3' }),
+        response(200, { id: 3, state: 'failed', error: 'timeout locking radio' }),
+    ]);
+    const e = await rejection(sb.runRadioJob('/api/v1/atu', { method: 'PUT' }));
+    assertEqual(e.message, 'timeout locking radio');
+});
+
+it('reports a cancelled job', async () => {
+    const sb = makeSandbox([
+        response(202, { id: 4, state: 'queued' }, {}),
+        response(200, { id: 4, state: 'cancelled' }),
+    ]);
+    const e = await rejection(sb.runRadioJob('/api/v1/atu', { method: 'PUT' }));
+    assertEqual(e.message, 'job cancelled');
+    assertEqual(sb._calls[1].url, '/api/v1/jobs/4', 'falls back to id when Location is missing');
+});
+
+it('gives up when the job disappears', async () => {
+    const sb = makeSandbox([
+        response(202, { id: 5, state: 'queued' }, { Location: '/api/v1/jobs/5' }),
+        response(404, { error: 'unknown job' }),
+    ]);
+    const e = await rejection(sb.runRadioJob('/api/v1/atu', { method: 'PUT' }));
+    assertEqual(e.message, 'job 5 lost (HTTP 404)');
+});
+
+report();
@@ -0,0 +1,124 @@
+#!/usr/bin/env node
+/**
+ * Unit tests for the server load hints in main.js
+ *
+ * Covers:
+ * - noteServerLoad: X-Poll-Interval, and Retry-After on 503 and 429 replies
+ * - nextPollDelay: the poller's own interval, the device's hint, and busy back-off
+ * - startPolling / stopPolling: rescheduling after each run, and stopping
+ *
+ * Usage:
+ *   node test/unit/test_server_load.js
+ */
+const { it, assertEqual, loadMainJs, report } = require('./harness');
+
+function response(status, headers = {}) {
+    return {
+        status: status,
+        ok: status >= 200 && status < 300,
+        headers: { get: (name) => (name in headers ? headers[name] : null) },
+    };
+}
+
+// now: fake clock in ms; timers: delays passed to setTimeout, with their callbacks
+function makeSandbox() {
+    const sandbox = {
+        console: console,
+        Math: Math,
+        parseInt: parseInt,
+        Date: { now: () => sandbox._now },
+        setTimeout: (fn, ms) => { sandbox._timers.push({ fn: fn, ms: ms }); return sandbox._timers.length; },
+        clearTimeout: (id) => { if (sandbox._timers[id - 1]) sandbox._timers[id - 1].cleared = true; },
+        _now: 1000000,
+        _timers: [],
+    };
+    return loadMainJs(sandbox, /const ServerLoad = \{[\s\S]*?\nfunction stopPolling\(poller\) \{[\s\S]*?\n\}/,
+                      'server load hints', 'this.ServerLoad = ServerLoad;');
+}
+
+console.log('\nserver load hints');
+
+it('uses the poller interval when the device sends no hints', () => {
+    const sb = makeSandbox();
+    sb.noteServerLoad(response(200));
+    assertEqual(sb.nextPollDelay(3000), 3000);
+});
+
+it('stretches the interval to X-Poll-Interval', () => {
+    const sb = makeSandbox();
+    sb.noteServerLoad(response(200, { 'X-Poll-Interval': '5000' }));
+    assertEqual(sb.nextPollDelay(3000), 5000, 'slower hint applies');
+    assertEqual(sb.nextPollDelay(60000), 60000, 'never polls faster than its own interval');
+});
+
+it('follows the latest hint as load drops', () => {
+    const sb = makeSandbox();
+    sb.noteServerLoad(response(200, { 'X-Poll-Interval': '8000' }));
+    sb.noteServerLoad(response(200, { 'X-Poll-Interval': '1000' }));
+    assertEqual(sb.nextPollDelay(3000), 3000);
+});
+
+it('ignores malformed hints', () => {
+    const sb = makeSandbox();
+    sb.noteServerLoad(response(200, { 'X-Poll-Interval': 'soon' }));
+    sb.noteServerLoad(null);
+    assertEqual(sb.nextPollDelay(3000), 3000);
+});
+
+it('backs off for Retry-After on a busy reply', () => {
+    const sb = makeSandbox();
+    sb.noteServerLoad(response(503, { 'Retry-After': '7' }));
+    assertEqual(sb.nextPollDelay(3000), 7000);
+    sb._now += 5000;
+    assertEqual(sb.nextPollDelay(3000), 3000, 'back-off expires');
+});
+
+it('backs off for Retry-After when over the rate limit', () => {
+    const sb = makeSandbox();
+    sb.noteServerLoad(response(429, { 'Retry-After': '4' }));
+    assertEqual(sb.nextPollDelay(3000), 4000);
+});
+
+it('backs off one second for a busy reply without Retry-After', () => {
+    const sb = makeSandbox();
+    sb.noteServerLoad(response(503));
+    assertEqual(sb.nextPollDelay(500), 1000);
+});
+
+it('ignores Retry-After on other replies', () => {
+    const sb = makeSandbox();
+    sb.noteServerLoad(response(200, { 'Retry-After': '7' }));
+    assertEqual(sb.nextPollDelay(3000), 3000);
+});
+
+it('reschedules after each run with the current delay', async () => {
+    const sb = makeSandbox();
+    let runs = 0;
+    const poller = sb.startPolling(async () => {
+        runs++;
+        sb.noteServerLoad(response(200, { 'X-Poll-Interval': '9000' }));
+    }, 3000);
+    assertEqual(sb._timers[0].ms, 3000, 'first run');
+    await sb._timers[0].fn();
+    assertEqual(runs, 1);
+    assertEqual(sb._timers[1].ms, 9000, 'second run follows the hint');
+    sb.stopPolling(poller);
+    assertEqual(sb._timers[1].cleared, true, 'stop cancels the pending run');
+});
+
+it('does not reschedule a poller stopped during its run', async () => {
+    const sb = makeSandbox();
+    let poller = null;
+    poller = sb.startPolling(async () => sb.stopPolling(poller), 3000);
+    await sb._timers[0].fn();
+    assertEqual(sb._timers.length, 1);
+});
+
+it('keeps polling after a run throws', async () => {
+    const sb = makeSandbox();
+    sb.startPolling(async () => { throw new Error('offline'); }, 3000);
+    await sb._timers[0].fn().catch(() => {});
+    assertEqual(sb._timers.length, 2);
+});
+
+report();